@@ -24,10 +24,13 @@
 #endif
 
 #include <csnode/blockchain.hpp>
+#include <csnode/datastream.hpp>
+#include <csnode/statesnapshot.hpp>
 
 #include <csstats.hpp>
 #include <deque>
 #include <queue>
+#include <set>
 
 #include <client/params.hpp>
 #include <lib/system/concurrent.hpp>
@@ -102,23 +105,25 @@ public:  // wrappers
     void executeByteCode(executor::ExecuteByteCodeResult& resp, const std::string& address, const std::string& smart_address, const std::vector<general::ByteCodeObject>& code,
                          const std::string& state, const std::string& method, const std::vector<general::Variant>& params, const int64_t& timeout) {
         csunused(timeout);
-        static std::mutex m;
-        std::lock_guard lk(m);  // temporary solution
 
         if (!code.empty()) {
+            ContractsLock contractsLock(*this, {BlockChain::getAddressFromKey(smart_address)});
+
             executor::SmartContractBinary smartContractBinary;
             smartContractBinary.contractAddress = smart_address;
             smartContractBinary.object.byteCodeObjects = code;
             smartContractBinary.object.instance = state;
             smartContractBinary.stateCanModify = solver_.isContractLocked(BlockChain::getAddressFromKey(smart_address)) ? true : false;
-            if (auto optOriginRes = execute(address, smartContractBinary, method, params))
+            const auto accessId = generateAccessId();
+            if (auto optOriginRes = execute(accessId, address, smartContractBinary, method, params))
                 resp = optOriginRes.value().resp;
         }
     }
 
     void executeByteCodeMultiple(ExecuteByteCodeMultipleResult& _return, const ::general::Address& initiatorAddress, const SmartContractBinary& invokedContract,
         const std::string& method, const std::vector<std::vector<::general::Variant>>& params, const int64_t executionTime) {
-        if (!connect()) {
+        auto connection = getConnection();
+        if (!connection) {
             _return.status.code = 1;
             _return.status.message = "No executor connection!";
             return;
@@ -126,14 +131,11 @@ public:  // wrappers
         const auto acceess_id = generateAccessId();
         ++execCount_;
         try {
-			std::shared_lock slk(shErrMt);
-            origExecutor_->executeByteCodeMultiple(_return, acceess_id, initiatorAddress, invokedContract, method, params, executionTime, EXECUTOR_VERSION);
+            connection->client->executeByteCodeMultiple(_return, acceess_id, initiatorAddress, invokedContract, method, params, executionTime, EXECUTOR_VERSION);
         }
         catch (::apache::thrift::transport::TTransportException & x) {
-            // sets stop_ flag to true forever, replace with new instance
-            if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-                reCreationOriginExecutor();
-            }
+            // client sets stop_ flag to true forever, replace with new instance
+            resetConnection(*connection);
             _return.status.code = 1;
             _return.status.message = x.what();
         }
@@ -143,24 +145,21 @@ public:  // wrappers
         }
         --execCount_;
         deleteAccessId(acceess_id);
-        disconnect();
     }
 
     void getContractMethods(GetContractMethodsResult& _return, const std::vector<::general::ByteCodeObject>& byteCodeObjects) {
-        if (!connect()) {
+        auto connection = getConnection();
+        if (!connection) {
             _return.status.code = 1;
             _return.status.message = "No executor connection!";
             return;
         }
         try {
-			std::shared_lock slk(shErrMt);
-            origExecutor_->getContractMethods(_return, byteCodeObjects, EXECUTOR_VERSION);
+            connection->client->getContractMethods(_return, byteCodeObjects, EXECUTOR_VERSION);
         }
         catch (::apache::thrift::transport::TTransportException & x) {
-            // sets stop_ flag to true forever, replace with new instance
-            if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-                reCreationOriginExecutor();
-            }
+            // client sets stop_ flag to true forever, replace with new instance
+            resetConnection(*connection);
             _return.status.code = 1;
             _return.status.message = x.what();
         }
@@ -168,24 +167,21 @@ public:  // wrappers
             _return.status.code = 1;
             _return.status.message = x.what();
         }
-        disconnect();
     }
 
     void getContractVariables(GetContractVariablesResult& _return, const std::vector<::general::ByteCodeObject>& byteCodeObjects, const std::string& contractState) {
-        if (!connect()) {
+        auto connection = getConnection();
+        if (!connection) {
             _return.status.code = 1;
             _return.status.message = "No executor connection!";
             return;
         }
         try {
-			std::shared_lock slk(shErrMt);
-            origExecutor_->getContractVariables(_return, byteCodeObjects, contractState, EXECUTOR_VERSION);
+            connection->client->getContractVariables(_return, byteCodeObjects, contractState, EXECUTOR_VERSION);
         }
         catch (::apache::thrift::transport::TTransportException & x) {
-            // sets stop_ flag to true forever, replace with new instance
-            if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-                reCreationOriginExecutor();
-            }
+            // client sets stop_ flag to true forever, replace with new instance
+            resetConnection(*connection);
             _return.status.code = 1;
             _return.status.message = x.what();
         }
@@ -193,24 +189,21 @@ public:  // wrappers
             _return.status.code = 1;
             _return.status.message = x.what();
         }
-        disconnect();
     }
 
     void compileSourceCode(CompileSourceCodeResult& _return, const std::string& sourceCode) {
-        if (!connect()) {
+        auto connection = getConnection();
+        if (!connection) {
             _return.status.code = 1;
             _return.status.message = "No executor connection!";
             return;
         }
         try {
-			std::shared_lock slk(shErrMt);
-            origExecutor_->compileSourceCode(_return, sourceCode, EXECUTOR_VERSION);
+            connection->client->compileSourceCode(_return, sourceCode, EXECUTOR_VERSION);
         }
         catch (::apache::thrift::transport::TTransportException & x) {
-            // sets stop_ flag to true forever, replace with new instance
-            if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-                reCreationOriginExecutor();
-            }
+            // client sets stop_ flag to true forever, replace with new instance
+            resetConnection(*connection);
             _return.status.code = 1;
             _return.status.message = x.what();
         }
@@ -218,12 +211,12 @@ public:  // wrappers
             _return.status.code = 1;
             _return.status.message = x.what();
         }
-        disconnect();
     }
 
 public:
-    static Executor& getInstance(const BlockChain* p_blockchain = nullptr, const cs::SolverCore* solver = nullptr, const int p_exec_port = 0) {  // singlton
-        static Executor executor(*p_blockchain, *solver, p_exec_port);
+    static Executor& getInstance(const BlockChain* p_blockchain = nullptr, const cs::SolverCore* solver = nullptr, const int p_exec_port = 0,
+                                 const size_t p_exec_connections = 1) {  // singlton
+        static Executor executor(*p_blockchain, *solver, p_exec_port, p_exec_connections);
         return executor;
     }
 
@@ -317,8 +310,6 @@ public:
 
     std::optional<ExecuteResult> executeTransaction(const csdb::Pool& pool, const uint64_t& offsetTrx, const csdb::Amount& feeLimit) {
         csunused(feeLimit);
-        static std::mutex m;
-        std::lock_guard lk(m);  // temporary solution
 
         auto smartTrxn = *(pool.transactions().begin() + offsetTrx);
 
@@ -327,6 +318,19 @@ public:
 
         csdb::Transaction deployTrxn;
         const auto isdeploy = isDeploy(smartTrxn);
+        const bool isPayable = !smartTrxn.user_field(0).is_valid() && smartTrxn.amount().to_double();
+
+        // the contract and the contracts it uses are not executed by other calls until this one is finished
+        api::SmartContractInvocation sci;
+        std::vector<csdb::Address> usedContracts{smartTarget};
+        if (!isdeploy && !isPayable) {
+            sci = deserialize<api::SmartContractInvocation>(smartTrxn.user_field(0).value<std::string>());
+            for (const auto& addrLock : sci.usedContracts) {
+                usedContracts.push_back(BlockChain::getAddressFromKey(addrLock));
+            }
+        }
+        ContractsLock contractsLock(*this, std::move(usedContracts));
+
         if (!isdeploy) {  // execute
             const auto optDeployId = getDeployTrxn(smartTarget);
             if (!optDeployId.has_value())
@@ -347,8 +351,8 @@ public:
 
         std::string method;
         std::vector<general::Variant> params;
-        api::SmartContractInvocation sci;
-        if (!smartTrxn.user_field(0).is_valid() && smartTrxn.amount().to_double()) {  // payable
+        const auto accessId = generateAccessId();
+        if (isPayable) {
             method = "payable";
             general::Variant var;
             var.__set_v_string(smartTrxn.amount().to_string());
@@ -364,20 +368,19 @@ public:
 			}
         }
         else if (!isdeploy) {
-            sci = deserialize<api::SmartContractInvocation>(smartTrxn.user_field(0).value<std::string>());
             method = sci.method;
             params = sci.params;
 
             for (const auto& addrLock : sci.usedContracts) {
-                addToLockSmart(addrLock, getFutureAccessId());
+                addToLockSmart(addrLock, accessId);
             }
         }
 
-        const auto optOriginRes = execute(smartSource.to_api_addr(), smartContractBinary, method, params);
+        const auto optOriginRes = execute(accessId, smartSource.to_api_addr(), smartContractBinary, method, params);
 
         if (!isdeploy) {
             for (const auto& addrLock : sci.usedContracts) {
-                deleteFromLockSmart(addrLock, getFutureAccessId());
+                deleteFromLockSmart(addrLock, accessId);
             }
         }
 
@@ -487,14 +490,61 @@ public slots:
         state_update(block);
     }
 
+    void onSaveState(cs::StateSnapshot& snapshot) {
+        cs::Bytes bytes;
+        cs::DataStream stream(bytes);
+        {
+            std::shared_lock slk(mtx_);
+            stream << lastState_.size();
+
+            for (const auto& [address, state] : lastState_) {
+                stream << address.public_key() << state;
+            }
+        }
+        snapshot.setSection(kSnapshotSection, std::move(bytes));
+    }
+
+    void onLoadState(const cs::StateSnapshot& snapshot, bool* failed) {
+        const cs::Bytes* data = snapshot.section(kSnapshotSection);
+        if (data == nullptr) {
+            *failed = true;
+            return;
+        }
+
+        cs::DataStream stream(data->data(), data->size());
+        std::map<csdb::Address, std::string> lastState;
+        size_t count = 0;
+        stream >> count;
+
+        for (size_t i = 0; i < count && stream.isValid(); ++i) {
+            cs::PublicKey key;
+            std::string state;
+            stream >> key >> state;
+            lastState.emplace(csdb::Address::from_public_key(key), std::move(state));
+        }
+
+        if (!stream.isValid()) {
+            *failed = true;
+            return;
+        }
+
+        std::lock_guard lk(mtx_);
+        lastState_ = std::move(lastState);
+    }
+
 private:
     std::map<general::Address, general::AccessID> lockSmarts;
-    explicit Executor(const BlockChain& p_blockchain, const cs::SolverCore& solver, const int p_exec_port)
+    explicit Executor(const BlockChain& p_blockchain, const cs::SolverCore& solver, const int p_exec_port, const size_t p_exec_connections)
     : blockchain_(p_blockchain)
-    , solver_(solver)
-    , executorTransport_(new ::apache::thrift::transport::TBufferedTransport(::apache::thrift::stdcxx::make_shared<::apache::thrift::transport::TSocket>("localhost", p_exec_port)))
-    , origExecutor_(
-          std::make_unique<executor::ContractExecutorConcurrentClient>(::apache::thrift::stdcxx::make_shared<apache::thrift::protocol::TBinaryProtocol>(executorTransport_))) {
+    , solver_(solver) {
+        for (size_t i = 0; i < std::max<size_t>(p_exec_connections, 1); ++i) {
+            auto connection = std::make_unique<Connection>();
+            connection->transport.reset(new ::apache::thrift::transport::TBufferedTransport(::apache::thrift::stdcxx::make_shared<::apache::thrift::transport::TSocket>("localhost", p_exec_port)));
+            connection->client = std::make_unique<OriginExecutor>(::apache::thrift::stdcxx::make_shared<BinaryProtocol>(connection->transport));
+            freeConnections_.push_back(connection.get());
+            connections_.push_back(std::move(connection));
+        }
+
         std::thread th([&]() {
             while (true) {
                 if (isConnect_) {
@@ -505,8 +555,7 @@ private:
 
                 static const int RECONNECT_TIME = 10;
                 std::this_thread::sleep_for(std::chrono::seconds(RECONNECT_TIME));
-                if (connect())
-                    disconnect();
+                getConnection();
             }
         });
         th.detach();
@@ -525,33 +574,29 @@ private:
         return lastAccessId_;
     }
 
-    uint64_t getFutureAccessId() {
-        return lastAccessId_ + 1;
-    }
-
     void deleteAccessId(const general::AccessID& p_access_id) {
         std::lock_guard lk(mtx_);
         accessSequence_.erase(p_access_id);
     }
 
-    std::optional<OriginExecuteResult> execute(const std::string& address, const SmartContractBinary& smartContractBinary, const std::string& method,
-        const std::vector<general::Variant>& params) {
+    // access id is generated by the caller and deleted here
+    std::optional<OriginExecuteResult> execute(const general::AccessID& access_id, const std::string& address, const SmartContractBinary& smartContractBinary,
+        const std::string& method, const std::vector<general::Variant>& params) {
         constexpr uint64_t EXECUTION_TIME = Consensus::T_smart_contract;
         OriginExecuteResult originExecuteRes{};
-        if (!connect())
+        auto connection = getConnection();
+        if (!connection) {
+            deleteAccessId(access_id);
             return std::nullopt;
-        const auto access_id = generateAccessId();
+        }
         ++execCount_;
         const auto timeBeg = std::chrono::steady_clock::now();
         try {
-			std::shared_lock slk(shErrMt);
-            origExecutor_->executeByteCode(originExecuteRes.resp, access_id, address, smartContractBinary, method, params, EXECUTION_TIME, EXECUTOR_VERSION);
+            connection->client->executeByteCode(originExecuteRes.resp, access_id, address, smartContractBinary, method, params, EXECUTION_TIME, EXECUTOR_VERSION);
         }
         catch (::apache::thrift::transport::TTransportException & x) {
-            // sets stop_ flag to true forever, replace with new instance
-            if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-                reCreationOriginExecutor();
-            }
+            // client sets stop_ flag to true forever, replace with new instance
+            resetConnection(*connection);
             originExecuteRes.resp.status.code = 1;
             originExecuteRes.resp.status.message = x.what();
         }
@@ -562,17 +607,57 @@ private:
         originExecuteRes.timeExecute = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - timeBeg).count();
         --execCount_;
         deleteAccessId(access_id);
-        disconnect();
         originExecuteRes.acceessId = access_id;
         return std::make_optional<OriginExecuteResult>(std::move(originExecuteRes));
     }
 
-    bool connect() {
-        try {
-            if (executorTransport_->isOpen())
-                executorTransport_->close();
+    using OriginExecutor = executor::ContractExecutorConcurrentClient;
+    using BinaryProtocol = apache::thrift::protocol::TBinaryProtocol;
+
+    // connection is used by one call at a time and stays open between the calls
+    struct Connection {
+        ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::transport::TTransport> transport;
+        std::unique_ptr<OriginExecutor> client;
+    };
+
+    struct ConnectionRelease {
+        Executor* executor;
+
+        void operator()(Connection* connection) const {
+            executor->releaseConnection(connection);
+        }
+    };
+
+    using ConnectionPtr = std::unique_ptr<Connection, ConnectionRelease>;
+
+    // waits for a free connection of the pool, returns empty pointer if the executor is not available
+    ConnectionPtr getConnection() {
+        Connection* connection = nullptr;
+        {
+            std::unique_lock lk(connectionsMt_);
+            cvFreeConnection_.wait(lk, [this] { return !freeConnections_.empty(); });
+            connection = freeConnections_.back();
+            freeConnections_.pop_back();
+        }
+
+        ConnectionPtr result(connection, ConnectionRelease{this});
+        if (!connect(*connection))
+            result.reset();
+        return result;
+    }
+
+    void releaseConnection(Connection* connection) {
+        {
+            std::lock_guard lk(connectionsMt_);
+            freeConnections_.push_back(connection);
+        }
+        cvFreeConnection_.notify_one();
+    }
 
-            executorTransport_->open();
+    bool connect(Connection& connection) {
+        try {
+            if (!connection.transport->isOpen())
+                connection.transport->open();
             isConnect_ = true;
         }
         catch (...) {
@@ -582,30 +667,63 @@ private:
         return isConnect_;
     }
 
-    void disconnect() {
-        executorTransport_->close();
+    void resetConnection(Connection& connection) {
+        try {
+            connection.transport->close();
+        }
+        catch (...) {
+        }
+        connection.client = std::make_unique<OriginExecutor>(::apache::thrift::stdcxx::make_shared<BinaryProtocol>(connection.transport));
     }
 
-	//
-	using OriginExecutor = executor::ContractExecutorConcurrentClient;
-	using BinaryProtocol = apache::thrift::protocol::TBinaryProtocol;
-	std::shared_mutex shErrMt;
-	void reCreationOriginExecutor() {
-		std::lock_guard glk(shErrMt);
-		origExecutor_.reset(new OriginExecutor(::apache::thrift::stdcxx::make_shared<BinaryProtocol>(executorTransport_)));
-	}
-	//	
+    // calls of the same contract and of the contracts using it wait for each other, other calls run concurrently
+    class ContractsLock {
+    public:
+        ContractsLock(Executor& executor, std::vector<csdb::Address> contracts)
+        : executor_(executor)
+        , contracts_(std::move(contracts)) {
+            std::unique_lock lk(executor_.contractsMt_);
+            executor_.cvContracts_.wait(lk, [this] {
+                return std::none_of(contracts_.cbegin(), contracts_.cend(), [this](const auto& addr) { return executor_.executingContracts_.count(addr) > 0; });
+            });
+            executor_.executingContracts_.insert(contracts_.cbegin(), contracts_.cend());
+        }
+
+        ~ContractsLock() {
+            {
+                std::lock_guard lk(executor_.contractsMt_);
+                for (const auto& addr : contracts_)
+                    executor_.executingContracts_.erase(addr);
+            }
+            executor_.cvContracts_.notify_all();
+        }
+
+        ContractsLock(const ContractsLock&) = delete;
+        ContractsLock& operator=(const ContractsLock&) = delete;
+
+    private:
+        Executor& executor_;
+        std::vector<csdb::Address> contracts_;
+    };
 
 private:
     const BlockChain& blockchain_;
     const cs::SolverCore& solver_;
-    ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::transport::TTransport> executorTransport_;
-    std::unique_ptr<executor::ContractExecutorConcurrentClient> origExecutor_;
+
+    std::vector<std::unique_ptr<Connection>> connections_;
+    std::vector<Connection*> freeConnections_;
+    std::mutex connectionsMt_;
+    std::condition_variable cvFreeConnection_;
+
+    std::set<csdb::Address> executingContracts_;
+    std::mutex contractsMt_;
+    std::condition_variable cvContracts_;
 
     general::AccessID lastAccessId_{};
     std::map<general::AccessID, cs::Sequence> accessSequence_;
     std::map<csdb::Address, csdb::TransactionID> deployTrxns_;
     std::map<csdb::Address, std::string> lastState_;
+    static constexpr const char* kSnapshotSection = "executor";
     std::map<csdb::Address, std::unordered_map<cs::Sequence, std::string>> cacheLastStates_;
     std::map<general::AccessID, std::vector<csdb::Transaction>> innerSendTransactions_;
 
@@ -807,6 +925,7 @@ private:
     cs::SpinLockable<std::map<csdb::Address, smart_trxns_queue>> smart_last_trxn;
     cs::SpinLockable<std::map<csdb::Address, std::vector<csdb::TransactionID>>> deployed_by_creator;
     cs::SpinLockable<PendingSmartTransactions> pending_smart_transactions;
+    static constexpr const char* kSnapshotSection = "api";
     std::map<csdb::PoolHash, api::Pool> poolCache;
     std::atomic_flag state_updater_running = ATOMIC_FLAG_INIT;
     std::thread state_updater;
@@ -832,6 +951,10 @@ private:
     size_t getMappedDeployerSmart(const csdb::Address& deployer, Mapper mapper, std::vector<decltype(mapper(api::SmartContract()))>& out);
 
     bool update_smart_caches_once(const csdb::PoolHash&, bool = false);
+
+    // smart contracts caches are stored into state snapshot as own section, blocks read by caches later than it are read again on loading
+    void save_smart_caches(cs::StateSnapshot& snapshot);
+    bool load_smart_caches(const cs::StateSnapshot& snapshot);
     void run();
 
     ::csdb::Transaction make_transaction(const ::api::Transaction&);
@@ -55,6 +55,9 @@ public:
         api_handler->store_block_slot(pool);
     }
 
+    void onSaveState(cs::StateSnapshot& snapshot);
+    void onLoadState(const cs::StateSnapshot& snapshot, bool* failed);
+
     void run();
 
     // interface
@@ -12,6 +12,7 @@
 
 #include <boost/functional/hash.hpp>
 #include <csdb/address.hpp>
+#include <lib/system/common.hpp>
 
 #include <ContractExecutor.h>
 
@@ -75,6 +76,10 @@ public:
 
     void applyToInternal(const std::function<void(const TokensMap&, const HoldersMap&)>);
 
+    // tokens are stored into state snapshot with the invocations not handled yet, holders are indexed again on loading
+    cs::Bytes toBinary();
+    bool fromBinary(const cs::Bytes& data);
+
     static bool isTransfer(const std::string& method, const std::vector<general::Variant>& params);
 
     static std::pair<csdb::Address, csdb::Address> getTransferData(const csdb::Address& initiator, const std::string& method, const std::vector<general::Variant>& params);
@@ -115,6 +120,8 @@ private:
         std::list<Params> invocations;
     };
     std::map<csdb::Address, TokenInvocationData> newExecutes_;
+    // taken from newExecutes_ and not handled completely yet
+    std::map<csdb::Address, TokenInvocationData> executes_;
 
     std::mutex dataMut_;
     TokensMap tokens_;
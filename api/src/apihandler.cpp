@@ -1,6 +1,7 @@
 #include <apihandler.hpp>
 
 #include <csnode/conveyer.hpp>
+#include <csnode/signaturescache.hpp>
 #include <lib/system/logger.hpp>
 #include <lib/system/utils.hpp>
 #include <solver/smartcontracts.hpp>
@@ -603,7 +604,7 @@ void APIHandler::dumb_transaction_flow(api::TransactionFlowResult& _return, cons
 
   // check signature
   const auto byteStream = tr.to_byte_stream_for_sig();
-  if (!cscrypto::verifySignature(tr.signature(), s_blockchain.getAddressByType(tr.source(), BlockChain::AddressType::PublicKey).public_key(), byteStream.data(), byteStream.size())) {
+  if (!cs::SignaturesCache::instance().verify(tr.signature(), s_blockchain.getAddressByType(tr.source(), BlockChain::AddressType::PublicKey).public_key(), byteStream.data(), byteStream.size())) {
     cslog() << "API: reject transaction with wrong signature";
     _return.status.code = ERROR_CODE;
     _return.status.message = "wrong signature! ByteStream: " + cs::Utils::byteStreamToHex(fromByteArray(byteStream));
@@ -660,7 +661,7 @@ void APIHandler::smart_transaction_flow(api::TransactionFlowResult& _return, con
 
   // check signature
   const auto byteStream = send_transaction.to_byte_stream_for_sig();
-  if (!cscrypto::verifySignature(send_transaction.signature(), s_blockchain.getAddressByType(send_transaction.source(), BlockChain::AddressType::PublicKey).public_key(), byteStream.data(), byteStream.size())) {
+  if (!cs::SignaturesCache::instance().verify(send_transaction.signature(), s_blockchain.getAddressByType(send_transaction.source(), BlockChain::AddressType::PublicKey).public_key(), byteStream.data(), byteStream.size())) {
     _return.status.code = ERROR_CODE;
     cslog() << "API: reject transaction with wrong signature";
     _return.status.message = "wrong signature! ByteStream: " + cs::Utils::byteStreamToHex(fromByteArray(byteStream));
@@ -1188,6 +1189,249 @@ bool APIHandler::update_smart_caches_once(const csdb::PoolHash& start, bool init
     return false;
 }
 
+static void writeTransactionId(cs::DataStream& stream, const csdb::TransactionID& id) {
+    stream << id.pool_hash() << id.index();
+}
+
+static csdb::TransactionID readTransactionId(cs::DataStream& stream) {
+    csdb::PoolHash hash;
+    cs::Sequence index = 0;
+    stream >> hash >> index;
+    return csdb::TransactionID(hash, index);
+}
+
+void APIHandler::save_smart_caches(cs::StateSnapshot& snapshot) {
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+
+    // caches are updated under the lock of pending transactions, they are consistent with each other while it is taken
+    auto locked_pending_smart_transactions = lockedReference(this->pending_smart_transactions);
+    stream << locked_pending_smart_transactions->last_pull_hash << locked_pending_smart_transactions->last_pull_sequence
+           << locked_pending_smart_transactions->queue.size();
+
+    for (auto queue = locked_pending_smart_transactions->queue; !queue.empty(); queue.pop()) {
+        stream << queue.front().first;
+        writeTransactionId(stream, queue.front().second.id());
+    }
+
+    {
+        auto opers = lockedReference(this->smart_operations);
+        stream << opers->size();
+
+        for (const auto& [id, op] : *opers) {
+            writeTransactionId(stream, id);
+            stream << static_cast<uint8_t>(op.state);
+            writeTransactionId(stream, op.stateTransaction);
+            stream << static_cast<uint8_t>(op.hasRetval | (op.returnsBool << 1) | (op.boolResult << 2));
+        }
+    }
+
+    {
+        auto sp = lockedReference(this->smarts_pending);
+        stream << sp->size();
+
+        for (const auto& [sequence, ids] : *sp) {
+            stream << sequence << ids.size();
+
+            for (const auto& id : ids) {
+                writeTransactionId(stream, id);
+            }
+        }
+    }
+
+    {
+        auto locked_smart_origin = lockedReference(this->smart_origin);
+        stream << locked_smart_origin->size();
+
+        for (const auto& [address, id] : *locked_smart_origin) {
+            stream << address.public_key();
+            writeTransactionId(stream, id);
+        }
+    }
+
+    {
+        auto locked_smart_state = lockedReference(this->smart_state);
+        stream << locked_smart_state->size();
+
+        for (const auto& [address, entry] : *locked_smart_state) {
+            const SmartState state = entry.getState();
+            stream << address.public_key() << state.state << static_cast<uint8_t>(state.lastEmpty);
+            writeTransactionId(stream, state.transaction);
+            writeTransactionId(stream, state.initer);
+        }
+    }
+
+    {
+        auto locked_deployed_by_creator = lockedReference(this->deployed_by_creator);
+        stream << locked_deployed_by_creator->size();
+
+        for (const auto& [address, ids] : *locked_deployed_by_creator) {
+            stream << address.public_key() << ids.size();
+
+            for (const auto& id : ids) {
+                writeTransactionId(stream, id);
+            }
+        }
+    }
+
+    stream << tm.toBinary();
+    snapshot.setSection(kSnapshotSection, std::move(bytes));
+}
+
+bool APIHandler::load_smart_caches(const cs::StateSnapshot& snapshot) {
+    const cs::Bytes* data = snapshot.section(kSnapshotSection);
+
+    if (data == nullptr) {
+        return false;
+    }
+
+    cs::DataStream stream(data->data(), data->size());
+
+    PendingSmartTransactions pending;
+    size_t count = 0;
+    stream >> pending.last_pull_hash >> pending.last_pull_sequence >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::Sequence sequence = 0;
+        stream >> sequence;
+        const auto id = readTransactionId(stream);
+
+        if (!stream.isValid()) {
+            break;
+        }
+
+        auto transaction = s_blockchain.loadTransaction(id);
+
+        if (!transaction.is_valid()) {
+            cserror() << "API: failed to read transaction " << id.to_string() << " to update smart contracts caches";
+            return false;
+        }
+
+        pending.queue.push(std::make_pair(sequence, transaction));
+    }
+
+    std::map<csdb::TransactionID, SmartOperation> operations;
+    count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        auto& op = operations[readTransactionId(stream)];
+        uint8_t state = 0;
+        uint8_t flags = 0;
+        stream >> state;
+        op.state = static_cast<SmartOperation::State>(state);
+        op.stateTransaction = readTransactionId(stream);
+        stream >> flags;
+        op.hasRetval = flags & 0x1;
+        op.returnsBool = flags & 0x2;
+        op.boolResult = flags & 0x4;
+    }
+
+    std::map<cs::Sequence, std::vector<csdb::TransactionID>> pendingSmarts;
+    count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::Sequence sequence = 0;
+        size_t idsCount = 0;
+        stream >> sequence >> idsCount;
+
+        auto& ids = pendingSmarts[sequence];
+
+        for (size_t j = 0; j < idsCount && stream.isValid(); ++j) {
+            ids.push_back(readTransactionId(stream));
+        }
+    }
+
+    std::map<csdb::Address, csdb::TransactionID> origin;
+    count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::PublicKey key;
+        stream >> key;
+        origin.emplace(csdb::Address::from_public_key(key), readTransactionId(stream));
+    }
+
+    std::map<csdb::Address, SmartState> states;
+    count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::PublicKey key;
+        SmartState state;
+        uint8_t lastEmpty = 0;
+        stream >> key >> state.state >> lastEmpty;
+        state.lastEmpty = lastEmpty != 0;
+        state.transaction = readTransactionId(stream);
+        state.initer = readTransactionId(stream);
+        states.emplace(csdb::Address::from_public_key(key), std::move(state));
+    }
+
+    std::map<csdb::Address, std::vector<csdb::TransactionID>> deployed;
+    count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::PublicKey key;
+        size_t idsCount = 0;
+        stream >> key >> idsCount;
+
+        auto& ids = deployed[csdb::Address::from_public_key(key)];
+
+        for (size_t j = 0; j < idsCount && stream.isValid(); ++j) {
+            ids.push_back(readTransactionId(stream));
+        }
+    }
+
+    cs::Bytes tokens;
+    stream >> tokens;
+
+    if (!stream.isValid() || !tm.fromBinary(tokens)) {
+        return false;
+    }
+
+    // caches can not include blocks later than snapshot, they are behind it if state updater has not read the last blocks yet
+    if (pending.last_pull_sequence > snapshot.sequence()) {
+        return false;
+    }
+
+    const cs::Sequence nextSequence = pending.last_pull_hash.is_empty() ? 0 : pending.last_pull_sequence + 1;
+
+    *lockedReference(this->pending_smart_transactions) = std::move(pending);
+    *lockedReference(this->smart_operations) = std::move(operations);
+    *lockedReference(this->smarts_pending) = std::move(pendingSmarts);
+    *lockedReference(this->deployed_by_creator) = std::move(deployed);
+
+    for (const auto& [address, id] : origin) {
+        executor_.updateDeployTrxns(address, id);
+    }
+
+    *lockedReference(this->smart_origin) = std::move(origin);
+
+    {
+        auto locked_smart_state = lockedReference(this->smart_state);
+        locked_smart_state->clear();
+
+        for (auto& [address, state] : states) {
+            (*locked_smart_state)[address].updateState([&](const SmartState&) { return state; });
+        }
+    }
+
+    for (cs::Sequence sequence = nextSequence; sequence <= snapshot.sequence(); ++sequence) {
+        csdb::Pool pool = s_blockchain.loadBlock(sequence);
+
+        if (!pool.is_valid()) {
+            cserror() << "API: failed to read block #" << sequence << " to update smart contracts caches";
+            return false;
+        }
+
+        update_smart_caches_slot(pool);
+    }
+
+    return true;
+}
+
 template <typename Mapper>
 size_t APIHandler::getMappedDeployerSmart(const csdb::Address& deployer, Mapper mapper, std::vector<decltype(mapper(api::SmartContract()))>& out) {
     auto locked_deployed_by_creator = lockedReference(this->deployed_by_creator);
@@ -1340,15 +1584,9 @@ void APIHandler::TransactionsStateGet(TransactionsStateGetResult& _return, const
         else {
             cs::Conveyer& conveyer = cs::Conveyer::instance();
             auto lock = conveyer.lock();
-            for (decltype(auto) it : conveyer.packetQueue()) {
-                const auto& transactions = it.transactions();
-                for (decltype(auto) transaction : transactions) {
-                    if (transaction.innerID() == inner_id) {
-                        _return.states[inner_id] = INPROGRESS;
-                        finish_for_idx = true;
-                        break;
-                    }
-                }
+            if (conveyer.lockedPacketQueue(lock).containsInnerId(inner_id)) {
+                _return.states[inner_id] = INPROGRESS;
+                finish_for_idx = true;
             }
             if (!finish_for_idx) {
                 decltype(auto) m_hash_tb = conveyer.transactionsPacketTable();  // find in hash table
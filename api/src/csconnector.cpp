@@ -62,6 +62,17 @@ connector::connector(BlockChain& m_blockchain, cs::SolverCore* solver, const Con
 #endif
 }
 
+void connector::onSaveState(cs::StateSnapshot& snapshot) {
+    api_handler->save_smart_caches(snapshot);
+}
+
+void connector::onLoadState(const cs::StateSnapshot& snapshot, bool* failed) {
+    if (!*failed && !api_handler->load_smart_caches(snapshot)) {
+        cserror() << "API: smart contracts caches are not restored from state snapshot";
+        *failed = true;
+    }
+}
+
 void connector::run() {
 
 #ifdef BINARY_TCP_API
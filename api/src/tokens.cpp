@@ -325,11 +325,12 @@ void TokensMaster::run() {
         while (running_.load()) {
             std::unique_lock<std::mutex> l(cvMut_);
             while (!deployQueue_.empty()) {
-                DeployTask dt = std::move(deployQueue_.front());
-                deployQueue_.pop();
+                // task is kept in the queue until it is handled not to be lost by state snapshot
+                DeployTask dt = deployQueue_.front();
                 l.unlock();
 
                 executor::GetContractMethodsResult methodsResult;
+                TokenStandart ts = TokenStandart::NotAToken;
 
                 // try { api_->executor_.getOrigExecutor(); }
                 // catch (...) { std::cout << "executor dosent run!" << std::endl; return; }
@@ -337,35 +338,39 @@ void TokensMaster::run() {
                 if (!dt.byteCodeObjects.empty()) {
                     api_->getExecutor().getContractMethods(methodsResult, dt.byteCodeObjects);
                     if (!methodsResult.status.code) {
-                        auto ts = getTokenStandart(methodsResult.methods);
-                        if (ts != TokenStandart::NotAToken) {
-                            Token t;
-                            t.standart = ts;
-                            t.owner = dt.deployer;
-
-                            {
-                                std::lock_guard<decltype(dataMut_)> lInt(dataMut_);
-                                tokens_[dt.address] = t;
-                            }
-                        }
+                        ts = getTokenStandart(methodsResult.methods);
                     }
                 }
 
                 l.lock();
+                deployQueue_.pop();
+
+                if (ts != TokenStandart::NotAToken) {
+                    Token t;
+                    t.standart = ts;
+                    t.owner = dt.deployer;
+
+                    {
+                        std::lock_guard<decltype(dataMut_)> lInt(dataMut_);
+                        tokens_[dt.address] = t;
+                    }
+                }
             }
 
-            decltype(newExecutes_) executes;
-            std::swap(executes, newExecutes_);
-            l.unlock();
+            std::swap(executes_, newExecutes_);
+
+            while (!executes_.empty()) {
+                auto st = executes_.begin();
 
-            for (auto& st : executes) {
                 {
                     std::lock_guard<decltype(dataMut_)> lInt(dataMut_);
-                    auto tIt = tokens_.find(st.first);
-                    if (tIt == tokens_.end())
+                    auto tIt = tokens_.find(st->first);
+                    if (tIt == tokens_.end()) {
+                        executes_.erase(st);
                         continue;  // Ignore if not-a-token
+                    }
 
-                    for (auto& ps : st.second.invocations) {
+                    for (auto& ps : st->second.invocations) {
                         initiateHolder(tIt->second, tIt->first, ps.initiator);
                         ++tIt->second.transactionsCount;
 
@@ -383,12 +388,20 @@ void TokensMaster::run() {
                                 initiateHolder(tIt->second, tIt->first, regDude);
                         }
                     }
+
+                    st->second.invocations.clear();
                 }
 
-                refreshTokenState(st.first, st.second.newState);
+                const auto token = st->first;
+                const auto newState = st->second.newState;
+                l.unlock();
+
+                refreshTokenState(token, newState);
+
+                l.lock();
+                executes_.erase(token);
             }
 
-            l.lock();
             tokCv_.wait(l);
         }
     });
@@ -436,6 +449,163 @@ void TokensMaster::applyToInternal(const std::function<void(const TokensMap&, co
     func(tokens_, holders_);
 }
 
+cs::Bytes TokensMaster::toBinary() {
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+
+    std::lock_guard<decltype(cvMut_)> l(cvMut_);
+    std::lock_guard<decltype(dataMut_)> lInt(dataMut_);
+
+    stream << tokens_.size();
+
+    for (const auto& [address, token] : tokens_) {
+        stream << address.public_key() << static_cast<uint8_t>(token.standart) << token.owner.public_key() << token.name << token.symbol << token.totalSupply
+               << token.transactionsCount << token.transfersCount << token.realHoldersCount << token.holders.size();
+
+        for (const auto& [holder, info] : token.holders) {
+            stream << holder.public_key() << info.balance << info.transfersCount;
+        }
+    }
+
+    stream << deployQueue_.size();
+
+    for (auto deployQueue = deployQueue_; !deployQueue.empty(); deployQueue.pop()) {
+        const auto& dt = deployQueue.front();
+        stream << dt.address.public_key() << dt.deployer.public_key() << dt.byteCodeObjects.size();
+
+        for (const auto& object : dt.byteCodeObjects) {
+            stream << serialize(object);
+        }
+    }
+
+    // invocations being handled go before the new ones of the same token
+    stream << executes_.size() + newExecutes_.size();
+
+    for (const auto* executes : {&executes_, &newExecutes_}) {
+        for (const auto& [address, tid] : *executes) {
+            stream << address.public_key() << tid.newState << tid.invocations.size();
+
+            for (const auto& ps : tid.invocations) {
+                stream << ps.initiator.public_key() << ps.method << ps.params.size();
+
+                for (const auto& param : ps.params) {
+                    stream << serialize(param);
+                }
+            }
+        }
+    }
+
+    return bytes;
+}
+
+bool TokensMaster::fromBinary(const cs::Bytes& data) {
+    cs::DataStream stream(data.data(), data.size());
+
+    TokensMap tokens;
+    HoldersMap holders;
+    size_t count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::PublicKey key;
+        cs::PublicKey owner;
+        uint8_t standart = 0;
+        stream >> key >> standart >> owner;
+
+        const auto address = csdb::Address::from_public_key(key);
+        auto& token = tokens[address];
+        token.standart = static_cast<TokenStandart>(standart);
+        token.owner = csdb::Address::from_public_key(owner);
+
+        size_t holdersCount = 0;
+        stream >> token.name >> token.symbol >> token.totalSupply >> token.transactionsCount >> token.transfersCount >> token.realHoldersCount >> holdersCount;
+
+        for (size_t j = 0; j < holdersCount && stream.isValid(); ++j) {
+            cs::PublicKey holder;
+            Token::HolderInfo info;
+            stream >> holder >> info.balance >> info.transfersCount;
+
+            const auto holderAddress = csdb::Address::from_public_key(holder);
+            token.holders.emplace(holderAddress, std::move(info));
+            holders[holderAddress].insert(address);
+        }
+    }
+
+    std::queue<DeployTask> deployQueue;
+    count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::PublicKey address;
+        cs::PublicKey deployer;
+        size_t objectsCount = 0;
+        stream >> address >> deployer >> objectsCount;
+
+        DeployTask dt;
+        dt.address = csdb::Address::from_public_key(address);
+        dt.deployer = csdb::Address::from_public_key(deployer);
+
+        for (size_t j = 0; j < objectsCount && stream.isValid(); ++j) {
+            std::string object;
+            stream >> object;
+
+            if (stream.isValid()) {
+                dt.byteCodeObjects.push_back(deserialize<general::ByteCodeObject>(std::move(object)));
+            }
+        }
+
+        deployQueue.push(std::move(dt));
+    }
+
+    std::map<csdb::Address, TokenInvocationData> executes;
+    count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::PublicKey address;
+        std::string newState;
+        size_t invocationsCount = 0;
+        stream >> address >> newState >> invocationsCount;
+
+        auto& tid = executes[csdb::Address::from_public_key(address)];
+        tid.newState = std::move(newState);
+
+        for (size_t j = 0; j < invocationsCount && stream.isValid(); ++j) {
+            cs::PublicKey initiator;
+            TokenInvocationData::Params ps;
+            size_t paramsCount = 0;
+            stream >> initiator >> ps.method >> paramsCount;
+            ps.initiator = csdb::Address::from_public_key(initiator);
+
+            for (size_t k = 0; k < paramsCount && stream.isValid(); ++k) {
+                std::string param;
+                stream >> param;
+
+                if (stream.isValid()) {
+                    ps.params.push_back(deserialize<general::Variant>(std::move(param)));
+                }
+            }
+
+            tid.invocations.push_back(std::move(ps));
+        }
+    }
+
+    if (!stream.isValid()) {
+        return false;
+    }
+
+    std::lock_guard<decltype(cvMut_)> l(cvMut_);
+    std::lock_guard<decltype(dataMut_)> lInt(dataMut_);
+
+    tokens_ = std::move(tokens);
+    holders_ = std::move(holders);
+    deployQueue_ = std::move(deployQueue);
+    newExecutes_ = std::move(executes);
+    executes_.clear();
+
+    return true;
+}
+
 bool TokensMaster::isTransfer(const std::string& method, const std::vector<general::Variant>& params) {
     return isNormalTransfer(method, params) || isTransferFrom(method, params);
 }
@@ -480,6 +650,12 @@ void TokensMaster::checkNewState(const csdb::Address&, const csdb::Address&, con
 }
 void TokensMaster::applyToInternal(const std::function<void(const TokensMap&, const HoldersMap&)>) {
 }
+cs::Bytes TokensMaster::toBinary() {
+    return cs::Bytes();
+}
+bool TokensMaster::fromBinary(const cs::Bytes&) {
+    return true;
+}
 bool TokensMaster::isTransfer(const std::string&, const std::vector<general::Variant>&) {
     return false;
 }
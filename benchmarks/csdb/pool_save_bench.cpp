@@ -0,0 +1,144 @@
+// Block store latency of csdb::Storage::pool_save: the pool is written to BerkeleyDB on the calling thread
+// or put to the write queue and written by the storage thread in groups. Pools are composed before
+// the measurement, the total time includes Storage::flush() after the last pool.
+// usage: pool_save_bench [directory] [pools count] [transactions per pool] [write queue size]
+// databases are created in <directory>/sync and <directory>/write_behind, existing ones are removed
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/pool.hpp>
+#include <csdb/storage.hpp>
+
+namespace {
+struct Result {
+    std::vector<double> latencies;  // microseconds
+    double seconds = 0;
+};
+
+std::vector<csdb::Pool> makePools(size_t poolsCount, size_t transactionsCount) {
+    std::vector<csdb::Pool> pools;
+    pools.reserve(poolsCount);
+
+    csdb::PoolHash previous;
+    cs::PublicKey key{};
+    cs::Signature signature{};
+
+    for (size_t i = 0; i < poolsCount; ++i) {
+        csdb::Pool pool(previous, i);
+
+        for (size_t j = 0; j < transactionsCount; ++j) {
+            key[0] = static_cast<cs::Byte>(j);
+            key[1] = static_cast<cs::Byte>(i);
+            signature[0] = static_cast<cs::Byte>(j);
+
+            pool.add_transaction(csdb::Transaction(static_cast<int64_t>(i * transactionsCount + j), csdb::Address::from_public_key(key),
+                                                   csdb::Address::from_wallet_id(static_cast<csdb::internal::WalletId>(j)), csdb::Currency(1),
+                                                   csdb::Amount(static_cast<int32_t>(j)), csdb::AmountCommission(0.1), csdb::AmountCommission(0.0), signature));
+        }
+
+        pool.compose();
+        previous = pool.hash();
+        pools.push_back(std::move(pool));
+    }
+
+    return pools;
+}
+
+bool run(const std::string& path, size_t writeQueueSize, const std::vector<csdb::Pool>& pools, Result& result) {
+    boost::filesystem::remove_all(path);
+
+    csdb::Storage::OpenOptions options;
+    options.write_queue_size = writeQueueSize;
+
+    csdb::Storage storage;
+
+    if (!storage.open(path, options)) {
+        std::cerr << "cannot open storage at " << path << ": " << storage.last_error_message() << std::endl;
+        return false;
+    }
+
+    result.latencies.reserve(pools.size());
+    const auto start = std::chrono::steady_clock::now();
+
+    for (const auto& pool : pools) {
+        const auto saveStart = std::chrono::steady_clock::now();
+
+        if (!storage.pool_save(pool)) {
+            std::cerr << "cannot save pool #" << pool.sequence() << ": " << storage.last_error_message() << std::endl;
+            return false;
+        }
+
+        result.latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - saveStart).count());
+    }
+
+    const bool flushed = storage.flush();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!flushed) {
+        std::cerr << "cannot flush storage: " << storage.last_error_message() << std::endl;
+        return false;
+    }
+
+    if (storage.size() != pools.size() || storage.last_hash() != pools.back().hash()) {
+        std::cerr << "storage does not contain all the pools" << std::endl;
+        return false;
+    }
+
+    storage.close();
+    return true;
+}
+
+void print(const char* name, Result& result) {
+    auto& latencies = result.latencies;
+    std::sort(latencies.begin(), latencies.end());
+
+    double sum = 0;
+    for (const auto latency : latencies) {
+        sum += latency;
+    }
+
+    const auto percentile = [&](double value) { return latencies[std::min(latencies.size() - 1, static_cast<size_t>(value * latencies.size()))]; };
+
+    std::cout << name << ": pool_save mean " << std::setw(8) << sum / latencies.size() << " us, p50 " << std::setw(8) << percentile(0.5) << " us, p99 "
+              << std::setw(8) << percentile(0.99) << " us, max " << std::setw(9) << latencies.back() << " us, total with flush " << std::setw(8)
+              << result.seconds * 1000 << " ms" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::string directory = argc > 1 ? argv[1] : "pool_save_bench";
+    const size_t poolsCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    const size_t transactionsCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100;
+    const size_t writeQueueSize = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : csdb::Storage::OpenOptions{}.write_queue_size;
+
+    if (poolsCount == 0 || writeQueueSize == 0) {
+        std::cerr << "pools count and write queue size should be positive" << std::endl;
+        return 1;
+    }
+
+    const auto pools = makePools(poolsCount, transactionsCount);
+    std::cout << poolsCount << " pools of " << transactionsCount << " transactions, write queue of " << writeQueueSize << " pools" << std::endl;
+
+    Result sync;
+    Result writeBehind;
+
+    if (!run(directory + "/sync", 0, pools, sync) || !run(directory + "/write_behind", writeQueueSize, pools, writeBehind)) {
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    print("sync        ", sync);
+    print("write-behind", writeBehind);
+
+    return 0;
+}
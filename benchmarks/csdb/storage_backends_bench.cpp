@@ -0,0 +1,172 @@
+// csdb::Storage over BerkeleyDB and LMDB backends: time to write a chain with pool_save and flush, to read
+// all the pools by sequence, to read random pools by hash and to walk the chain back by pool_load_meta
+// like the API does. The cache of decoded pools is off, so every read goes to the database.
+// The chain is like the real one: most of the blocks are empty, the rest have a random number of transactions.
+// usage: storage_backends_bench [directory] [pools count] [mean transactions per non empty pool]
+// databases are created in <directory>/berkeleydb and <directory>/lmdb, existing ones are removed
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/pool.hpp>
+#include <csdb/storage.hpp>
+
+namespace {
+struct Result {
+    double writeMs = 0;
+    double sequentialMs = 0;
+    double randomMs = 0;
+    double metaMs = 0;
+};
+
+std::vector<csdb::Pool> makeChain(size_t poolsCount, size_t meanTransactions) {
+    std::vector<csdb::Pool> pools;
+    pools.reserve(poolsCount);
+
+    std::mt19937 random(42);
+    std::bernoulli_distribution hasTransactions(0.4);
+    std::uniform_int_distribution<size_t> transactionsCount(1, meanTransactions * 2);
+
+    csdb::PoolHash previous;
+    cs::PublicKey key{};
+    cs::Signature signature{};
+    int64_t innerId = 0;
+
+    for (size_t i = 0; i < poolsCount; ++i) {
+        csdb::Pool pool(previous, i);
+        const size_t count = hasTransactions(random) ? transactionsCount(random) : 0;
+
+        for (size_t j = 0; j < count; ++j) {
+            key[0] = static_cast<cs::Byte>(j);
+            key[1] = static_cast<cs::Byte>(random());
+            signature[0] = static_cast<cs::Byte>(j);
+
+            pool.add_transaction(csdb::Transaction(++innerId, csdb::Address::from_public_key(key),
+                                                   csdb::Address::from_wallet_id(static_cast<csdb::internal::WalletId>(random() % 100000)), csdb::Currency(1),
+                                                   csdb::Amount(static_cast<int32_t>(j)), csdb::AmountCommission(0.1), csdb::AmountCommission(0.0), signature));
+        }
+
+        pool.compose();
+        previous = pool.hash();
+        pools.push_back(std::move(pool));
+    }
+
+    return pools;
+}
+
+template <typename Function>
+double measure(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool run(const std::string& path, csdb::Storage::Backend backend, const std::vector<csdb::Pool>& pools, Result& result) {
+    boost::filesystem::remove_all(path);
+
+    csdb::Storage::OpenOptions options;
+    options.backend = backend;
+    options.pool_cache_size = 0;
+
+    csdb::Storage storage;
+
+    if (!storage.open(path, options)) {
+        std::cerr << "cannot open storage at " << path << ": " << storage.last_error_message() << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+
+    result.writeMs = measure([&] {
+        for (const auto& pool : pools) {
+            ok = ok && storage.pool_save(pool);
+        }
+        ok = ok && storage.flush();
+    });
+
+    if (!ok || storage.size() != pools.size()) {
+        std::cerr << "cannot write pools: " << storage.last_error_message() << std::endl;
+        return false;
+    }
+
+    size_t loaded = 0;
+
+    // database record number is the sequence of the pool + 1
+    result.sequentialMs = measure([&] {
+        for (size_t i = 1; i <= pools.size(); ++i) {
+            loaded += storage.pool_load(static_cast<cs::Sequence>(i)).is_valid();
+        }
+    });
+
+    std::mt19937 random(7);
+    std::uniform_int_distribution<size_t> index(0, pools.size() - 1);
+
+    result.randomMs = measure([&] {
+        for (size_t i = 0; i < pools.size(); ++i) {
+            loaded += storage.pool_load(pools[index(random)].hash()).is_valid();
+        }
+    });
+
+    result.metaMs = measure([&] {
+        csdb::PoolHash hash = storage.last_hash();
+        size_t count = 0;
+
+        while (!hash.is_empty()) {
+            hash = storage.pool_load_meta(hash, count).previous_hash();
+            ++loaded;
+        }
+    });
+
+    if (loaded != pools.size() * 3) {
+        std::cerr << "not all the pools are read back" << std::endl;
+        return false;
+    }
+
+    storage.close();
+    return true;
+}
+
+void print(const char* name, const Result& result, size_t poolsCount) {
+    const auto perPool = [poolsCount](double ms) { return ms * 1000 / poolsCount; };
+
+    std::cout << name << ": write " << std::setw(9) << result.writeMs << " ms, by sequence " << std::setw(6) << perPool(result.sequentialMs) << " us, by hash "
+              << std::setw(6) << perPool(result.randomMs) << " us, meta " << std::setw(6) << perPool(result.metaMs) << " us per pool" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::string directory = argc > 1 ? argv[1] : "storage_backends_bench";
+    const size_t poolsCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+    const size_t meanTransactions = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 50;
+
+    if (poolsCount == 0 || meanTransactions == 0) {
+        std::cerr << "pools count and transactions count should be positive" << std::endl;
+        return 1;
+    }
+
+    const auto pools = makeChain(poolsCount, meanTransactions);
+    std::cout << poolsCount << " pools, " << meanTransactions << " transactions in a non empty pool on average" << std::endl;
+
+    Result berkeleyDb;
+    Result lmdb;
+
+    if (!run(directory + "/berkeleydb", csdb::Storage::Backend::BerkeleyDB, pools, berkeleyDb) ||
+        !run(directory + "/lmdb", csdb::Storage::Backend::LMDB, pools, lmdb)) {
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    print("BerkeleyDB", berkeleyDb, poolsCount);
+    print("LMDB      ", lmdb, poolsCount);
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Pool building from the packets of a round: time of Conveyer::applyCharacteristic over rounds of many packets
+// with every transaction accepted, and time of findPackets for the hashes of the previous round like packets
+// requests from neighbours do. Packets are put to the conveyer table before the measurement.
+// usage: applycharacteristic_bench [packets per round] [transactions per packet] [rounds count]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csnode/conveyer.hpp>
+#include <lib/system/logger.hpp>
+
+namespace {
+class BenchConveyer : public cs::ConveyerBase {
+public:
+    BenchConveyer() = default;
+};
+
+std::vector<cs::TransactionsPacket> makePackets(size_t round, size_t packetsCount, size_t transactionsCount) {
+    std::vector<cs::TransactionsPacket> packets(packetsCount);
+
+    cs::PublicKey key{};
+    cs::Signature signature{};
+
+    for (size_t i = 0; i < packetsCount; ++i) {
+        for (size_t j = 0; j < transactionsCount; ++j) {
+            key[0] = static_cast<cs::Byte>(i);
+            key[1] = static_cast<cs::Byte>(j);
+            key[2] = static_cast<cs::Byte>(round);
+            signature[0] = static_cast<cs::Byte>(j);
+
+            packets[i].addTransaction(csdb::Transaction(static_cast<int64_t>((round * packetsCount + i) * transactionsCount + j + 1), csdb::Address::from_public_key(key),
+                                                        csdb::Address::from_wallet_id(static_cast<csdb::internal::WalletId>(j)), csdb::Currency(1),
+                                                        csdb::Amount(static_cast<int32_t>(j)), csdb::AmountCommission(0.1), csdb::AmountCommission(0.0), signature));
+        }
+
+        packets[i].makeHash();
+    }
+
+    return packets;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t packetsCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    const size_t transactionsCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+    const size_t roundsCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20;
+
+    if (packetsCount == 0 || transactionsCount == 0 || roundsCount == 0) {
+        std::cerr << "usage: applycharacteristic_bench [packets per round] [transactions per packet] [rounds count]" << std::endl;
+        return 1;
+    }
+
+    logging::core::get()->set_filter(logging::trivial::severity >= logger::severity_level::warning);
+
+    std::cout << roundsCount << " rounds of " << packetsCount << " packets of " << transactionsCount << " transactions" << std::endl;
+
+    BenchConveyer conveyer;
+    cs::PublicKey writer{};
+
+    double applyMs = 0;
+    double findMs = 0;
+    size_t found = 0;
+
+    for (size_t round = 1; round <= roundsCount; ++round) {
+        auto packets = makePackets(round, packetsCount, transactionsCount);
+        cs::PacketsHashes hashes;
+
+        for (auto& packet : packets) {
+            hashes.push_back(packet.hash());
+            conveyer.addTransactionsPacket(packet);
+        }
+
+        conveyer.setTable(cs::RoundTable{static_cast<cs::RoundNumber>(round), writer, cs::ConfidantsKeys{}, hashes, cs::Characteristic{}});
+        conveyer.setCharacteristic(cs::Characteristic{cs::Bytes(packetsCount * transactionsCount, 1)}, static_cast<cs::RoundNumber>(round));
+
+        cs::PoolMetaInfo info{"0", writer, csdb::PoolHash{}, static_cast<cs::Sequence>(round), cs::Bytes{}, std::vector<csdb::Pool::SmartSignature>{}};
+
+        auto start = std::chrono::steady_clock::now();
+        auto pool = conveyer.applyCharacteristic(info);
+        applyMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (!pool.has_value() || pool.value().transactions_count() != packetsCount * transactionsCount) {
+            std::cerr << "pool of round " << round << " is not built" << std::endl;
+            return 1;
+        }
+
+        start = std::chrono::steady_clock::now();
+        found += conveyer.findPackets(hashes, static_cast<cs::RoundNumber>(round)).size();
+        findMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    if (found != packetsCount * roundsCount) {
+        std::cerr << "not all the packets are found" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "applyCharacteristic: " << std::setw(9) << applyMs / roundsCount << " ms per round" << std::endl;
+    std::cout << "findPackets:         " << std::setw(9) << findMs / roundsCount << " ms per round" << std::endl;
+
+    return 0;
+}
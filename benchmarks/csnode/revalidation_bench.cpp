@@ -0,0 +1,244 @@
+// Re-validation of a round after rejections: every transaction is validated again on each iteration
+// or only the transactions grouped by TransactionsDependencies with the changed ones. The round has
+// independent transfers and chains of transactions each rejected on the iteration after the previous one,
+// like the transactions emitted by a contract whose new_state is rejected.
+// usage: revalidation_bench [transactions count] [chains count] [chain length]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <set>
+#include <vector>
+
+#include <csnode/transactionsdependencies.hpp>
+
+namespace {
+struct ModelTransaction {
+    size_t source;
+    size_t target;
+    int32_t amount;
+};
+
+struct Round {
+    std::vector<ModelTransaction> transactions;
+    std::vector<csdb::Amount> balances;
+};
+
+// chain k: c(i + 1) -> c(i) from the end of the chain, c(0) spends more than it has after them all
+Round makeRound(size_t transfersCount, size_t chainsCount, size_t chainLength) {
+    Round round;
+    std::vector<std::vector<ModelTransaction>> chains(chainsCount);
+
+    for (auto& chain : chains) {
+        const size_t first = round.balances.size();
+        round.balances.resize(first + chainLength + 2, csdb::Amount(10));
+
+        for (size_t i = chainLength; i-- > 0;) {
+            chain.push_back(ModelTransaction{first + i + 1, first + i, 1});
+        }
+
+        chain.push_back(ModelTransaction{first, first + chainLength + 1, static_cast<int32_t>(chainLength + 100)});
+    }
+
+    // transfers between the wallets of small groups
+    constexpr size_t groupWallets = 4;
+    const size_t transfersWallets = round.balances.size();
+    const size_t groups = std::max<size_t>(transfersCount / (2 * groupWallets), 1);
+    round.balances.resize(transfersWallets + groups * groupWallets, csdb::Amount(1000000));
+
+    const size_t chainsTransactions = chainsCount * (chainLength + 1);
+    const size_t step = std::max<size_t>(transfersCount / std::max<size_t>(chainsTransactions, 1), 1);
+    size_t nextChain = 0;
+    std::vector<size_t> chainsPositions(chainsCount, 0);
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+
+    for (size_t i = 0; i < transfersCount; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        const size_t group = transfersWallets + (state % groups) * groupWallets;
+        const size_t source = group + (state >> 20) % groupWallets;
+        const size_t target = group + (source - group + 1 + (state >> 30) % (groupWallets - 1)) % groupWallets;
+        round.transactions.push_back(ModelTransaction{source, target, 1});
+
+        if (i % step == 0 && chainsCount > 0) {
+            for (size_t tries = 0; tries < chainsCount; ++tries, nextChain = (nextChain + 1) % chainsCount) {
+                if (chainsPositions[nextChain] < chains[nextChain].size()) {
+                    round.transactions.push_back(chains[nextChain][chainsPositions[nextChain]++]);
+                    nextChain = (nextChain + 1) % chainsCount;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (size_t chain = 0; chain < chainsCount; ++chain) {
+        for (; chainsPositions[chain] < chains[chain].size(); ++chainsPositions[chain]) {
+            round.transactions.push_back(chains[chain][chainsPositions[chain]]);
+        }
+    }
+
+    return round;
+}
+
+// validation like TransactionsValidator does for balances, wallets of the rejected transactions
+// stay rejected in the next iterations as the rejected new_state contracts do
+class ModelValidator {
+public:
+    explicit ModelValidator(const Round& round)
+    : round_(round)
+    , wallets_(round.balances.size()) {
+        for (size_t i = 0; i < wallets_.size(); ++i) {
+            wallets_[i].balance_ = round_.balances[i];
+        }
+    }
+
+    void restore(size_t wallet) {
+        wallets_[wallet] = cs::WalletsState::WalletData{cs::WalletsState::noInd_, round_.balances[wallet], {}};
+    }
+
+    void validate(const std::vector<size_t>& indices, cs::Bytes& mask) {
+        for (const auto i : indices) {
+            if (!mask[i]) {
+                continue;
+            }
+
+            ++validated_;
+            const ModelTransaction& transaction = round_.transactions[i];
+            auto& source = wallets_[transaction.source];
+            const csdb::Amount amount(transaction.amount);
+
+            if (rejected_.count(transaction.source) || rejected_.count(transaction.target) || source.balance_ < amount) {
+                rejected_.insert(transaction.source);
+                mask[i] = 0;
+                continue;
+            }
+
+            source.balance_ -= amount;
+            wallets_[transaction.target].balance_ += amount;
+        }
+    }
+
+    const cs::WalletsState::WalletData* wallet(size_t index) const {
+        return &wallets_[index];
+    }
+
+    uint64_t validated() const {
+        return validated_;
+    }
+
+private:
+    const Round& round_;
+    std::vector<cs::WalletsState::WalletData> wallets_;
+    std::set<size_t> rejected_;
+    uint64_t validated_ = 0;
+};
+
+struct Result {
+    cs::Bytes mask;
+    size_t iterations = 0;
+    uint64_t validated = 0;
+    double seconds = 0;
+};
+
+Result run(const Round& round, bool incremental) {
+    const auto start = std::chrono::steady_clock::now();
+
+    Result result;
+    result.mask.assign(round.transactions.size(), 1);
+
+    ModelValidator validator(round);
+    cs::TransactionsDependencies dependencies;
+
+    std::vector<size_t> all(round.transactions.size());
+    std::iota(all.begin(), all.end(), 0);
+
+    std::vector<size_t> indices = all;
+    cs::Bytes previousMask;
+
+    while (!indices.empty()) {
+        ++result.iterations;
+        previousMask = result.mask;
+        validator.validate(indices, result.mask);
+
+        std::vector<size_t> changed;
+
+        for (size_t i = 0; i < result.mask.size(); ++i) {
+            if (result.mask[i] != previousMask[i]) {
+                changed.push_back(i);
+            }
+        }
+
+        if (changed.empty()) {
+            break;
+        }
+
+        if (!incremental) {
+            for (size_t wallet = 0; wallet < round.balances.size(); ++wallet) {
+                validator.restore(wallet);
+            }
+
+            indices = all;
+            continue;
+        }
+
+        if (dependencies.empty()) {
+            dependencies.reset(round.transactions.size());
+
+            for (size_t i = 0; i < round.transactions.size(); ++i) {
+                const ModelTransaction& transaction = round.transactions[i];
+                dependencies.add(i, csdb::Address::from_wallet_id(transaction.source), validator.wallet(transaction.source));
+                dependencies.add(i, csdb::Address::from_wallet_id(transaction.target), validator.wallet(transaction.target));
+            }
+        }
+
+        cs::TransactionsDependencies::Addresses wallets;
+        indices = dependencies.affected(changed, wallets);
+
+        for (const auto& address : wallets) {
+            validator.restore(address.wallet_id());
+        }
+    }
+
+    result.validated = validator.validated();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t transfersCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const size_t chainsCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+    const size_t chainLength = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 50;
+
+    if (transfersCount == 0) {
+        std::cerr << "usage: revalidation_bench [transactions count] [chains count] [chain length]" << std::endl;
+        return 1;
+    }
+
+    const Round round = makeRound(transfersCount, chainsCount, chainLength);
+    std::cout << round.transactions.size() << " transactions, " << chainsCount << " chains of " << chainLength << " rejected one by one" << std::endl;
+
+    const Result full = run(round, false);
+    const Result incremental = run(round, true);
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (const auto& [name, result] : {std::make_pair("full       ", &full), std::make_pair("incremental", &incremental)}) {
+        const auto rejected = std::count(result->mask.begin(), result->mask.end(), 0);
+        std::cout << name << ": " << std::setw(4) << result->iterations << " iterations, " << std::setw(10) << result->validated << " validations, "
+                  << std::setw(5) << rejected << " rejected, " << std::setw(8) << result->seconds * 1000 << " ms" << std::endl;
+    }
+
+    if (full.mask != incremental.mask) {
+        std::cerr << "characteristic masks differ" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Round processing over std::vector<csdb::Transaction> and over cs::TransactionsBatch: allocations made to keep
+// the transactions of a round and time of a pass over them like fee counting does, the size of each transaction
+// is taken from to_byte_stream() or from TransactionsBatch::serializedSize() and its comment is looked up.
+// usage: transactionsbatch_bench [transactions count] [rounds count]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include <csdb/currency.hpp>
+#include <csnode/transactionsbatch.hpp>
+
+namespace {
+std::atomic<size_t> allocationsCount{0};
+std::atomic<size_t> allocatedBytes{0};
+}  // namespace
+
+void* operator new(size_t size) {
+    ++allocationsCount;
+    allocatedBytes += size;
+
+    if (void* result = std::malloc(size == 0 ? 1 : size)) {
+        return result;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+struct Allocations {
+    size_t count = allocationsCount;
+    size_t bytes = allocatedBytes;
+
+    void print(const char* name, size_t rounds) const {
+        std::cout << name << ": " << std::setw(10) << (allocationsCount - count) / rounds << " allocations, " << std::setw(10) << (allocatedBytes - bytes) / rounds
+                  << " bytes per round" << std::endl;
+    }
+};
+
+std::vector<csdb::Transaction> makeTransactions(size_t count) {
+    std::vector<csdb::Transaction> result;
+    result.reserve(count);
+
+    cs::PublicKey key{};
+    cs::Signature signature{};
+
+    for (size_t i = 0; i < count; ++i) {
+        key[0] = static_cast<cs::Byte>(i);
+        key[1] = static_cast<cs::Byte>(i >> 8);
+        signature[0] = static_cast<cs::Byte>(i);
+
+        // every second transaction uses wallet ids, every fourth one has a comment
+        const csdb::Address source = (i % 2 != 0) ? csdb::Address::from_wallet_id(static_cast<csdb::internal::WalletId>(i)) : csdb::Address::from_public_key(key);
+        key[2] = 1;
+        const csdb::Address target = csdb::Address::from_public_key(key);
+        key[2] = 0;
+
+        result.emplace_back(static_cast<int64_t>(i), source, target, csdb::Currency(1), csdb::Amount(static_cast<int32_t>(i % 1000)), csdb::AmountCommission(0.1),
+                            csdb::AmountCommission(0.0), signature);
+
+        if (i % 4 == 0) {
+            result.back().add_user_field(-1, std::string("payment ") + std::to_string(i));
+        }
+    }
+
+    return result;
+}
+
+template <typename Function>
+double measure(size_t rounds, Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < rounds; ++i) {
+        function();
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t transactionsCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const size_t roundsCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+    const auto source = makeTransactions(transactionsCount);
+    std::cout << transactionsCount << " transactions, " << roundsCount << " rounds" << std::endl;
+
+    // storage of a round: copies of the transactions received from network
+    Allocations vectorAllocations;
+
+    for (size_t i = 0; i < roundsCount; ++i) {
+        std::vector<csdb::Transaction> transactions;
+        transactions.reserve(source.size());
+
+        for (const auto& transaction : source) {
+            transactions.push_back(transaction.clone());
+        }
+    }
+
+    vectorAllocations.print("vector<csdb::Transaction>", roundsCount);
+
+    Allocations batchAllocations;
+    cs::TransactionsBatch batch;
+
+    for (size_t i = 0; i < roundsCount; ++i) {
+        batch.clear();
+
+        for (const auto& transaction : source) {
+            batch.add(transaction);
+        }
+    }
+
+    batchAllocations.print("TransactionsBatch        ", roundsCount);
+    std::cout << "TransactionsBatch memory: " << batch.memoryUsage() << " bytes" << std::endl;
+
+    // a pass over the round like fee counting
+    size_t vectorTotal = 0;
+    const double vectorTime = measure(roundsCount, [&] {
+        for (const auto& transaction : source) {
+            vectorTotal += transaction.to_byte_stream().size();
+            vectorTotal += transaction.user_field(-1).value<std::string>().size();
+            vectorTotal += static_cast<size_t>(transaction.amount().integral());
+        }
+    });
+
+    size_t batchTotal = 0;
+    const double batchTime = measure(roundsCount, [&] {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            batchTotal += batch.serializedSize(i);
+            batchTotal += batch.stringUserField(i, -1).size();
+            batchTotal += static_cast<size_t>(batch.amount(i).integral());
+        }
+    });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "pass over vector<csdb::Transaction>: " << std::setw(9) << vectorTime << " ms" << std::endl;
+    std::cout << "pass over TransactionsBatch:         " << std::setw(9) << batchTime << " ms" << std::endl;
+
+    if (vectorTotal != batchTotal) {
+        std::cout << "results differ: " << vectorTotal << " != " << batchTotal << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+// WalletsCache access: wallets are loaded from a state snapshot like the blockchain does on start, then all the
+// wallets are scanned like the balances check after loading does and random wallets are found by id like blocks
+// transactions are applied. The heap is fragmented before loading like the one of a node which has worked for a
+// while. Memory is the bytes kept allocated by the cache after loading, requested ones and the ones the heap holds
+// for them with the allocator headers and rounding, which is what the cache adds to the resident memory.
+// usage: walletscache_bench [wallets count] [lookups count]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+
+#include <csnode/datastream.hpp>
+#include <csnode/walletscache.hpp>
+#include <csnode/walletsids.hpp>
+#include <lib/system/logger.hpp>
+
+namespace {
+// live bytes are counted, the size of a block is kept before it
+std::atomic<size_t> liveBytes{0};
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+}  // namespace
+
+void* operator new(size_t size) {
+    if (auto* block = static_cast<char*>(std::malloc(size + kHeaderSize))) {
+        *reinterpret_cast<size_t*>(block) = size;
+        liveBytes += size;
+        return block + kHeaderSize;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer != nullptr) {
+        char* block = static_cast<char*>(pointer) - kHeaderSize;
+        liveBytes -= *reinterpret_cast<size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+// bytes of the heap chunks in use and of the large blocks mapped separately
+size_t heapInUse() {
+    const auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// snapshot of wallets cache, every 16th wallet is absent like the removed ones are
+cs::Bytes makeSnapshot(size_t walletsCount) {
+    uint8_t layout = 0;
+#ifdef MONITOR_NODE
+    layout |= 0x1;
+#endif
+#ifdef TRANSACTIONS_INDEX
+    layout |= 0x2;
+#endif
+
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+    stream << layout << walletsCount;
+
+    cs::PublicKey key{};
+    cs::TransactionsTail tail;
+
+    for (size_t i = 0; i < walletsCount; ++i) {
+        const bool present = i % 16 != 15;
+        stream << static_cast<uint8_t>(present);
+
+        if (!present) {
+            continue;
+        }
+
+        key[0] = static_cast<cs::Byte>(i);
+        key[1] = static_cast<cs::Byte>(i >> 8);
+        key[2] = static_cast<cs::Byte>(i >> 16);
+        key[3] = static_cast<cs::Byte>(i >> 24);
+
+        stream << key << csdb::Amount(static_cast<int32_t>(i % 1000)) << static_cast<uint64_t>(i);
+        stream.addValue(tail);
+#ifdef MONITOR_NODE
+        stream << static_cast<uint64_t>(0);
+#endif
+#ifdef TRANSACTIONS_INDEX
+        stream << csdb::PoolHash{} << static_cast<cs::Sequence>(0);
+#endif
+    }
+
+    // payable and closed smart contracts transactions
+    stream << size_t(0) << size_t(0);
+#ifdef MONITOR_NODE
+    stream << size_t(0);
+#endif
+
+    return bytes;
+}
+
+// every second block is freed in random order, the rest are kept
+std::vector<std::unique_ptr<char[]>> fragmentHeap(size_t blocksCount, size_t blockSize) {
+    std::vector<std::unique_ptr<char[]>> blocks;
+    blocks.reserve(blocksCount);
+
+    for (size_t i = 0; i < blocksCount; ++i) {
+        blocks.emplace_back(new char[blockSize]);
+    }
+
+    std::vector<size_t> freed;
+
+    for (size_t i = 0; i < blocksCount; i += 2) {
+        freed.push_back(i);
+    }
+
+    std::shuffle(freed.begin(), freed.end(), std::mt19937_64(7));
+
+    for (const auto i : freed) {
+        blocks[i].reset();
+    }
+
+    return blocks;
+}
+
+template <typename Function>
+double measure(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t walletsCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t lookupsCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+
+    if (walletsCount == 0 || lookupsCount == 0) {
+        std::cerr << "usage: walletscache_bench [wallets count] [lookups count]" << std::endl;
+        return 1;
+    }
+
+    logging::core::get()->set_filter(logging::trivial::severity >= logger::severity_level::warning);
+
+    std::cout << walletsCount << " wallets, " << lookupsCount << " lookups" << std::endl;
+
+    const cs::Bytes snapshot = makeSnapshot(walletsCount);
+
+    const auto kept = fragmentHeap(walletsCount * 2, sizeof(cs::WalletsCache::WalletData));
+
+    cs::WalletsIds ids;
+    cs::WalletsCache cache(cs::WalletsCache::Config{}, csdb::Address{}, csdb::Address{}, ids);
+
+    const size_t bytesBefore = liveBytes;
+    const size_t heapBefore = heapInUse();
+    bool loaded = false;
+
+    const double loadMs = measure([&] { loaded = cache.fromBinary(snapshot); });
+
+    const size_t bytes = liveBytes - bytesBefore;
+    const size_t heapBytes = heapInUse() - heapBefore;
+
+    if (!loaded) {
+        std::cerr << "snapshot is not loaded" << std::endl;
+        return 1;
+    }
+
+    uint64_t sum = 0;
+
+    const double scanMs = measure([&] {
+        cache.iterateOverWallets([&](const cs::WalletsCache::WalletData::Address&, const cs::WalletsCache::WalletData& wallet) {
+            sum += wallet.transNum_;
+            return true;
+        });
+    });
+
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<size_t> index(0, walletsCount - 1);
+
+    std::vector<cs::WalletsCache::WalletId> walletIds;
+    walletIds.reserve(lookupsCount);
+
+    for (size_t i = 0; i < lookupsCount; ++i) {
+        walletIds.push_back(static_cast<cs::WalletsCache::WalletId>(index(random)));
+    }
+
+    auto updater = cache.createUpdater();
+    size_t found = 0;
+
+    const double findMs = measure([&] {
+        for (const auto walletId : walletIds) {
+            if (const auto* wallet = updater->findWallet(walletId)) {
+                sum += wallet->transNum_;
+                ++found;
+            }
+        }
+    });
+
+    if (found == 0 || sum == 0) {
+        std::cerr << "no wallets are found" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "load:            " << std::setw(9) << loadMs << " ms" << std::endl;
+    std::cout << "memory:          " << std::setw(9) << static_cast<double>(bytes) / walletsCount << " bytes per wallet requested, "
+              << static_cast<double>(heapBytes) / walletsCount << " held by heap" << std::endl;
+    std::cout << "scan:            " << std::setw(9) << scanMs * 1000000 / walletsCount << " ns per wallet" << std::endl;
+    std::cout << "find by id:      " << std::setw(9) << findMs * 1000000 / lookupsCount << " ns per lookup" << std::endl;
+
+    return 0;
+}
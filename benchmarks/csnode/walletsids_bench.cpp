@@ -0,0 +1,143 @@
+// WalletsIds lookups in both directions: ids are given to the public keys of all the wallets like the blockchain
+// does on loading, then random addresses are resolved to ids and random ids back to addresses like transactions
+// with wallet id source or target are. Memory is the bytes kept allocated by WalletsIds after the ids are given.
+// usage: walletsids_bench [wallets count] [lookups count]
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+
+#include <csnode/walletsids.hpp>
+#include <lib/system/logger.hpp>
+
+namespace {
+// live bytes are counted, the size of a block is kept before it
+std::atomic<size_t> liveBytes{0};
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+}  // namespace
+
+void* operator new(size_t size) {
+    if (auto* block = static_cast<char*>(std::malloc(size + kHeaderSize))) {
+        *reinterpret_cast<size_t*>(block) = size;
+        liveBytes += size;
+        return block + kHeaderSize;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer != nullptr) {
+        char* block = static_cast<char*>(pointer) - kHeaderSize;
+        liveBytes -= *reinterpret_cast<size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+cs::PublicKey makeKey(size_t index) {
+    cs::PublicKey key{};
+
+    // spread the bytes like the ones of a real key
+    uint64_t value = index * 0x9E3779B97F4A7C15ull + 1;
+
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i] = static_cast<cs::Byte>(value >> ((i % 8) * 8));
+
+        if (i % 8 == 7) {
+            value = value * 0xBF58476D1CE4E5B9ull + i;
+        }
+    }
+
+    return key;
+}
+
+template <typename Function>
+double measure(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t walletsCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    const size_t lookupsCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+
+    if (walletsCount == 0 || lookupsCount == 0) {
+        std::cerr << "usage: walletsids_bench [wallets count] [lookups count]" << std::endl;
+        return 1;
+    }
+
+    logging::core::get()->set_filter(logging::trivial::severity >= logger::severity_level::warning);
+
+    std::cout << walletsCount << " wallets, " << lookupsCount << " lookups" << std::endl;
+
+    cs::WalletsIds ids;
+    cs::WalletsIds::WalletId id = 0;
+
+    const size_t bytesBefore = liveBytes;
+
+    const double fillMs = measure([&] {
+        for (size_t i = 0; i < walletsCount; ++i) {
+            ids.normal().get(csdb::Address::from_public_key(makeKey(i)), id);
+        }
+    });
+
+    const size_t bytes = liveBytes - bytesBefore;
+
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<size_t> index(0, walletsCount - 1);
+
+    std::vector<csdb::Address> addresses;
+    std::vector<cs::WalletsIds::WalletId> walletIds;
+    addresses.reserve(lookupsCount);
+    walletIds.reserve(lookupsCount);
+
+    for (size_t i = 0; i < lookupsCount; ++i) {
+        addresses.push_back(csdb::Address::from_public_key(makeKey(index(random))));
+        walletIds.push_back(static_cast<cs::WalletsIds::WalletId>(index(random)));
+    }
+
+    size_t found = 0;
+
+    const double findMs = measure([&] {
+        for (const auto& address : addresses) {
+            found += ids.normal().find(address, id);
+        }
+    });
+
+    const double findAddrMs = measure([&] {
+        csdb::Address address;
+
+        for (const auto walletId : walletIds) {
+            found += ids.normal().findaddr(walletId, address);
+        }
+    });
+
+    if (found != lookupsCount * 2) {
+        std::cerr << "not all the wallets are found" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "fill:            " << std::setw(9) << fillMs << " ms, " << std::setw(6) << static_cast<double>(bytes) / walletsCount << " bytes per wallet"
+              << std::endl;
+    std::cout << "address -> id:   " << std::setw(9) << findMs * 1000000 / lookupsCount << " ns per lookup" << std::endl;
+    std::cout << "id -> address:   " << std::setw(9) << findAddrMs * 1000000 / lookupsCount << " ns per lookup" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,271 @@
+// Contracts execution on the node side against the executor stub: every contract is deployed, then called
+// again and again with its cached state, each result is stored as new_state in a block the executor caches
+// states from. Threads call their own contracts over the pooled executor connections.
+// usage: executor_bench [contracts] [calls per contract] [threads] [connections] [latency, us] [result size] [failure rate]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <apihandler.hpp>
+#include <csnode/blockchain.hpp>
+#include <solver/smartcontracts.hpp>
+#include <solver/solvercore.hpp>
+
+#include "executorstub.hpp"
+
+namespace {
+constexpr uint16_t kPort = 19080;
+constexpr size_t kByteCodeSize = 16 * 1024;
+
+using Latencies = std::vector<std::chrono::microseconds>;
+
+struct Contract {
+    csdb::Address address;
+    std::string key;
+    std::vector<general::ByteCodeObject> byteCode;
+    // the last state stored in a block
+    std::string state;
+};
+
+struct Report {
+    Latencies deploys;
+    Latencies calls;
+    uint64_t failures = 0;
+    uint64_t mismatches = 0;
+};
+
+csdb::Address makeAddress(size_t number, cs::Byte tag) {
+    cs::PublicKey key{};
+    key[0] = tag;
+    std::copy(reinterpret_cast<const cs::Byte*>(&number), reinterpret_cast<const cs::Byte*>(&number) + sizeof(number), key.begin() + 1);
+    return csdb::Address::from_public_key(key);
+}
+
+class Bench {
+public:
+    Bench(executor::Executor& executor, size_t contractsCount)
+    : executor_(executor)
+    , deployer_(makeAddress(0, 0xff)) {
+        for (size_t i = 0; i < contractsCount; ++i) {
+            Contract contract;
+            contract.address = makeAddress(i, 0x01);
+            contract.key = contract.address.to_api_addr();
+
+            general::ByteCodeObject object;
+            object.name = "Contract" + std::to_string(i);
+            object.byteCode.assign(kByteCodeSize, static_cast<char>(i));
+            contract.byteCode.push_back(std::move(object));
+
+            contracts_.push_back(std::move(contract));
+        }
+    }
+
+    // contracts number, number + step, ... of the thread
+    Report run(size_t number, size_t step, size_t callsCount) {
+        Report report;
+
+        for (size_t i = number; i < contracts_.size(); i += step) {
+            const auto start = std::chrono::steady_clock::now();
+            deploy(contracts_[i], report);
+            report.deploys.push_back(elapsed(start));
+        }
+
+        for (size_t call = 0; call < callsCount; ++call) {
+            for (size_t i = number; i < contracts_.size(); i += step) {
+                const auto start = std::chrono::steady_clock::now();
+                execute(contracts_[i], call, report);
+                report.calls.push_back(elapsed(start));
+            }
+        }
+
+        return report;
+    }
+
+private:
+    static std::chrono::microseconds elapsed(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    void deploy(Contract& contract, Report& report) {
+        api::SmartContractInvocation invocation;
+        invocation.smartContractDeploy.byteCodeObjects = contract.byteCode;
+
+        csdb::Transaction transaction(nextInnerId(), deployer_, contract.address, csdb::Currency(1), csdb::Amount(0), csdb::AmountCommission(1.0),
+                                      csdb::AmountCommission(0.0), cs::Signature{});
+        transaction.add_user_field(cs::trx_uf::deploy::Code, serialize(invocation));
+
+        csdb::Pool block;
+        block.set_sequence(nextSequence());
+        block.add_transaction(transaction);
+
+        const auto result = executor_.executeTransaction(block, 0, csdb::Amount(1));
+
+        if (!result.has_value() || result.value().newState.empty()) {
+            ++report.failures;
+            return;
+        }
+
+        storeNewState(contract, block, result.value().newState, result.value().retValue, report);
+    }
+
+    void execute(Contract& contract, size_t call, Report& report) {
+        const auto state = executor_.getState(contract.address);
+
+        if (state.value_or(std::string{}) != contract.state) {
+            ++report.mismatches;
+        }
+
+        general::Variant param;
+        param.__set_v_string(std::to_string(call));
+
+        executor::ExecuteByteCodeResult result;
+        executor_.executeByteCode(result, deployer_.to_api_addr(), contract.key, contract.byteCode, state.value_or(std::string{}), "call", {param}, 0);
+
+        if (result.status.code != 0 || result.invokedContractState.empty()) {
+            ++report.failures;
+            return;
+        }
+
+        csdb::Pool start;
+        start.set_sequence(nextSequence());
+        storeNewState(contract, start, result.invokedContractState, result.ret_val, report);
+    }
+
+    // new_state the consensus on contract execution results in, executor caches the state from the stored block
+    void storeNewState(Contract& contract, const csdb::Pool& start, const std::string& state, const general::Variant& retValue, Report& report) {
+        csdb::Transaction transaction(nextInnerId(), contract.address, contract.address, csdb::Currency(1), csdb::Amount(0), csdb::AmountCommission(1.0),
+                                      csdb::AmountCommission(0.0), cs::Signature{});
+        transaction.add_user_field(cs::trx_uf::new_state::Value, state);
+        transaction.add_user_field(cs::trx_uf::new_state::RefStart, cs::SmartContractRef(start.hash(), start.sequence(), 0).to_user_field());
+        transaction.add_user_field(cs::trx_uf::new_state::Fee, csdb::Amount(0));
+        transaction.add_user_field(cs::trx_uf::new_state::RetVal, serialize(retValue));
+
+        csdb::Pool block;
+        block.set_sequence(nextSequence());
+        block.add_transaction(transaction);
+
+        executor_.onBlockStored(block);
+        contract.state = state;
+
+        if (executor_.getState(contract.address).value_or(std::string{}) != state) {
+            ++report.mismatches;
+        }
+    }
+
+    int64_t nextInnerId() {
+        return ++innerId_;
+    }
+
+    cs::Sequence nextSequence() {
+        return ++sequence_;
+    }
+
+    executor::Executor& executor_;
+    csdb::Address deployer_;
+    std::vector<Contract> contracts_;
+    std::atomic<int64_t> innerId_{0};
+    std::atomic<cs::Sequence> sequence_{0};
+};
+
+void print(const char* name, Latencies& latencies) {
+    if (latencies.empty()) {
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    std::chrono::microseconds total{0};
+
+    for (const auto latency : latencies) {
+        total += latency;
+    }
+
+    std::cout << name << ": " << std::setw(8) << latencies.size() << ", latency mean " << std::setw(8) << total.count() / latencies.size() << " us, p50 "
+              << std::setw(8) << latencies[latencies.size() / 2].count() << " us, p99 " << std::setw(8) << latencies[latencies.size() * 99 / 100].count() << " us"
+              << std::endl;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t contractsCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    const size_t callsCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    const size_t threadsCount = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 4;
+    const size_t connectionsCount = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 4;
+
+    cs::ExecutorStub::Settings settings;
+
+    if (argc > 5) {
+        settings.latency = std::chrono::microseconds(std::strtoull(argv[5], nullptr, 10));
+    }
+
+    if (argc > 6) {
+        settings.resultSize = std::strtoull(argv[6], nullptr, 10);
+    }
+
+    if (argc > 7) {
+        settings.failureRate = std::strtod(argv[7], nullptr);
+    }
+
+    if (contractsCount == 0 || threadsCount == 0 || connectionsCount == 0 || settings.resultSize == 0) {
+        std::cerr << "usage: executor_bench [contracts] [calls per contract] [threads] [connections] [latency, us] [result size] [failure rate]" << std::endl;
+        return 1;
+    }
+
+    cs::ExecutorStubServer server(settings, kPort);
+    server.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // blocks are not stored, the blockchain serves addresses conversion and access ids only
+    BlockChain blockchain(makeAddress(0, 0xfe), makeAddress(1, 0xfe));
+    cs::SolverCore solver;
+    auto& executor = executor::Executor::getInstance(&blockchain, &solver, kPort, connectionsCount);
+
+    std::cout << contractsCount << " contracts, " << callsCount << " calls each, " << threadsCount << " threads, " << connectionsCount << " connections, stub latency "
+              << settings.latency.count() << " us, result " << settings.resultSize << " bytes, failure rate " << settings.failureRate << std::endl;
+
+    Bench bench(executor, contractsCount);
+    std::vector<Report> reports(threadsCount);
+    std::vector<std::thread> threads;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&, i] { reports[i] = bench.run(i, threadsCount, callsCount); });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Report total;
+
+    for (auto& report : reports) {
+        total.deploys.insert(total.deploys.end(), report.deploys.begin(), report.deploys.end());
+        total.calls.insert(total.calls.end(), report.calls.begin(), report.calls.end());
+        total.failures += report.failures;
+        total.mismatches += report.mismatches;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    print("deploys", total.deploys);
+    print("calls  ", total.calls);
+    std::cout << (total.deploys.size() + total.calls.size()) / seconds << " executions per second in " << seconds * 1000 << " ms" << std::endl;
+    std::cout << "executed by stub " << server.stub().calls() << ", failed " << total.failures << std::endl;
+
+    server.stop();
+
+    if (total.mismatches != 0) {
+        std::cerr << total.mismatches << " cached states differ from the stored ones" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
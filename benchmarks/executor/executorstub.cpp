@@ -0,0 +1,97 @@
+#include "executorstub.hpp"
+
+#include <functional>
+#include <random>
+
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/transport/TServerSocket.h>
+
+#include <lib/system/utils.hpp>
+
+namespace {
+// the same contract state and call give the same new state, as the real executor does
+std::string makeState(const std::string& state, const std::string& method, size_t paramsCount, size_t size) {
+    uint64_t value = std::hash<std::string>{}(state) ^ (std::hash<std::string>{}(method) << 1) ^ paramsCount;
+    value |= 1;
+
+    std::string result(size, '\0');
+
+    for (auto& symbol : result) {
+        value ^= value << 13;
+        value ^= value >> 7;
+        value ^= value << 17;
+        symbol = static_cast<char>(value);
+    }
+
+    return result;
+}
+}  // namespace
+
+namespace cs {
+ExecutorStub::ExecutorStub(const Settings& settings)
+: settings_(settings) {
+}
+
+void ExecutorStub::executeByteCode(executor::ExecuteByteCodeResult& _return, const general::AccessID accessId, const general::Address& initiatorAddress,
+                                   const executor::SmartContractBinary& invokedContract, const std::string& method, const std::vector<general::Variant>& params,
+                                   const int64_t executionTime, const int16_t version) {
+    csunused(accessId);
+    csunused(initiatorAddress);
+    csunused(executionTime);
+    csunused(version);
+
+    ++calls_;
+
+    if (settings_.latency.count() > 0) {
+        std::this_thread::sleep_for(settings_.latency);
+    }
+
+    if (fail()) {
+        ++failures_;
+        _return.status.code = 1;
+        _return.status.message = "executor stub failure";
+        return;
+    }
+
+    _return.status.code = 0;
+    _return.invokedContractState = makeState(invokedContract.object.instance, method, params.size(), settings_.resultSize);
+    _return.ret_val.__set_v_string(method);
+}
+
+bool ExecutorStub::fail() {
+    if (settings_.failureRate <= 0) {
+        return false;
+    }
+
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+    return std::uniform_real_distribution<double>(0, 1)(generator) < settings_.failureRate;
+}
+
+ExecutorStubServer::ExecutorStubServer(const ExecutorStub::Settings& settings, uint16_t port)
+: stub_(::apache::thrift::stdcxx::make_shared<ExecutorStub>(settings))
+, server_(::apache::thrift::stdcxx::make_shared<executor::ContractExecutorProcessor>(stub_),
+          ::apache::thrift::stdcxx::make_shared<::apache::thrift::transport::TServerSocket>(port),
+          ::apache::thrift::stdcxx::make_shared<::apache::thrift::transport::TBufferedTransportFactory>(),
+          ::apache::thrift::stdcxx::make_shared<::apache::thrift::protocol::TBinaryProtocolFactory>()) {
+}
+
+ExecutorStubServer::~ExecutorStubServer() {
+    stop();
+}
+
+void ExecutorStubServer::run() {
+    server_.serve();
+}
+
+void ExecutorStubServer::start() {
+    thread_ = std::thread([this] { run(); });
+}
+
+void ExecutorStubServer::stop() {
+    if (thread_.joinable()) {
+        server_.stop();
+        thread_.join();
+    }
+}
+}  // namespace cs
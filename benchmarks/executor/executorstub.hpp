@@ -0,0 +1,72 @@
+#ifndef EXECUTOR_STUB_HPP
+#define EXECUTOR_STUB_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <ContractExecutor.h>
+#include <thrift/server/TThreadedServer.h>
+
+namespace cs {
+// Stand-in for the contract executor service: answers the node over the same Thrift interface
+// without running any byte-code, so the node side of contracts execution can be measured alone
+class ExecutorStub : public executor::ContractExecutorNull {
+public:
+    struct Settings {
+        // time of every execution
+        std::chrono::microseconds latency{1000};
+        // size of the new contract state
+        size_t resultSize = 1024;
+        // part of executions failed with an error status, from 0 to 1
+        double failureRate = 0;
+    };
+
+    explicit ExecutorStub(const Settings& settings);
+
+    void executeByteCode(executor::ExecuteByteCodeResult& _return, const general::AccessID accessId, const general::Address& initiatorAddress,
+                         const executor::SmartContractBinary& invokedContract, const std::string& method, const std::vector<general::Variant>& params,
+                         const int64_t executionTime, const int16_t version) override;
+
+    uint64_t calls() const {
+        return calls_;
+    }
+
+    uint64_t failures() const {
+        return failures_;
+    }
+
+private:
+    bool fail();
+
+    const Settings settings_;
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> failures_{0};
+};
+
+// serves the stub on the port with the transport and protocol the node's executor client uses
+class ExecutorStubServer {
+public:
+    ExecutorStubServer(const ExecutorStub::Settings& settings, uint16_t port);
+    ~ExecutorStubServer();
+
+    // blocks until stopped
+    void run();
+
+    // serves in its own thread
+    void start();
+    void stop();
+
+    const ExecutorStub& stub() const {
+        return *stub_;
+    }
+
+private:
+    ::apache::thrift::stdcxx::shared_ptr<ExecutorStub> stub_;
+    ::apache::thrift::server::TThreadedServer server_;
+    std::thread thread_;
+};
+}  // namespace cs
+
+#endif  // EXECUTOR_STUB_HPP
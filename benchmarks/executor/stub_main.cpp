@@ -0,0 +1,38 @@
+// Contract executor stub for a node started with executor_port in [api] section of its config
+// usage: executor_stub [port] [latency, us] [result size] [failure rate]
+
+#include <cstdlib>
+#include <iostream>
+
+#include "executorstub.hpp"
+
+int main(int argc, char** argv) {
+    const auto port = static_cast<uint16_t>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 9080);
+
+    cs::ExecutorStub::Settings settings;
+
+    if (argc > 2) {
+        settings.latency = std::chrono::microseconds(std::strtoull(argv[2], nullptr, 10));
+    }
+
+    if (argc > 3) {
+        settings.resultSize = std::strtoull(argv[3], nullptr, 10);
+    }
+
+    if (argc > 4) {
+        settings.failureRate = std::strtod(argv[4], nullptr);
+    }
+
+    if (port == 0 || settings.failureRate < 0 || settings.failureRate > 1) {
+        std::cerr << "usage: executor_stub [port] [latency, us] [result size] [failure rate]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "executor stub on port " << port << ": latency " << settings.latency.count() << " us, result " << settings.resultSize << " bytes, failure rate "
+              << settings.failureRate << std::endl;
+
+    cs::ExecutorStubServer server(settings, port);
+    server.run();
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Debug logging cost on the calling threads: Boost::Log stream records formatted and written by the callers
+// or binary records put to thread rings and written by the log thread. Records go to a text file, rings are
+// big enough to keep all the records of a thread, so the log thread writes them after the callers finish.
+// usage: binarylog_bench [threads] [records per thread] [log file]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/log/core.hpp>
+#include <boost/log/utility/setup/common_attributes.hpp>
+#include <boost/log/utility/setup/file.hpp>
+
+#include <lib/system/binarylog.hpp>
+
+namespace {
+struct Result {
+    double callerSeconds = 0;
+    double totalSeconds = 0;
+};
+
+template <typename Log>
+Result run(size_t threadsCount, size_t recordsCount, bool binary, Log&& log) {
+    if (binary) {
+        logger::BinaryLog::start(logger::severity_level::debug, recordsCount * 128);
+    }
+
+    std::vector<double> callers(threadsCount);
+    std::vector<std::thread> threads;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([&, i] {
+            const auto threadStart = std::chrono::steady_clock::now();
+
+            for (size_t j = 0; j < recordsCount; ++j) {
+                log(i, j);
+            }
+
+            callers[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - threadStart).count();
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (binary) {
+        logger::BinaryLog::stop();
+    }
+
+    logging::core::get()->flush();
+
+    Result result;
+    result.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto seconds : callers) {
+        result.callerSeconds += seconds;
+    }
+
+    return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t threadsCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4;
+    const size_t recordsCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200000;
+    const std::string fileName = argc > 3 ? argv[3] : "binarylog_bench.log";
+
+    if (threadsCount == 0 || recordsCount == 0) {
+        std::cerr << "usage: binarylog_bench [threads] [records per thread] [log file]" << std::endl;
+        return 1;
+    }
+
+    logging::add_common_attributes();
+    logging::add_file_log(logging::keywords::file_name = fileName, logging::keywords::format = "[%TimeStamp%] %Severity% %Message%");
+
+    const std::string peer("127.0.0.1:6000");
+
+    const Result boost = run(threadsCount, recordsCount, false, [&](size_t thread, size_t record) {
+        csdebug() << "NODE> Send block reply. Sequences: " << record << " - " << record + 10 << ", thread " << thread << ", peer " << peer;
+    });
+
+    const Result binary = run(threadsCount, recordsCount, true, [&](size_t thread, size_t record) {
+        csdebugf("NODE> Send block reply. Sequences: {} - {}, thread {}, peer {}", record, record + 10, thread, peer);
+    });
+
+    const double records = static_cast<double>(threadsCount * recordsCount);
+
+    std::cout << threadsCount << " threads, " << recordsCount << " records each to " << fileName << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    for (const auto& [name, result] : {std::make_pair("boost ", &boost), std::make_pair("binary", &binary)}) {
+        std::cout << name << ": " << std::setw(8) << result->callerSeconds * 1e9 / records << " ns per record in callers, " << std::setw(8)
+                  << result->totalSeconds * 1000 << " ms until written" << std::endl;
+    }
+
+    std::cout << "binary records dropped: " << logger::BinaryLog::dropped() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Fragments per message and CPU time per MB of a large message at different packet sizes:
+// splitting by OPackStream, LZ4 encoding as the writer does, decoding as the reader does
+// and reassembly by PacketCollector. Every fragment is compressed on its own or the message
+// is compressed as a whole before the fragmentation and decompressed once collected.
+// usage: fragmentation_bench [message size] [messages count]
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <csnode/packstream.hpp>
+#include <net/pacmans.hpp>
+
+namespace {
+const cs::PublicKey kSenderKey = {};
+
+// transactions like content: compressible in part
+std::vector<cs::Byte> makeData(size_t size) {
+    std::vector<cs::Byte> data(size);
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+
+    for (size_t i = 0; i < size; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        data[i] = (i % 64 < 32) ? static_cast<cs::Byte>(state) : static_cast<cs::Byte>(i / 64);
+    }
+
+    return data;
+}
+
+struct Result {
+    uint32_t fragments = 0;
+    uint64_t wireBytes = 0;
+    double cpuSeconds = 0;
+};
+
+Result run(uint32_t packetSize, bool messageCompression, const std::vector<cs::Byte>& data, uint32_t messages) {
+    RegionAllocator sendAllocator(1 << 24, 1);
+    IPacMan pacman(packetSize);
+    std::vector<char> encodeBuffer(Packet::MaxSize);
+
+    Result result;
+    const std::clock_t start = std::clock();
+
+    for (uint32_t m = 0; m < messages; ++m) {
+        cs::OPackStream stream(&sendAllocator, kSenderKey);
+        stream.setPacketSize(packetSize);
+        stream.setMessageCompression(messageCompression);
+        stream.init(BaseFlags::Broadcast | BaseFlags::Fragmented | BaseFlags::Compressed);
+        stream << MsgTypes::NewBlock << static_cast<cs::RoundNumber>(m);
+        stream << cs::BytesView(data.data(), data.size());
+
+        Packet* fragments = stream.getPackets();
+        const uint32_t count = stream.getPacketsCount();
+
+        auto collector = std::make_unique<PacketCollector>();
+        bool completed = false;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            auto encoded = fragments[i].encode(boost::asio::buffer(encodeBuffer.data(), encodeBuffer.size()));
+            result.wireBytes += encoded.size();
+
+            // as the datagram is received by the reader
+            auto& task = pacman.allocNext();
+            std::memcpy(task.pack.data(), encoded.data(), encoded.size());
+
+            task.size = task.pack.decode(encoded.size());
+            if (task.size == 0) {
+                std::cerr << "cannot decode fragment " << i << std::endl;
+                std::exit(1);
+            }
+
+            pacman.enQueueLast();
+
+            auto received = pacman.getNextTask();
+            bool newMessage = false;
+            collector->getMessage(received->pack, newMessage, completed);
+        }
+
+        if (!completed) {
+            std::cerr << "message of " << count << " fragments is not completed" << std::endl;
+            std::exit(1);
+        }
+
+        result.fragments = count;
+    }
+
+    result.cpuSeconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t messageSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1 << 20);
+    const uint32_t messages = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 50;
+
+    if (messageSize == 0 || messages == 0) {
+        std::cerr << "usage: fragmentation_bench [message size] [messages count]" << std::endl;
+        return 1;
+    }
+
+    const auto data = makeData(messageSize);
+    const double megabytes = static_cast<double>(messageSize) * messages / (1 << 20);
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (const bool messageCompression : {false, true}) {
+        // 1472 is UDP payload of 1500 bytes MTU, the largest size fits 9000 bytes MTU
+        for (const uint32_t packetSize : {Packet::DefaultSize, 1472u, 4096u, Packet::MaxSize}) {
+            const Result result = run(packetSize, messageCompression, data, messages);
+
+            std::cout << (messageCompression ? "message " : "fragment") << " compression, packet size " << std::setw(5) << packetSize << ": "
+                      << std::setw(5) << result.fragments << " fragments/message, " << std::setw(8)
+                      << static_cast<double>(result.wireBytes) / megabytes / 1024 << " KB on wire/MB, " << std::setw(7)
+                      << result.cpuSeconds * 1000 / megabytes << " ms CPU/MB" << std::endl;
+        }
+    }
+
+    return 0;
+}
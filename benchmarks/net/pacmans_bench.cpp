@@ -0,0 +1,302 @@
+// Packet queues handoff: throughput and latency of IPacMan (reader -> processor) and
+// OPacMan (many senders -> writer) on the bounded ring against the former std::list + mutex queues.
+// usage: pacmans_bench [tasks count] [senders count]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <net/pacmans.hpp>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+uint64_t now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+// the queues as they were before the ring, tasks live in list nodes guarded by a mutex
+class ListIPacMan {
+public:
+    using Task = IPacMan::Task;
+
+    ListIPacMan()
+    : allocator_(1 << 20) {
+    }
+
+    Task& allocNext() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.emplace_back();
+        auto end = queue_.end();
+        Task& task = *(--end);
+        new (&task) Task{{}, 0, Packet(allocator_.allocateNext(Packet::MaxSize))};
+        return task;
+    }
+
+    void enQueueLast() {
+        Task& task = queue_.back();
+        allocator_.shrinkLast(static_cast<uint32_t>(task.size));
+        size_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    TaskPtr<ListIPacMan> getNextTask() {
+        while (!size_.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        TaskPtr<ListIPacMan> result;
+        result.owner_ = this;
+        result.it_ = queue_.begin();
+        return result;
+    }
+
+    using TaskIterator = std::list<TaskBody<Task>>::iterator;
+
+    void releaseTask(TaskIterator& it) {
+        Task& task = *it;
+        task.~Task();
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.erase(it);
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+private:
+    std::list<TaskBody<Task>> queue_;
+    std::mutex mutex_;
+    std::atomic<size_t> size_ = {0};
+    RegionAllocator allocator_;
+};
+
+// the former queue could hand out a task another sender was still filling,
+// here the nodes are flagged on enqueue to keep the benchmark safe
+class ListOPacMan {
+public:
+    using Task = OPacMan::Task;
+
+    struct Node {
+        operator Task&() {
+            return body;
+        }
+
+        TaskBody<Task> body;
+        std::atomic<bool> filled = {false};
+    };
+
+    Task* allocNext() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.emplace_back();
+        auto end = queue_.end();
+        Task& task = *(--end);
+        new (&task) Task();
+        return &task;
+    }
+
+    void enQueue(Task* task) {
+        reinterpret_cast<Node*>(task)->filled.store(true, std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    TaskPtr<ListOPacMan> getNextTask() {
+        while (!size_.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        TaskPtr<ListOPacMan> result;
+        result.owner_ = this;
+        result.it_ = queue_.begin();
+
+        while (!result.it_->filled.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        return result;
+    }
+
+    using TaskIterator = std::list<Node>::iterator;
+
+    void releaseTask(TaskIterator& it) {
+        Task& task = *it;
+        task.~Task();
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.erase(it);
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+private:
+    std::list<Node> queue_;
+    std::mutex mutex_;
+    std::atomic<size_t> size_ = {0};
+};
+
+struct Result {
+    double seconds = 0;
+    std::vector<uint64_t> latencies;
+};
+
+void print(const std::string& name, const Result& result) {
+    auto latencies = result.latencies;
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * static_cast<double>(latencies.size())))] / 1000.0;
+    };
+
+    std::cout << std::left << std::setw(34) << name << std::right << std::setw(10)
+              << static_cast<uint64_t>(static_cast<double>(latencies.size()) / result.seconds) << " tasks/s, latency us p50 " << std::setw(8)
+              << percentile(0.5) << " p99 " << std::setw(8) << percentile(0.99) << " p99.9 " << std::setw(8) << percentile(0.999) << " max "
+              << std::setw(8) << latencies.back() / 1000.0 << std::endl;
+}
+
+uint64_t readStamp(const Packet& pack) {
+    uint64_t stamp;
+    std::memcpy(&stamp, pack.data(), sizeof(stamp));
+    return stamp;
+}
+
+// reader -> processor, one task at a time
+template <typename PacMan>
+Result runInput(uint64_t count) {
+    PacMan pacman;
+    Result result;
+    result.latencies.reserve(count);
+
+    const auto start = Clock::now();
+
+    std::thread reader([&]() {
+        for (uint64_t i = 0; i < count; ++i) {
+            auto& task = pacman.allocNext();
+            const uint64_t stamp = now();
+            std::memcpy(task.pack.data(), &stamp, sizeof(stamp));
+            task.size = sizeof(stamp);
+            pacman.enQueueLast();
+        }
+    });
+
+    for (uint64_t i = 0; i < count; ++i) {
+        auto task = pacman.getNextTask();
+        result.latencies.push_back(now() - readStamp(task->pack));
+    }
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    reader.join();
+    return result;
+}
+
+// reader -> processor, batches as recvmmsg fills them
+Result runInputBatch(uint64_t count, size_t batch) {
+    IPacMan pacman;
+    Result result;
+    result.latencies.reserve(count);
+
+    const auto start = Clock::now();
+
+    std::thread reader([&]() {
+        for (uint64_t i = 0; i < count;) {
+            const size_t received = static_cast<size_t>(std::min<uint64_t>(batch, count - i));
+            pacman.reserve(IPacMan::MaxBatchSize);
+
+            const uint64_t stamp = now();
+            for (size_t j = 0; j < received; ++j) {
+                auto& task = pacman.reserved(j);
+                std::memcpy(task.pack.data(), &stamp, sizeof(stamp));
+                task.size = sizeof(stamp);
+            }
+
+            pacman.enQueueReserved(received);
+            i += received;
+        }
+    });
+
+    for (uint64_t i = 0; i < count; ++i) {
+        auto task = pacman.getNextTask();
+        result.latencies.push_back(now() - readStamp(task->pack));
+    }
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    reader.join();
+    return result;
+}
+
+// many senders -> writer
+template <typename PacMan>
+Result runOutput(uint64_t count, size_t senders) {
+    PacMan pacman;
+    Result result;
+    result.latencies.reserve(count);
+
+    const uint64_t perSender = count / senders;
+    const ip::udp::endpoint endpoint(ip::address_v4::loopback(), 9000);
+
+    // packets should outlive the senders
+    std::vector<std::unique_ptr<RegionAllocator>> allocators;
+    for (size_t i = 0; i < senders; ++i) {
+        allocators.emplace_back(new RegionAllocator(1 << 20));
+    }
+
+    const auto start = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < senders; ++i) {
+        threads.emplace_back([&, i]() {
+            RegionAllocator& allocator = *allocators[i];
+
+            for (uint64_t j = 0; j < perSender; ++j) {
+                Packet pack(allocator.allocateNext(sizeof(uint64_t)));
+
+                auto task = pacman.allocNext();
+                const uint64_t stamp = now();
+                std::memcpy(pack.data(), &stamp, sizeof(stamp));
+
+                task->endpoint = endpoint;
+                task->pack = pack;
+                pacman.enQueue(task);
+            }
+        });
+    }
+
+    for (uint64_t i = 0; i < perSender * senders; ++i) {
+        auto task = pacman.getNextTask();
+        result.latencies.push_back(now() - readStamp(task->pack));
+    }
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const size_t senders = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+
+    if (count == 0 || senders == 0) {
+        std::cerr << "usage: pacmans_bench [tasks count] [senders count]" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    print("IPacMan list + mutex", runInput<ListIPacMan>(count));
+    print("IPacMan ring", runInput<IPacMan>(count));
+    print("IPacMan ring, batch of 16", runInputBatch(count, 16));
+
+    const std::string suffix = ", " + std::to_string(senders) + " senders";
+    print("OPacMan list + mutex" + suffix, runOutput<ListOPacMan>(count, senders));
+    print("OPacMan ring" + suffix, runOutput<OPacMan>(count, senders));
+
+    return 0;
+}
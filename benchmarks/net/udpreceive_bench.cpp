@@ -0,0 +1,209 @@
+// Loopback UDP receive throughput: one receive_from and one processor wakeup per datagram
+// against recvmmsg into reserved IPacMan tasks with one wakeup per batch.
+// usage: udpreceive_bench [packets count] [packet size]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <net/pacmans.hpp>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+enum class Mode {
+    Single,
+    Batch
+};
+
+struct Result {
+    uint64_t received = 0;
+    uint64_t syscalls = 0;
+    double seconds = 0;
+};
+
+// processor side: consumes as many tasks as signaled by the reader
+void processorRoutine(IPacMan& pacman, int eventfd, std::atomic<uint64_t>& processed, std::atomic<bool>& stop) {
+    while (!stop.load()) {
+        uint64_t tasks = 0;
+        if (read(eventfd, &tasks, sizeof(tasks)) != sizeof(tasks) || stop.load()) {
+            continue;
+        }
+
+        for (uint64_t i = 0; i < tasks; ++i) {
+            auto task = pacman.getNextTask();
+            if (task->size != 0) {
+                processed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void readerRoutine(Mode mode, IPacMan& pacman, ip::udp::socket& socket, int eventfd, std::atomic<bool>& stop, uint64_t& syscalls) {
+    if (mode == Mode::Single) {
+        while (!stop.load()) {
+            auto& task = pacman.allocNext();
+
+            boost::system::error_code error;
+            const size_t size = socket.receive_from(boost::asio::buffer(task.pack.data(), Packet::MaxSize), task.sender, 0, error);
+            ++syscalls;
+
+            if (error || (task.size = task.pack.decode(size)) == 0) {
+                pacman.rejectLast();
+                continue;
+            }
+
+            pacman.enQueueLast();
+
+            uint64_t one = 1;
+            write(eventfd, &one, sizeof(one));
+        }
+
+        return;
+    }
+
+    std::vector<mmsghdr> msg(IPacMan::MaxBatchSize);
+    std::vector<iovec> iovecs(IPacMan::MaxBatchSize);
+
+    while (!stop.load()) {
+        pacman.reserve(IPacMan::MaxBatchSize);
+
+        for (size_t i = 0; i < IPacMan::MaxBatchSize; ++i) {
+            auto& task = pacman.reserved(i);
+            iovecs[i] = iovec{task.pack.data(), Packet::MaxSize};
+            msg[i] = mmsghdr{};
+            msg[i].msg_hdr.msg_iov = &iovecs[i];
+            msg[i].msg_hdr.msg_iovlen = 1;
+            msg[i].msg_hdr.msg_name = task.sender.data();
+            msg[i].msg_hdr.msg_namelen = static_cast<socklen_t>(task.sender.capacity());
+        }
+
+        const int received = recvmmsg(socket.native_handle(), msg.data(), IPacMan::MaxBatchSize, MSG_WAITFORONE, nullptr);
+        ++syscalls;
+
+        if (received <= 0) {
+            continue;
+        }
+
+        for (int i = 0; i < received; ++i) {
+            auto& task = pacman.reserved(static_cast<size_t>(i));
+            task.sender.resize(msg[i].msg_hdr.msg_namelen);
+            task.size = task.pack.decode(msg[i].msg_len);
+        }
+
+        pacman.enQueueReserved(static_cast<size_t>(received));
+
+        uint64_t count = static_cast<uint64_t>(received);
+        write(eventfd, &count, sizeof(count));
+    }
+}
+
+Result run(Mode mode, uint64_t packets, size_t packetSize) {
+    boost::asio::io_context context;
+
+    ip::udp::socket receiver(context, ip::udp::endpoint(ip::address_v4::loopback(), 0));
+    receiver.set_option(ip::udp::socket::receive_buffer_size(1 << 23));
+
+    ip::udp::socket sender(context, ip::udp::endpoint(ip::address_v4::loopback(), 0));
+    const auto target = receiver.local_endpoint();
+
+    IPacMan pacman;
+    const int eventfd = ::eventfd(0, 0);
+
+    std::atomic<bool> stop = {false};
+    std::atomic<uint64_t> processed = {0};
+    uint64_t syscalls = 0;
+
+    std::thread processor(processorRoutine, std::ref(pacman), eventfd, std::ref(processed), std::ref(stop));
+    std::thread reader(readerRoutine, mode, std::ref(pacman), std::ref(receiver), eventfd, std::ref(stop), std::ref(syscalls));
+
+    // packets are sent by sendmmsg batches as the node writer does, first byte 0 means plain not fragmented packet
+    std::vector<char> payload(packetSize, 0);
+    std::vector<mmsghdr> msg(IPacMan::MaxBatchSize);
+    iovec vec{payload.data(), payload.size()};
+
+    for (auto& m : msg) {
+        m.msg_hdr.msg_iov = &vec;
+        m.msg_hdr.msg_iovlen = 1;
+        m.msg_hdr.msg_name = const_cast<void*>(static_cast<const void*>(target.data()));
+        m.msg_hdr.msg_namelen = static_cast<socklen_t>(target.size());
+    }
+
+    const auto start = Clock::now();
+
+    for (uint64_t sent = 0; sent < packets;) {
+        const auto count = static_cast<unsigned>(std::min<uint64_t>(IPacMan::MaxBatchSize, packets - sent));
+        const int result = sendmmsg(sender.native_handle(), msg.data(), count, 0);
+        if (result > 0) {
+            sent += static_cast<uint64_t>(result);
+        }
+
+        // do not outrun the receiver too much, loopback drops on full socket buffer
+        const auto waitStart = Clock::now();
+        while (sent - processed.load(std::memory_order_relaxed) > 4096 && Clock::now() - waitStart < std::chrono::milliseconds(10)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // wait for the tail
+    auto last = processed.load();
+    do {
+        last = processed.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    } while (processed.load() != last);
+
+    const auto finish = Clock::now();
+
+    // wakes up blocked reader
+    stop.store(true);
+    sender.send_to(boost::asio::buffer(payload), target);
+    reader.join();
+
+    uint64_t wakeup = 1;
+    write(eventfd, &wakeup, sizeof(wakeup));
+    processor.join();
+    close(eventfd);
+
+    Result result;
+    result.received = processed.load();
+    result.syscalls = syscalls;
+    result.seconds = std::chrono::duration<double>(finish - start).count() - 0.2;
+    return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const uint64_t packets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const size_t packetSize = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : Packet::MaxSize;
+
+    if (packetSize == 0 || packetSize > Packet::MaxSize) {
+        std::cerr << "packet size should be in range 1.." << Packet::MaxSize << std::endl;
+        return 1;
+    }
+
+    for (const auto mode : {Mode::Single, Mode::Batch}) {
+        const Result result = run(mode, packets, packetSize);
+
+        std::cout << (mode == Mode::Single ? "receive_from" : "recvmmsg    ") << ": " << result.received << " of " << packets << " packets, "
+                  << static_cast<uint64_t>(static_cast<double>(result.received) / result.seconds) << " packets/s, "
+                  << static_cast<double>(result.received) / static_cast<double>(std::max<uint64_t>(result.syscalls, 1)) << " packets/syscall" << std::endl;
+    }
+
+    return 0;
+}
+#else
+int main() {
+    std::cout << "recvmmsg is available on Linux only" << std::endl;
+    return 0;
+}
+#endif
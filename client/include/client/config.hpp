@@ -25,6 +25,10 @@ const std::string DEFAULT_PATH_TO_PRIVATE_KEY = "NodePrivate.txt";
 
 const uint32_t DEFAULT_MAX_NEIGHBOURS = Neighbourhood::MaxNeighbours;
 const uint32_t DEFAULT_CONNECTION_BANDWIDTH = 1 << 19;
+const uint32_t DEFAULT_PROCESSOR_THREADS = 1;
+const uint32_t MAX_PROCESSOR_THREADS = 16;
+const uint32_t DEFAULT_PACKET_SIZE = Packet::DefaultSize;
+const uint32_t MAX_PACKET_SIZE = Packet::MaxSize;
 
 typedef short unsigned Port;
 
@@ -60,6 +64,7 @@ struct ApiData {
     uint16_t ajaxPort = 8081;
     uint16_t executorPort = 9080;
     uint16_t apiexecPort = 9070;
+    uint8_t executorConnections = 4;  // calls to executor made concurrently: cannot be 0
 };
 
 class Config {
@@ -114,6 +119,32 @@ public:
         return connectionBandwidth_;
     }
 
+    // received packets are processed by that many threads sharded by sender, 1 means the single processor thread
+    uint32_t getProcessorThreads() const {
+        return processorThreads_;
+    }
+
+    // the largest datagram to send and receive, the smaller one is used with a peer which supports less
+    uint32_t getPacketSize() const {
+        return packetSize_;
+    }
+
+    // node messages are compressed as a whole, all the nodes should understand it
+    bool isMessageCompression() const {
+        return messageCompression_;
+    }
+
+    // the same dictionary should be set at all the nodes, empty if not used
+    const cs::Bytes& getCompressionDictionary() const {
+        return compressionDictionary_;
+    }
+
+    // transactions affected by the rejected ones are validated again until the characteristic mask does not change,
+    // all the trusted nodes must use the same value, otherwise they build different characteristics
+    bool isValidationIterations() const {
+        return validationIterations_;
+    }
+
     bool isSymmetric() const {
         return symmetric_;
     }
@@ -168,6 +199,11 @@ private:
     bool ipv6_;
     uint32_t maxNeighbours_;
     uint64_t connectionBandwidth_;
+    uint32_t processorThreads_ = DEFAULT_PROCESSOR_THREADS;
+    uint32_t packetSize_ = DEFAULT_PACKET_SIZE;
+    bool messageCompression_ = false;
+    cs::Bytes compressionDictionary_;
+    bool validationIterations_ = false;
 
     bool symmetric_;
     EndpointData hostAddressEp_;
@@ -1,4 +1,5 @@
 /* Send blaming letters to @yrtimd */
+#include <algorithm>
 #include <iostream>
 #include <regex>
 #include <stdexcept>
@@ -42,6 +43,11 @@ const std::string PARAM_NAME_HOSTS_FILENAME = "hosts_filename";
 const std::string PARAM_NAME_USE_IPV6 = "ipv6";
 const std::string PARAM_NAME_MAX_NEIGHBOURS = "max_neighbours";
 const std::string PARAM_NAME_CONNECTION_BANDWIDTH = "connection_bandwidth";
+const std::string PARAM_NAME_PROCESSOR_THREADS = "processor_threads";
+const std::string PARAM_NAME_PACKET_SIZE = "packet_size";
+const std::string PARAM_NAME_MESSAGE_COMPRESSION = "message_compression";
+const std::string PARAM_NAME_COMPRESSION_DICTIONARY = "compression_dictionary";
+const std::string PARAM_NAME_VALIDATION_ITERATIONS = "validation_iterations";
 
 const std::string PARAM_NAME_IP = "ip";
 const std::string PARAM_NAME_PORT = "port";
@@ -56,6 +62,7 @@ const std::string PARAM_NAME_POOL_SYNC_SEQ_VERIF_FREQ = "sequences_verification_
 const std::string PARAM_NAME_API_PORT = "port";
 const std::string PARAM_NAME_AJAX_PORT = "ajax_port";
 const std::string PARAM_NAME_EXECUTOR_PORT = "executor_port";
+const std::string PARAM_NAME_EXECUTOR_CONNECTIONS = "executor_connections";
 const std::string PARAM_NAME_APIEXEC_PORT = "apiexec_port";
 
 const std::string ARG_NAME_CONFIG_FILE = "config-file";
@@ -528,6 +535,26 @@ Config Config::readFromFile(const std::string& fileName) {
 
         result.connectionBandwidth_ = params.count(PARAM_NAME_CONNECTION_BANDWIDTH) ? params.get<uint64_t>(PARAM_NAME_CONNECTION_BANDWIDTH) : DEFAULT_CONNECTION_BANDWIDTH;
 
+        result.processorThreads_ = params.count(PARAM_NAME_PROCESSOR_THREADS) ? params.get<uint32_t>(PARAM_NAME_PROCESSOR_THREADS) : DEFAULT_PROCESSOR_THREADS;
+        result.processorThreads_ = std::max(1u, std::min(result.processorThreads_, MAX_PROCESSOR_THREADS));
+
+        result.packetSize_ = params.count(PARAM_NAME_PACKET_SIZE) ? params.get<uint32_t>(PARAM_NAME_PACKET_SIZE) : DEFAULT_PACKET_SIZE;
+        result.packetSize_ = std::max(DEFAULT_PACKET_SIZE, std::min(result.packetSize_, MAX_PACKET_SIZE));
+
+        result.messageCompression_ = params.count(PARAM_NAME_MESSAGE_COMPRESSION) && params.get<std::string>(PARAM_NAME_MESSAGE_COMPRESSION) == "true";
+        result.validationIterations_ = params.count(PARAM_NAME_VALIDATION_ITERATIONS) && params.get<std::string>(PARAM_NAME_VALIDATION_ITERATIONS) == "true";
+
+        if (params.count(PARAM_NAME_COMPRESSION_DICTIONARY)) {
+            const auto dictionaryFileName = params.get<std::string>(PARAM_NAME_COMPRESSION_DICTIONARY);
+
+            std::ifstream dictionaryFile;
+            dictionaryFile.exceptions(std::ifstream::failbit);
+            dictionaryFile.open(dictionaryFileName, std::ios::binary);
+            dictionaryFile.exceptions(std::ifstream::goodbit);
+
+            result.compressionDictionary_.assign(std::istreambuf_iterator<char>(dictionaryFile), std::istreambuf_iterator<char>());
+        }
+
         result.nType_ = getFromMap(params.get<std::string>(PARAM_NAME_NODE_TYPE), NODE_TYPES_MAP);
 
         if (config.count(BLOCK_NAME_HOST_ADDRESS)) {
@@ -645,6 +672,7 @@ void Config::readApiData(const boost::property_tree::ptree& config) {
     checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_AJAX_PORT, apiData_.ajaxPort);
     checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_EXECUTOR_PORT, apiData_.executorPort);
     checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_APIEXEC_PORT, apiData_.apiexecPort);
+    checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_EXECUTOR_CONNECTIONS, apiData_.executorConnections);
 }
 
 template <typename T>
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <string>
+
+#include <cscrypto/cscrypto.hpp>
+
+#include "csdb/address.hpp"
+#include "csdb/amount.hpp"
+#include "csdb/amount_commission.hpp"
+#include "csdb/currency.hpp"
+#include "csdb/internal/utils.hpp"
+#include "csdb/pool.hpp"
+#include "csdb/storage.hpp"
+#include "csdb/transaction.hpp"
+
+// Сканирование базы из CSDB_BENCHMARK_POOLS (по умолчанию 20000) пулов
+// по CSDB_BENCHMARK_TRANSACTIONS (по умолчанию 50) транзакций в каждом.
+// Аргумент бенчмарка - OpenOptions::rescan_threads, 1 - последовательное сканирование.
+
+namespace {
+size_t env_value(const char* name, size_t default_value) {
+    const char* value = std::getenv(name);
+    return value != nullptr ? static_cast<size_t>(std::strtoull(value, nullptr, 10)) : default_value;
+}
+
+csdb::Address address(uint8_t id) {
+    cs::PublicKey key{};
+    key.fill(id);
+    return csdb::Address::from_public_key(key);
+}
+
+const std::string& database_path() {
+    static const std::string path = []() {
+        const std::string result = csdb::internal::app_data_path() + "/csdb_benchmark_rescan";
+        csdb::internal::path_remove(result);
+
+        const size_t pools = env_value("CSDB_BENCHMARK_POOLS", 20000);
+        const size_t transactions = env_value("CSDB_BENCHMARK_TRANSACTIONS", 50);
+
+        csdb::Storage storage;
+        if (!storage.open(result)) {
+            return result;
+        }
+
+        csdb::PoolHash previous;
+        int64_t inner_id = 0;
+
+        for (cs::Sequence sequence = 0; sequence < pools; ++sequence) {
+            csdb::Pool pool(previous, sequence);
+
+            for (size_t i = 0; i < transactions; ++i) {
+                csdb::Transaction transaction(++inner_id, address(static_cast<uint8_t>(i)), address(static_cast<uint8_t>(i + 1)), csdb::Currency(1),
+                                              csdb::Amount(1), csdb::AmountCommission(0.1), csdb::AmountCommission(0.1), cs::Signature{});
+                pool.add_transaction(transaction);
+            }
+
+            pool.compose();
+            storage.pool_save(pool);
+            previous = pool.hash();
+        }
+
+        storage.close();
+        return result;
+    }();
+
+    return path;
+}
+
+void rescan(benchmark::State& state, const csdb::Storage::DecodeCallback& check) {
+    const std::string& path = database_path();
+    size_t pools = 0;
+
+    for (auto _ : state) {
+        csdb::Storage::OpenOptions options;
+        options.rescan_threads = static_cast<size_t>(state.range(0));
+        options.on_decode = check;
+
+        csdb::Storage storage;
+        if (!storage.open(path, options)) {
+            state.SkipWithError(storage.last_error_message().c_str());
+            break;
+        }
+
+        pools = storage.size();
+        storage.close();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pools));
+}
+
+void BM_Rescan(benchmark::State& state) {
+    rescan(state, nullptr);
+}
+
+// вместо проверки подписей, которым нужны настоящие ключи, хешируются подписываемые данные транзакций
+void BM_RescanWithCheck(benchmark::State& state) {
+    rescan(state, [](const csdb::Pool& pool) {
+        for (const auto& transaction : pool.transactions()) {
+            const auto bytes = transaction.to_byte_stream_for_sig();
+            benchmark::DoNotOptimize(cscrypto::calculateHash(bytes.data(), bytes.size()));
+        }
+        return true;
+    });
+}
+}  // namespace
+
+BENCHMARK(BM_Rescan)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_RescanWithCheck)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
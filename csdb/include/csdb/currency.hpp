@@ -23,6 +23,7 @@ public:
     Currency(const uint8_t& id);
 
     bool is_valid() const noexcept;
+    uint8_t id() const noexcept;
     std::string to_string() const noexcept;
 
     bool operator==(const Currency& other) const noexcept;
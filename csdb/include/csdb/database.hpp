@@ -40,15 +40,43 @@ public:
     virtual bool get(const uint32_t seq_no, cs::Bytes* value = nullptr) = 0;
     virtual bool remove(const cs::Bytes& key) = 0;
 
+    // bytes of a stored block, they are valid while the view or its copies exist
+    struct View {
+        cs::BytesView data;
+        std::shared_ptr<const void> holder;
+    };
+
+    // by default the block is copied to the view, backends mapping the file to memory return it without copying
+    virtual bool get_view(const cs::Bytes& key, View* view);
+    virtual bool get_view(const uint32_t seq_no, View* view);
+
     using Item = std::pair<cs::Bytes, cs::Bytes>;
     using ItemList = std::vector<Item>;
     virtual bool write_batch(const ItemList& items) = 0;
 
+    struct PoolItem {
+        cs::Bytes key;
+        uint32_t seq_no;
+        cs::Bytes value;
+    };
+    using PoolItemList = std::vector<PoolItem>;
+
+    // puts all the pools in one transaction, by default they are put one by one
+    virtual bool put_batch(const PoolItemList& items);
+
+    // data written before the call is on disk after it
+    virtual bool sync();
+
 #ifdef TRANSACTIONS_INDEX
     virtual bool putToTransIndex(const cs::Bytes& key, const cs::Bytes& value) = 0;
     virtual bool getFromTransIndex(const cs::Bytes& key, cs::Bytes* value) = 0;
 #endif
 
+    // ordered address -> (sequence, transaction index) index, all changes of one call are atomic
+    virtual bool updateAddressIndex(const ItemList& toPut, const std::vector<cs::Bytes>& toRemove) = 0;
+    virtual bool getFromAddressIndex(const cs::Bytes& key, cs::Bytes* value) = 0;
+    virtual bool clearAddressIndex() = 0;
+
     class Iterator {
     protected:
         Iterator();
@@ -68,6 +96,7 @@ public:
     };
     using IteratorPtr = std::shared_ptr<Iterator>;
     virtual IteratorPtr new_iterator() = 0;
+    virtual IteratorPtr new_address_index_iterator() = 0;
 
 public:
     Error last_error() const;
@@ -34,8 +34,15 @@ private:
     bool get(const uint32_t seq_no, cs::Bytes* value) final;
     bool remove(const cs::Bytes&) final;
     bool write_batch(const ItemList&) final;
+    bool put_batch(const PoolItemList& items) final;
+    bool sync() final;
     IteratorPtr new_iterator() final;
 
+    bool updateAddressIndex(const ItemList& toPut, const std::vector<cs::Bytes>& toRemove) final;
+    bool getFromAddressIndex(const cs::Bytes& key, cs::Bytes* value) final;
+    bool clearAddressIndex() final;
+    IteratorPtr new_address_index_iterator() final;
+
 #ifdef TRANSACTIONS_INDEX
     bool putToTransIndex(const cs::Bytes& key, const cs::Bytes& value) override final;
     bool getFromTransIndex(const cs::Bytes& key, cs::Bytes* value) override final;
@@ -43,6 +50,7 @@ private:
 
 private:
     class Iterator;
+    class IndexIterator;
 
 private:
     void set_last_error_from_berkeleydb(int status);
@@ -51,6 +59,7 @@ private:
     DbEnv env_;
     std::unique_ptr<Db> db_blocks_;
     std::unique_ptr<Db> db_seq_no_;
+    std::unique_ptr<Db> db_addr_idx_;
 #ifdef TRANSACTIONS_INDEX
     std::unique_ptr<Db> db_trans_idx_;
 #endif
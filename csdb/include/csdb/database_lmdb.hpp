@@ -0,0 +1,72 @@
+/**
+ * @file database_lmdb.h
+ */
+
+#ifndef _CREDITS_CSDB_DATABASE_LMDB_H_INCLUDED_
+#define _CREDITS_CSDB_DATABASE_LMDB_H_INCLUDED_
+
+#include <lmdb.h>
+#include <string>
+
+#include "csdb/database.hpp"
+
+namespace csdb {
+
+// LMDB is a B+tree in a memory mapped file: blocks are read straight from the map (see get_view),
+// transactions are committed without sync like in BerkeleyDB backend, data is flushed by sync()
+class DatabaseLMDB : public Database {
+public:
+    // address space reserved for the map, the file grows as the data is written
+    static constexpr size_t kDefaultMapSize = size_t(1) << 40;
+
+    DatabaseLMDB();
+    ~DatabaseLMDB() override;
+
+public:
+    bool open(const std::string& path, size_t map_size = kDefaultMapSize);
+
+private:
+    bool is_open() const final;
+    bool put(const cs::Bytes& key, uint32_t seq_no, const cs::Bytes& value) final;
+    bool get(const cs::Bytes& key, cs::Bytes* value) final;
+    bool get(const uint32_t seq_no, cs::Bytes* value) final;
+    bool get_view(const cs::Bytes& key, View* view) final;
+    bool get_view(const uint32_t seq_no, View* view) final;
+    bool remove(const cs::Bytes&) final;
+    bool write_batch(const ItemList&) final;
+    bool put_batch(const PoolItemList& items) final;
+    bool sync() final;
+    IteratorPtr new_iterator() final;
+
+    bool updateAddressIndex(const ItemList& toPut, const std::vector<cs::Bytes>& toRemove) final;
+    bool getFromAddressIndex(const cs::Bytes& key, cs::Bytes* value) final;
+    bool clearAddressIndex() final;
+    IteratorPtr new_address_index_iterator() final;
+
+#ifdef TRANSACTIONS_INDEX
+    bool putToTransIndex(const cs::Bytes& key, const cs::Bytes& value) override final;
+    bool getFromTransIndex(const cs::Bytes& key, cs::Bytes* value) override final;
+#endif
+
+private:
+    class Iterator;
+
+private:
+    bool set_result(int status);
+    int put_block(MDB_txn* txn, const cs::Bytes& key, uint32_t seq_no, const cs::Bytes& value);
+    int get_block(MDB_txn* txn, const cs::Bytes& key, MDB_val* value);
+    bool get_record(MDB_dbi dbi, const cs::Bytes& key, cs::Bytes* value);
+    IteratorPtr new_iterator(MDB_dbi dbi, bool range_seek);
+
+private:
+    MDB_env* env_;
+    MDB_dbi db_blocks_;
+    MDB_dbi db_seq_no_;
+    MDB_dbi db_addr_idx_;
+#ifdef TRANSACTIONS_INDEX
+    MDB_dbi db_trans_idx_;
+#endif
+};
+
+}  // namespace csdb
+#endif  // _CREDITS_CSDB_DATABASE_LMDB_H_INCLUDED_
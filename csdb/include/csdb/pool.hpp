@@ -137,6 +137,8 @@ public:
 
     static Pool from_binary(cs::Bytes&& data);
     static Pool meta_from_binary(cs::Bytes&& data, size_t& cnt);
+    // only the header is decoded, the data is not copied to the pool
+    static Pool meta_from_view(cs::BytesView data, size_t& cnt);
     static Pool load(const PoolHash& hash, Storage storage = Storage());
 
     // static Pool from_byte_stream(const char* data, size_t size);
@@ -88,9 +88,72 @@ public:
     WeakPtr weak_ptr() const noexcept;
 
 public:
+    /**
+     * @brief Callback для восстановления клиентом состояния из снимка
+     * @param[out] test_failed Устанавливается в true, если открытие необходимо прервать.
+     * @return true, если состояние восстановлено, и блоки до точки продолжения включительно
+     *         не нужно передавать в \ref readBlockEvent. false, если нужно полное сканирование.
+     *
+     * Вызывается перед сканированием только после того, как хеш блока в точке продолжения
+     * совпал с ожидаемым.
+     */
+    typedef ::std::function<bool(bool* test_failed)> ResumeCallback;
+
+    /**
+     * @brief Callback для проверки прочитанного пула в потоке декодирования
+     * @return false, если пул не прошёл проверку и открытие необходимо прервать.
+     *
+     * При параллельном сканировании вызывается одновременно из нескольких потоков и в произвольном
+     * порядке пулов, поэтому допустимы только проверки, не зависящие от состояния по предыдущим
+     * блокам (например, проверка подписей). Пул передаётся клиенту в \ref readBlockEvent строго
+     * по порядку и только после успешной проверки.
+     */
+    typedef ::std::function<bool(const Pool& pool)> DecodeCallback;
+
+    /// Драйвер базы данных, создаваемой хранилищем при открытии по пути
+    enum class Backend {
+        BerkeleyDB,
+        /// Доступен при сборке с CSDB_WITH_LMDB
+        LMDB,
+    };
+
     struct OpenOptions {
         /// Экземпляр драйвера базы данных
         ::std::shared_ptr<Database> db;
+        /// Драйвер для \ref open(const ::std::string&, OpenOptions, OpenCallback)
+        Backend backend = Backend::BerkeleyDB;
+        /// Перестроить индекс адресов заново во время открытия хранилища
+        bool rebuild_address_index = false;
+        /// Точка продолжения сканирования: хеш (\ref PoolHash::to_binary) и номер последнего блока,
+        /// состояние по которому клиент может восстановить без чтения блоков.
+        /// Пустой хеш - полное сканирование.
+        cs::Bytes resume_hash;
+        cs::Sequence resume_sequence = 0;
+        ResumeCallback on_resume;
+        /// Количество потоков декодирования пулов при сканировании: 0 - по числу ядер,
+        /// 1 - чтение, декодирование и передача клиенту в одном (вызывающем) потоке
+        size_t rescan_threads = 0;
+        DecodeCallback on_decode;
+        /// Размер кеша декодированных пулов в байтах, 0 - пулы не кешируются
+        size_t pool_cache_size = 64 * 1024 * 1024;
+        /// Длина очереди записи пулов: \ref pool_save только ставит пул в очередь, пулы пишутся
+        /// в базу отдельным потоком группами по несколько пулов в одной транзакции.
+        /// 0 - пул пишется в базу в вызывающем потоке.
+        size_t write_queue_size = 256;
+    };
+
+    /// Статистика кеша декодированных пулов
+    struct PoolCacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t pools;  ///< Количество пулов в кеше
+        size_t size;   ///< Оценка занимаемой пулами памяти в байтах
+
+        double hit_rate() const {
+            const uint64_t total = hits + misses;
+            return total != 0 ? static_cast<double>(hits) / total : 0.0;
+        }
     };
 
     struct OpenProgress {
@@ -132,6 +195,17 @@ public:
      */
     bool open(const ::std::string& path_to_base = ::std::string{}, OpenCallback callback = nullptr);
 
+    /**
+     * @brief Открывает хранилище по пути к хранилищу с набором параметров
+     * @param path_to_base  Путь к базе данных
+     * @param opt           Набор параметров для открытия. Член \ref OpenOptions::db игнорируется.
+     * @param callback      Функция обратного вызова для процедуры открытия
+     * @overload
+     *
+     * См. \ref open(const ::std::string& path_to_base, OpenCallback callback);
+     */
+    bool open(const ::std::string& path_to_base, OpenOptions opt, OpenCallback callback = nullptr);
+
     /**
      * @brief Создание хранилища по набору параметров.
      *
@@ -180,10 +254,20 @@ public:
      * @param[in] pool Пул для записи в хранилище.
      * @return true, если пул успешно записан.
      *
+     * При включённой очереди записи (\ref OpenOptions::write_queue_size) пул только ставится
+     * в очередь, если она заполнена - метод ждёт места в ней. До записи в базу пул доступен
+     * методам чтения. Запись на диск гарантируется только после \ref flush.
+     *
      * \sa ::csdb::Pool::save
      */
     bool pool_save(Pool pool);
 
+    /**
+     * @brief Дожидается записи в базу всех пулов из очереди записи и сброса базы на диск
+     * @return false, если запись какого-либо пула завершилась ошибкой.
+     */
+    bool flush();
+
     /**
      * @brief Загружает пул из хранилища
      * @param[in] hash Хэш пула, который надо загрузить.
@@ -195,8 +279,23 @@ public:
      */
     Pool pool_load(const PoolHash& hash) const;
     Pool pool_load(const cs::Sequence sequence) const;
+
+    /**
+     * @brief Загружает заголовок пула без транзакций
+     * @param[out] cnt Количество транзакций в пуле
+     *
+     * Заголовок читается прямо из данных базы (\ref Database::get_view), у пула, прочитанного
+     * из базы, нет сериализованного представления.
+     */
     Pool pool_load_meta(const PoolHash& hash, size_t& cnt) const;
 
+    /**
+     * @brief Загружает пул из хранилища в сериализованном виде, без декодирования
+     * @param[in] sequence Номер записи, как в \ref pool_load(const cs::Sequence sequence)
+     * @return Данные пула (\ref ::csdb::Pool::to_binary). Если пул не найден, возвращается пустой массив.
+     */
+    cs::Bytes pool_load_binary(const cs::Sequence sequence) const;
+
     Pool pool_remove_last();
 
     /**
@@ -267,12 +366,31 @@ public:
      */
     bool get_from_blockchain(const Address& addr /*input*/, const int64_t& innerId /*input*/, Transaction& trx /*output*/) const;
 
+    /**
+     * @brief rebuild_address_index полностью перестраивает индекс адресов по содержимому хранилища
+     * @param callback функция обратного вызова для отображения прогресса
+     * @return true, если индекс успешно перестроен
+     *
+     * При открытии хранилища индекс дополняется автоматически для всех блоков, которые ещё не были
+     * проиндексированы, поэтому вызывать метод нужно только при повреждении индекса.
+     */
+    bool rebuild_address_index(OpenCallback callback = nullptr);
+
+    /**
+     * @brief pool_cache_stats возвращает статистику кеша декодированных пулов
+     *
+     * Кеш используется методами \ref pool_load, \ref pool_load_meta и \ref transaction.
+     * Размер кеша задаётся \ref OpenOptions::pool_cache_size.
+     */
+    PoolCacheStats pool_cache_stats() const;
+
 public signals:
     const ReadBlockSignal& readBlockEvent() const;
 
 private:
   static cs::Bytes get_trans_index_key(const Address&, const PoolHash&);
   Pool pool_load_internal(const PoolHash& hash, const bool metaOnly, size_t& trxCnt) const;
+  Transaction get_last_by_role(uint8_t role, const Address& addr) const noexcept;
 
   ::std::shared_ptr<priv> d;
 };
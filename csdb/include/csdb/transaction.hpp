@@ -123,6 +123,12 @@ public:
     std::vector<uint8_t> to_byte_stream() const;
     std::vector<uint8_t> to_byte_stream_for_sig() const;
 
+    /**
+     * @brief Дописывает подписываемые данные транзакции в конец буфера
+     * @param[in,out] buffer Буфер, в который последовательно сериализуются данные нескольких транзакций
+     */
+    void to_byte_stream_for_sig(cs::Bytes& buffer) const;
+
     bool verify_signature(const cs::PublicKey& public_key) const;
 
     /**
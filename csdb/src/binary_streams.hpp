@@ -24,6 +24,11 @@ namespace priv {
 
 class obstream {
 public:
+    obstream() = default;
+    explicit obstream(cs::Bytes&& buffer)
+    : buffer_(std::move(buffer)) {
+    }
+
     void put(const void* buf, size_t size);
     void put(const std::string& value);
     void put(const cs::Bytes& value);
@@ -50,6 +55,10 @@ public:
         return buffer_;
     }
 
+    inline cs::Bytes release() {
+        return std::move(buffer_);
+    }
+
 private:
     cs::Bytes buffer_;
 };
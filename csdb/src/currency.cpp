@@ -20,6 +20,10 @@ bool Currency::is_valid() const noexcept {
     return d != nullptr;
 }
 
+uint8_t Currency::id() const noexcept {
+    return d->id;
+}
+
 std::string Currency::to_string() const noexcept {
     return std::to_string(d->id);
 }
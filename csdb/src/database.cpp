@@ -22,6 +22,42 @@ Database::Database() {
 
 Database::~Database() = default;
 
+bool Database::get_view(const cs::Bytes& key, View* view) {
+    auto data = std::make_shared<cs::Bytes>();
+    if (!get(key, data.get())) {
+        return false;
+    }
+
+    view->data = cs::BytesView(data->data(), data->size());
+    view->holder = std::move(data);
+    return true;
+}
+
+bool Database::get_view(const uint32_t seq_no, View* view) {
+    auto data = std::make_shared<cs::Bytes>();
+    if (!get(seq_no, data.get())) {
+        return false;
+    }
+
+    view->data = cs::BytesView(data->data(), data->size());
+    view->holder = std::move(data);
+    return true;
+}
+
+bool Database::put_batch(const PoolItemList& items) {
+    for (const auto& item : items) {
+        if (!put(item.key, item.seq_no, item.value)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Database::sync() {
+    return true;
+}
+
 Database::Iterator::Iterator() = default;
 
 Database::Iterator::~Iterator() = default;
@@ -1,4 +1,5 @@
 #include <db_cxx.h>
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <exception>
@@ -68,7 +69,8 @@ struct Dbt_safe : public Dbt {
 DatabaseBerkeleyDB::DatabaseBerkeleyDB()
 : env_(static_cast<uint32_t>(0))
 , db_blocks_(nullptr)
-, db_seq_no_(nullptr) {
+, db_seq_no_(nullptr)
+, db_addr_idx_(nullptr) {
 }
 
 DatabaseBerkeleyDB::~DatabaseBerkeleyDB() {
@@ -78,6 +80,9 @@ DatabaseBerkeleyDB::~DatabaseBerkeleyDB() {
     std::cout << "Attempt db_seq_no_ to close...\n" << std::flush;
     db_seq_no_->close(0);
     std::cout << "DB db_seq_no_ was closed.\n" << std::flush;
+    if (db_addr_idx_) {
+        db_addr_idx_->close(0);
+    }
 #ifdef TRANSACTIONS_INDEX
     db_trans_idx_->close(0);
 #endif
@@ -89,7 +94,7 @@ void DatabaseBerkeleyDB::set_last_error_from_berkeleydb(int status) {
     if (status == 0) {
         err = NoError;
     }
-    else if (status == ENOENT) {
+    else if (status == ENOENT || status == DB_NOTFOUND) {
         err = NotFound;
     }
     if (NoError == err) {
@@ -115,6 +120,7 @@ bool DatabaseBerkeleyDB::open(const std::string &path) {
 
     db_blocks_.reset(nullptr);
     db_seq_no_.reset(nullptr);
+    db_addr_idx_.reset(nullptr);
 
     env_.log_set_config(DB_LOG_AUTO_REMOVE, 1);
 
@@ -154,6 +160,11 @@ bool DatabaseBerkeleyDB::open(const std::string &path) {
         status = db_seq_no->open(txn, "sequence.db", NULL, DB_HASH, DB_CREATE | DB_READ_UNCOMMITTED, 0);
         db_seq_no_.swap(db_seq_no);
     }
+    if (!status) {
+        decltype(db_addr_idx_) db_addr_idx(new Db(&env_, 0));
+        status = db_addr_idx->open(txn, "addrindex.db", NULL, DB_BTREE, DB_CREATE | DB_READ_UNCOMMITTED, 0);
+        db_addr_idx_.swap(db_addr_idx);
+    }
 
     if (status) {
         set_last_error_from_berkeleydb(status);
@@ -217,6 +228,65 @@ bool DatabaseBerkeleyDB::put(const cs::Bytes &key, uint32_t seq_no, const cs::By
     }
 }
 
+bool DatabaseBerkeleyDB::put_batch(const PoolItemList &items) {
+    if (!db_blocks_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    DbTxn *tid;
+    int status = env_.txn_begin(nullptr, &tid, DB_READ_UNCOMMITTED);
+    int txn_create_status = status;
+    auto g = cs::scopeGuard([&]() {
+        if (txn_create_status) {
+            return;
+        }
+        if (status) {
+            tid->abort();
+        }
+        else {
+            tid->commit(0);
+        }
+    });
+
+    for (auto it = items.begin(); !status && it != items.end(); ++it) {
+        Dbt_copy<uint32_t> db_seq_no(it->seq_no + 1);
+        Dbt_copy<cs::Bytes> db_value(it->value);
+        status = db_blocks_->put(tid, &db_seq_no, &db_value, 0);
+
+        if (!status) {
+            Dbt_copy<cs::Bytes> db_key(it->key);
+            status = db_seq_no_->put(tid, &db_key, &db_seq_no, 0);
+        }
+    }
+
+    if (!status) {
+        set_last_error();
+        return true;
+    }
+    else {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+}
+
+bool DatabaseBerkeleyDB::sync() {
+    if (!db_blocks_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    // transactions are committed without sync (DB_TXN_NOSYNC)
+    int status = env_.log_flush(nullptr);
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
 bool DatabaseBerkeleyDB::get(const cs::Bytes &key, cs::Bytes *value) {
     if (!db_blocks_) {
         set_last_error(NotOpen);
@@ -356,8 +426,31 @@ public:
         assert(false);
     }
 
-    void seek(const cs::Bytes &) final {
-        assert(false);
+    // key is a record number as native uint32_t, i.e. sequence of the block + 1
+    void seek(const cs::Bytes &key) final {
+        if (it_ == nullptr) {
+            return;
+        }
+
+        if (key.size() != sizeof(uint32_t)) {
+            valid_ = false;
+            return;
+        }
+
+        uint32_t seq_no = 0;
+        std::copy(key.begin(), key.end(), reinterpret_cast<uint8_t *>(&seq_no));
+
+        Dbt_copy<uint32_t> db_seq_no(seq_no);
+        Dbt_safe value;
+
+        int ret = it_->get(&db_seq_no, &value, DB_SET);
+        if (ret == 0) {
+            set_value(value);
+            valid_ = true;
+        }
+        else {
+            valid_ = false;
+        }
     }
 
     void next() override final {
@@ -416,6 +509,199 @@ DatabaseBerkeleyDB::IteratorPtr DatabaseBerkeleyDB::new_iterator() {
     return Database::IteratorPtr(new DatabaseBerkeleyDB::Iterator(cursorp));
 }
 
+class DatabaseBerkeleyDB::IndexIterator final : public Database::Iterator {
+public:
+    explicit IndexIterator(Dbc *it)
+    : it_(it)
+    , valid_(false) {
+    }
+    ~IndexIterator() final {
+        if (it_ != nullptr) {
+            it_->close();
+        }
+    }
+    bool is_valid() const final {
+        return valid_;
+    }
+
+    void seek_to_first() final {
+        move(DB_FIRST);
+    }
+
+    void seek_to_last() final {
+        move(DB_LAST);
+    }
+
+    // positions to the first key which is not less than the passed one
+    void seek(const cs::Bytes &key) final {
+        if (it_ == nullptr || key.empty()) {
+            valid_ = false;
+            return;
+        }
+
+        Dbt_safe db_key;
+        db_key.set_data(malloc(key.size()));
+        std::copy(key.begin(), key.end(), static_cast<uint8_t *>(db_key.get_data()));
+        db_key.set_size(static_cast<uint32_t>(key.size()));
+        db_key.set_flags(DB_DBT_REALLOC);
+
+        Dbt_safe value;
+        int ret = it_->get(&db_key, &value, DB_SET_RANGE);
+        set_current(ret, db_key, value);
+    }
+
+    void next() final {
+        move(DB_NEXT);
+    }
+
+    void prev() final {
+        move(DB_PREV);
+    }
+
+    cs::Bytes key() const final {
+        if (valid_) {
+            return key_;
+        }
+        return cs::Bytes{};
+    }
+
+    cs::Bytes value() const final {
+        if (valid_) {
+            return value_;
+        }
+        return cs::Bytes{};
+    }
+
+private:
+    void move(uint32_t flags) {
+        if (it_ == nullptr) {
+            return;
+        }
+
+        Dbt_safe key;
+        Dbt_safe value;
+
+        int ret = it_->get(&key, &value, flags);
+        set_current(ret, key, value);
+    }
+
+    void set_current(int ret, const Dbt &key, const Dbt &value) {
+        valid_ = (ret == 0);
+        if (valid_) {
+            auto kbegin = static_cast<uint8_t *>(key.get_data());
+            key_.assign(kbegin, kbegin + key.get_size());
+            auto vbegin = static_cast<uint8_t *>(value.get_data());
+            value_.assign(vbegin, vbegin + value.get_size());
+        }
+    }
+
+    Dbc *it_;
+    bool valid_;
+    cs::Bytes key_;
+    cs::Bytes value_;
+};
+
+DatabaseBerkeleyDB::IteratorPtr DatabaseBerkeleyDB::new_address_index_iterator() {
+    if (!db_addr_idx_) {
+        set_last_error(NotOpen);
+        return nullptr;
+    }
+
+    Dbc *cursorp = nullptr;
+    int status = db_addr_idx_->cursor(nullptr, &cursorp, DB_READ_UNCOMMITTED);
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return nullptr;
+    }
+
+    return Database::IteratorPtr(new DatabaseBerkeleyDB::IndexIterator(cursorp));
+}
+
+bool DatabaseBerkeleyDB::updateAddressIndex(const ItemList &toPut, const std::vector<cs::Bytes> &toRemove) {
+    if (!db_addr_idx_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    DbTxn *tid;
+    int status = env_.txn_begin(nullptr, &tid, DB_READ_UNCOMMITTED);
+    int txn_create_status = status;
+    auto g = cs::scopeGuard([&]() {
+        if (txn_create_status) {
+            return;
+        }
+        if (status) {
+            tid->abort();
+        }
+        else {
+            tid->commit(0);
+        }
+    });
+
+    for (auto it = toRemove.begin(); !status && it != toRemove.end(); ++it) {
+        Dbt_copy<cs::Bytes> db_key(*it);
+        status = db_addr_idx_->del(tid, &db_key, 0);
+        if (status == DB_NOTFOUND) {
+            status = 0;
+        }
+    }
+
+    for (auto it = toPut.begin(); !status && it != toPut.end(); ++it) {
+        Dbt_copy<cs::Bytes> db_key(it->first);
+        Dbt_copy<cs::Bytes> db_value(it->second);
+        status = db_addr_idx_->put(tid, &db_key, &db_value, 0);
+    }
+
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
+bool DatabaseBerkeleyDB::getFromAddressIndex(const cs::Bytes &key, cs::Bytes *value) {
+    if (!db_addr_idx_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    Dbt_copy<cs::Bytes> db_key(key);
+    if (value == nullptr) {
+        return db_addr_idx_->exists(nullptr, &db_key, 0) == 0;
+    }
+
+    Dbt_safe db_value;
+    int status = db_addr_idx_->get(nullptr, &db_key, &db_value, DB_READ_UNCOMMITTED);
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+
+    auto begin = static_cast<uint8_t *>(db_value.get_data());
+    value->assign(begin, begin + db_value.get_size());
+    set_last_error();
+    return true;
+}
+
+bool DatabaseBerkeleyDB::clearAddressIndex() {
+    if (!db_addr_idx_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    uint32_t count = 0;
+    int status = db_addr_idx_->truncate(nullptr, &count, DB_AUTO_COMMIT);
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
 #ifdef TRANSACTIONS_INDEX
 bool DatabaseBerkeleyDB::putToTransIndex(const cs::Bytes &key, const cs::Bytes &value) {
     if (!db_trans_idx_) {
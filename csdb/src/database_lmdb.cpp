@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <memory>
+
+#include <boost/filesystem.hpp>
+
+#include "csdb/database_lmdb.hpp"
+
+namespace csdb {
+
+namespace {
+// every view and iterator holds a read transaction
+constexpr unsigned int kMaxReaders = 1024;
+
+struct txn_abort {
+    void operator()(MDB_txn *txn) const {
+        mdb_txn_abort(txn);
+    }
+};
+using txn_ptr = std::unique_ptr<MDB_txn, txn_abort>;
+
+MDB_val to_val(const cs::Bytes &bytes) {
+    MDB_val val;
+    val.mv_size = bytes.size();
+    val.mv_data = const_cast<uint8_t *>(bytes.data());
+    return val;
+}
+
+MDB_val to_val(uint32_t &seq_no) {
+    MDB_val val;
+    val.mv_size = sizeof(seq_no);
+    val.mv_data = &seq_no;
+    return val;
+}
+
+cs::Bytes to_bytes(const MDB_val &val) {
+    auto begin = static_cast<const uint8_t *>(val.mv_data);
+    return cs::Bytes(begin, begin + val.mv_size);
+}
+
+int begin_read(MDB_env *env, txn_ptr &txn) {
+    MDB_txn *t = nullptr;
+    int status = mdb_txn_begin(env, nullptr, MDB_RDONLY, &t);
+    txn.reset(t);
+    return status;
+}
+
+// the transaction is committed if the function succeeds
+template <typename Function>
+int write_txn(MDB_env *env, Function &&function) {
+    MDB_txn *txn = nullptr;
+    int status = mdb_txn_begin(env, nullptr, 0, &txn);
+    if (status) {
+        return status;
+    }
+
+    status = function(txn);
+    if (status) {
+        mdb_txn_abort(txn);
+        return status;
+    }
+
+    return mdb_txn_commit(txn);
+}
+}  // namespace
+
+DatabaseLMDB::DatabaseLMDB()
+: env_(nullptr)
+, db_blocks_(0)
+, db_seq_no_(0)
+, db_addr_idx_(0) {
+#ifdef TRANSACTIONS_INDEX
+    db_trans_idx_ = 0;
+#endif
+}
+
+DatabaseLMDB::~DatabaseLMDB() {
+    if (env_ != nullptr) {
+        mdb_env_close(env_);
+    }
+}
+
+bool DatabaseLMDB::set_result(int status) {
+    if (status == 0) {
+        set_last_error();
+        return true;
+    }
+
+    Error err = UnknownError;
+    if (status == MDB_NOTFOUND || status == ENOENT) {
+        err = NotFound;
+    }
+    else if (status == MDB_CORRUPTED || status == MDB_PAGE_NOTFOUND || status == MDB_INVALID) {
+        err = Corruption;
+    }
+    else if (status == MDB_MAP_FULL || status == EIO || status == ENOSPC) {
+        err = IOError;
+    }
+
+    set_last_error(err, "LMDB error: %s", mdb_strerror(status));
+    return false;
+}
+
+bool DatabaseLMDB::open(const std::string &path, size_t map_size) {
+    boost::filesystem::path direc(path);
+    if (boost::filesystem::exists(direc)) {
+        if (!boost::filesystem::is_directory(direc)) {
+            return false;
+        }
+    }
+    else {
+        if (!boost::filesystem::create_directories(direc)) {
+            return false;
+        }
+    }
+
+    if (env_ != nullptr) {
+        mdb_env_close(env_);
+        env_ = nullptr;
+    }
+
+    MDB_env *env = nullptr;
+    int status = mdb_env_create(&env);
+    if (status) {
+        return set_result(status);
+    }
+
+    status = mdb_env_set_maxdbs(env, 4);
+    status = status ? status : mdb_env_set_maxreaders(env, kMaxReaders);
+    status = status ? status : mdb_env_set_mapsize(env, map_size);
+    // read transactions are not bound to threads, views are released in any thread
+    status = status ? status : mdb_env_open(env, path.c_str(), MDB_NOTLS | MDB_NOSYNC, 0664);
+
+    status = status ? status : write_txn(env, [&](MDB_txn *txn) {
+        int s = mdb_dbi_open(txn, "blockchain", MDB_CREATE | MDB_INTEGERKEY, &db_blocks_);
+        s = s ? s : mdb_dbi_open(txn, "sequence", MDB_CREATE, &db_seq_no_);
+        s = s ? s : mdb_dbi_open(txn, "addrindex", MDB_CREATE, &db_addr_idx_);
+#ifdef TRANSACTIONS_INDEX
+        s = s ? s : mdb_dbi_open(txn, "index", MDB_CREATE, &db_trans_idx_);
+#endif
+        return s;
+    });
+
+    if (status) {
+        mdb_env_close(env);
+        return set_result(status);
+    }
+
+    env_ = env;
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLMDB::is_open() const {
+    return env_ != nullptr;
+}
+
+int DatabaseLMDB::put_block(MDB_txn *txn, const cs::Bytes &key, uint32_t seq_no, const cs::Bytes &value) {
+    uint32_t record = seq_no + 1;
+    MDB_val db_record = to_val(record);
+    MDB_val db_value = to_val(value);
+
+    // blocks are appended in order, so pages are filled up without splits
+    int status = mdb_put(txn, db_blocks_, &db_record, &db_value, MDB_APPEND);
+    if (status == MDB_KEYEXIST) {
+        status = mdb_put(txn, db_blocks_, &db_record, &db_value, 0);
+    }
+
+    if (!status) {
+        MDB_val db_key = to_val(key);
+        status = mdb_put(txn, db_seq_no_, &db_key, &db_record, 0);
+    }
+
+    return status;
+}
+
+int DatabaseLMDB::get_block(MDB_txn *txn, const cs::Bytes &key, MDB_val *value) {
+    MDB_val db_key = to_val(key);
+    MDB_val db_record;
+
+    int status = mdb_get(txn, db_seq_no_, &db_key, &db_record);
+    if (status) {
+        return status;
+    }
+
+    if (db_record.mv_size != sizeof(uint32_t)) {
+        return MDB_CORRUPTED;
+    }
+
+    // values in the map may be unaligned
+    uint32_t record = 0;
+    std::copy_n(static_cast<const uint8_t *>(db_record.mv_data), sizeof(record), reinterpret_cast<uint8_t *>(&record));
+    MDB_val record_key = to_val(record);
+
+    return mdb_get(txn, db_blocks_, &record_key, value);
+}
+
+bool DatabaseLMDB::put(const cs::Bytes &key, uint32_t seq_no, const cs::Bytes &value) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    return set_result(write_txn(env_, [&](MDB_txn *txn) { return put_block(txn, key, seq_no, value); }));
+}
+
+bool DatabaseLMDB::put_batch(const PoolItemList &items) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    return set_result(write_txn(env_, [&](MDB_txn *txn) {
+        int status = 0;
+        for (auto it = items.begin(); !status && it != items.end(); ++it) {
+            status = put_block(txn, it->key, it->seq_no, it->value);
+        }
+        return status;
+    }));
+}
+
+bool DatabaseLMDB::sync() {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    // transactions are committed without sync (MDB_NOSYNC)
+    return set_result(mdb_env_sync(env_, 1));
+}
+
+bool DatabaseLMDB::get(const cs::Bytes &key, cs::Bytes *value) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    txn_ptr txn;
+    int status = begin_read(env_, txn);
+    if (status) {
+        return set_result(status);
+    }
+
+    if (value == nullptr) {
+        MDB_val db_key = to_val(key);
+        MDB_val db_record;
+        return set_result(mdb_get(txn.get(), db_seq_no_, &db_key, &db_record));
+    }
+
+    MDB_val db_value;
+    status = get_block(txn.get(), key, &db_value);
+    if (status) {
+        return set_result(status);
+    }
+
+    *value = to_bytes(db_value);
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLMDB::get(const uint32_t seq_no, cs::Bytes *value) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    if (value == nullptr) {
+        return false;
+    }
+
+    txn_ptr txn;
+    int status = begin_read(env_, txn);
+    if (status) {
+        return set_result(status);
+    }
+
+    uint32_t record = seq_no;
+    MDB_val db_record = to_val(record);
+    MDB_val db_value;
+
+    status = mdb_get(txn.get(), db_blocks_, &db_record, &db_value);
+    if (status) {
+        return set_result(status);
+    }
+
+    *value = to_bytes(db_value);
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLMDB::get_view(const cs::Bytes &key, View *view) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    txn_ptr txn;
+    int status = begin_read(env_, txn);
+
+    MDB_val db_value;
+    status = status ? status : get_block(txn.get(), key, &db_value);
+    if (status) {
+        return set_result(status);
+    }
+
+    // the page stays mapped and unchanged while the read transaction is alive
+    view->data = cs::BytesView(static_cast<const uint8_t *>(db_value.mv_data), db_value.mv_size);
+    view->holder = std::shared_ptr<MDB_txn>(txn.release(), txn_abort());
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLMDB::get_view(const uint32_t seq_no, View *view) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    txn_ptr txn;
+    int status = begin_read(env_, txn);
+
+    uint32_t record = seq_no;
+    MDB_val db_record = to_val(record);
+    MDB_val db_value;
+
+    status = status ? status : mdb_get(txn.get(), db_blocks_, &db_record, &db_value);
+    if (status) {
+        return set_result(status);
+    }
+
+    view->data = cs::BytesView(static_cast<const uint8_t *>(db_value.mv_data), db_value.mv_size);
+    view->holder = std::shared_ptr<MDB_txn>(txn.release(), txn_abort());
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLMDB::remove(const cs::Bytes &key) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    return set_result(write_txn(env_, [&](MDB_txn *txn) {
+        MDB_val db_key = to_val(key);
+        MDB_val db_record;
+
+        int status = mdb_get(txn, db_seq_no_, &db_key, &db_record);
+        if (status) {
+            return status;
+        }
+
+        if (db_record.mv_size != sizeof(uint32_t)) {
+            return static_cast<int>(MDB_CORRUPTED);
+        }
+
+        uint32_t record = 0;
+        std::copy_n(static_cast<const uint8_t *>(db_record.mv_data), sizeof(record), reinterpret_cast<uint8_t *>(&record));
+        MDB_val record_key = to_val(record);
+
+        status = mdb_del(txn, db_seq_no_, &db_key, nullptr);
+        return status ? status : mdb_del(txn, db_blocks_, &record_key, nullptr);
+    }));
+}
+
+bool DatabaseLMDB::write_batch(const ItemList &) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    set_last_error(NotSupported);
+    return false;
+}
+
+class DatabaseLMDB::Iterator final : public Database::Iterator {
+public:
+    // range_seek: seek positions to the first key which is not less than the passed one,
+    // otherwise the key is a record number as native uint32_t, i.e. sequence of the block + 1
+    Iterator(MDB_txn *txn, MDB_cursor *cursor, bool range_seek)
+    : txn_(txn)
+    , cursor_(cursor)
+    , range_seek_(range_seek)
+    , valid_(false) {
+    }
+
+    ~Iterator() final {
+        mdb_cursor_close(cursor_);
+        mdb_txn_abort(txn_);
+    }
+
+    bool is_valid() const final {
+        return valid_;
+    }
+
+    void seek_to_first() final {
+        move(MDB_FIRST);
+    }
+
+    void seek_to_last() final {
+        move(MDB_LAST);
+    }
+
+    void seek(const cs::Bytes &key) final {
+        if (key.empty() || (!range_seek_ && key.size() != sizeof(uint32_t))) {
+            valid_ = false;
+            return;
+        }
+
+        uint32_t record = 0;
+        if (range_seek_) {
+            key_ = to_val(key);
+        }
+        else {
+            std::copy(key.begin(), key.end(), reinterpret_cast<uint8_t *>(&record));
+            key_ = to_val(record);
+        }
+
+        // the key is replaced by the one in the map
+        move(range_seek_ ? MDB_SET_RANGE : MDB_SET_KEY);
+    }
+
+    void next() final {
+        move(MDB_NEXT);
+    }
+
+    void prev() final {
+        move(MDB_PREV);
+    }
+
+    cs::Bytes key() const final {
+        if (valid_) {
+            return to_bytes(key_);
+        }
+        return cs::Bytes{};
+    }
+
+    cs::Bytes value() const final {
+        if (valid_) {
+            return to_bytes(value_);
+        }
+        return cs::Bytes{};
+    }
+
+private:
+    void move(MDB_cursor_op op) {
+        valid_ = (mdb_cursor_get(cursor_, &key_, &value_, op) == 0);
+    }
+
+    MDB_txn *txn_;
+    MDB_cursor *cursor_;
+    bool range_seek_;
+    bool valid_;
+    MDB_val key_{};
+    MDB_val value_{};
+};
+
+DatabaseLMDB::IteratorPtr DatabaseLMDB::new_iterator(MDB_dbi dbi, bool range_seek) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return nullptr;
+    }
+
+    txn_ptr txn;
+    int status = begin_read(env_, txn);
+
+    MDB_cursor *cursor = nullptr;
+    status = status ? status : mdb_cursor_open(txn.get(), dbi, &cursor);
+    if (status) {
+        set_result(status);
+        return nullptr;
+    }
+
+    set_last_error();
+    return Database::IteratorPtr(new DatabaseLMDB::Iterator(txn.release(), cursor, range_seek));
+}
+
+DatabaseLMDB::IteratorPtr DatabaseLMDB::new_iterator() {
+    return new_iterator(db_blocks_, false);
+}
+
+DatabaseLMDB::IteratorPtr DatabaseLMDB::new_address_index_iterator() {
+    return new_iterator(db_addr_idx_, true);
+}
+
+bool DatabaseLMDB::updateAddressIndex(const ItemList &toPut, const std::vector<cs::Bytes> &toRemove) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    return set_result(write_txn(env_, [&](MDB_txn *txn) {
+        int status = 0;
+
+        for (auto it = toRemove.begin(); !status && it != toRemove.end(); ++it) {
+            MDB_val db_key = to_val(*it);
+            status = mdb_del(txn, db_addr_idx_, &db_key, nullptr);
+            if (status == MDB_NOTFOUND) {
+                status = 0;
+            }
+        }
+
+        for (auto it = toPut.begin(); !status && it != toPut.end(); ++it) {
+            MDB_val db_key = to_val(it->first);
+            MDB_val db_value = to_val(it->second);
+            status = mdb_put(txn, db_addr_idx_, &db_key, &db_value, 0);
+        }
+
+        return status;
+    }));
+}
+
+bool DatabaseLMDB::get_record(MDB_dbi dbi, const cs::Bytes &key, cs::Bytes *value) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    txn_ptr txn;
+    int status = begin_read(env_, txn);
+
+    MDB_val db_key = to_val(key);
+    MDB_val db_value;
+
+    status = status ? status : mdb_get(txn.get(), dbi, &db_key, &db_value);
+    if (status) {
+        return set_result(status);
+    }
+
+    if (value != nullptr) {
+        *value = to_bytes(db_value);
+    }
+
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLMDB::getFromAddressIndex(const cs::Bytes &key, cs::Bytes *value) {
+    return get_record(db_addr_idx_, key, value);
+}
+
+bool DatabaseLMDB::clearAddressIndex() {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    return set_result(write_txn(env_, [&](MDB_txn *txn) { return mdb_drop(txn, db_addr_idx_, 0); }));
+}
+
+#ifdef TRANSACTIONS_INDEX
+bool DatabaseLMDB::putToTransIndex(const cs::Bytes &key, const cs::Bytes &value) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    return set_result(write_txn(env_, [&](MDB_txn *txn) {
+        MDB_val db_key = to_val(key);
+        MDB_val db_value = to_val(value);
+        return mdb_put(txn, db_trans_idx_, &db_key, &db_value, 0);
+    }));
+}
+
+bool DatabaseLMDB::getFromTransIndex(const cs::Bytes &key, cs::Bytes *value) {
+    return get_record(db_trans_idx_, key, value);
+}
+#endif
+
+}  // namespace csdb
@@ -929,6 +929,17 @@ Pool Pool::meta_from_binary(cs::Bytes&& data, size_t& cnt) {
     return Pool(p.release());
 }
 
+Pool Pool::meta_from_view(cs::BytesView data, size_t& cnt) {
+    std::unique_ptr<priv> p(new priv());
+    ::csdb::priv::ibstream is(data.data(), data.size());
+
+    if (!p->get_meta(is, cnt)) {
+        return Pool();
+    }
+
+    return Pool(p.release());
+}
+
 Pool Pool::meta_from_byte_stream(const char* data, size_t size) {
     std::unique_ptr<priv> p(new priv());
     ::csdb::priv::ibstream is(data, size);
@@ -0,0 +1,214 @@
+#include "pool_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace csdb {
+namespace priv {
+
+namespace {
+// Пул хранит сериализованное представление и декодированные транзакции примерно такого же размера
+size_t pool_memory_size(size_t binary_size, const cs::Bytes& hash) {
+    constexpr size_t entry_overhead = 256;
+    return binary_size * 2 + hash.size() + entry_overhead;
+}
+}  // namespace
+
+pool_cache::pool_cache(size_t max_size)
+: shards_(shards_count)
+, hash_shards_(shards_count)
+, shard_max_size_(max_size / shards_count) {
+}
+
+void pool_cache::set_max_size(size_t max_size) {
+    shard_max_size_ = max_size / shards_count;
+
+    if (max_size == 0) {
+        clear();
+    }
+}
+
+bool pool_cache::get(cs::Sequence sequence, Pool& pool) {
+    shard& s = shard_of(sequence);
+
+    {
+        std::lock_guard<std::mutex> lock(s.lock);
+        auto it = s.index.find(sequence);
+
+        if (it != s.index.end()) {
+            s.lru.splice(s.lru.begin(), s.lru, it->second);
+            pool = it->second->pool;
+            ++hits_;
+            return true;
+        }
+    }
+
+    ++misses_;
+    return false;
+}
+
+bool pool_cache::get(const cs::Bytes& hash, Pool& pool) {
+    cs::Sequence sequence = 0;
+    bool found = false;
+
+    {
+        hash_shard& hs = hash_shard_of(hash);
+        std::lock_guard<std::mutex> lock(hs.lock);
+        auto it = hs.index.find(hash);
+
+        if (it != hs.index.end()) {
+            sequence = it->second;
+            found = true;
+        }
+    }
+
+    if (found) {
+        shard& s = shard_of(sequence);
+        std::lock_guard<std::mutex> lock(s.lock);
+        auto it = s.index.find(sequence);
+
+        // индекс хешей обновляется после сегмента пулов, поэтому хеш проверяется ещё раз
+        if (it != s.index.end() && it->second->hash == hash) {
+            s.lru.splice(s.lru.begin(), s.lru, it->second);
+            pool = it->second->pool;
+            ++hits_;
+            return true;
+        }
+    }
+
+    ++misses_;
+    return false;
+}
+
+void pool_cache::put(const Pool& pool, const cs::Bytes& hash, size_t binary_size, uint64_t epoch) {
+    const size_t size = pool_memory_size(binary_size, hash);
+    const size_t max_size = shard_max_size_;
+
+    if (!pool.is_valid() || size > max_size) {
+        return;
+    }
+
+    const cs::Sequence sequence = pool.sequence();
+    std::vector<std::pair<cs::Bytes, cs::Sequence>> evicted;
+
+    {
+        shard& s = shard_of(sequence);
+        std::lock_guard<std::mutex> lock(s.lock);
+
+        if (epoch != epoch_) {
+            return;
+        }
+
+        auto it = s.index.find(sequence);
+
+        if (it != s.index.end()) {
+            if (it->second->hash != hash) {
+                evicted.emplace_back(it->second->hash, sequence);
+            }
+
+            s.size -= it->second->size;
+            s.lru.erase(it->second);
+            s.index.erase(it);
+        }
+
+        s.lru.push_front(entry{sequence, hash, pool, size});
+        s.index.emplace(sequence, s.lru.begin());
+        s.size += size;
+
+        while (s.size > max_size) {
+            entry& last = s.lru.back();
+            evicted.emplace_back(std::move(last.hash), last.sequence);
+
+            s.size -= last.size;
+            s.index.erase(last.sequence);
+            s.lru.pop_back();
+            ++evictions_;
+        }
+    }
+
+    remove_hashes(evicted);
+
+    hash_shard& hs = hash_shard_of(hash);
+    std::lock_guard<std::mutex> lock(hs.lock);
+    hs.index[hash] = sequence;
+}
+
+void pool_cache::remove(cs::Sequence sequence) {
+    // пулы, читаемые из базы одновременно с удалением, в кеш уже не попадут
+    ++epoch_;
+
+    std::vector<std::pair<cs::Bytes, cs::Sequence>> removed;
+
+    {
+        shard& s = shard_of(sequence);
+        std::lock_guard<std::mutex> lock(s.lock);
+        auto it = s.index.find(sequence);
+
+        if (it == s.index.end()) {
+            return;
+        }
+
+        removed.emplace_back(std::move(it->second->hash), sequence);
+        s.size -= it->second->size;
+        s.lru.erase(it->second);
+        s.index.erase(it);
+    }
+
+    remove_hashes(removed);
+}
+
+void pool_cache::clear() {
+    ++epoch_;
+
+    for (auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s.lock);
+        s.lru.clear();
+        s.index.clear();
+        s.size = 0;
+    }
+
+    for (auto& hs : hash_shards_) {
+        std::lock_guard<std::mutex> lock(hs.lock);
+        hs.index.clear();
+    }
+}
+
+Storage::PoolCacheStats pool_cache::stats() const {
+    Storage::PoolCacheStats result{};
+    result.hits = hits_;
+    result.misses = misses_;
+    result.evictions = evictions_;
+
+    for (const auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s.lock);
+        result.pools += s.lru.size();
+        result.size += s.size;
+    }
+
+    return result;
+}
+
+pool_cache::shard& pool_cache::shard_of(cs::Sequence sequence) {
+    return shards_[sequence % shards_count];
+}
+
+pool_cache::hash_shard& pool_cache::hash_shard_of(const cs::Bytes& hash) {
+    size_t value = 0;
+    std::memcpy(&value, hash.data(), std::min(sizeof(value), hash.size()));
+    return hash_shards_[value % shards_count];
+}
+
+void pool_cache::remove_hashes(const std::vector<std::pair<cs::Bytes, cs::Sequence>>& hashes) {
+    for (const auto& [hash, sequence] : hashes) {
+        hash_shard& hs = hash_shard_of(hash);
+        std::lock_guard<std::mutex> lock(hs.lock);
+        auto it = hs.index.find(hash);
+
+        if (it != hs.index.end() && it->second == sequence) {
+            hs.index.erase(it);
+        }
+    }
+}
+
+}  // namespace priv
+}  // namespace csdb
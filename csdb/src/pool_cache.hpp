@@ -0,0 +1,95 @@
+#ifndef _CREDITS_CSDB_PRIVATE_POOL_CACHE_H_INCLUDED_
+#define _CREDITS_CSDB_PRIVATE_POOL_CACHE_H_INCLUDED_
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <lib/system/common.hpp>
+
+#include "csdb/pool.hpp"
+#include "csdb/storage.hpp"
+
+namespace csdb {
+namespace priv {
+
+/**
+ * @brief Кеш последних вычитанных (декодированных) пулов хранилища.
+ *
+ * Пулы доступны по номеру и по хешу (\ref PoolHash::to_binary). Размер кеша ограничен в байтах,
+ * вытесняются давно не использованные пулы. Кеш разделён на сегменты по номеру пула, каждый
+ * сегмент со своей блокировкой; индекс хешей разделён на сегменты отдельно.
+ *
+ * Пулы в кеше только читаются: копия \ref Pool разделяет данные с кешем и отделяется при изменении.
+ */
+class pool_cache {
+public:
+    static constexpr size_t shards_count = 16;
+
+    explicit pool_cache(size_t max_size = 0);
+
+    void set_max_size(size_t max_size);
+
+    bool get(cs::Sequence sequence, Pool& pool);
+    bool get(const cs::Bytes& hash, Pool& pool);
+
+    /**
+     * Номер изменения содержимого хранилища. Пул, прочитанный из базы, помещается в кеш, только
+     * если с начала чтения пулы не удалялись (иначе в кеш мог бы попасть уже удалённый пул).
+     */
+    uint64_t epoch() const {
+        return epoch_.load();
+    }
+
+    /// binary_size - размер сериализованного пула, по нему оценивается занимаемая пулом память
+    void put(const Pool& pool, const cs::Bytes& hash, size_t binary_size, uint64_t epoch);
+    void remove(cs::Sequence sequence);
+    void clear();
+
+    Storage::PoolCacheStats stats() const;
+
+private:
+    struct entry {
+        cs::Sequence sequence;
+        cs::Bytes hash;
+        Pool pool;
+        size_t size;
+    };
+
+    using lru_list = std::list<entry>;
+
+    struct shard {
+        mutable std::mutex lock;
+        lru_list lru;  // в начале - последний использованный пул
+        std::unordered_map<cs::Sequence, lru_list::iterator> index;
+        size_t size = 0;
+    };
+
+    struct hash_shard {
+        std::mutex lock;
+        std::map<cs::Bytes, cs::Sequence> index;
+    };
+
+    shard& shard_of(cs::Sequence sequence);
+    hash_shard& hash_shard_of(const cs::Bytes& hash);
+
+    void remove_hashes(const std::vector<std::pair<cs::Bytes, cs::Sequence>>& hashes);
+
+    std::vector<shard> shards_;
+    std::vector<hash_shard> hash_shards_;
+
+    std::atomic<size_t> shard_max_size_;
+    std::atomic<uint64_t> epoch_{0};
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+}  // namespace priv
+}  // namespace csdb
+
+#endif  // _CREDITS_CSDB_PRIVATE_POOL_CACHE_H_INCLUDED_
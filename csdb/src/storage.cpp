@@ -1,14 +1,20 @@
 #include "csdb/storage.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <climits>
 #include <condition_variable>
 #include <cstdarg>
 #include <deque>
+#include <iterator>
+#include <limits>
 #include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <thread>
+#include <tuple>
 
 #include <lib/system/logger.hpp>
 #include <lib/system/utils.hpp>
@@ -17,10 +23,14 @@
 #include "csdb/address.hpp"
 #include "csdb/database.hpp"
 #include "csdb/database_berkeleydb.hpp"
+#ifdef CSDB_WITH_LMDB
+#include "csdb/database_lmdb.hpp"
+#endif
 #include "csdb/internal/shared_data_ptr_implementation.hpp"
 #include "csdb/internal/utils.hpp"
 #include "csdb/pool.hpp"
 #include "csdb/wallet.hpp"
+#include "pool_cache.hpp"
 
 namespace {
 struct last_error_struct {
@@ -104,6 +114,221 @@ void update_heads_and_tails(heads_t& heads, tails_t& tails, const PoolHash& cur_
     }
 }
 
+// Конвейер чтения пулов при сканировании. Курсор базы читается отдельным потоком пакетами
+// по rescan_batch_size записей, пакеты декодируются (вместе с вычислением хешей и проверкой
+// DecodeCallback) в пуле потоков, а в вызывающий поток пакеты выдаются строго по порядку.
+// Число прочитанных, но ещё не выданных пакетов ограничено, чтобы не держать в памяти всю цепочку.
+class rescan_pipeline {
+public:
+    static constexpr size_t rescan_batch_size = 64;
+    static constexpr size_t batches_per_worker = 4;
+
+    struct batch_t {
+        std::vector<cs::Bytes> raw;
+        std::vector<Pool> pools;
+        bool checked = true;  // все пулы пакета прошли проверку DecodeCallback
+        bool decoded = false;
+    };
+
+    rescan_pipeline(Database::IteratorPtr it, size_t workers, const Storage::DecodeCallback& check)
+    : it_(std::move(it))
+    , check_(check)
+    , max_batches_(workers * batches_per_worker) {
+        reader_ = std::thread(&rescan_pipeline::read_routine, this);
+
+        workers_.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.emplace_back(&rescan_pipeline::decode_routine, this);
+        }
+    }
+
+    ~rescan_pipeline() {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            stop_ = true;
+        }
+        cond_var_.notify_all();
+
+        reader_.join();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    // Возвращает false, когда все пулы выданы
+    bool next(batch_t& batch) {
+        std::unique_lock<std::mutex> lock(lock_);
+        cond_var_.wait(lock, [this]() { return (!queue_.empty() && queue_.front().decoded) || (read_done_ && queue_.empty()); });
+
+        if (queue_.empty()) {
+            return false;
+        }
+
+        batch = std::move(queue_.front());
+        queue_.pop_front();
+        --decode_pos_;
+
+        lock.unlock();
+        cond_var_.notify_all();
+        return true;
+    }
+
+private:
+    void read_routine() {
+        while (it_->is_valid()) {
+            batch_t batch;
+            batch.raw.reserve(rescan_batch_size);
+
+            for (; it_->is_valid() && batch.raw.size() < rescan_batch_size; it_->next()) {
+                batch.raw.emplace_back(it_->value());
+            }
+
+            std::unique_lock<std::mutex> lock(lock_);
+            cond_var_.wait(lock, [this]() { return stop_ || queue_.size() < max_batches_; });
+
+            if (stop_) {
+                return;
+            }
+
+            queue_.emplace_back(std::move(batch));
+            lock.unlock();
+            cond_var_.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            read_done_ = true;
+        }
+        cond_var_.notify_all();
+    }
+
+    void decode_routine() {
+        for (;;) {
+            std::unique_lock<std::mutex> lock(lock_);
+            cond_var_.wait(lock, [this]() { return stop_ || decode_pos_ < queue_.size() || read_done_; });
+
+            if (stop_ || decode_pos_ >= queue_.size()) {
+                return;
+            }
+
+            // ссылки на элементы deque не меняются при добавлении в конец и удалении других элементов из начала,
+            // а из очереди пакет забирается только после декодирования
+            batch_t& batch = queue_[decode_pos_++];
+            lock.unlock();
+
+            batch.pools.reserve(batch.raw.size());
+            for (auto& data : batch.raw) {
+                batch.pools.emplace_back(Pool::from_binary(std::move(data)));
+
+                const Pool& p = batch.pools.back();
+                if (p.is_valid() && check_ != nullptr && !check_(p)) {
+                    batch.checked = false;
+                    break;
+                }
+            }
+            batch.raw.clear();
+
+            lock.lock();
+            batch.decoded = true;
+            lock.unlock();
+            cond_var_.notify_all();
+        }
+    }
+
+    Database::IteratorPtr it_;
+    const Storage::DecodeCallback& check_;
+    const size_t max_batches_;
+
+    std::thread reader_;
+    std::vector<std::thread> workers_;
+
+    std::mutex lock_;
+    std::condition_variable cond_var_;
+    std::deque<batch_t> queue_;
+    size_t decode_pos_ = 0;  // количество пакетов в начале очереди, уже взятых на декодирование
+    bool read_done_ = false;
+    bool stop_ = false;
+};
+
+size_t rescan_workers(const Storage::OpenOptions& opt) {
+    if (opt.rescan_threads != 0) {
+        return opt.rescan_threads;
+    }
+
+    // поток чтения и вызывающий поток заняты меньше потоков декодирования, поэтому ядра не резервируются
+    return std::max<size_t>(std::thread::hardware_concurrency(), 2);
+}
+
+// Индекс адресов: ключ - роль адреса в транзакции, адрес, номер блока и индекс транзакции в блоке
+// (целые в big endian, чтобы порядок ключей совпадал с порядком транзакций в цепочке),
+// значение - innerID транзакции.
+constexpr uint8_t kAddressIndexSource = 's';
+constexpr uint8_t kAddressIndexTarget = 't';
+constexpr uint8_t kAddressIndexPublicKey = 'p';
+constexpr uint8_t kAddressIndexWalletId = 'w';
+constexpr size_t kAddressIndexPositionSize = sizeof(cs::Sequence) + sizeof(uint32_t);
+
+const cs::Bytes kAddressIndexMarkerKey = {'m'};
+
+struct AddressIndexEntry {
+    cs::Sequence sequence;
+    uint32_t index;
+    int64_t innerId;
+};
+
+template <typename T>
+void put_big_endian(cs::Bytes& dst, T value) {
+    for (size_t i = sizeof(T); i > 0; --i) {
+        dst.push_back(static_cast<uint8_t>(value >> ((i - 1) * CHAR_BIT)));
+    }
+}
+
+template <typename T>
+T get_big_endian(const uint8_t* src) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value = static_cast<T>((value << CHAR_BIT) | src[i]);
+    }
+    return value;
+}
+
+cs::Bytes address_index_prefix(uint8_t role, const Address& addr) {
+    cs::Bytes res;
+    res.reserve(2 + cs::PublicKey{}.size() + kAddressIndexPositionSize);
+    res.push_back(role);
+
+    if (addr.is_public_key()) {
+        const auto& key = addr.public_key();
+        res.push_back(kAddressIndexPublicKey);
+        res.insert(res.end(), key.begin(), key.end());
+    }
+    else {
+        res.push_back(kAddressIndexWalletId);
+        put_big_endian(res, addr.wallet_id());
+    }
+
+    return res;
+}
+
+cs::Bytes address_index_key(cs::Bytes prefix, cs::Sequence sequence, uint32_t index) {
+    put_big_endian(prefix, sequence);
+    put_big_endian(prefix, index);
+    return prefix;
+}
+
+cs::Bytes address_index_value(int64_t innerId) {
+    cs::Bytes res;
+    put_big_endian(res, static_cast<uint64_t>(innerId));
+    return res;
+}
+
+// Ключ записи пула в итераторе базы блоков - номер записи (номер пула + 1)
+cs::Bytes block_record_key(cs::Sequence sequence) {
+    const auto record = static_cast<uint32_t>(sequence + 1);
+    const auto begin = reinterpret_cast<const uint8_t*>(&record);
+    return cs::Bytes(begin, begin + sizeof(record));
+}
+
 }  // namespace
 
 class Storage::priv {
@@ -113,20 +338,48 @@ public:
     }
 
     ~priv() {
-        if (write_thread.joinable()) {
-            quit = true;
-            write_cond_var.notify_one();
-            write_thread.join();
-        }
+        stop_writing();
     }
 
 private:
-    bool rescan(Storage::OpenCallback callback);
+    // Пулов, записываемых в базу одной транзакцией
+    static constexpr size_t write_group_size = 64;
+    // Пауза перед повторной записью пулов, запись которых завершилась ошибкой
+    static constexpr std::chrono::milliseconds write_retry_delay{1000};
+
+    // Пул, ожидающий записи в базу
+    struct pending_pool {
+        cs::Bytes key;  // Хеш пула (\ref PoolHash::to_binary)
+        Pool pool;
+    };
+
+    bool rescan(const Storage::OpenOptions& opt, Storage::OpenCallback callback);
+    bool check_resume_point(const PoolHash& hash, cs::Sequence sequence);
+
+    void start_writing(size_t queue_size);
+    void stop_writing();
+    bool enqueue(const cs::Bytes& key, const Pool& pool);
+    bool wait_written();
+    bool find_pending(const cs::Bytes& key, Pool& pool);
+    bool find_pending(cs::Sequence sequence, Pool& pool);
     void write_routine();
 
+    bool load_address_index_marker();
+    bool index_pool(const Pool& pool);
+    bool unindex_pool(const Pool& pool);
+    void index_saved_pool(const Pool& pool);
+    bool load_saved(cs::Sequence sequence, Pool& pool);
+
+    template <typename Visitor>
+    void visit_address_index(const cs::Bytes& prefix, cs::Sequence sequence, uint32_t index, Visitor visitor) const;
+
+    template <typename Visitor>
+    void visit_address(const Storage& storage, uint8_t role, const Address& addr, cs::Sequence sequence, uint32_t index, Visitor visitor) const;
+
     std::shared_ptr<Database> db = nullptr;
     PoolHash last_hash;     // Хеш последнего пула
     size_t count_pool = 0;  // Количество пулов транзакций в хранилище (первоночально заполняется в check)
+    std::atomic<cs::Sequence> indexed_pools{0};  // Количество пулов с начала цепочки, транзакции которых внесены в индекс адресов
 
     void set_last_error(Storage::Error error = Storage::NoError, const ::std::string& message = ::std::string());
     void set_last_error(Storage::Error error, const char* message, ...);
@@ -136,14 +389,20 @@ private:
 
     std::mutex data_lock;
 
-    std::deque<Pool> write_queue;
+    // Очередь записи: пулы сохраняются в базу потоком записи группами, до записи они читаются из очереди
+    std::deque<pending_pool> write_queue;
+    size_t write_queue_size = 0;  // Максимальная длина очереди, 0 - пулы пишутся в вызывающем потоке
+    size_t writing = 0;           // Количество пулов в начале очереди, записываемых сейчас
+    bool write_failed = false;    // Последняя запись пулов завершилась ошибкой, пулы остаются в очереди до повторной записи
     std::mutex write_lock;
-    std::condition_variable write_cond_var;
+    std::condition_variable write_cond_var;    // В очереди новые пулы или поток записи завершается
+    std::condition_variable written_cond_var;  // Пулы записаны, в очереди есть место
 
 private signals:
     ReadBlockSignal read_block_event;
 
-    // TODO: Добавить кеш для хранения последних вычитанных пулов транзакций
+    // Последние вычитанные пулы транзакций
+    ::csdb::priv::pool_cache cache;
 
     friend class ::csdb::Storage;
 };
@@ -183,21 +442,75 @@ void Storage::priv::set_last_error(Storage::Error error, const char* message, ..
     }
 }
 
-bool Storage::priv::rescan(Storage::OpenCallback callback) {
+bool Storage::priv::rescan(const Storage::OpenOptions& opt, Storage::OpenCallback callback) {
     last_hash = {};
     count_pool = 0;
 
+    if (!load_address_index_marker()) {
+        return false;
+    }
+
     heads_t heads;
     tails_t tails;
 
+    // Пулы с номерами меньше first уже учтены клиентом в восстановленном состоянии
+    cs::Sequence first = 0;
+
+    const PoolHash resume_hash = PoolHash::from_binary(cs::Bytes(opt.resume_hash));
+
+    if (!resume_hash.is_empty() && opt.on_resume != nullptr) {
+        if (check_resume_point(resume_hash, opt.resume_sequence)) {
+            bool test_failed = false;
+            const bool resumed = opt.on_resume(&test_failed);
+
+            if (test_failed) {
+                set_last_error(Storage::DataIntegrityError, "Data integrity error: client failed to restore state of pool %d", static_cast<int>(opt.resume_sequence));
+                return false;
+            }
+
+            if (resumed) {
+                first = opt.resume_sequence + 1;
+            }
+        }
+        else {
+            cswarning() << "Storage> pool " << opt.resume_sequence << " differs from resume point, full rescan is required";
+        }
+    }
+
+    if (first > 0) {
+        heads.emplace(resume_hash, head_info_t{first, PoolHash{}});
+        count_pool = first;
+
+        // Пулы, ещё не внесённые в индекс адресов, индексируются без передачи клиенту
+        for (cs::Sequence sequence = indexed_pools; sequence < first; ++sequence) {
+            cs::Bytes data;
+            if (!db->get(static_cast<uint32_t>(sequence + 1), &data)) {
+                set_last_error(Storage::DatabaseError, "Cannot read pool %d: %s", static_cast<int>(sequence), db->last_error_message().c_str());
+                return false;
+            }
+
+            Pool p = Pool::from_binary(std::move(data));
+            if (!p.is_valid() || !index_pool(p)) {
+                set_last_error(Storage::DataIntegrityError, "Data integrity error: Cannot index pool %d.", static_cast<int>(sequence));
+                return false;
+            }
+        }
+    }
+
     Database::IteratorPtr it = db->new_iterator();
     assert(it);
 
+    if (first > 0) {
+        it->seek(block_record_key(first));
+    }
+    else {
+        it->seek_to_first();
+    }
+
     Storage::OpenProgress progress{0};
-    for (it->seek_to_first(); it->is_valid(); it->next()) {
-        cs::Bytes v = it->value();
 
-        Pool p = Pool::from_binary(std::move(v));
+    // Передаёт клиенту очередной декодированный пул; порядок вызовов совпадает с порядком пулов в базе
+    auto apply_pool = [&](const Pool& p) -> bool {
         if (!p.is_valid()) {
             set_last_error(Storage::DataIntegrityError, "Data integrity error: Corrupted pool for key'.");
             return false;
@@ -212,6 +525,10 @@ bool Storage::priv::rescan(Storage::OpenCallback callback) {
             return false;
         }
 
+        if (p.sequence() >= indexed_pools && !index_pool(p)) {
+            return false;
+        }
+
         update_heads_and_tails(heads, tails, p.hash(), p.previous_hash());
         count_pool++;
         progress.poolsProcessed++;
@@ -222,6 +539,47 @@ bool Storage::priv::rescan(Storage::OpenCallback callback) {
                 return false;
             }
         }
+
+        return true;
+    };
+
+    auto check_failed = [this](const Pool& p) {
+        set_last_error(Storage::DataIntegrityError, "Data integrity error: client rejected pool %d", static_cast<int>(p.sequence()));
+    };
+
+    const size_t workers = rescan_workers(opt);
+
+    if (workers == 1) {
+        for (; it->is_valid(); it->next()) {
+            Pool p = Pool::from_binary(it->value());
+
+            if (p.is_valid() && opt.on_decode != nullptr && !opt.on_decode(p)) {
+                check_failed(p);
+                return false;
+            }
+
+            if (!apply_pool(p)) {
+                return false;
+            }
+        }
+    }
+    else {
+        rescan_pipeline pipeline(std::move(it), workers, opt.on_decode);
+        rescan_pipeline::batch_t batch;
+
+        while (pipeline.next(batch)) {
+            for (const auto& p : batch.pools) {
+                // непроверенный пул всегда последний в пакете
+                if (!batch.checked && &p == &batch.pools.back() && p.is_valid()) {
+                    check_failed(p);
+                    return false;
+                }
+
+                if (!apply_pool(p)) {
+                    return false;
+                }
+            }
+        }
     }
 
     // Посмотрим, сколько у нас завершённых цепочек.
@@ -259,22 +617,340 @@ bool Storage::priv::rescan(Storage::OpenCallback callback) {
     return false;
 }
 
+bool Storage::priv::check_resume_point(const PoolHash& hash, cs::Sequence sequence) {
+    cs::Bytes data;
+    if (!db->get(static_cast<uint32_t>(sequence + 1), &data)) {
+        return false;
+    }
+
+    Pool p = Pool::from_binary(std::move(data));
+    return p.is_valid() && p.sequence() == sequence && p.hash() == hash;
+}
+
+bool Storage::priv::load_address_index_marker() {
+    indexed_pools = 0;
+
+    cs::Bytes data;
+    if (!db->getFromAddressIndex(kAddressIndexMarkerKey, &data)) {
+        if (db->last_error() != Database::NotFound) {
+            set_last_error(Storage::DatabaseError, "Cannot read address index: %s", db->last_error_message().c_str());
+            return false;
+        }
+        return true;
+    }
+
+    if (data.size() != sizeof(cs::Sequence)) {
+        set_last_error(Storage::DataIntegrityError, "Data integrity error: corrupted address index marker");
+        return false;
+    }
+
+    indexed_pools = get_big_endian<cs::Sequence>(data.data());
+    return true;
+}
+
+bool Storage::priv::index_pool(const Pool& pool) {
+    const auto& transactions = pool.transactions();
+    const cs::Sequence sequence = pool.sequence();
+
+    Database::ItemList items;
+    items.reserve(transactions.size() * 2 + 1);
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        const Transaction& t = transactions[i];
+        const uint32_t index = static_cast<uint32_t>(i);
+
+        items.emplace_back(address_index_key(address_index_prefix(kAddressIndexSource, t.source()), sequence, index), address_index_value(t.innerID()));
+        items.emplace_back(address_index_key(address_index_prefix(kAddressIndexTarget, t.target()), sequence, index), address_index_value(t.innerID()));
+    }
+
+    const cs::Sequence indexed = std::max(indexed_pools.load(), sequence + 1);
+    cs::Bytes marker;
+    put_big_endian(marker, indexed);
+    items.emplace_back(kAddressIndexMarkerKey, std::move(marker));
+
+    if (!db->updateAddressIndex(items, {})) {
+        set_last_error(Storage::DatabaseError, "Cannot index pool %d: %s", static_cast<int>(sequence), db->last_error_message().c_str());
+        return false;
+    }
+
+    indexed_pools = indexed;
+    return true;
+}
+
+bool Storage::priv::unindex_pool(const Pool& pool) {
+    const auto& transactions = pool.transactions();
+    const cs::Sequence sequence = pool.sequence();
+
+    std::vector<cs::Bytes> keys;
+    keys.reserve(transactions.size() * 2);
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        const Transaction& t = transactions[i];
+        const uint32_t index = static_cast<uint32_t>(i);
+
+        keys.push_back(address_index_key(address_index_prefix(kAddressIndexSource, t.source()), sequence, index));
+        keys.push_back(address_index_key(address_index_prefix(kAddressIndexTarget, t.target()), sequence, index));
+    }
+
+    const cs::Sequence indexed = std::min(indexed_pools.load(), sequence);
+    cs::Bytes marker;
+    put_big_endian(marker, indexed);
+
+    if (!db->updateAddressIndex({{kAddressIndexMarkerKey, std::move(marker)}}, keys)) {
+        set_last_error(Storage::DatabaseError, "Cannot remove pool %d from index: %s", static_cast<int>(sequence), db->last_error_message().c_str());
+        return false;
+    }
+
+    indexed_pools = indexed;
+    return true;
+}
+
+// Индексирует сохранённый пул и предшествующие ему пулы, пропущенные индексом: записанные не по порядку
+// или не внесённые в индекс из-за ошибки. Пока пропуск в цепочке не заполнен, пулы после него не индексируются
+// и находятся запросами по адресу обходом цепочки (\ref visit_address).
+void Storage::priv::index_saved_pool(const Pool& pool) {
+    const cs::Sequence sequence = pool.sequence();
+
+    if (sequence < indexed_pools) {
+        return;
+    }
+
+    for (cs::Sequence skipped = indexed_pools; skipped < sequence; ++skipped) {
+        Pool p;
+        if (!load_saved(skipped, p)) {
+            csdebug() << "Storage> pool #" << skipped << " is not saved yet, address index ends at it";
+            return;
+        }
+
+        if (!index_pool(p)) {
+            return;
+        }
+    }
+
+    if (!index_pool(pool)) {
+        cswarning() << "Storage> address index ends at pool #" << indexed_pools << ", newer pools are looked up in the chain";
+    }
+}
+
+bool Storage::priv::load_saved(cs::Sequence sequence, Pool& pool) {
+    if (find_pending(sequence, pool)) {
+        return true;
+    }
+
+    cs::Bytes data;
+    if (!db->get(static_cast<uint32_t>(sequence + 1), &data)) {
+        return false;
+    }
+
+    pool = Pool::from_binary(std::move(data));
+    return pool.is_valid() && pool.sequence() == sequence;
+}
+
+// Обходит записи индекса с указанным префиксом в порядке убывания, начиная с позиции,
+// непосредственно предшествующей (sequence, index). Обход прекращается, если visitor вернул false.
+template <typename Visitor>
+void Storage::priv::visit_address_index(const cs::Bytes& prefix, cs::Sequence sequence, uint32_t index, Visitor visitor) const {
+    Database::IteratorPtr it = db->new_address_index_iterator();
+    if (!it) {
+        return;
+    }
+
+    it->seek(address_index_key(prefix, sequence, index));
+    if (it->is_valid()) {
+        it->prev();
+    }
+    else {
+        it->seek_to_last();
+    }
+
+    for (; it->is_valid(); it->prev()) {
+        const cs::Bytes key = it->key();
+        if (key.size() != prefix.size() + kAddressIndexPositionSize || !std::equal(prefix.begin(), prefix.end(), key.begin())) {
+            break;
+        }
+
+        const cs::Bytes value = it->value();
+        if (value.size() != sizeof(int64_t)) {
+            break;
+        }
+
+        const uint8_t* position = key.data() + prefix.size();
+        AddressIndexEntry entry{get_big_endian<cs::Sequence>(position), get_big_endian<uint32_t>(position + sizeof(cs::Sequence)),
+                                static_cast<int64_t>(get_big_endian<uint64_t>(value.data()))};
+
+        if (!visitor(entry)) {
+            break;
+        }
+    }
+}
+
+// Обходит транзакции адреса в указанной роли в порядке убывания, начиная с позиции, непосредственно
+// предшествующей (sequence, index): сначала в пулах, ещё не внесённых в индекс (включая очередь записи),
+// обходом цепочки от последнего пула, затем в индексе.
+template <typename Visitor>
+void Storage::priv::visit_address(const Storage& storage, uint8_t role, const Address& addr, cs::Sequence sequence, uint32_t index, Visitor visitor) const {
+    const cs::Sequence indexed = indexed_pools;
+
+    for (Pool pool = storage.pool_load(storage.last_hash()); pool.is_valid() && pool.sequence() >= indexed; pool = storage.pool_load(pool.previous_hash())) {
+        if (pool.sequence() <= sequence) {
+            const auto& transactions = pool.transactions();
+            size_t i = pool.sequence() == sequence ? std::min<size_t>(transactions.size(), index) : transactions.size();
+
+            while (i-- > 0) {
+                const Transaction& t = transactions[i];
+                const Address& address = role == kAddressIndexSource ? t.source() : t.target();
+
+                if (address == addr && !visitor(AddressIndexEntry{pool.sequence(), static_cast<uint32_t>(i), t.innerID()})) {
+                    return;
+                }
+            }
+        }
+
+        if (pool.sequence() == 0) {
+            break;
+        }
+    }
+
+    // пулы, проиндексированные во время обхода цепочки, уже просмотрены
+    if (sequence >= indexed) {
+        sequence = indexed;
+        index = 0;
+    }
+
+    visit_address_index(address_index_prefix(role, addr), sequence, index, visitor);
+}
+
+void Storage::priv::start_writing(size_t queue_size) {
+    stop_writing();
+
+    std::lock_guard<std::mutex> lock(write_lock);
+    write_queue_size = queue_size;
+    write_failed = false;
+    quit = false;
+
+    if (write_queue_size > 0) {
+        write_thread = std::thread(&Storage::priv::write_routine, this);
+    }
+}
+
+void Storage::priv::stop_writing() {
+    if (!write_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(write_lock);
+        quit = true;
+    }
+
+    // очередь дописывается перед завершением потока
+    write_cond_var.notify_one();
+    write_thread.join();
+
+    std::lock_guard<std::mutex> lock(write_lock);
+    write_queue_size = 0;
+}
+
+bool Storage::priv::enqueue(const cs::Bytes& key, const Pool& pool) {
+    std::unique_lock<std::mutex> lock(write_lock);
+    written_cond_var.wait(lock, [this] { return write_queue.size() < write_queue_size || write_failed; });
+
+    // очередь заполнена пулами, которые не удаётся записать
+    if (write_queue.size() >= write_queue_size) {
+        return false;
+    }
+
+    write_queue.push_back(pending_pool{key, pool});
+    write_cond_var.notify_one();
+    return true;
+}
+
+bool Storage::priv::wait_written() {
+    std::unique_lock<std::mutex> lock(write_lock);
+    written_cond_var.wait(lock, [this] { return write_queue.empty() || write_failed; });
+    return write_queue.empty();
+}
+
+bool Storage::priv::find_pending(const cs::Bytes& key, Pool& pool) {
+    std::lock_guard<std::mutex> lock(write_lock);
+    auto it = std::find_if(write_queue.begin(), write_queue.end(), [&](const pending_pool& pending) { return pending.key == key; });
+
+    if (it == write_queue.end()) {
+        return false;
+    }
+
+    pool = it->pool;
+    return true;
+}
+
+bool Storage::priv::find_pending(cs::Sequence sequence, Pool& pool) {
+    std::lock_guard<std::mutex> lock(write_lock);
+    auto it = std::find_if(write_queue.begin(), write_queue.end(), [&](const pending_pool& pending) { return pending.pool.sequence() == sequence; });
+
+    if (it == write_queue.end()) {
+        return false;
+    }
+
+    pool = it->pool;
+    return true;
+}
+
 void Storage::priv::write_routine() {
     std::unique_lock<std::mutex> lock(write_lock);
-    while (!quit) {
-        write_cond_var.wait(lock);
-        while (!write_queue.empty()) {
-            Pool& pool = write_queue.front();
-            if (!pool.is_read_only()) {
-                if (!pool.compose()) {
-                    set_last_error(Storage::DataIntegrityError, "Pool passed to storage is not composed and failed to compose now");
-                }
+
+    while (true) {
+        write_cond_var.wait(lock, [this] { return quit || !write_queue.empty(); });
+
+        if (write_queue.empty()) {
+            break;
+        }
+
+        // пулы остаются в очереди (и читаются из неё), пока не записаны
+        writing = std::min(write_queue.size(), write_group_size);
+
+        Database::PoolItemList items;
+        std::vector<Pool> pools;
+        items.reserve(writing);
+        pools.reserve(writing);
+
+        for (size_t i = 0; i < writing; ++i) {
+            const Pool& pool = write_queue[i].pool;
+            items.push_back(Database::PoolItem{write_queue[i].key, static_cast<uint32_t>(pool.sequence()), pool.to_binary()});
+            pools.push_back(pool);
+        }
+
+        lock.unlock();
+
+        const bool written = db->put_batch(items);
+
+        if (written) {
+            for (const auto& pool : pools) {
+                index_saved_pool(pool);
             }
-            const PoolHash hash = pool.hash();
+        }
+        else {
+            cserror() << "Storage> cannot write " << items.size() << " pools from #" << pools.front().sequence() << ", will retry: " << db->last_error_message();
+        }
+
+        lock.lock();
+
+        // пулы, которые не удалось записать, остаются в очереди и читаются из неё до повторной записи
+        if (written) {
+            write_queue.erase(write_queue.begin(), write_queue.begin() + static_cast<std::ptrdiff_t>(writing));
+        }
+
+        writing = 0;
+        write_failed = !written;
 
-            db->put(hash.to_binary(), static_cast<uint32_t>(pool.sequence()), pool.to_binary());
+        written_cond_var.notify_all();
+
+        if (!written) {
+            if (quit) {
+                cserror() << "Storage> " << write_queue.size() << " pools are not written";
+                break;
+            }
 
-            write_queue.pop_front();
+            write_cond_var.wait_for(lock, write_retry_delay, [this] { return quit; });
         }
     }
 }
@@ -346,6 +1022,7 @@ bool Storage::open(const OpenOptions& opt, OpenCallback callback) {
         return false;
     }
 
+    d->stop_writing();
     d->db = opt.db;
 
     if (!d->db->is_open()) {
@@ -353,31 +1030,63 @@ bool Storage::open(const OpenOptions& opt, OpenCallback callback) {
         return false;
     }
 
-    if (!d->rescan(callback)) {
+    d->cache.clear();
+    d->cache.set_max_size(opt.pool_cache_size);
+
+    if (opt.rebuild_address_index && !d->db->clearAddressIndex()) {
+        d->set_last_error(DatabaseError, "Cannot clear address index: %s", d->db->last_error_message().c_str());
         d->db.reset();
         return false;
     }
 
+    if (!d->rescan(opt, callback)) {
+        d->db.reset();
+        return false;
+    }
+
+    d->start_writing(opt.write_queue_size);
+
     d->set_last_error();
     return true;
 }
 
 bool Storage::open(const ::std::string& path_to_base, OpenCallback callback) {
+    return open(path_to_base, OpenOptions{}, callback);
+}
+
+bool Storage::open(const ::std::string& path_to_base, OpenOptions opt, OpenCallback callback) {
     ::std::string path{path_to_base};
     if (path.empty()) {
         path = ::csdb::internal::app_data_path() + "/CREDITS";
     }
 
-    auto db{::std::make_shared<::csdb::DatabaseBerkeleyDB>()};
-    db->open(path);
-
-    d->write_thread = std::thread(&Storage::priv::write_routine, d.get());
+    if (opt.backend == Backend::LMDB) {
+#ifdef CSDB_WITH_LMDB
+        auto db{::std::make_shared<::csdb::DatabaseLMDB>()};
+        db->open(path);
+        opt.db = db;
+#else
+        d->set_last_error(DatabaseError, "LMDB backend is not built in");
+        return false;
+#endif
+    }
+    else {
+        auto db{::std::make_shared<::csdb::DatabaseBerkeleyDB>()};
+        db->open(path);
+        opt.db = db;
+    }
 
-    return open(OpenOptions{db}, callback);
+    return open(opt, callback);
 }
 
 void Storage::close() {
+    if (d->db) {
+        flush();
+    }
+
+    d->stop_writing();
     d->db.reset();
+    d->cache.clear();
     d->set_last_error();
 }
 
@@ -407,19 +1116,29 @@ bool Storage::pool_save(Pool pool) {
     }
 
     const PoolHash hash = pool.hash();
+    const cs::Bytes key = hash.to_binary();
+    Pool pending;
 
-    if (d->db->get(hash.to_binary())) {
+    if (d->find_pending(key, pending) || d->db->get(key)) {
         d->set_last_error(InvalidParameter, "%s: Pool already pressent [hash: %s]", funcName(), hash.to_string().c_str());
         return false;
     }
-    /*
-      {
-        std::unique_lock<std::mutex> lock(d->write_lock);
-        d->write_queue.push_back(pool);
-        d->write_cond_var.notify_one();
-      }
-    */
-    d->db->put(hash.to_binary(), static_cast<uint32_t>(pool.sequence()), pool.to_binary());
+
+    if (d->write_thread.joinable()) {
+        // пул записывается потоком записи, до этого он доступен из очереди
+        if (!d->enqueue(key, pool)) {
+            d->set_last_error(DatabaseError, "%s: Cannot write pool [hash: %s], write queue is full of not written pools", funcName(), hash.to_string().c_str());
+            return false;
+        }
+    }
+    else {
+        if (!d->db->put(key, static_cast<uint32_t>(pool.sequence()), pool.to_binary())) {
+            d->set_last_error(DatabaseError, "%s: Cannot write pool [hash: %s]", funcName(), hash.to_string().c_str());
+            return false;
+        }
+
+        d->index_saved_pool(pool);
+    }
 
     {
         std::unique_lock<std::mutex> lock(d->data_lock);
@@ -445,26 +1164,27 @@ Pool Storage::pool_load_internal(const PoolHash& hash, const bool metaOnly, size
     }
 
     Pool res;
+    const cs::Bytes key = hash.to_binary();
+
+    // в кеше полные пулы, они подходят и для чтения только заголовка
+    if (d->cache.get(key, res)) {
+        trxCnt = res.transactions_count();
+        d->set_last_error();
+        return res;
+    }
+
+    // пул удаляется из очереди записи только после записи в базу
+    const uint64_t epoch = d->cache.epoch();
     bool needParseData = true;
     cs::Bytes data;
 
-    if (!d->db->get(hash.to_binary(), &data)) {
-        {
-            std::unique_lock<std::mutex> lock2(d->write_lock);
-            for (auto& poolToWrite : d->write_queue) {
-                if (poolToWrite.hash() == hash) {
-                    res = poolToWrite;
-                    needParseData = false;
-                    trxCnt = res.transactions().size();
-                    break;
-                }
-            }
-        }
-
-        if (needParseData && !d->db->get(hash.to_binary(), &data)) {
-            d->set_last_error(DatabaseError);
-            return Pool{};
-        }
+    if (d->find_pending(key, res)) {
+        needParseData = false;
+        trxCnt = res.transactions_count();
+    }
+    else if (!d->db->get(key, &data)) {
+        d->set_last_error(DatabaseError);
+        return Pool{};
     }
 
     if (needParseData) {
@@ -472,7 +1192,9 @@ Pool Storage::pool_load_internal(const PoolHash& hash, const bool metaOnly, size
             res = Pool::meta_from_binary(std::move(data), trxCnt);
         }
         else {
+            const size_t size = data.size();
             res = Pool::from_binary(std::move(data));
+            d->cache.put(res, key, size, epoch);
         }
     }
 
@@ -488,30 +1210,42 @@ Pool Storage::pool_load_internal(const PoolHash& hash, const bool metaOnly, size
 }
 
 bool Storage::write_queue_search(const PoolHash& hash, Pool& res_pool) const {
-    std::unique_lock<std::mutex> lock(d->write_lock, std::defer_lock);
-
-    if (!d->write_queue.empty() && lock.try_lock()) {
-        auto pos = std::find_if(d->write_queue.begin(), d->write_queue.end(), [&](Pool& pool) { return hash == pool.hash(); });
-
-        if (pos != d->write_queue.cend()) {
-            res_pool = *pos;
-            return true;
-        }
-    }
-    return false;
+    return d->find_pending(hash.to_binary(), res_pool);
 }
 
 bool Storage::write_queue_pop(Pool& res_pool) {
-    std::unique_lock<std::mutex> lock(d->write_lock);
+    std::lock_guard<std::mutex> lock(d->write_lock);
 
-    if (!d->write_queue.empty()) {
-        res_pool = d->write_queue.back();
+    // пулы, которые уже пишутся в базу, из очереди не удаляются
+    if (d->write_queue.size() > d->writing) {
+        res_pool = d->write_queue.back().pool;
         d->write_queue.pop_back();
+        d->written_cond_var.notify_all();
         return true;
     }
     return false;
 }
 
+bool Storage::flush() {
+    if (!isOpen()) {
+        d->set_last_error(NotOpen);
+        return false;
+    }
+
+    if (!d->wait_written()) {
+        d->set_last_error(DatabaseError, "%s: Some pools are not written", funcName());
+        return false;
+    }
+
+    if (!d->db->sync()) {
+        d->set_last_error(DatabaseError, "%s: Cannot sync database: %s", funcName(), d->db->last_error_message().c_str());
+        return false;
+    }
+
+    d->set_last_error();
+    return true;
+}
+
 Pool Storage::pool_load(const PoolHash& hash) const {
     size_t size;
     return pool_load_internal(hash, false, size);
@@ -524,29 +1258,32 @@ Pool Storage::pool_load(const cs::Sequence sequence) const {
     }
 
     Pool res;
+
+    // номер записи в базе на единицу больше номера пула
+    if (sequence > 0 && d->cache.get(sequence - 1, res)) {
+        d->set_last_error();
+        return res;
+    }
+
+    const uint64_t epoch = d->cache.epoch();
     bool needParseData = true;
     cs::Bytes data;
 
-    if (!d->db->get(static_cast<uint32_t>(sequence), &data)) {
-        {
-            std::unique_lock<std::mutex> lock2(d->write_lock);
-            for (auto& poolToWrite : d->write_queue) {
-                if (poolToWrite.sequence() == sequence) {
-                    res = poolToWrite;
-                    needParseData = false;
-                    break;
-                }
-            }
-        }
-
-        if (needParseData && !d->db->get(static_cast<uint32_t>(sequence), &data)) {
-            d->set_last_error(DatabaseError);
-            return Pool{};
-        }
+    if (sequence > 0 && d->find_pending(sequence - 1, res)) {
+        needParseData = false;
+    }
+    else if (!d->db->get(static_cast<uint32_t>(sequence), &data)) {
+        d->set_last_error(DatabaseError);
+        return Pool{};
     }
 
     if (needParseData) {
+        const size_t size = data.size();
         res = Pool::from_binary(std::move(data));
+
+        if (res.is_valid()) {
+            d->cache.put(res, res.hash().to_binary(), size, epoch);
+        }
     }
 
     if (!res.is_valid()) {
@@ -559,6 +1296,29 @@ Pool Storage::pool_load(const cs::Sequence sequence) const {
     return res;
 }
 
+cs::Bytes Storage::pool_load_binary(const cs::Sequence sequence) const {
+    if (!isOpen()) {
+        d->set_last_error(NotOpen);
+        return cs::Bytes{};
+    }
+
+    cs::Bytes data;
+    Pool pending;
+
+    if (sequence > 0 && d->find_pending(sequence - 1, pending)) {
+        d->set_last_error();
+        return pending.to_binary();
+    }
+
+    if (!d->db->get(static_cast<uint32_t>(sequence), &data)) {
+        d->set_last_error(DatabaseError);
+        return cs::Bytes{};
+    }
+
+    d->set_last_error();
+    return data;
+}
+
 Pool Storage::pool_load_meta(const PoolHash& hash, size_t& cnt) const {
     if (!isOpen()) {
         d->set_last_error(NotOpen);
@@ -573,16 +1333,25 @@ Pool Storage::pool_load_meta(const PoolHash& hash, size_t& cnt) const {
     Pool res{};
     bool found = write_queue_search(hash, res);
     if (found) {
+        cnt = res.transactions_count();
+        d->set_last_error();
         return res;
     }
 
-    cs::Bytes data;
-    if (!d->db->get(hash.to_binary(), &data)) {
+    const cs::Bytes key = hash.to_binary();
+    if (d->cache.get(key, res)) {
+        cnt = res.transactions_count();
+        d->set_last_error();
+        return res;
+    }
+
+    Database::View view;
+    if (!d->db->get_view(key, &view)) {
         d->set_last_error(DatabaseError);
         return Pool{};
     }
 
-    res = Pool::meta_from_binary(std::move(data), cnt);
+    res = Pool::meta_from_view(view.data, cnt);
     if (!res.is_valid()) {
         d->set_last_error(DataIntegrityError, "%s: Error decoding pool [hash: %s]", funcName(), hash.to_string().c_str());
     }
@@ -603,10 +1372,18 @@ Pool Storage::pool_remove_last() {
     bool found = write_queue_pop(res);
 
     if (found) {
+        std::lock_guard<std::mutex> lock(d->data_lock);
+        --d->count_pool;
         d->last_hash = res.previous_hash();
         return res;
     }
 
+    // последний пул уже пишется в базу
+    if (!d->wait_written()) {
+        d->set_last_error(DatabaseError, "%s: Some pools are not written", funcName());
+        return Pool{};
+    }
+
     if (last_hash().is_empty()) {
         d->set_last_error(InvalidParameter, "%s: Empty hash passed", funcName());
         return Pool{};
@@ -628,58 +1405,56 @@ Pool Storage::pool_remove_last() {
 
     d->db->remove(last_hash().to_binary());
 
-    --d->count_pool;
-    d->last_hash = res.previous_hash();
+    if (res.is_valid()) {
+        d->cache.remove(res.sequence());
+    }
+
+    if (res.is_valid() && res.sequence() < d->indexed_pools) {
+        d->unindex_pool(res);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(d->data_lock);
+        --d->count_pool;
+        d->last_hash = res.previous_hash();
+    }
 
     return res;
 }
 
+Storage::PoolCacheStats Storage::pool_cache_stats() const {
+    return d->cache.stats();
+}
+
 Wallet Storage::wallet(const Address& addr) const {
     return Wallet::get(addr);
 }
 
 bool Storage::get_from_blockchain(const Address& addr /*input*/, const int64_t& innerId /*input*/, Transaction& trx /*output*/) const {
-    Pool curPool;
-    cs::Sequence curIdx = cs::numeric_cast<cs::Sequence>(innerId);
+    if (!isOpen()) {
+        d->set_last_error(NotOpen);
+        return false;
+    }
+
     bool is_in_blockchain = false;
 
-    auto nextIt = [this, &curPool, &curIdx]() -> bool {
-        if (curPool.is_valid()) {
-            if (curIdx) {
-                curIdx--;
-                return true;
-            }
-            else {
-                do {
-                    curPool = pool_load(curPool.previous_hash());
-                } while (curPool.is_valid() && !(curPool.transactions_count()));
-                if (curPool.is_valid()) {
-                    curIdx = static_cast<cs::Sequence>(curPool.transactions_count() - 1);
-                    return true;
-                }
-            }
+    // innerID хранится в значении записи индекса, поэтому пул загружается только для найденной транзакции
+    auto visitor = [this, &innerId, &trx, &is_in_blockchain](const AddressIndexEntry& entry) {
+        if (entry.innerId != innerId) {
+            return true;
         }
-        else {
-            curPool = pool_load(last_hash());
-            while (curPool.is_valid() && !(curPool.transactions_count())) {
-                curPool = pool_load(curPool.previous_hash());
-            }
-            if (curPool.is_valid()) {
-                curIdx = static_cast<cs::Sequence>(curPool.transactions_count() - 1);
-                return true;
-            }
+
+        const Pool pool = pool_load(entry.sequence + 1);
+        const Transaction found = pool.transaction(static_cast<size_t>(entry.index));
+        if (found.is_valid()) {
+            trx = found;
+            is_in_blockchain = true;
         }
+
         return false;
     };
 
-    do {
-        const Transaction trx_curr = curPool.transaction(curIdx);
-        if (trx_curr.source() == addr && trx_curr.innerID() == innerId) {
-            is_in_blockchain = true;
-            trx = trx_curr;
-            break;
-        }
-    } while (nextIt());
+    d->visit_address(*this, kAddressIndexSource, addr, std::numeric_limits<cs::Sequence>::max(), std::numeric_limits<uint32_t>::max(), visitor);
 
     return is_in_blockchain;
 }
@@ -690,59 +1465,71 @@ const ReadBlockSignal& Storage::readBlockEvent() const {
 
 std::vector<Transaction> Storage::transactions(const Address& addr, size_t limit, const TransactionID& offset) const {
     std::vector<Transaction> res;
-    res.reserve(limit);
 
-    Pool curPool;
-    cs::Sequence curIdx = 0;
-
-    auto seekIt = [this, &curPool, &curIdx](const TransactionID& id) -> bool {
-        if (id.is_valid()) {
-            curPool = pool_load(id.pool_hash());
-            if (curPool.is_valid() && id.index() < curPool.transactions_count()) {
-                curIdx = id.index();
-                return true;
-            }
+    if (!isOpen()) {
+        d->set_last_error(NotOpen);
+        return res;
+    }
+
+    if (limit == 0) {
+        return res;
+    }
+
+    cs::Sequence upperSequence = std::numeric_limits<cs::Sequence>::max();
+    uint32_t upperIndex = std::numeric_limits<uint32_t>::max();
+
+    if (offset.is_valid()) {
+        size_t count = 0;
+        const Pool offsetPool = pool_load_meta(offset.pool_hash(), count);
+        if (!offsetPool.is_valid() || offset.index() >= count) {
+            return res;
         }
-        return false;
+
+        upperSequence = offsetPool.sequence();
+        upperIndex = static_cast<uint32_t>(offset.index());
+    }
+
+    // собираем не более limit позиций по каждой из ролей адреса, затем сливаем их по убыванию
+    auto collect = [this, &addr, limit, upperSequence, upperIndex](uint8_t role) {
+        std::vector<AddressIndexEntry> entries;
+        d->visit_address(*this, role, addr, upperSequence, upperIndex, [&entries, limit](const AddressIndexEntry& entry) {
+            entries.push_back(entry);
+            return entries.size() < limit;
+        });
+        return entries;
     };
 
-    auto nextIt = [this, &curPool, &curIdx]() -> bool {
-        if (curPool.is_valid()) {
-            if (curIdx) {
-                curIdx--;
-                return true;
-            }
-            else {
-                do {
-                    curPool = pool_load(curPool.previous_hash());
-                } while (curPool.is_valid() && !(curPool.transactions_count()));
-                if (curPool.is_valid()) {
-                    curIdx = static_cast<cs::Sequence>(curPool.transactions_count() - 1);
-                    return true;
-                }
-            }
-        }
-        else {
-            curPool = pool_load(last_hash());
-            while (curPool.is_valid() && !(curPool.transactions_count())) {
-                curPool = pool_load(curPool.previous_hash());
-            }
-            if (curPool.is_valid()) {
-                curIdx = static_cast<cs::Sequence>(curPool.transactions_count() - 1);
-                return true;
-            }
-        }
-        return false;
+    const std::vector<AddressIndexEntry> sources = collect(kAddressIndexSource);
+    const std::vector<AddressIndexEntry> targets = collect(kAddressIndexTarget);
+
+    auto greater = [](const AddressIndexEntry& lhs, const AddressIndexEntry& rhs) {
+        return std::tie(lhs.sequence, lhs.index) > std::tie(rhs.sequence, rhs.index);
+    };
+    auto equal = [](const AddressIndexEntry& lhs, const AddressIndexEntry& rhs) {
+        return lhs.sequence == rhs.sequence && lhs.index == rhs.index;
     };
 
-    if (offset.is_valid())
-        if (!seekIt(offset))
-            return res;
+    std::vector<AddressIndexEntry> positions;
+    positions.reserve(sources.size() + targets.size());
+    std::merge(sources.begin(), sources.end(), targets.begin(), targets.end(), std::back_inserter(positions), greater);
+    positions.erase(std::unique(positions.begin(), positions.end(), equal), positions.end());
 
-    while (res.size() < limit && nextIt()) {
-        const Transaction t = curPool.transaction(curIdx);
-        if ((t.source() == addr) || (t.target() == addr))
+    if (positions.size() > limit) {
+        positions.resize(limit);
+    }
+
+    res.reserve(positions.size());
+
+    Pool curPool;
+    for (const auto& position : positions) {
+        if (!curPool.is_valid() || curPool.sequence() != position.sequence) {
+            curPool = pool_load(position.sequence + 1);
+        }
+
+        Transaction t = curPool.transaction(static_cast<size_t>(position.index));
+        if (t.is_valid()) {
             res.push_back(t);
+        }
     }
 
     return res;
@@ -758,32 +1545,76 @@ Transaction Storage::transaction(const TransactionID& id) const {
 }
 
 Transaction Storage::get_last_by_source(Address source) const noexcept {
-    Pool curr = pool_load(last_hash());
+    return get_last_by_role(kAddressIndexSource, source);
+}
 
-    while (curr.is_valid()) {
-        const auto& t = curr.get_last_by_source(source);
-        if (t.is_valid())
-            return t;
+Transaction Storage::get_last_by_target(Address target) const noexcept {
+    return get_last_by_role(kAddressIndexTarget, target);
+}
 
-        curr = pool_load(curr.previous_hash());
+Transaction Storage::get_last_by_role(uint8_t role, const Address& addr) const noexcept {
+    if (!isOpen()) {
+        d->set_last_error(NotOpen);
+        return Transaction{};
     }
 
-    return Transaction{};
+    Transaction res;
+    auto visitor = [this, &res](const AddressIndexEntry& entry) {
+        res = pool_load(entry.sequence + 1).transaction(static_cast<size_t>(entry.index));
+        return false;
+    };
+
+    d->visit_address(*this, role, addr, std::numeric_limits<cs::Sequence>::max(), std::numeric_limits<uint32_t>::max(), visitor);
+
+    return res;
 }
 
-Transaction Storage::get_last_by_target(Address target) const noexcept {
-    Pool curr = pool_load(last_hash());
+bool Storage::rebuild_address_index(OpenCallback callback) {
+    if (!isOpen()) {
+        d->set_last_error(NotOpen);
+        return false;
+    }
 
-    while (curr.is_valid()) {
-        const auto& t = curr.get_last_by_target(target);
-        if (t.is_valid()) {
-            return t;
+    // пулы из очереди записи индексируются потоком записи
+    if (!d->wait_written()) {
+        d->set_last_error(DatabaseError, "%s: Some pools are not written", funcName());
+        return false;
+    }
+
+    if (!d->db->clearAddressIndex()) {
+        d->set_last_error(DatabaseError, "%s: Cannot clear address index", funcName());
+        return false;
+    }
+
+    d->indexed_pools = 0;
+
+    Database::IteratorPtr it = d->db->new_iterator();
+    if (!it) {
+        d->set_last_error(DatabaseError);
+        return false;
+    }
+
+    OpenProgress progress{0};
+    for (it->seek_to_first(); it->is_valid(); it->next()) {
+        Pool p = Pool::from_binary(it->value());
+        if (!p.is_valid()) {
+            d->set_last_error(DataIntegrityError, "%s: Corrupted pool", funcName());
+            return false;
         }
 
-        curr = pool_load(curr.previous_hash());
+        if (!d->index_pool(p)) {
+            return false;
+        }
+
+        ++progress.poolsProcessed;
+        if (callback != nullptr && callback(progress)) {
+            d->set_last_error(UserCancelled);
+            return false;
+        }
     }
 
-    return Transaction{};
+    d->set_last_error();
+    return true;
 }
 
 #ifdef TRANSACTIONS_INDEX
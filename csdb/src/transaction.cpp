@@ -263,7 +263,13 @@ bool Transaction::verify_signature(const cs::PublicKey& public_key) const {
 }
 
 std::vector<uint8_t> Transaction::to_byte_stream_for_sig() const {
-    ::csdb::priv::obstream os;
+    std::vector<uint8_t> result;
+    to_byte_stream_for_sig(result);
+    return result;
+}
+
+void Transaction::to_byte_stream_for_sig(cs::Bytes& buffer) const {
+    ::csdb::priv::obstream os(std::move(buffer));
     const priv* data = d.constData();
     uint8_t innerID[6];
     {
@@ -292,14 +298,13 @@ std::vector<uint8_t> Transaction::to_byte_stream_for_sig() const {
     decltype(data->user_fields_) custom_user_fields(data->user_fields_.lower_bound(0), data->user_fields_.end());
     if (custom_user_fields.size()) {
         os.put_smart(custom_user_fields);
-        auto buf = os.buffer();
-        return buf;
     }
     else {
         uint8_t num_user_fields = 0;
         os.put(num_user_fields);
-        return os.buffer();
     }
+
+    buffer = os.release();
 }
 
 void Transaction::put(::csdb::priv::obstream& os) const {
@@ -0,0 +1,154 @@
+// Перенос хранилища между драйверами базы данных: все пулы и индекс адресов копируются
+// из исходной базы в новую группами в одной транзакции.
+// usage: csdb_migrate <berkeleydb|lmdb> <source path> <berkeleydb|lmdb> <target path>
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "csdb/database_berkeleydb.hpp"
+#include "csdb/database_lmdb.hpp"
+#include "csdb/pool.hpp"
+
+namespace {
+constexpr size_t group_size = 256;
+
+std::shared_ptr<csdb::Database> open_database(const std::string& backend, const std::string& path) {
+    if (backend == "berkeleydb") {
+        auto db = std::make_shared<csdb::DatabaseBerkeleyDB>();
+        db->open(path);
+        return db;
+    }
+
+    if (backend == "lmdb") {
+        auto db = std::make_shared<csdb::DatabaseLMDB>();
+        db->open(path);
+        return db;
+    }
+
+    std::cerr << "unknown backend " << backend << std::endl;
+    return nullptr;
+}
+
+bool copy_pools(csdb::Database& source, csdb::Database& target, size_t& count) {
+    csdb::Database::IteratorPtr it = source.new_iterator();
+    if (!it) {
+        std::cerr << "cannot read pools: " << source.last_error_message() << std::endl;
+        return false;
+    }
+
+    csdb::Database::PoolItemList group;
+    group.reserve(group_size);
+
+    for (it->seek_to_first(); it->is_valid(); it->next()) {
+        cs::Bytes data = it->value();
+        const csdb::Pool pool = csdb::Pool::from_binary(cs::Bytes(data));
+
+        if (!pool.is_valid()) {
+            std::cerr << "cannot decode pool after #" << count << std::endl;
+            return false;
+        }
+
+        group.push_back(csdb::Database::PoolItem{pool.hash().to_binary(), static_cast<uint32_t>(pool.sequence()), std::move(data)});
+
+        if (group.size() == group_size) {
+            if (!target.put_batch(group)) {
+                std::cerr << "cannot write pools: " << target.last_error_message() << std::endl;
+                return false;
+            }
+
+            count += group.size();
+            group.clear();
+            std::cout << '\r' << count << " pools" << std::flush;
+        }
+    }
+
+    if (!group.empty() && !target.put_batch(group)) {
+        std::cerr << "cannot write pools: " << target.last_error_message() << std::endl;
+        return false;
+    }
+
+    count += group.size();
+    std::cout << '\r' << count << " pools" << std::endl;
+    return true;
+}
+
+bool copy_address_index(csdb::Database& source, csdb::Database& target, size_t& count) {
+    csdb::Database::IteratorPtr it = source.new_address_index_iterator();
+    if (!it) {
+        std::cerr << "cannot read address index: " << source.last_error_message() << std::endl;
+        return false;
+    }
+
+    csdb::Database::ItemList group;
+    const std::vector<cs::Bytes> nothing_to_remove;
+
+    for (it->seek_to_first(); it->is_valid(); it->next()) {
+        group.emplace_back(it->key(), it->value());
+
+        if (group.size() == group_size * 16) {
+            if (!target.updateAddressIndex(group, nothing_to_remove)) {
+                std::cerr << "cannot write address index: " << target.last_error_message() << std::endl;
+                return false;
+            }
+
+            count += group.size();
+            group.clear();
+        }
+    }
+
+    if (!group.empty() && !target.updateAddressIndex(group, nothing_to_remove)) {
+        std::cerr << "cannot write address index: " << target.last_error_message() << std::endl;
+        return false;
+    }
+
+    count += group.size();
+    std::cout << count << " address index records" << std::endl;
+    return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 5) {
+        std::cerr << "usage: csdb_migrate <berkeleydb|lmdb> <source path> <berkeleydb|lmdb> <target path>" << std::endl;
+        return 1;
+    }
+
+    auto source = open_database(argv[1], argv[2]);
+    auto target = open_database(argv[3], argv[4]);
+
+    if (!source || !source->is_open()) {
+        std::cerr << "cannot open source database " << argv[2] << std::endl;
+        return 1;
+    }
+
+    if (!target || !target->is_open()) {
+        std::cerr << "cannot open target database " << argv[4] << std::endl;
+        return 1;
+    }
+
+    csdb::Database::IteratorPtr target_it = target->new_iterator();
+    if (target_it) {
+        target_it->seek_to_first();
+    }
+
+    if (!target_it || target_it->is_valid()) {
+        std::cerr << "target database should be empty" << std::endl;
+        return 1;
+    }
+    target_it.reset();
+
+    size_t pools = 0;
+    size_t records = 0;
+
+    if (!copy_pools(*source, *target, pools) || !copy_address_index(*source, *target, records)) {
+        return 1;
+    }
+
+    if (!target->sync()) {
+        std::cerr << "cannot sync target database: " << target->last_error_message() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
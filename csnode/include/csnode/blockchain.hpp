@@ -5,6 +5,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 #include <fstream>
@@ -36,6 +37,7 @@ class WalletsIds;
 class Fee;
 class TransactionsPacket;
 class BlockValidator;
+class StateSnapshot;
 
 /** @brief   The new block signal emits when finalizeBlock() occurs just before recordBlock() */
 using StoreBlockSignal = cs::Signal<void(const csdb::Pool&)>;
@@ -43,6 +45,13 @@ using StoreBlockSignal = cs::Signal<void(const csdb::Pool&)>;
 /** @brief   The write block or remove block signal emits when block is flushed to disk */
 using ChangeBlockSignal = cs::Signal<void(const cs::Sequence)>;
 using ReadBlockSignal = csdb::ReadBlockSignal;
+
+/** @brief The save state signal emits when state snapshot is made, every reader of blocks from DB adds own section to snapshot */
+using SaveStateSignal = cs::Signal<void(cs::StateSnapshot&)>;
+
+/** @brief The load state signal emits on start instead of reading blocks included into snapshot, caller assigns failed to true if
+ * unable to restore own state */
+using LoadStateSignal = cs::Signal<void(const cs::StateSnapshot&, bool* failed)>;
 }  // namespace cs
 
 class BlockChain {
@@ -183,6 +192,12 @@ public signals:
 
     const cs::ReadBlockSignal& readBlockEvent() const;
 
+    /** @brief The save state event. Raised when in-memory state built from blocks is stored to snapshot file */
+    cs::SaveStateSignal saveStateEvent;
+
+    /** @brief The load state event. Raised on start if state is restored from snapshot file, readBlockEvent() is raised only for blocks after it */
+    cs::LoadStateSignal loadStateEvent;
+
 public slots:
 
     // prototype is void (csdb::Transaction)
@@ -204,6 +219,8 @@ public:
     csdb::Pool loadBlock(const csdb::PoolHash&) const;
     csdb::Pool loadBlock(const cs::Sequence sequence) const;
     csdb::Pool loadBlockMeta(const csdb::PoolHash&, size_t& cnt) const;
+    // serialized block as stored, empty if not found
+    cs::Bytes loadBlockBinary(const cs::Sequence sequence) const;
     csdb::Transaction loadTransaction(const csdb::TransactionID&) const;
     void iterateOverWallets(const std::function<bool(const cs::WalletsCache::WalletData::Address&, const cs::WalletsCache::WalletData&)>);
     csdb::Pool getLastBlock() const {
@@ -263,6 +280,12 @@ private:
     void onReadFromDB(csdb::Pool block, bool* shouldStop);
     bool postInitFromDB();
 
+    // state snapshot is made every StateSnapshotPeriod blocks to skip reading them on the next start
+    static constexpr cs::Sequence StateSnapshotPeriod = 10000;
+
+    void saveStateSnapshot(cs::Sequence sequence, const csdb::PoolHash& hash);
+    bool restoreStateSnapshot(const cs::StateSnapshot& snapshot, bool* failed);
+
     template <typename WalletCacheProcessor>
     bool updateWalletIds(const csdb::Pool& pool, WalletCacheProcessor& proc);
     bool insertNewWalletId(const csdb::Address& newWallAddress, WalletId newWalletId, cs::WalletsCache::Initer& initer);
@@ -287,6 +310,9 @@ private:
 
     mutable std::recursive_mutex dbLock_;
     csdb::Storage storage_;
+    std::string snapshotPath_;
+    // flushes storage and writes state snapshot file not to delay the block recording
+    std::thread snapshotThread_;
 
     std::unique_ptr<cs::BlockHashes> blockHashes_;
 
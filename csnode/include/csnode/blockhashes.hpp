@@ -38,6 +38,10 @@ public:
 
     const std::vector<csdb::PoolHash>& getHashes() const;
 
+    // to store hashes into the state snapshot
+    cs::Bytes toBinary() const;
+    bool fromBinary(const cs::Bytes& data);
+
 private:
     std::vector<csdb::PoolHash> hashes_;
 
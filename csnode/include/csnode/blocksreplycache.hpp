@@ -0,0 +1,64 @@
+#ifndef BLOCKS_REPLY_CACHE_HPP
+#define BLOCKS_REPLY_CACHE_HPP
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <csnode/nodecore.hpp>
+#include <lib/system/common.hpp>
+
+namespace cs {
+///
+/// LZ4 compressed replies to block requests recently sent to syncing neighbours.
+/// Replies are keyed by the requested sequences, least recently used ones are evicted
+/// when total size of compressed data exceeds the limit.
+///
+class BlocksReplyCache {
+public:
+    struct Frame {
+        // size of serialized blocks before compression
+        std::size_t binSize = 0;
+        std::size_t blocksCount = 0;
+        cs::Bytes data;
+    };
+
+    using FramePtr = std::shared_ptr<const Frame>;
+
+    explicit BlocksReplyCache(std::size_t maxBytes);
+
+    // returns nullptr if reply is not cached
+    FramePtr find(const cs::PoolsRequestedSequences& sequences);
+    void insert(const cs::PoolsRequestedSequences& sequences, FramePtr frame);
+
+    // drops all replies containing blocks starting from sequence
+    void removeFrom(cs::Sequence sequence);
+
+    std::size_t hits() const {
+        return hits_;
+    }
+
+    std::size_t misses() const {
+        return misses_;
+    }
+
+private:
+    using Entries = std::list<std::pair<cs::PoolsRequestedSequences, FramePtr>>;
+
+    void erase(Entries::iterator it);
+
+    const std::size_t maxBytes_;
+    std::size_t bytes_ = 0;
+
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+
+    // most recently used first
+    Entries entries_;
+    std::map<cs::PoolsRequestedSequences, Entries::iterator> index_;
+    std::mutex mutex_;
+};
+}  // namespace cs
+
+#endif  // BLOCKS_REPLY_CACHE_HPP
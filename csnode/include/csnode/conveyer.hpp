@@ -48,10 +48,19 @@ public:
     ///
     void setRound(cs::RoundNumber round);
 
+    ///
+    /// @brief Sets resolver of transaction sources used by packet queue to key its per-source queues.
+    /// @param resolver Maps the wallet id and the public key forms of one wallet to the same address.
+    /// @warning Thread safe.
+    ///
+    void setSourceResolver(cs::PacketQueue::SourceResolver resolver);
+
     ///
     /// @brief Adds transaction to conveyer, start point of conveyer.
     /// @param transaction csdb Transaction, not valid transavtion would not be
     /// sent to network.
+    /// @warning Thread safe, does not wait for conveyer lock: transaction is staged
+    /// in the buffer of calling thread and moved to packet queue at flush.
     ///
     void addTransaction(const csdb::Transaction& transaction);
 
@@ -74,9 +83,17 @@ public:
 
     ///
     /// @brief Returns transactions packet queue, first stage of conveyer.
+    /// Staged transactions are not in it until the queue is drained or flushed.
+    /// @warning Call under lock().
     ///
     const cs::PacketQueue& packetQueue() const;
 
+    ///
+    /// @brief Moves staged transactions to the queue and returns it.
+    /// @param lock Exclusive lock taken by lock(), the queue is changed under it.
+    ///
+    const cs::PacketQueue& lockedPacketQueue(const std::unique_lock<cs::SharedMutex>& lock);
+
     ///
     /// @brief Returns pair of transactions packet created in current round and smart contract packets.
     /// @warning Slow-performance method. Thread safe.
@@ -262,10 +279,17 @@ public:
     ///
     /// @brief Searches transactions packet in current hash table, or in hash table storage.
     /// @param hash Created transactions packet hash.
-    /// @return Returns transactions packet if its found, otherwise returns nothing.
-    /// @warning No thread safe.
+    /// @return Returns pointer to transactions packet if its found, otherwise returns nullptr.
+    /// @warning No thread safe, pointer is valid until the packet is removed from table.
     ///
-    std::optional<cs::TransactionsPacket> findPacket(const cs::TransactionsPacketHash& hash, const cs::RoundNumber round) const;
+    const cs::TransactionsPacket* findPacket(const cs::TransactionsPacketHash& hash, const cs::RoundNumber round) const;
+
+    ///
+    /// @brief Searches transactions packets like findPacket.
+    /// @return Returns found packets, not found hashes are skipped.
+    /// @warning Thread safe, takes shared lock, so intake and other lookups are not blocked.
+    ///
+    cs::Packets findPackets(const cs::PacketsHashes& hashes, const cs::RoundNumber round) const;
 
     ///
     /// @brief Returns existing of invalid transaction in meta storage.
@@ -293,6 +317,9 @@ public slots:
 
 protected:
     void removeHashesFromTable(const cs::PacketsHashes& hashes);
+
+    // moves staged transactions to packet queue, call under exclusive lock
+    void drainStagedTransactions();
     cs::TransactionsPacketTable& poolTable(cs::RoundNumber round);
 
 private:
@@ -7,6 +7,8 @@
 #include <csdb/amount_commission.hpp>
 #include <csdb/transaction.hpp>
 
+#include <csnode/transactionsbatch.hpp>
+
 namespace cs {
 namespace fee {
 
@@ -17,6 +19,16 @@ using Transactions = std::vector<csdb::Transaction>;
 ///
 void setCountedFees(Transactions&);
 
+///
+/// @brief sets counted fee for each transaction in passed batch
+///
+void setCountedFees(TransactionsBatch&);
+
+///
+/// @brief sets counted fee for each transaction in passed batch and in the transactions the batch is built from
+///
+void setCountedFees(TransactionsBatch&, Transactions&);
+
 ///
 /// @brief allows to estimate weather max fee is enough before consensus
 /// @return true if max fee >= countedFee
@@ -28,6 +40,11 @@ bool estimateMaxFee(const csdb::Transaction&, csdb::AmountCommission& countedFee
 ///
 csdb::AmountCommission getFee(const csdb::Transaction&);
 
+///
+/// @return counted fee for transaction of the batch, the size of ordinary transactions is counted without serialization
+///
+csdb::AmountCommission getFee(const TransactionsBatch&, size_t index);
+
 } // namespace fee
 } // namespace cs
 #endif  // SOLVER_FEE_HPP
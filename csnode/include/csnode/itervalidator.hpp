@@ -6,6 +6,9 @@
 #include <vector>
 
 #include <csnode/nodecore.hpp>
+#include <csnode/signaturesverifier.hpp>
+#include <csnode/transactionsbatch.hpp>
+#include <csnode/transactionsdependencies.hpp>
 #include <csnode/transactionsvalidator.hpp>
 #include <lib/system/common.hpp>
 
@@ -21,18 +24,32 @@ public:
     Characteristic formCharacteristic(SolverContext&, Transactions&, Packets& smartsPackets);
 
 private:
-    bool validateTransactions(SolverContext&, Bytes& characteristicMask, const Transactions&);
+    bool validateTransactions(SolverContext&, Bytes& characteristicMask, const Transactions&, const TransactionsDependencies::Indices& indices);
+
+    // restores the wallets affected by the last iteration and returns the transactions to validate again
+    TransactionsDependencies::Indices prepareNextIteration(SolverContext&, const Transactions&, const Bytes& characteristicMask);
+    void buildDependencies(SolverContext&, const Transactions&);
 
     void checkRejectedSmarts(SolverContext&, Bytes& characteristicMask, const Transactions&);
 
     void checkSignaturesSmartSource(SolverContext&, Packets& smartContractsPackets);
     void checkTransactionsSignatures(SolverContext& context, const Transactions& transactions, Bytes& characteristicMask, Packets& smartsPackets);
-    bool checkTransactionSignature(SolverContext& context, const csdb::Transaction& transaction);
+    bool checkSmartTransactionSignature(const csdb::Transaction& transaction) const;
 
     bool deployAdditionalCheck(SolverContext& context, size_t trxInd, const csdb::Transaction& transaction);
 
     std::unique_ptr<TransactionsValidator> pTransval_;
     std::set<csdb::Address> smartSourceInvalidSignatures_;
+
+    // signatures of the users transactions are verified by a batch
+    SignaturesVerifier signaturesVerifier_;
+
+    // built once per round from the transactions, fees are counted and smart contract transactions are found by it
+    TransactionsBatch batch_;
+
+    // built once per round when the first iteration changes the mask
+    TransactionsDependencies dependencies_;
+    Bytes previousMask_;
 };
 }  // namespace cs
 #endif  // ITER_VALIDATOR_HPP
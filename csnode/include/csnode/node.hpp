@@ -15,6 +15,7 @@
 #include <net/neighbourhood.hpp>
 
 #include "blockchain.hpp"
+#include "blocksreplycache.hpp"
 #include "confirmationlist.hpp"
 #include "packstream.hpp"
 #include "roundstat.hpp"
@@ -156,7 +157,7 @@ public:
     // smarts consensus additional functions:
 
     // syncro send functions
-    void sendBlockReply(const cs::PoolsBlock& poolsBlock, const cs::PublicKey& target, std::size_t packCounter);
+    void sendBlockReply(const cs::PoolsRequestedSequences& sequences, const cs::PublicKey& target, std::size_t packCounter);
 
     void flushCurrentTasks();
     void becomeWriter();
@@ -289,7 +290,8 @@ private:
     template <typename... Args>
     void writeDefaultStream(Args&&... args);
 
-    RegionPtr compressPoolsBlock(const cs::PoolsBlock& poolsBlock, std::size_t& realBinSize);
+    // compresses stored blocks as serialized cs::PoolsBlock without decoding them, skips absent blocks
+    cs::BlocksReplyCache::FramePtr compressPoolsBlock(const cs::PoolsRequestedSequences& sequences);
     cs::PoolsBlock decompressPoolsBlock(const uint8_t* data, const size_t size);
 
     // TODO: C++ 17 static inline?
@@ -323,6 +325,10 @@ private:
     RegionAllocator allocator_;
     RegionAllocator packStreamAllocator_;
 
+    // compressed replies to block requests
+    static const std::size_t blocksReplyCacheSize_ = 32 * 1024 * 1024;
+    cs::BlocksReplyCache blocksReplyCache_;
+
     uint32_t startPacketRequestPoint_ = 0;
 
     // ms timeout
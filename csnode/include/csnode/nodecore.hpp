@@ -23,8 +23,9 @@ struct hash<cs::TransactionsPacketHash> {
 }  // namespace std
 
 namespace cs {
-// table for fast transactions storage
-using TransactionsPacketTable = std::map<TransactionsPacketHash, TransactionsPacket>;  // TODO: check performance of map/unordered_map
+// table for fast transactions storage, references to packets are stable,
+// packets are moved between tables by node extraction without copying
+using TransactionsPacketTable = std::unordered_map<TransactionsPacketHash, TransactionsPacket>;
 
 // array of packets
 using TransactionsBlock = std::vector<cs::TransactionsPacket>;
@@ -2,34 +2,99 @@
 #define PACKETQUEUE_HPP
 
 #include <deque>
-#include <optional>
+#include <functional>
+#include <map>
+#include <set>
 
 #include <csnode/nodecore.hpp>
 #include <boost/noncopyable.hpp>
 
 namespace cs {
-// implements business logic for transpaction packet
+// implements business logic for transpaction packet:
+// single transactions are kept as a mempool ordered by max fee, packets are formed from the most valuable ones,
+// transactions of the same source leave the queue by increasing inner id like TransactionsTail expects them,
+// when the queue is full the cheapest transaction is evicted, separate packets are sent first and are never evicted
 class PacketQueue : public boost::noncopyable {
 public:
+    // maps any form of wallet address to the one used as a source key
+    using SourceResolver = std::function<csdb::Address(const csdb::Address&)>;
+
     explicit PacketQueue(size_t queueSize, size_t transactionsSize, size_t packetsPerRound);
     ~PacketQueue() = default;
 
+    // the wallet id and the public key of one source must resolve to the same address,
+    // otherwise its transactions are ordered by inner id in two independent queues
+    void setSourceResolver(SourceResolver resolver);
+
+    // returns false if the queue is full and the fee of transaction is not greater than the cheapest queued one
     bool push(const csdb::Transaction& transaction);
     void push(const cs::TransactionsPacket& packet);
 
     cs::TransactionsBlock pop();
 
-    std::deque<cs::TransactionsPacket>::const_iterator begin() const;
-    std::deque<cs::TransactionsPacket>::const_iterator end() const;
+    bool containsInnerId(int64_t innerId) const;
 
+    // packets count which pop() would form from the current content
     size_t size() const;
+    size_t transactionsCount() const;
+    size_t evictedCount() const;
     bool isEmpty() const;
-    std::deque<cs::TransactionsPacket>::const_reference back() const;
 
 private:
-    std::deque<cs::TransactionsPacket> queue_;
+    struct Entry {
+        csdb::Transaction transaction;
+        double fee;
+        uint64_t order;
+    };
+
+    // transactions of one source by inner id, equal ids keep the order of arrival
+    using SourceQueue = std::multimap<int64_t, Entry>;
+    using Sources = std::map<csdb::Address, SourceQueue>;
+
+    struct Key {
+        double fee;
+        uint64_t order;
+        Sources::iterator source;
+        SourceQueue::iterator entry;
+    };
+
+    // the cheapest first, the latest of the same fee is evicted first
+    struct CheapestFirst {
+        bool operator()(const Key& left, const Key& right) const {
+            return left.fee < right.fee || (left.fee == right.fee && left.order > right.order);
+        }
+    };
+
+    // the most valuable first, the earliest of the same fee goes first
+    struct MostValuableFirst {
+        bool operator()(const Key& left, const Key& right) const {
+            return left.fee > right.fee || (left.fee == right.fee && left.order < right.order);
+        }
+    };
+
+    static Key makeKey(Sources::iterator source, SourceQueue::iterator entry);
+
+    csdb::Address resolveSource(const csdb::Address& source) const;
+
+    void erase(Sources::iterator source, SourceQueue::iterator entry);
+    csdb::Transaction takeMostValuable();
+
+private:
+    std::deque<cs::TransactionsPacket> packets_;
+    SourceResolver resolver_;
+
+    Sources sources_;
+    std::set<Key, CheapestFirst> byFee_;
+
+    // only the transaction with the least inner id of each source can be put to packet
+    std::set<Key, MostValuableFirst> heads_;
+
+    size_t transactionsCount_;
+    size_t evictedCount_;
+    uint64_t order_;
 
-    size_t maxQueueSize_;
+    // queue size is counted in full packets
+    size_t maxTransactionsCount_;
     size_t maxTransactionsSize_;
     size_t maxPacketsPerRound_;
 
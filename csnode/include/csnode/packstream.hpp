@@ -13,6 +13,7 @@
 
 #include <lib/system/hash.hpp>
 
+#include <net/messagecompression.hpp>
 #include <net/packet.hpp>
 
 namespace cs {
@@ -218,6 +219,24 @@ public:
         *this << receiver;
     }
 
+    // size of the packets the next message is split into, see Connection::packetSize
+    void setPacketSize(const uint32_t size) {
+        packetSize_ = size;
+    }
+
+    uint32_t getPacketSize() const {
+        return packetSize_;
+    }
+
+    // node messages are compressed as a whole before fragmentation, see cs::MessageCompression
+    void setMessageCompression(const bool enabled) {
+        messageCompression_ = enabled;
+    }
+
+    bool isMessageCompression() const {
+        return messageCompression_;
+    }
+
     void clear() {
         for (auto ptr = packets_; ptr != packetsEnd_; ++ptr) {
             ptr->~Packet();
@@ -287,6 +306,10 @@ public:
 
     Packet* getPackets() {
         if (!finished_) {
+            if (messageCompression_) {
+                compressMessage();
+            }
+
             allocator_->shrinkLast(static_cast<uint32_t>(ptr_ - static_cast<cs::Byte*>((packetsEnd_ - 1)->data())));
 
             if (packetsCount_ > 1) {
@@ -350,7 +373,7 @@ private:
             }
         }
 
-        new (packetsEnd_) Packet(allocator_->allocateNext(Packet::MaxSize));
+        new (packetsEnd_) Packet(allocator_->allocateNext(packetSize_));
 
         ptr_ = static_cast<cs::Byte*>(packetsEnd_->data());
         end_ = ptr_ + packetsEnd_->size();
@@ -392,10 +415,58 @@ private:
         insertBytes(reinterpret_cast<const char*>(bytes), size);
     }
 
+    // the packets are formed again of the first packet header, type, round and compressed data of the message
+    void compressMessage() {
+        auto first = static_cast<cs::Byte*>(packets_->data());
+
+        if (*first & BaseFlags::NetworkMsg) {
+            return;
+        }
+
+        const uint32_t headersLength = packets_->getHeadersLength();
+        const uint32_t prefixSize = headersLength + static_cast<uint32_t>(MessageCompression::PrefixSize);
+
+        if (getCurrentSize() < prefixSize && packetsCount_ == 1) {
+            return;
+        }
+
+        cs::Bytes data;
+        data.reserve(static_cast<size_t>(packetsCount_) * packetSize_);
+
+        for (auto p = packets_; p != packetsEnd_; ++p) {
+            auto begin = static_cast<cs::Byte*>(p->data());
+            auto end = (p + 1 == packetsEnd_) ? ptr_ : begin + p->size();
+
+            data.insert(data.end(), begin + (p == packets_ ? prefixSize : headersLength), end);
+        }
+
+        cs::Bytes compressed;
+        if (!MessageCompression::instance().compress(static_cast<MsgTypes>(first[headersLength]), data.data(), data.size(), compressed)) {
+            return;
+        }
+
+        cs::Bytes prefix(first, first + prefixSize);
+
+        // fragments do not compress again
+        prefix.front() = static_cast<cs::Byte>((prefix.front() | BaseFlags::CompressedMessage) & ~BaseFlags::Compressed);
+
+        if (prefix.front() & BaseFlags::Fragmented) {
+            *reinterpret_cast<uint16_t*>(prefix.data() + Offsets::FragmentsNum) = 1;
+        }
+
+        clear();
+        newPack();
+
+        insertBytes(prefix.data(), static_cast<uint32_t>(prefix.size()));
+        insertBytes(compressed.data(), static_cast<uint32_t>(compressed.size()));
+    }
+
     cs::Byte* ptr_ = nullptr;
     cs::Byte* end_ = nullptr;
 
     RegionAllocator* allocator_;
+    uint32_t packetSize_ = Packet::DefaultSize;
+    bool messageCompression_ = false;
 
     Packet* packets_;
     uint16_t packetsCount_ = 0;
@@ -9,6 +9,8 @@
 namespace cs {
 constexpr size_t MaxStoredDurations = 1000;
 
+class StateSnapshot;
+
 class RoundStat {
 public:
     RoundStat();
@@ -21,6 +23,10 @@ public:
     // called when next block is stored
     void onStoreBlock(csdb::Pool block);
 
+    // called when state snapshot is made or restored instead of reading blocks
+    void onSaveState(cs::StateSnapshot& snapshot);
+    void onLoadState(const cs::StateSnapshot& snapshot, bool* failed);
+
     size_t total_transactions() const {
         return totalAcceptedTransactions_;
     }
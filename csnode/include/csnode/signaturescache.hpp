@@ -0,0 +1,80 @@
+#ifndef SIGNATURES_CACHE_HPP
+#define SIGNATURES_CACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include <csdb/transaction.hpp>
+#include <lib/system/common.hpp>
+
+namespace cs {
+// Keeps successful signature verifications of the transactions, so a transaction verified at the API
+// or in the stage one is not verified again when its block is validated, stored or synced.
+// Record is found by (signature, public key, hash of the signed data), failed verifications are not kept
+class SignaturesCache {
+public:
+    static constexpr size_t DefaultCapacity = 1 << 17;
+    static constexpr size_t ShardsCount = 16;
+
+    static SignaturesCache& instance();
+
+    explicit SignaturesCache(size_t capacity = DefaultCapacity);
+
+    SignaturesCache(const SignaturesCache&) = delete;
+    SignaturesCache& operator=(const SignaturesCache&) = delete;
+
+    // returns cached result or verifies signature and caches it on success
+    bool verify(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Byte* data, size_t size);
+    bool verify(const csdb::Transaction& transaction, const cs::PublicKey& publicKey);
+
+    // lookup and insertion for the callers verifying signatures by themselves
+    bool contains(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Hash& dataHash);
+    void insert(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Hash& dataHash);
+
+    void clear();
+
+    size_t size() const;
+
+    size_t capacity() const {
+        return shardCapacity_ * ShardsCount;
+    }
+
+    uint64_t hits() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t misses() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct SignatureHash {
+        size_t operator()(const cs::Signature& signature) const;
+    };
+
+    struct Record {
+        cs::PublicKey publicKey;
+        cs::Hash dataHash;
+    };
+
+    // the oldest records are evicted first
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<cs::Signature, Record, SignatureHash> records;
+        std::deque<cs::Signature> order;
+    };
+
+    Shard& shard(const cs::Signature& signature);
+
+    const size_t shardCapacity_;
+    std::array<Shard, ShardsCount> shards_;
+
+    std::atomic<uint64_t> hits_ = {0};
+    std::atomic<uint64_t> misses_ = {0};
+};
+}  // namespace cs
+
+#endif  // SIGNATURES_CACHE_HPP
@@ -0,0 +1,72 @@
+#ifndef SIGNATURES_VERIFIER_HPP
+#define SIGNATURES_VERIFIER_HPP
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <csdb/transaction.hpp>
+#include <csnode/signaturescache.hpp>
+#include <lib/system/common.hpp>
+
+namespace cs {
+// Verifies signatures of the transactions of a round as a batch: the signed data are serialized
+// one after another into a single buffer and verified by the calling thread together with the pool,
+// signatures found in the cache are not verified again and the verified ones are added to it
+class SignaturesVerifier {
+public:
+    // smaller batches are verified by the calling thread only
+    static constexpr size_t MinParallelSize = 64;
+    // signatures taken by a thread at once
+    static constexpr size_t ChunkSize = 16;
+
+    explicit SignaturesVerifier(size_t threadsCount = std::thread::hardware_concurrency(), SignaturesCache& cache = SignaturesCache::instance());
+    ~SignaturesVerifier();
+
+    SignaturesVerifier(const SignaturesVerifier&) = delete;
+    SignaturesVerifier& operator=(const SignaturesVerifier&) = delete;
+
+    void reserve(size_t count);
+
+    // index is the position of the transaction in the characteristic mask
+    void add(size_t index, const csdb::Transaction& transaction, const cs::PublicKey& publicKey);
+    void add(size_t index, const cs::Byte* data, size_t size, const cs::Signature& signature, const cs::PublicKey& publicKey);
+
+    // marks the transactions of invalid signatures as rejected in the mask, returns their indices
+    std::vector<size_t> verify(cs::Bytes& characteristicMask);
+
+    void clear();
+
+    size_t size() const {
+        return entries_.size();
+    }
+
+    size_t threadsCount() const {
+        return threadsCount_;
+    }
+
+private:
+    struct Entry {
+        size_t index;
+        size_t offset;
+        size_t size;
+        cs::Signature signature;
+        cs::PublicKey publicKey;
+    };
+
+    void verifyChunks(std::atomic<size_t>& next);
+
+    const size_t threadsCount_;
+    SignaturesCache& cache_;
+    std::unique_ptr<boost::asio::thread_pool> pool_;
+
+    cs::Bytes buffer_;
+    std::vector<Entry> entries_;
+    std::vector<cs::Byte> results_;
+};
+}  // namespace cs
+
+#endif  // SIGNATURES_VERIFIER_HPP
@@ -0,0 +1,58 @@
+#ifndef STATE_SNAPSHOT_HPP
+#define STATE_SNAPSHOT_HPP
+
+#include <map>
+#include <string>
+
+#include <csdb/pool.hpp>
+#include <lib/system/common.hpp>
+
+namespace cs {
+///
+/// On-disk snapshot of in-memory state built by reading blocks from database.
+/// Snapshot is tagged with sequence and hash of the last block it includes,
+/// every reader of the blocks stores own state as a named section.
+///
+class StateSnapshot {
+public:
+    // increment on any change of file layout or of any section content
+    static constexpr uint32_t Version = 3;
+
+    using Sections = std::map<std::string, cs::Bytes>;
+
+    StateSnapshot() = default;
+    StateSnapshot(cs::Sequence sequence, const csdb::PoolHash& hash);
+
+    bool isValid() const {
+        return !hash_.is_empty();
+    }
+
+    cs::Sequence sequence() const {
+        return sequence_;
+    }
+
+    const csdb::PoolHash& hash() const {
+        return hash_;
+    }
+
+    void setSection(const std::string& name, cs::Bytes&& data);
+
+    // returns nullptr if section is absent
+    const cs::Bytes* section(const std::string& name) const;
+
+    // writes snapshot to temporary file and replaces the file by path with it
+    bool save(const std::string& path) const;
+
+    // returns false if file is absent, has unknown version or damaged (checksum does not match)
+    bool load(const std::string& path);
+
+    static void remove(const std::string& path);
+
+private:
+    cs::Sequence sequence_ = 0;
+    csdb::PoolHash hash_;
+    Sections sections_;
+};
+}  // namespace cs
+
+#endif  // STATE_SNAPSHOT_HPP
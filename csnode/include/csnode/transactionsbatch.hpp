@@ -0,0 +1,130 @@
+#ifndef TRANSACTIONS_BATCH_HPP
+#define TRANSACTIONS_BATCH_HPP
+
+#include <string_view>
+#include <vector>
+
+#include <csdb/address.hpp>
+#include <csdb/amount.hpp>
+#include <csdb/amount_commission.hpp>
+#include <csdb/transaction.hpp>
+#include <csdb/user_field.hpp>
+
+#include <lib/system/common.hpp>
+
+namespace cs {
+// Transactions of a round without an allocation per transaction: every fixed field of all the transactions
+// is stored in its own array, values of user fields are stored one after another in a common buffer.
+// Transactions are converted from and to csdb::Transaction where they come from and go to network and storage
+class TransactionsBatch {
+public:
+    struct Address {
+        cs::PublicKey publicKey;
+        csdb::internal::WalletId walletId;
+        bool isWalletId;
+    };
+
+    TransactionsBatch() = default;
+    explicit TransactionsBatch(const std::vector<csdb::Transaction>& transactions);
+
+    void reserve(size_t transactionsCount, size_t userFieldsSize = 0);
+    void clear();
+
+    void add(const csdb::Transaction& transaction);
+
+    size_t size() const {
+        return innerIds_.size();
+    }
+
+    bool empty() const {
+        return innerIds_.empty();
+    }
+
+    csdb::Transaction transaction(size_t index) const;
+    std::vector<csdb::Transaction> transactions() const;
+
+    int64_t innerId(size_t index) const {
+        return innerIds_[index];
+    }
+
+    const Address& source(size_t index) const {
+        return sources_[index];
+    }
+
+    const Address& target(size_t index) const {
+        return targets_[index];
+    }
+
+    uint8_t currency(size_t index) const {
+        return currencies_[index];
+    }
+
+    const csdb::Amount& amount(size_t index) const {
+        return amounts_[index];
+    }
+
+    csdb::AmountCommission maxFee(size_t index) const {
+        return csdb::AmountCommission(maxFees_[index]);
+    }
+
+    csdb::AmountCommission countedFee(size_t index) const {
+        return csdb::AmountCommission(countedFees_[index]);
+    }
+
+    void setCountedFee(size_t index, csdb::AmountCommission fee) {
+        countedFees_[index] = fee.get_raw();
+    }
+
+    const cs::Signature& signature(size_t index) const {
+        return signatures_[index];
+    }
+
+    bool hasUserField(size_t index, csdb::user_field_id_t id) const {
+        return findUserField(index, id) != nullptr;
+    }
+
+    // Unknown if there is no such field
+    csdb::UserField::Type userFieldType(size_t index, csdb::user_field_id_t id) const;
+
+    // empty if the field is not a string
+    std::string_view stringUserField(size_t index, csdb::user_field_id_t id) const;
+
+    // size of csdb::Transaction::to_byte_stream() of the transaction, computed without serialization
+    size_t serializedSize(size_t index) const;
+
+    // bytes allocated by the batch
+    size_t memoryUsage() const;
+
+    static csdb::Address toAddress(const Address& address);
+    static Address fromAddress(const csdb::Address& address);
+
+private:
+    struct UserField {
+        csdb::user_field_id_t id;
+        csdb::UserField::Type type;
+        // value in the buffer: 8 bytes of integer, csdb::Amount or characters of string
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    const UserField* findUserField(size_t index, csdb::user_field_id_t id) const;
+    csdb::UserField userField(const UserField& field) const;
+
+    std::vector<int64_t> innerIds_;
+    std::vector<Address> sources_;
+    std::vector<Address> targets_;
+    std::vector<uint8_t> currencies_;
+    std::vector<csdb::Amount> amounts_;
+    std::vector<uint16_t> maxFees_;
+    std::vector<uint16_t> countedFees_;
+    std::vector<cs::Signature> signatures_;
+    std::vector<uint64_t> times_;
+
+    // fields of transaction i are [userFieldsBegin_[i], userFieldsBegin_[i + 1]) in id order
+    std::vector<uint32_t> userFieldsBegin_ = {0};
+    std::vector<UserField> userFields_;
+    cs::Bytes values_;
+};
+}  // namespace cs
+
+#endif  // TRANSACTIONS_BATCH_HPP
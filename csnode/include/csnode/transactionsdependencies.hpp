@@ -0,0 +1,51 @@
+#ifndef TRANSACTIONS_DEPENDENCIES_HPP
+#define TRANSACTIONS_DEPENDENCIES_HPP
+
+#include <unordered_map>
+#include <vector>
+
+#include <csdb/address.hpp>
+#include <csnode/walletsstate.hpp>
+
+namespace cs {
+// Groups the transactions of a round by the wallets they read or change: transactions of different groups
+// do not depend on each other, so a rejection requires only the transactions of its group to be validated again
+class TransactionsDependencies {
+public:
+    using Wallet = const WalletsState::WalletData*;
+    using Indices = std::vector<size_t>;
+    using Addresses = std::vector<csdb::Address>;
+
+    void reset(size_t transactionsCount);
+
+    // transaction depends on the state of the wallet, address is used to restore the wallet state
+    void add(size_t index, const csdb::Address& address, Wallet wallet);
+
+    // transactions of the groups of the changed ones in ascending order and the wallets of these groups
+    Indices affected(const Indices& changed, Addresses& wallets);
+
+    bool empty() const {
+        return parents_.empty();
+    }
+
+    size_t groupsCount();
+
+private:
+    size_t find(size_t index);
+    void group();
+
+    std::vector<size_t> parents_;
+    // wallet number, its address and the first transaction depending on it
+    std::unordered_map<Wallet, size_t> wallets_;
+    Addresses addresses_;
+    Indices walletsIndices_;
+
+    // filled once all the transactions are added
+    bool grouped_ = false;
+    std::vector<size_t> groupOf_;
+    std::vector<Indices> groups_;
+    std::vector<Addresses> groupsWallets_;
+};
+}  // namespace cs
+
+#endif  // TRANSACTIONS_DEPENDENCIES_HPP
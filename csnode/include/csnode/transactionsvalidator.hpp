@@ -19,6 +19,7 @@ public:
     using CharacteristicMask = cs::Bytes;
     using TransactionIndex = WalletsState::TransactionIndex;
     using RejectedSmarts = std::vector<std::pair<csdb::Transaction, size_t>>;
+    using Indices = std::vector<size_t>;
 
 public:
     struct Config {
@@ -29,8 +30,10 @@ public:
     TransactionsValidator(WalletsState& walletsState, const Config& config);
 
     void reset(size_t transactionsNum);
+    // resets the given transactions only, their wallets should be restored
+    void reset(const Indices& trxsInds);
     bool validateTransaction(SolverContext& context, const Transactions& trxs, size_t trxInd);
-    size_t checkRejectedSmarts(SolverContext& context, const Transactions& trxs, CharacteristicMask& maskIncluded);
+    size_t checkRejectedSmarts(SolverContext& context, const Transactions& trxs, const Indices& trxsInds, CharacteristicMask& maskIncluded);
     void validateByGraph(SolverContext& context, CharacteristicMask& maskIncluded, const Transactions& trxs);
 
     void clearCaches();
@@ -9,6 +9,8 @@
 #include <csdb/transaction.hpp>
 #include <csnode/nodecore.hpp>
 #include <csnode/transactionstail.hpp>
+#include <array>
+#include <bitset>
 #include <list>
 #include <map>
 #include <memory>
@@ -38,16 +40,18 @@ public:
     };
 
 public:
+    // fields updated by every block go first, the address and the rest are read rarely,
+    // all of them are kept in one record as the code across the node reads them directly
     struct WalletData {
         using Address = cs::PublicKey;
 
-        Address address_;
         csdb::Amount balance_;
+        uint64_t transNum_ = 0;
         TransactionsTail trxTail_;
-		uint64_t transNum_ = 0;
+        Address address_;
 
 #ifdef MONITOR_NODE
-        uint64_t createTime_ = 0;        
+        uint64_t createTime_ = 0;
 #endif
 #ifdef TRANSACTIONS_INDEX
         csdb::TransactionID lastTransaction_;
@@ -74,8 +78,78 @@ public:
         return wallets_.size();
     }
 
+    struct MemoryUsage {
+        size_t wallets = 0;
+        size_t slabs = 0;
+        size_t bytes = 0;
+    };
+
+    MemoryUsage memoryUsage() const;
+
 private:
-    using Data = std::vector<WalletData*>;
+    // wallets by id in slabs, records are allocated for the present wallets only and are not moved when the storage
+    // grows, so wallet references stay valid and full scans go through memory sequentially,
+    // a wallet costs its record and a slot index instead of a separate heap block with its header and a pointer
+    class Data {
+    public:
+        static constexpr size_t SlabSize = 1024;
+
+        // ids range, like the size of a vector indexed by id
+        size_t size() const {
+            return size_;
+        }
+
+        // wallets present
+        size_t count() const {
+            return count_;
+        }
+
+        void reserve(size_t size);
+        void grow(size_t size);
+
+        WalletData* find(WalletId id);
+        const WalletData* find(WalletId id) const;
+
+        // returns new default wallet, the present one is reset
+        WalletData& emplace(WalletId id);
+        void erase(WalletId id);
+
+        // puts records of every slab together without spare ones, moves them, so no wallet reference may be kept
+        void shrinkToFit();
+
+        // stops if function returns false
+        template <typename Function>
+        void forEach(Function&& function) const;
+
+        template <typename Function>
+        void forEach(Function&& function);
+
+        MemoryUsage memoryUsage() const;
+
+    private:
+        struct Slab {
+            // records of the wallets added after shrinkToFit() are allocated by chunks
+            static constexpr size_t ChunkSize = 16;
+            using Chunk = std::array<WalletData, ChunkSize>;
+
+            WalletData& record(size_t slot);
+            const WalletData& record(size_t slot) const;
+
+            std::bitset<SlabSize> present;
+            std::array<uint16_t, SlabSize> slotOf;
+
+            std::unique_ptr<WalletData[]> records;
+            size_t recordsCount = 0;
+            std::vector<std::unique_ptr<Chunk>> chunks;
+
+            size_t used = 0;
+            std::vector<uint16_t> freeSlots;  // records of erased wallets
+        };
+
+        std::vector<std::unique_ptr<Slab>> slabs_;
+        size_t size_ = 0;
+        size_t count_ = 0;
+    };
 
     class ProcessorBase {
     public:
@@ -170,6 +244,10 @@ public:
     std::unique_ptr<Initer> createIniter();
     std::unique_ptr<Updater> createUpdater();
 
+    // wallets state to store into the state snapshot, ids are stored by WalletsIds
+    cs::Bytes toBinary() const;
+    bool fromBinary(const cs::Bytes& data);
+
 private:
     const Config config_;
     WalletsIds& walletsIds_;
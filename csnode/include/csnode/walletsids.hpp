@@ -5,6 +5,7 @@
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include "csdb/internal/types.hpp"
 
 namespace cs {
@@ -28,6 +29,9 @@ public:
         bool findAnyOrInsertSpecial(const WalletAddress& address, WalletId& id);
 
     private:
+        // the next special id is stored together with the normal ids
+        friend class WalletsIds;
+
         WalletsIds& norm_;
         WalletId nextIdSpecial_;
         static constexpr uint32_t maskSpecial_ = (1u << 31);
@@ -75,9 +79,30 @@ public:
         return *norm_;
     }
 
+    // ids of public key wallets, to store them into the state snapshot
+    cs::Bytes toBinary() const;
+    bool fromBinary(const cs::Bytes& data);
+
 private:
-    using Data = std::unordered_map<WalletAddress, WalletId>;
+    struct PublicKeyHash {
+        size_t operator()(const cs::PublicKey& key) const noexcept;
+    };
+
+    // keys are stored inline, addresses are made only for the callers
+    using Data = std::unordered_map<cs::PublicKey, WalletId, PublicKeyHash>;
+
+    // reverse index: keys of the map by normal id and by special id without the special bit,
+    // map nodes are not moved by rehashing so the pointers stay valid until the key is erased
+    using Keys = std::vector<const cs::PublicKey*>;
+
+    Keys& keys(WalletId id);
+    void setKey(WalletId id, const cs::PublicKey* key);
+    void resetKey(WalletId id, const cs::PublicKey* key);
+    void rebuildKeys();
+
     Data data_;
+    Keys normalKeys_;
+    Keys specialKeys_;
     WalletId nextId_;
     std::unique_ptr<Special> special_;
     std::unique_ptr<Normal> norm_;
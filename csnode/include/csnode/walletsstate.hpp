@@ -39,6 +39,9 @@ public:
     WalletData& getData(const WalletAddress& address, WalletId& id);
     void setModified(const WalletId& id);
 
+    // drops the changes of the wallet made since updateFromSource(), it is loaded again on the next access
+    void restore(const WalletAddress& address);
+
 private:
     class WalletsExisting {
     public:
@@ -48,6 +51,7 @@ private:
         void updateFromSource();
         WalletData* getData(const WalletId& id);
         void setModified(const WalletId& id);
+        bool restore(const WalletId& id);
 
     private:
         bool updateFromSource(const WalletId& id);
@@ -64,6 +68,7 @@ private:
     public:
         void clear();
         WalletData& getData(const WalletAddress& address);
+        void restore(const WalletAddress& address);
 
     private:
         using Storage = std::unordered_map<WalletAddress, WalletData>;
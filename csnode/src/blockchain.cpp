@@ -12,6 +12,7 @@
 #include <csnode/datastream.hpp>
 #include <csnode/fee.hpp>
 #include <csnode/nodeutils.hpp>
+#include <csnode/statesnapshot.hpp>
 #include <solver/smartcontracts.hpp>
 
 #include <client/config.hpp>
@@ -20,6 +21,14 @@
 
 using namespace cs;
 
+namespace {
+const char* kStateSnapshotFile = "state.snapshot";
+const char* kSnapshotBlockChain = "blockchain";
+const char* kSnapshotWalletsIds = "wallets_ids";
+const char* kSnapshotWalletsCache = "wallets_cache";
+const char* kSnapshotBlockHashes = "block_hashes";
+}  // namespace
+
 BlockChain::BlockChain(csdb::Address genesisAddress, csdb::Address startAddress)
 : good_(false)
 , dbLock_()
@@ -36,6 +45,9 @@ BlockChain::BlockChain(csdb::Address genesisAddress, csdb::Address startAddress)
 }
 
 BlockChain::~BlockChain() {
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();
+    }
 }
 
 bool BlockChain::init(const std::string& path) {
@@ -50,8 +62,33 @@ bool BlockChain::init(const std::string& path) {
         return false;
     };
 
-    if (!storage_.open(path, progress)) {
+    csdb::Storage::OpenOptions options;
+    cs::StateSnapshot snapshot;
+    bool snapshotFailed = false;
+
+    if (!path.empty()) {
+        snapshotPath_ = path + '/' + kStateSnapshotFile;
+
+        if (snapshot.load(snapshotPath_)) {
+            cslog() << "Found state snapshot of block #" << WithDelimiters(snapshot.sequence());
+            options.resume_hash = snapshot.hash().to_binary();
+            options.resume_sequence = snapshot.sequence();
+            options.on_resume = [&](bool* failed) {
+                const bool restored = restoreStateSnapshot(snapshot, failed);
+                snapshotFailed = *failed;
+                return restored;
+            };
+        }
+    }
+
+    if (!storage_.open(path, options, progress)) {
         cserror() << "Couldn't open database at " << path;
+
+        if (snapshotFailed) {
+            cserror() << "State snapshot is not compatible, it is removed. Restart node to read all blocks";
+            cs::StateSnapshot::remove(snapshotPath_);
+        }
+
         return false;
     }
 
@@ -70,6 +107,11 @@ bool BlockChain::init(const std::string& path) {
             return false;
         }
         std::cout << "Done\n";
+
+        if (totalLoaded >= StateSnapshotPeriod) {
+            const auto lastSequence = getLastSequence();
+            saveStateSnapshot(lastSequence, getHashBySequence(lastSequence));
+        }
     }
 
 #if defined(TRANSACTIONS_INDEX) && defined(RECREATE_INDEX)
@@ -142,6 +184,127 @@ bool BlockChain::postInitFromDB() {
         return true;
     };
     walletsCacheStorage_->iterateOverWallets(func);
+
+    const auto usage = walletsCacheStorage_->memoryUsage();
+    cslog() << "Blockchain: " << usage.wallets << " wallets in " << usage.slabs << " slabs, " << usage.bytes / 1024 << " KB";
+    return true;
+}
+
+void BlockChain::saveStateSnapshot(cs::Sequence sequence, const csdb::PoolHash& hash) {
+    if (snapshotPath_.empty()) {
+        return;
+    }
+
+    cs::StateSnapshot snapshot(sequence, hash);
+
+    {
+        cs::Lock lock(dbLock_);
+        std::lock_guard cacheLock(cacheMutex_);
+
+        cs::Bytes bytes;
+        cs::DataStream stream(bytes);
+        stream << uuid_;
+#ifdef TRANSACTIONS_INDEX
+        stream << total_transactions_count_ << lastNonEmptyBlock_.hash << lastNonEmptyBlock_.transCount << previousNonEmpty_.size();
+
+        for (const auto& [key, data] : previousNonEmpty_) {
+            stream << key << data.hash << data.transCount;
+        }
+#endif
+        snapshot.setSection(kSnapshotBlockChain, std::move(bytes));
+        snapshot.setSection(kSnapshotWalletsIds, walletIds_->toBinary());
+        snapshot.setSection(kSnapshotWalletsCache, walletsCacheStorage_->toBinary());
+        snapshot.setSection(kSnapshotBlockHashes, blockHashes_->toBinary());
+    }
+
+    emit saveStateEvent(snapshot);
+
+    // the previous snapshot is written long ago, it is made once per StateSnapshotPeriod blocks
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();
+    }
+
+    snapshotThread_ = std::thread([this, sequence, snapshot = std::move(snapshot)]() {
+        // the snapshot must not refer to blocks which are not on disk yet
+        if (!storage_.flush()) {
+            cserror() << "BLOCKCHAIN> cannot flush storage, state snapshot of block #" << sequence << " is not saved";
+            return;
+        }
+
+        snapshot.save(snapshotPath_);
+    });
+}
+
+bool BlockChain::restoreStateSnapshot(const cs::StateSnapshot& snapshot, bool* failed) {
+    const cs::Bytes* chainData = snapshot.section(kSnapshotBlockChain);
+    const cs::Bytes* idsData = snapshot.section(kSnapshotWalletsIds);
+    const cs::Bytes* cacheData = snapshot.section(kSnapshotWalletsCache);
+    const cs::Bytes* hashesData = snapshot.section(kSnapshotBlockHashes);
+
+    if (chainData == nullptr || idsData == nullptr || cacheData == nullptr || hashesData == nullptr) {
+        cswarning() << "Blockchain: state snapshot is incomplete, read all blocks";
+        return false;
+    }
+
+    // restore into new instances not to leave partially restored state
+    auto walletIds = std::make_unique<WalletsIds>();
+    auto walletsCache = std::make_unique<WalletsCache>(WalletsCache::Config(), genesisAddress_, startAddress_, *walletIds);
+    auto blockHashes = std::make_unique<cs::BlockHashes>();
+
+    if (!walletIds->fromBinary(*idsData) || !walletsCache->fromBinary(*cacheData) || !blockHashes->fromBinary(*hashesData) ||
+        blockHashes->getLast() != snapshot.hash()) {
+        cswarning() << "Blockchain: state snapshot is damaged, read all blocks";
+        return false;
+    }
+
+    cs::DataStream stream(chainData->data(), chainData->size());
+    uint64_t uuid = 0;
+    stream >> uuid;
+#ifdef TRANSACTIONS_INDEX
+    uint64_t totalTransactionsCount = 0;
+    NonEmptyBlockData lastNonEmptyBlock;
+    std::map<csdb::PoolHash, NonEmptyBlockData> previousNonEmpty;
+    size_t count = 0;
+    stream >> totalTransactionsCount >> lastNonEmptyBlock.hash >> lastNonEmptyBlock.transCount >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        csdb::PoolHash key;
+        NonEmptyBlockData data;
+        stream >> key >> data.hash >> data.transCount;
+        previousNonEmpty.emplace(key, data);
+    }
+#endif
+
+    if (!stream.isValid()) {
+        cswarning() << "Blockchain: state snapshot is damaged, read all blocks";
+        return false;
+    }
+
+    {
+        cs::Lock lock(dbLock_);
+        std::lock_guard cacheLock(cacheMutex_);
+
+        uuid_ = uuid;
+#ifdef TRANSACTIONS_INDEX
+        total_transactions_count_ = totalTransactionsCount;
+        lastNonEmptyBlock_ = lastNonEmptyBlock;
+        previousNonEmpty_ = std::move(previousNonEmpty);
+#endif
+        walletsCacheUpdater_.reset();
+        walletsPools_ = std::make_unique<WalletsPools>(genesisAddress_, startAddress_, *walletIds);
+        walletsCacheStorage_ = std::move(walletsCache);
+        walletIds_ = std::move(walletIds);
+        walletsCacheUpdater_ = walletsCacheStorage_->createUpdater();
+        blockHashes_ = std::move(blockHashes);
+    }
+
+    emit loadStateEvent(snapshot, failed);
+
+    if (*failed) {
+        return false;
+    }
+
+    csdebug() << "Blockchain: state is restored from snapshot, UUID = " << uuid_;
     return true;
 }
 
@@ -314,6 +477,20 @@ csdb::Pool BlockChain::loadBlockMeta(const csdb::PoolHash& ph, size_t& cnt) cons
     return storage_.pool_load_meta(ph, cnt);
 }
 
+cs::Bytes BlockChain::loadBlockBinary(const cs::Sequence sequence) const {
+    std::lock_guard lock(dbLock_);
+
+    if (deferredBlock_.is_valid() && deferredBlock_.sequence() == sequence) {
+        return deferredBlock_.to_binary();
+    }
+
+    if (sequence > getLastSequence()) {
+        return cs::Bytes{};
+    }
+
+    return storage_.pool_load_binary(sequence + 1);
+}
+
 csdb::Transaction BlockChain::loadTransaction(const csdb::TransactionID& transId) const {
     std::lock_guard l(dbLock_);
     csdb::Transaction transaction;
@@ -808,6 +985,10 @@ void BlockChain::addNewWalletsToPool(csdb::Pool& pool) {
 }
 
 void BlockChain::close() {
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();
+    }
+
     cs::Lock lock(dbLock_);
     storage_.close();
 }
@@ -964,6 +1145,11 @@ std::optional<csdb::Pool> BlockChain::recordBlock(csdb::Pool& pool, bool isTrust
         csdebug() << "signatures amount = " << deferredBlock_.signatures().size() << ", smartSignatures amount = " << deferredBlock_.smartSignatures().size()
                   << ", see block info above";
         csdebug() << "----------------------------------------------------------------------------------";
+
+        // in-memory state corresponds to the flushed block until the next one is finalized
+        if (flushed_block_seq % StateSnapshotPeriod == 0) {
+            saveStateSnapshot(flushed_block_seq, deferredBlock_.hash());
+        }
     }
 
     {
@@ -1,4 +1,5 @@
 #include <csnode/blockhashes.hpp>
+#include <csnode/datastream.hpp>
 #include <cstring>
 #include <fstream>
 #include <lib/system/logger.hpp>
@@ -104,4 +105,30 @@ const std::vector<csdb::PoolHash>& BlockHashes::getHashes() const {
     return hashes_;
 }
 
+cs::Bytes BlockHashes::toBinary() const {
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+    stream << isDbInited_ << db_.first_ << db_.last_ << hashes_;
+    return bytes;
+}
+
+bool BlockHashes::fromBinary(const cs::Bytes& data) {
+    cs::DataStream stream(data.data(), data.size());
+
+    bool isDbInited = false;
+    DbStructure db{};
+    std::vector<csdb::PoolHash> hashes;
+    stream >> isDbInited >> db.first_ >> db.last_ >> hashes;
+
+    if (!stream.isValid() || (isDbInited && hashes.size() != db.last_ + 1)) {
+        cserror() << "BlockHashes: corrupted snapshot data";
+        return false;
+    }
+
+    isDbInited_ = isDbInited;
+    db_ = db;
+    hashes_ = std::move(hashes);
+    return true;
+}
+
 }  // namespace cs
@@ -0,0 +1,68 @@
+#include <csnode/blocksreplycache.hpp>
+
+#include <algorithm>
+
+namespace cs {
+
+BlocksReplyCache::BlocksReplyCache(std::size_t maxBytes)
+: maxBytes_(maxBytes) {
+}
+
+BlocksReplyCache::FramePtr BlocksReplyCache::find(const cs::PoolsRequestedSequences& sequences) {
+    std::lock_guard lock(mutex_);
+
+    const auto it = index_.find(sequences);
+
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+}
+
+void BlocksReplyCache::insert(const cs::PoolsRequestedSequences& sequences, FramePtr frame) {
+    if (!frame || frame->data.size() > maxBytes_) {
+        return;
+    }
+
+    std::lock_guard lock(mutex_);
+
+    if (const auto it = index_.find(sequences); it != index_.end()) {
+        erase(it->second);
+    }
+
+    bytes_ += frame->data.size();
+    entries_.emplace_front(sequences, std::move(frame));
+    index_.emplace(sequences, entries_.begin());
+
+    while (bytes_ > maxBytes_) {
+        erase(std::prev(entries_.end()));
+    }
+}
+
+void BlocksReplyCache::removeFrom(cs::Sequence sequence) {
+    std::lock_guard lock(mutex_);
+
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        const auto& sequences = it->first;
+        const bool affected = std::any_of(sequences.cbegin(), sequences.cend(), [sequence](cs::Sequence value) { return value >= sequence; });
+
+        if (affected) {
+            erase(it++);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void BlocksReplyCache::erase(Entries::iterator it) {
+    bytes_ -= it->second->data.size();
+    index_.erase(it->first);
+    entries_.erase(it);
+}
+
+}  // namespace cs
@@ -10,6 +10,7 @@
 #include <lib/system/common.hpp>
 #include <csnode/walletsstate.hpp>
 #include <csnode/walletscache.hpp>
+#include <csnode/signaturescache.hpp>
 #include <csdb/amount_commission.hpp>
 #include <csdb/pool.hpp>
 #include <cscrypto/cscrypto.hpp>
@@ -286,9 +287,9 @@ bool TransactionsChecker::checkSignature(const csdb::Transaction& t) {
                 << t.source().wallet_id() << " in blockchain";
       return false;
     }
-    return t.verify_signature(dataToFetchPublicKey.address_);
+    return SignaturesCache::instance().verify(t, dataToFetchPublicKey.address_);
   } else {
-    return t.verify_signature(t.source().public_key());
+    return SignaturesCache::instance().verify(t, t.source().public_key());
   }
 }
 
@@ -5,8 +5,12 @@
 #include <csnode/datastream.hpp>
 #include <solver/smartcontracts.hpp>
 
+#include <array>
+#include <cassert>
 #include <exception>
 #include <iomanip>
+#include <mutex>
+#include <thread>
 
 #include <lib/system/hash.hpp>
 #include <lib/system/logger.hpp>
@@ -19,11 +23,29 @@ std::once_flag onceFlag = {};
 static void setup(cs::ConveyerBase* conveyer) {
     conveyerView = conveyer;
 }
+
+constexpr size_t kStagingShards = 16;
+
+// threads get shards in turn, so up to kStagingShards adding threads do not share a shard
+size_t stagingShardIndex() {
+    static std::atomic<size_t> nextShard = 0;
+    thread_local const size_t shard = nextShard++ % kStagingShards;
+    return shard;
+}
 }
 
 struct cs::ConveyerBase::Impl {
     explicit Impl(size_t queueSize, size_t transactionsSize, size_t packetsPerRound);
 
+    // transactions added since last flush, every shard is used by its own threads
+    struct alignas(64) StagingShard {
+        std::mutex lock;
+        std::vector<csdb::Transaction> transactions;
+    };
+
+    std::array<StagingShard, kStagingShards> staging;
+    std::atomic<size_t> stagedCount = 0;
+
     // first storage of transactions, before sending to network
     cs::PacketQueue packetQueue;
 
@@ -78,28 +100,42 @@ void cs::ConveyerBase::setRound(cs::RoundNumber round) {
 
 cs::ConveyerBase::~ConveyerBase() = default;
 
+void cs::ConveyerBase::setSourceResolver(cs::PacketQueue::SourceResolver resolver) {
+    cs::Lock lock(sharedMutex_);
+    pimpl_->packetQueue.setSourceResolver(std::move(resolver));
+}
+
 void cs::ConveyerBase::addTransaction(const csdb::Transaction& transaction) {
     if (!transaction.is_valid()) {
         cswarning() << csname() << "Can not add no valid transaction to conveyer";
         return;
     }
 
-    cs::Lock lock(sharedMutex_);
-
     auto id = transaction.innerID();
 
-    if (pimpl_->packetQueue.push(transaction)) {
-        csdetails() << csname() << "Add valid transaction to conveyer id: " << id << ", queue size: " << pimpl_->packetQueue.size();
+    if (pimpl_->stagedCount >= MaxQueueSize) {
+        cswarning() << csname() << "Add transaction failed, too many transactions before flush, transaction id: " << id;
+        return;
     }
-    else {
-        cswarning() << csname() << "Add transaction failed to queue, transaction id: " << id << ", queue size: " << pimpl_->packetQueue.size();
+
+    Impl::StagingShard& shard = pimpl_->staging[stagingShardIndex()];
+
+    {
+        std::lock_guard<std::mutex> lock(shard.lock);
+        shard.transactions.push_back(transaction);
+        ++pimpl_->stagedCount;
     }
+
+    csdetails() << csname() << "Add valid transaction to conveyer id: " << id;
 }
 
 void cs::ConveyerBase::addSeparatePacket(const cs::TransactionsPacket& packet) {
     csdebug() << csname() << "Add separate transactions packet to conveyer, transactions " << packet.transactionsCount();
     cs::Lock lock(sharedMutex_);
 
+    // keep order of previously added transactions
+    drainStagedTransactions();
+
     // add current packet
     pimpl_->packetQueue.push(packet);
 }
@@ -124,6 +160,12 @@ const cs::PacketQueue& cs::ConveyerBase::packetQueue() const {
     return pimpl_->packetQueue;
 }
 
+const cs::PacketQueue& cs::ConveyerBase::lockedPacketQueue(const std::unique_lock<cs::SharedMutex>& lock) {
+    assert(lock.owns_lock() && lock.mutex() == &sharedMutex_);
+    drainStagedTransactions();
+    return pimpl_->packetQueue;
+}
+
 std::optional<std::pair<cs::TransactionsPacket, cs::Packets>> cs::ConveyerBase::createPacket() const {
     cs::Lock lock(sharedMutex_);
 
@@ -458,8 +500,10 @@ std::optional<csdb::Pool> cs::ConveyerBase::applyCharacteristic(const cs::PoolMe
         return std::nullopt;
     }
 
-    cs::TransactionsPacketTable hashTable;
     const cs::PacketsHashes& localHashes = meta->roundTable.hashes;
+    cs::TransactionsPacketTable hashTable;
+    hashTable.reserve(localHashes.size());
+
     const cs::Characteristic& characteristic = meta->characteristic;
     cs::TransactionsPacketTable& currentHashTable = poolTable(round);
 
@@ -474,16 +518,25 @@ std::optional<csdb::Pool> cs::ConveyerBase::applyCharacteristic(const cs::PoolMe
     cs::TransactionsPacket invalidTransactions;
 
     for (const auto& hash : localHashes) {
-        // try to get from meta if can
-        auto optionalPacket = findPacket(hash, round);
+        auto iterator = hashTable.find(hash);
 
-        if (!optionalPacket.has_value()) {
-            csmeta(cserror) << "hash not found " << hash.toString() << ", strage behaviour detected";
-            removeHashesFromTable(localHashes);
-            return std::nullopt;
+        if (iterator == hashTable.end()) {
+            // current table packets are removed after applying anyway, move them to storage hash table without copying
+            if (auto node = pimpl_->packetsTable.extract(hash); !node.empty()) {
+                iterator = hashTable.insert(std::move(node)).position;
+            }
+            // try to get from meta if can
+            else if (const cs::TransactionsPacket* found = findPacket(hash, round); found) {
+                iterator = hashTable.emplace(hash, *found).first;
+            }
+            else {
+                csmeta(cserror) << "hash not found " << hash.toString() << ", strage behaviour detected";
+                removeHashesFromTable(localHashes);
+                return std::nullopt;
+            }
         }
 
-        auto packet = std::move(optionalPacket).value();
+        const cs::TransactionsPacket& packet = iterator->second;
         const auto& transactions = packet.transactions();
 
         // first look at signatures if it is smarts packet
@@ -529,9 +582,6 @@ std::optional<csdb::Pool> cs::ConveyerBase::applyCharacteristic(const cs::PoolMe
             removeHashesFromTable(localHashes);
             return std::nullopt;
         }
-
-        // create storage hash table and remove from current hash table
-        hashTable.emplace(hash, std::move(packet));
     }
 
     // remove current hashes from table
@@ -569,24 +619,37 @@ std::optional<csdb::Pool> cs::ConveyerBase::applyCharacteristic(const cs::PoolMe
     return std::make_optional<csdb::Pool>(std::move(newPool));
 }
 
-std::optional<cs::TransactionsPacket> cs::ConveyerBase::findPacket(const cs::TransactionsPacketHash& hash, const RoundNumber round) const {
+const cs::TransactionsPacket* cs::ConveyerBase::findPacket(const cs::TransactionsPacketHash& hash, const RoundNumber round) const {
     if (auto iterator = pimpl_->packetsTable.find(hash); iterator != pimpl_->packetsTable.end()) {
-        return iterator->second;
+        return &iterator->second;
     }
 
     cs::ConveyerMeta* meta = pimpl_->metaStorage.get(round);
 
     if (!meta) {
-        return std::nullopt;
+        return nullptr;
     }
 
     const auto& value = meta->hashTable;
 
     if (auto iter = value.find(hash); iter != value.end()) {
-        return iter->second;
+        return &iter->second;
     }
 
-    return std::nullopt;
+    return nullptr;
+}
+
+cs::Packets cs::ConveyerBase::findPackets(const cs::PacketsHashes& hashes, const cs::RoundNumber round) const {
+    cs::Packets packets;
+    cs::SharedLock lock(sharedMutex_);
+
+    for (const auto& hash : hashes) {
+        if (const cs::TransactionsPacket* packet = findPacket(hash, round); packet) {
+            packets.push_back(*packet);
+        }
+    }
+
+    return packets;
 }
 
 bool cs::ConveyerBase::isMetaTransactionInvalid(int64_t id) {
@@ -606,16 +669,7 @@ bool cs::ConveyerBase::isMetaTransactionInvalid(int64_t id) {
 
 size_t cs::ConveyerBase::packetQueueTransactionsCount() const {
     cs::SharedLock lock(sharedMutex_);
-    size_t count = 0;
-
-    auto begin = pimpl_->packetQueue.begin();
-    auto end = pimpl_->packetQueue.end();
-
-    std::for_each(begin, end, [&](const auto& packet) {
-        count += packet.transactionsCount();
-    });
-
-    return count;
+    return pimpl_->stagedCount + pimpl_->packetQueue.transactionsCount();
 }
 
 std::unique_lock<cs::SharedMutex> cs::ConveyerBase::lock() const {
@@ -625,6 +679,7 @@ std::unique_lock<cs::SharedMutex> cs::ConveyerBase::lock() const {
 void cs::ConveyerBase::flushTransactions() {
     cs::Lock lock(sharedMutex_);
 
+    drainStagedTransactions();
     auto packets = pimpl_->packetQueue.pop();
 
     for (auto& packet : packets) {
@@ -650,6 +705,31 @@ void cs::ConveyerBase::flushTransactions() {
     }
 }
 
+void cs::ConveyerBase::drainStagedTransactions() {
+    if (pimpl_->stagedCount == 0) {
+        return;
+    }
+
+    std::vector<csdb::Transaction> transactions;
+
+    for (Impl::StagingShard& shard : pimpl_->staging) {
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            transactions.swap(shard.transactions);
+            pimpl_->stagedCount -= transactions.size();
+        }
+
+        for (const auto& transaction : transactions) {
+            if (!pimpl_->packetQueue.push(transaction)) {
+                cswarning() << csname() << "Add transaction failed to queue, transaction id: " << transaction.innerID() << ", queue size: " << pimpl_->packetQueue.size();
+            }
+        }
+
+        // cleared buffer goes to the next shard with its capacity
+        transactions.clear();
+    }
+}
+
 void cs::ConveyerBase::removeHashesFromTable(const cs::PacketsHashes& hashes) {
     for (const auto& hash : hashes) {
         pimpl_->packetsTable.erase(hash);
@@ -28,20 +28,25 @@ std::array<std::tuple<size_t, double, double>, 14> feeLevels = {
 
 namespace fee {
 
-csdb::AmountCommission getFee(const csdb::Transaction& t) {
-    size_t size = t.to_byte_stream().size();
-
-    if (!SmartContracts::is_smart_contract(t)) {
-        if (size <= kCommonTrSize) {
-            return csdb::AmountCommission(kMinFee);
-        } else if (size <= kCommonTrSize + 55) { // 50 chars string in user field
-            return csdb::AmountCommission(kMinFee * 3);
-        }
+namespace {
+// fee of a transaction which is not a smart contract one, false if its size is not a common one
+bool getCommonFee(size_t size, csdb::AmountCommission& fee) {
+    if (size <= kCommonTrSize) {
+        fee = csdb::AmountCommission(kMinFee);
+        return true;
+    } else if (size <= kCommonTrSize + 55) { // 50 chars string in user field
+        fee = csdb::AmountCommission(kMinFee * 3);
+        return true;
     }
 
+    return false;
+}
+
+template <typename IsDeploy>
+csdb::AmountCommission getLevelFee(size_t size, IsDeploy isDeploy) {
     for (const auto& level : feeLevels) {
         if (size < std::get<0>(level)) {
-            if (SmartContracts::is_deploy(t)) {
+            if (isDeploy()) {
                 return csdb::AmountCommission(std::get<1>(level));
             }
             return csdb::AmountCommission(std::get<2>(level));
@@ -51,6 +56,41 @@ csdb::AmountCommission getFee(const csdb::Transaction& t) {
     double k = static_cast<double>(size) / std::get<0>(feeLevels[feeLevels.size() - 1]);
     return csdb::AmountCommission(std::get<1>(feeLevels[feeLevels.size() - 1]) * k);
 }
+}  // namespace
+
+csdb::AmountCommission getFee(const csdb::Transaction& t) {
+    size_t size = t.to_byte_stream().size();
+    csdb::AmountCommission fee;
+
+    if (!SmartContracts::is_smart_contract(t) && getCommonFee(size, fee)) {
+        return fee;
+    }
+
+    return getLevelFee(size, [&t] { return SmartContracts::is_deploy(t); });
+}
+
+csdb::AmountCommission getFee(const TransactionsBatch& batch, size_t index) {
+    // the same check as SmartContracts::is_smart_contract() does
+    auto type = batch.userFieldType(index, trx_uf::deploy::Code);
+
+    if (type == csdb::UserField::Unknown) {
+        type = batch.userFieldType(index, trx_uf::new_state::Value);
+    }
+
+    if (type == csdb::UserField::String) {
+        return getFee(batch.transaction(index));
+    }
+
+    // the size is counted without serialization
+    const size_t size = batch.serializedSize(index);
+    csdb::AmountCommission fee;
+
+    if (getCommonFee(size, fee)) {
+        return fee;
+    }
+
+    return getLevelFee(size, [] { return false; });
+}
 
 bool estimateMaxFee(const csdb::Transaction& t, csdb::AmountCommission& countedFee) {
     countedFee = getFee(t);
@@ -65,7 +105,21 @@ bool estimateMaxFee(const csdb::Transaction& t, csdb::AmountCommission& countedF
 
 void setCountedFees(Transactions& trxs) {
     for (auto& t : trxs) {
-        t.set_counted_fee(getFee(t));  
+        t.set_counted_fee(getFee(t));
+    }
+}
+
+void setCountedFees(TransactionsBatch& batch) {
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch.setCountedFee(i, getFee(batch, i));
+    }
+}
+
+void setCountedFees(TransactionsBatch& batch, Transactions& trxs) {
+    setCountedFees(batch);
+
+    for (size_t i = 0; i < trxs.size(); ++i) {
+        trxs[i].set_counted_fee(batch.countedFee(i));
     }
 }
 } // namespace fee
@@ -1,7 +1,11 @@
 #include <csnode/itervalidator.hpp>
 
 #include <cstring>
+#include <numeric>
+#include <unordered_map>
 
+#include <csnode/fee.hpp>
+#include <csnode/walletscache.hpp>
 #include <csnode/walletsstate.hpp>
 #include <smartcontracts.hpp>
 #include <solvercontext.hpp>
@@ -10,6 +14,22 @@ namespace {
 const char* kLogPrefix = "Validator: ";
 const uint8_t kInvalidMarker = 0;
 const uint8_t kValidMarker = 1;
+
+// the same checks as SmartContracts::is_smart_contract() and SmartContracts::is_new_state() do, without copying user fields
+bool isSmartContract(const cs::TransactionsBatch& batch, size_t index) {
+    auto type = batch.userFieldType(index, cs::trx_uf::deploy::Code);
+
+    if (type == csdb::UserField::Unknown) {
+        type = batch.userFieldType(index, cs::trx_uf::new_state::Value);
+    }
+
+    return type == csdb::UserField::String;
+}
+
+bool isNewState(const cs::TransactionsBatch& batch, size_t index) {
+    return batch.userFieldType(index, cs::trx_uf::new_state::Value) == csdb::UserField::String &&
+           batch.userFieldType(index, cs::trx_uf::new_state::RefStart) == csdb::UserField::String;
+}
 }  // namespace
 
 namespace cs {
@@ -22,19 +42,39 @@ Characteristic IterValidator::formCharacteristic(SolverContext& context, Transac
     cs::Characteristic characteristic;
     characteristic.mask.resize(transactions.size(), kValidMarker);
 
+    batch_.clear();
+    batch_.reserve(transactions.size());
+
+    for (const auto& transaction : transactions) {
+        batch_.add(transaction);
+    }
+
     checkTransactionsSignatures(context, transactions, characteristic.mask, smartsPackets);
 
-    bool needNewIteration = false;
+    // counted fees do not depend on the mask, so they are set once
+    fee::setCountedFees(batch_, transactions);
+    context.wallets().updateFromSource();
+    pTransval_->reset(transactions.size());
+    dependencies_.reset(0);
+
+    // the first iteration validates all the transactions, the next ones only the transactions
+    // depending on the wallets of the ones rejected or restored by the previous iteration
+    TransactionsDependencies::Indices indices(transactions.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
     size_t iterationCounter = 1;
 
-    do {
-        csdebug() << kLogPrefix << "current iteration: " << iterationCounter;
-        context.blockchain().setTransactionsFees(transactions, characteristic.mask);
-        context.wallets().updateFromSource();
-        pTransval_->reset(transactions.size());
-        needNewIteration = validateTransactions(context, characteristic.mask, transactions);
+    while (!indices.empty()) {
+        csdebug() << kLogPrefix << "current iteration: " << iterationCounter << ", transactions to validate: " << indices.size();
+        previousMask_ = characteristic.mask;
+
+        if (!validateTransactions(context, characteristic.mask, transactions, indices)) {
+            break;
+        }
+
+        indices = prepareNextIteration(context, transactions, characteristic.mask);
         ++iterationCounter;
-    } while (needNewIteration);
+    }
 
     checkRejectedSmarts(context, characteristic.mask, transactions);
     pTransval_->clearCaches();
@@ -42,6 +82,65 @@ Characteristic IterValidator::formCharacteristic(SolverContext& context, Transac
     return characteristic;
 }
 
+TransactionsDependencies::Indices IterValidator::prepareNextIteration(SolverContext& context, const Transactions& transactions, const cs::Bytes& characteristicMask) {
+    TransactionsDependencies::Indices changed;
+
+    for (size_t i = 0; i < characteristicMask.size(); ++i) {
+        if (characteristicMask[i] != previousMask_[i]) {
+            changed.push_back(i);
+        }
+    }
+
+    if (changed.empty()) {
+        return changed;
+    }
+
+    if (dependencies_.empty()) {
+        buildDependencies(context, transactions);
+    }
+
+    TransactionsDependencies::Addresses wallets;
+    auto indices = dependencies_.affected(changed, wallets);
+
+    for (const auto& address : wallets) {
+        context.wallets().restore(address);
+    }
+
+    pTransval_->reset(indices);
+
+    csdebug() << kLogPrefix << changed.size() << " changed transaction(s) affect " << indices.size() << " of " << transactions.size() << " transactions, "
+              << wallets.size() << " wallet(s) restored";
+
+    return indices;
+}
+
+void IterValidator::buildDependencies(SolverContext& context, const Transactions& transactions) {
+    auto& wallets = context.wallets();
+    dependencies_.reset(transactions.size());
+
+    auto add = [&](size_t index, const csdb::Address& address) {
+        WalletsState::WalletId id{};
+        dependencies_.add(index, address, &wallets.getData(address, id));
+    };
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        const auto& transaction = transactions[i];
+        add(i, transaction.source());
+        add(i, transaction.target());
+
+        // new_state is paid from the starter transaction source
+        if (isNewState(batch_, i)) {
+            const csdb::Transaction starter = WalletsCache::findSmartContractInitTrx(transaction, context.blockchain());
+
+            if (starter.is_valid()) {
+                add(i, starter.source());
+            }
+        }
+    }
+
+    csdebug() << kLogPrefix << transactions.size() << " transactions are split to " << dependencies_.groupsCount() << " independent groups";
+}
+
 void IterValidator::checkRejectedSmarts(SolverContext& context, cs::Bytes& characteristicMask, const Transactions& transactions) {
     // test if any of smart-emitted transaction rejected, reject all transactions from this smart
     // 1. collect rejected smart addresses
@@ -101,13 +200,13 @@ void IterValidator::checkRejectedSmarts(SolverContext& context, cs::Bytes& chara
     }
 }
 
-bool IterValidator::validateTransactions(SolverContext& context, cs::Bytes& characteristicMask, const Transactions& transactions) {
+bool IterValidator::validateTransactions(SolverContext& context, cs::Bytes& characteristicMask, const Transactions& transactions,
+                                         const TransactionsDependencies::Indices& indices) {
     bool needOneMoreIteration = false;
-    const size_t transactionsCount = transactions.size();
     size_t blockedCounter = 0;
 
     // validate each transaction
-    for (size_t i = 0; i < transactionsCount; ++i) {
+    for (const auto i : indices) {
         if (characteristicMask[i] == kInvalidMarker) {
             continue;
         }
@@ -115,7 +214,7 @@ bool IterValidator::validateTransactions(SolverContext& context, cs::Bytes& char
         const csdb::Transaction& transaction = transactions[i];
         bool isValid = pTransval_->validateTransaction(context, transactions, i);
 
-        if (isValid && SmartContracts::is_deploy(transaction)) {
+        if (isValid && isSmartContract(batch_, i) && SmartContracts::is_deploy(transaction)) {
             isValid = deployAdditionalCheck(context, i, transaction);
         }
 
@@ -131,7 +230,7 @@ bool IterValidator::validateTransactions(SolverContext& context, cs::Bytes& char
     }
 
     // validation of all transactions by graph
-    size_t restoredCounter = pTransval_->checkRejectedSmarts(context, transactions, characteristicMask);
+    size_t restoredCounter = pTransval_->checkRejectedSmarts(context, transactions, indices, characteristicMask);
     if (blockedCounter == restoredCounter) {
         needOneMoreIteration = false;
     }
@@ -142,7 +241,9 @@ bool IterValidator::validateTransactions(SolverContext& context, cs::Bytes& char
         needOneMoreIteration = true;
     }
 
-    needOneMoreIteration = false; // iterations switched off
+    if (!context.validation_iterations()) {
+        needOneMoreIteration = false;  // iterations switched off
+    }
 
     return needOneMoreIteration;
 }
@@ -166,57 +267,76 @@ bool IterValidator::deployAdditionalCheck(SolverContext& context, size_t trxInd,
 
 void IterValidator::checkTransactionsSignatures(SolverContext& context, const Transactions& transactions, cs::Bytes& characteristicMask, Packets& smartsPackets) {
     checkSignaturesSmartSource(context, smartsPackets);
-    size_t transactionsCount = transactions.size();
-    size_t maskSize = characteristicMask.size();
+    const size_t count = std::min(transactions.size(), characteristicMask.size());
     size_t rejectedCounter = 0;
-    for (size_t i = 0; i < transactionsCount; ++i) {
-        if (i < maskSize) {
-            bool correctSignature = checkTransactionSignature(context, transactions[i]);
-            if (!correctSignature) {
+
+    // public keys of the wallet ids are found once per round
+    std::unordered_map<csdb::internal::WalletId, cs::PublicKey> walletsKeys;
+
+    signaturesVerifier_.clear();
+    signaturesVerifier_.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const csdb::Transaction& transaction = transactions[i];
+        const csdb::Address source = transaction.source();
+
+        // TODO: is_known_smart_contract() does not recognize not yet deployed contract, so all transactions emitted in constructor
+        // currently will be rejected
+        const bool newState = isNewState(batch_, i);
+        const bool smartSourceTransaction = !isSmartContract(batch_, i) && context.smart_contracts().is_known_smart_contract(source);
+
+        if (newState || smartSourceTransaction) {
+            if (!checkSmartTransactionSignature(transaction)) {
                 characteristicMask[i] = kInvalidMarker;
-                rejectedCounter++;
+                ++rejectedCounter;
                 cslog() << kLogPrefix << "transaction[" << i << "] rejected, incorrect signature.";
-                if (SmartContracts::is_new_state(transactions[i])) {
-                    pTransval_->addRejectedNewState(context.smart_contracts().absolute_address(transactions[i].source()));
+
+                if (newState) {
+                    pTransval_->addRejectedNewState(context.smart_contracts().absolute_address(source));
                 }
             }
+
+            continue;
+        }
+
+        if (!source.is_wallet_id()) {
+            signaturesVerifier_.add(i, transaction, source.public_key());
+            continue;
+        }
+
+        auto it = walletsKeys.find(source.wallet_id());
+
+        if (it == walletsKeys.end()) {
+            BlockChain::WalletData walletData;
+            context.blockchain().findWalletData(source.wallet_id(), walletData);
+            it = walletsKeys.emplace(source.wallet_id(), walletData.address_).first;
         }
+
+        signaturesVerifier_.add(i, transaction, it->second);
+    }
+
+    for (const auto index : signaturesVerifier_.verify(characteristicMask)) {
+        ++rejectedCounter;
+        cslog() << kLogPrefix << "transaction[" << index << "] rejected, incorrect signature.";
     }
+
     if (rejectedCounter) {
         cslog() << kLogPrefix << "wrong signatures num: " << rejectedCounter;
     }
 }
 
-bool IterValidator::checkTransactionSignature(SolverContext& context, const csdb::Transaction& transaction) {
-    BlockChain::WalletData data_to_fetch_pulic_key;
-    csdb::Address src = transaction.source();
-    // TODO: is_known_smart_contract() does not recognize not yet deployed contract, so all transactions emitted in constructor
-    // currently will be rejected
-    bool smartSourceTransaction = false;
-    bool isSmart = SmartContracts::is_smart_contract(transaction);
-    if (!isSmart) {
-        smartSourceTransaction = context.smart_contracts().is_known_smart_contract(transaction.source());
+bool IterValidator::checkSmartTransactionSignature(const csdb::Transaction& transaction) const {
+    // special rule for new_state transactions
+    if (SmartContracts::is_new_state(transaction) && transaction.source() != transaction.target()) {
+        csdebug() << kLogPrefix << "smart state transaction has different source and target";
+        return false;
     }
-    if (!SmartContracts::is_new_state(transaction) && !smartSourceTransaction) {
-        if (src.is_wallet_id()) {
-            context.blockchain().findWalletData(src.wallet_id(), data_to_fetch_pulic_key);
-            return transaction.verify_signature(data_to_fetch_pulic_key.address_);
-        }
-        return transaction.verify_signature(src.public_key());
-    }
-    else {
-        // special rule for new_state transactions
-        if (SmartContracts::is_new_state(transaction) && src != transaction.target()) {
-            csdebug() << kLogPrefix << "smart state transaction has different source and target";
-            return false;
-        }
-        auto it = smartSourceInvalidSignatures_.find(transaction.source());
-        if (it != smartSourceInvalidSignatures_.end()) {
-            csdebug() << kLogPrefix << "smart contract transaction has invalid signature";
-            return false;
-        }
-        return true;
+    auto it = smartSourceInvalidSignatures_.find(transaction.source());
+    if (it != smartSourceInvalidSignatures_.end()) {
+        csdebug() << kLogPrefix << "smart contract transaction has invalid signature";
+        return false;
     }
+    return true;
 }
 
 void IterValidator::checkSignaturesSmartSource(SolverContext& context, cs::Packets& smartContractsPackets) {
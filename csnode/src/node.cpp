@@ -12,11 +12,13 @@
 #include <csnode/nodeutils.hpp>
 #include <csnode/poolsynchronizer.hpp>
 
+#include <lib/system/binarylog.hpp>
 #include <lib/system/logger.hpp>
 #include <lib/system/progressbar.hpp>
 #include <lib/system/signals.hpp>
 #include <lib/system/utils.hpp>
 
+#include <net/messagecompression.hpp>
 #include <net/transport.hpp>
 #include <net/packetvalidator.hpp>
 
@@ -39,20 +41,32 @@ Node::Node(const Config& config)
 , blockChain_(genesisAddress_, startAddress_)
 , allocator_(1 << 24, 5)
 , packStreamAllocator_(1 << 26, 5)
+, blocksReplyCache_(blocksReplyCacheSize_)
 , ostream_(&packStreamAllocator_, nodeIdKey_)
 , stat_() {
+    // dictionary is set before any message is received
+    cs::MessageCompression::instance().setDictionary(config.getCompressionDictionary());
+    ostream_.setMessageCompression(config.isMessageCompression());
+
     solver_ = new cs::SolverCore(this, genesisAddress_, startAddress_);
+    solver_->setValidationIterations(config.isValidationIterations());
     std::cout << "Start transport... ";
     transport_ = new Transport(config, this);
     std::cout << "Done\n";
     poolSynchronizer_ = new cs::PoolSynchronizer(config.getPoolSyncSettings(), transport_, &blockChain_);
 
-    auto& executor = executor::Executor::getInstance(&blockChain_, solver_, config.getApiSettings().executorPort);
+    auto& executor = executor::Executor::getInstance(&blockChain_, solver_, config.getApiSettings().executorPort,
+                                                     config.getApiSettings().executorConnections);
 
     cs::Connector::connect(&blockChain_.readBlockEvent(), &stat_, &cs::RoundStat::onReadBlock);
     cs::Connector::connect(&blockChain_.storeBlockEvent, &stat_, &cs::RoundStat::onStoreBlock);
     cs::Connector::connect(&blockChain_.storeBlockEvent, &executor, &executor::Executor::onBlockStored);
     cs::Connector::connect(&blockChain_.readBlockEvent(), &executor, &executor::Executor::onReadBlock);
+    cs::Connector::connect(&blockChain_.saveStateEvent, &stat_, &cs::RoundStat::onSaveState);
+    cs::Connector::connect(&blockChain_.loadStateEvent, &stat_, &cs::RoundStat::onLoadState);
+    cs::Connector::connect(&blockChain_.saveStateEvent, &executor, &executor::Executor::onSaveState);
+    cs::Connector::connect(&blockChain_.loadStateEvent, &executor, &executor::Executor::onLoadState);
+    cs::Connector::connect(&blockChain_.removeBlockEvent, &blocksReplyCache_, &cs::BlocksReplyCache::removeFrom);
     cs::Connector::connect(&transport_->pingReceived, this, &Node::onPingReceived);
     cs::Connector::connect(&Node::stopRequested, this, &Node::onStopRequested);
 
@@ -75,6 +89,8 @@ bool Node::init(const Config& config) {
         csconnector::Config{config.getApiSettings().port, config.getApiSettings().ajaxPort, config.getApiSettings().executorPort, config.getApiSettings().apiexecPort});
     std::cout << "Done\n";
     cs::Connector::connect(&blockChain_.readBlockEvent(), api_.get(), &csconnector::connector::onReadFromDB);
+    cs::Connector::connect(&blockChain_.saveStateEvent, api_.get(), &csconnector::connector::onSaveState);
+    cs::Connector::connect(&blockChain_.loadStateEvent, api_.get(), &csconnector::connector::onLoadState);
     cs::Connector::connect(&blockChain_.storeBlockEvent, api_.get(), &csconnector::connector::onStoreBlock);
 #endif  // NODE_API
 
@@ -83,6 +99,11 @@ bool Node::init(const Config& config) {
     }
     cslog() << "Blockchain is ready, contains " << WithDelimiters(stat_.total_transactions()) << " transactions";
 
+    // wallet id and public key sources of one wallet share the queue ordered by inner id
+    cs::Conveyer::instance().setSourceResolver([this](const csdb::Address& source) {
+        return blockChain_.getAddressByType(source, BlockChain::AddressType::PublicKey);
+    });
+
 #ifdef NODE_API
     api_->run();
 #endif  // NODE_API
@@ -607,34 +628,13 @@ void Node::getBlockRequest(const uint8_t* data, const size_t size, const cs::Pub
         return;
     }
 
-    const bool isOneBlockReply = poolSynchronizer_->isOneBlockReply();
-    const std::size_t reserveSize = isOneBlockReply ? 1 : sequences.size();
-
-    cs::PoolsBlock poolsBlock;
-    poolsBlock.reserve(reserveSize);
-
-    auto sendReply = [&] {
-        sendBlockReply(poolsBlock, sender, packetNum);
-        poolsBlock.clear();
-    };
-
-    for (auto& sequence : sequences) {
-        csdb::Pool pool = blockChain_.loadBlock(sequence);
-
-        if (pool.is_valid()) {
-            poolsBlock.push_back(std::move(pool));
-
-            if (isOneBlockReply) {
-                sendReply();
-            }
-        }
-        else {
-            csmeta(cserror) << "Load block: " << sequence << " from blockchain is Invalid";
+    if (poolSynchronizer_->isOneBlockReply()) {
+        for (const auto sequence : sequences) {
+            sendBlockReply(cs::PoolsRequestedSequences{sequence}, sender, packetNum);
         }
     }
-
-    if (!isOneBlockReply) {
-        sendReply();
+    else {
+        sendBlockReply(sequences, sender, packetNum);
     }
 }
 
@@ -663,20 +663,31 @@ void Node::getBlockReply(const uint8_t* data, const size_t size) {
     poolSynchronizer_->getBlockReply(std::move(poolsBlock), packetNum);
 }
 
-void Node::sendBlockReply(const cs::PoolsBlock& poolsBlock, const cs::PublicKey& target, std::size_t packetNum) {
-    for (const auto& pool : poolsBlock) {
-        csdebug() << "NODE> Send block reply. Sequence: " << pool.sequence();
-    }
+void Node::sendBlockReply(const cs::PoolsRequestedSequences& sequences, const cs::PublicKey& target, std::size_t packetNum) {
+    csdebugf("NODE> Send block reply. Sequences: {} - {}, count: {}", sequences.front(), sequences.back(), sequences.size());
+
+    cs::BlocksReplyCache::FramePtr frame = blocksReplyCache_.find(sequences);
+
+    if (!frame) {
+        frame = compressPoolsBlock(sequences);
+
+        if (!frame) {
+            return;
+        }
 
-    csdebug() << "Node> Sending blocks with signatures:";
-    for (const auto& it : poolsBlock) {
-        csdebug() << "#" << it.sequence() << " signs = " << it.signatures().size();
+        // the last block may still be replaced, so replies with it are not cached
+        if (frame->blocksCount == sequences.size() && sequences.back() < blockChain_.getLastSequence()) {
+            blocksReplyCache_.insert(sequences, frame);
+        }
     }
 
-    std::size_t realBinSize = 0;
-    RegionPtr memPtr = compressPoolsBlock(poolsBlock, realBinSize);
+    csdebugf("NODE> Send block reply. Cache hits: {}, misses: {}", blocksReplyCache_.hits(), blocksReplyCache_.misses());
+
+    RegionPtr memPtr = allocator_.allocateNext(cs::numeric_cast<uint32_t>(frame->data.size()));
+    std::copy(frame->data.begin(), frame->data.end(), static_cast<cs::Byte*>(memPtr.get()));
 
-    tryToSendDirect(target, MsgTypes::RequestedBlock, cs::Conveyer::instance().currentRoundNumber(), realBinSize, cs::numeric_cast<uint32_t>(memPtr.size()), memPtr, packetNum);
+    tryToSendDirect(target, MsgTypes::RequestedBlock, cs::Conveyer::instance().currentRoundNumber(), frame->binSize, cs::numeric_cast<uint32_t>(memPtr.size()), memPtr,
+                    packetNum);
 }
 
 void Node::becomeWriter() {
@@ -687,18 +698,7 @@ void Node::becomeWriter() {
 void Node::processPacketsRequest(cs::PacketsHashes&& hashes, const cs::RoundNumber round, const cs::PublicKey& sender) {
     csdebug() << "NODE> Processing packets sync request";
 
-    cs::Packets packets;
-
-    const auto& conveyer = cs::Conveyer::instance();
-    std::unique_lock<cs::SharedMutex> lock = conveyer.lock();
-
-    for (const auto& hash : hashes) {
-        std::optional<cs::TransactionsPacket> packet = conveyer.findPacket(hash, round);
-
-        if (packet) {
-            packets.push_back(std::move(packet).value());
-        }
-    }
+    cs::Packets packets = cs::Conveyer::instance().findPackets(hashes, round);
 
     if (packets.empty()) {
         csdebug() << "NODE> Cannot find packets in storage";
@@ -813,6 +813,7 @@ void Node::sendBlockRequest(const ConnectionPtr target, const cs::PoolsRequested
     csmeta(csdetails) << "Target out(): " << target->getOut() << ", sequence from: " << sequences.front() << ", to: " << sequences.back() << ", packet: " << packetNum
                       << ", round: " << round;
 
+    ostream_.setPacketSize(target->packetSize);
     ostream_.init(BaseFlags::Neighbours | BaseFlags::Signed | BaseFlags::Compressed);
     ostream_ << MsgTypes::BlockRequest;
     ostream_ << round;
@@ -1020,6 +1021,8 @@ template <typename... Args>
 void Node::sendDefault(const cs::PublicKey& target, const MsgTypes msgType, const cs::RoundNumber round, Args&&... args) {
     static constexpr cs::Byte defautFlags = 0; // BaseFlags::Fragmented;
 
+    // the message may be relayed by other nodes, the relayed fragments are not split again
+    ostream_.setPacketSize(Packet::DefaultSize);
     ostream_.init(defautFlags, target);
     csdetails() << "NODE> Sending default to key: " << cs::Utils::byteStreamToHex(target.data(), target.size());
 
@@ -1039,6 +1042,8 @@ bool Node::sendToNeighbour(const cs::PublicKey& target, const MsgTypes msgType,
 
 template <typename... Args>
 void Node::sendToNeighbour(const ConnectionPtr target, const MsgTypes msgType, const cs::RoundNumber round, Args&&... args) {
+    // messages to neighbours are not relayed, so they use the size agreed with the neighbour
+    ostream_.setPacketSize(target->packetSize);
     ostream_.init(BaseFlags::Neighbours | BaseFlags::Broadcast /*| BaseFlags::Fragmented*/ | BaseFlags::Compressed);
     ostream_ << msgType << round;
 
@@ -1053,6 +1058,8 @@ void Node::sendToNeighbour(const ConnectionPtr target, const MsgTypes msgType, c
 
 template <class... Args>
 void Node::sendBroadcast(const MsgTypes msgType, const cs::RoundNumber round, Args&&... args) {
+    // broadcast is relayed by the neighbours to the nodes which may not support the larger packets
+    ostream_.setPacketSize(Packet::DefaultSize);
     ostream_.init(BaseFlags::Broadcast /*| BaseFlags::Fragmented*/ | BaseFlags::Compressed);
     csdetails() << "NODE> Sending broadcast";
 
@@ -1130,6 +1137,7 @@ bool Node::sendToNeighbours(const MsgTypes msgType, const cs::RoundNumber round,
 
 template <typename... Args>
 void Node::sendBroadcast(const cs::PublicKey& target, const MsgTypes& msgType, const cs::RoundNumber round, Args&&... args) {
+    ostream_.setPacketSize(Packet::DefaultSize);
     ostream_.init(BaseFlags::Fragmented | BaseFlags::Compressed, target);
     csdetails() << "NODE> Sending broadcast to key: " << cs::Utils::byteStreamToHex(target.data(), target.size());
 
@@ -1149,29 +1157,51 @@ void Node::sendBroadcastImpl(const MsgTypes& msgType, const cs::RoundNumber roun
     ostream_.clear();
 }
 
-RegionPtr Node::compressPoolsBlock(const cs::PoolsBlock& poolsBlock, std::size_t& realBinSize) {
+cs::BlocksReplyCache::FramePtr Node::compressPoolsBlock(const cs::PoolsRequestedSequences& sequences) {
+    // stored block bytes are the same as csdb::Pool serialization in cs::DataStream,
+    // so vector of them is read by receiver as cs::PoolsBlock
+    std::vector<cs::Bytes> blocks;
+    blocks.reserve(sequences.size());
+
+    for (const auto sequence : sequences) {
+        cs::Bytes block = blockChain_.loadBlockBinary(sequence);
+
+        if (block.empty()) {
+            csmeta(cserror) << "Load block: " << sequence << " from blockchain is Invalid";
+            continue;
+        }
+
+        blocks.push_back(std::move(block));
+    }
+
+    if (blocks.empty()) {
+        return nullptr;
+    }
+
     cs::Bytes bytes;
     cs::DataStream stream(bytes);
 
-    stream << poolsBlock;
+    stream << blocks;
 
-    char* data = reinterpret_cast<char*>(bytes.data());
+    const char* data = reinterpret_cast<const char*>(bytes.data());
     const int binSize = cs::numeric_cast<int>(bytes.size());
 
-    const auto maxSize = LZ4_compressBound(binSize);
-    auto memPtr = allocator_.allocateNext(static_cast<uint32_t>(maxSize));
+    auto frame = std::make_shared<cs::BlocksReplyCache::Frame>();
+    frame->binSize = bytes.size();
+    frame->blocksCount = blocks.size();
+    frame->data.resize(cs::numeric_cast<std::size_t>(LZ4_compressBound(binSize)));
 
-    const int compressedSize = LZ4_compress_default(data, static_cast<char*>(memPtr.get()), binSize, cs::numeric_cast<int>(memPtr.size()));
+    const int compressedSize = LZ4_compress_default(data, reinterpret_cast<char*>(frame->data.data()), binSize, cs::numeric_cast<int>(frame->data.size()));
 
     if (!compressedSize) {
         csmeta(cserror) << "Compress poools block error";
+        return nullptr;
     }
 
-    allocator_.shrinkLast(cs::numeric_cast<uint32_t>(compressedSize));
-
-    realBinSize = cs::numeric_cast<std::size_t>(binSize);
+    frame->data.resize(cs::numeric_cast<std::size_t>(compressedSize));
+    frame->data.shrink_to_fit();
 
-    return memPtr;
+    return frame;
 }
 
 cs::PoolsBlock Node::decompressPoolsBlock(const uint8_t* data, const size_t size) {
@@ -2540,8 +2570,8 @@ void Node::onRoundStart(const cs::RoundTable& roundTable) {
     csdebug() << " Node key " << cs::Utils::byteStreamToHex(nodeIdKey_);
     cslog() << " Last written sequence = " << WithDelimiters(blockChain_.getLastSequence()) << ", neighbours = " << transport_->getNeighboursCount();
 
-    if (Transport::cntCorruptedFragments > 0 || Transport::cntDirtyAllocs > 0 || Transport::cntExtraLargeNotSent > 0) {
-        cslog() << " ! " << Transport::cntDirtyAllocs << " / " << Transport::cntCorruptedFragments << " / " << Transport::cntExtraLargeNotSent;
+    if (Transport::cntExtraLargeNotSent > 0) {
+        cslog() << " ! " << Transport::cntExtraLargeNotSent;
     }
 
     std::ostringstream line2;
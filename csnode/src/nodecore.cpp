@@ -1,5 +1,7 @@
 #include "nodecore.hpp"
 
+#include <cstring>
+
 namespace cs {
 Zero::Zero() {
     hash.fill(0);
@@ -14,12 +16,19 @@ static const cs::Zero zero;
 }  // namespace
 
 std::size_t std::hash<cs::TransactionsPacketHash>::operator()(const cs::TransactionsPacketHash& packetHash) const noexcept {
+    const auto& data = packetHash.toBinary();
+    auto size = data.size();
+
+    // packet hash bytes are uniformly distributed already
+    if (size >= sizeof(std::size_t)) {
+        std::size_t hash;
+        std::memcpy(&hash, data.data(), sizeof(hash));
+        return hash;
+    }
+
     const std::size_t p = 16777619;
     std::size_t hash = 2166136261;
 
-    auto data = packetHash.toBinary();
-    auto size = data.size();
-
     for (std::size_t i = 0; i < size; ++i) {
         hash = (hash ^ data[i]) * p;
     }
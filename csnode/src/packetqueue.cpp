@@ -1,30 +1,70 @@
 #include <csnode/packetqueue.hpp>
 #include <csnode/conveyer.hpp>
 
+#include <csdb/amount_commission.hpp>
+
+#include <lib/system/logger.hpp>
+
+#include <algorithm>
+#include <limits>
+
 cs::PacketQueue::PacketQueue(size_t queueSize, size_t transactionsSize, size_t packetsPerRound)
-: maxQueueSize_(queueSize)
-, maxTransactionsSize_(transactionsSize)
+: maxTransactionsSize_(transactionsSize)
 , maxPacketsPerRound_(packetsPerRound) {
+    maxTransactionsCount_ = (transactionsSize != 0 && queueSize > std::numeric_limits<size_t>::max() / transactionsSize) ? std::numeric_limits<size_t>::max()
+                                                                                                                          : queueSize * transactionsSize;
+    transactionsCount_ = 0;
+    evictedCount_ = 0;
+    order_ = 0;
     cachedRound_ = 0;
     cachedPackets_ = 0;
 }
 
+void cs::PacketQueue::setSourceResolver(SourceResolver resolver) {
+    resolver_ = std::move(resolver);
+}
+
 bool cs::PacketQueue::push(const csdb::Transaction& transaction) {
-    if (queue_.size() >= maxQueueSize_) {
-        return false;
+    const double fee = transaction.max_fee().to_double();
+
+    if (transactionsCount_ >= maxTransactionsCount_) {
+        if (byFee_.empty() || fee <= byFee_.begin()->fee) {
+            return false;
+        }
+
+        auto cheapest = byFee_.begin();
+        cswarning() << "PacketQueue: queue is full, evict transaction id: " << cheapest->entry->first << ", source: " << cheapest->source->first.to_string()
+                    << ", fee: " << cheapest->fee;
+
+        erase(cheapest->source, cheapest->entry);
+
+        ++evictedCount_;
     }
 
-    if (queue_.empty() || queue_.back().transactions().size() >= maxTransactionsSize_) {
-        queue_.push_back(cs::TransactionsPacket{});
+    auto source = sources_.try_emplace(resolveSource(transaction.source())).first;
+    SourceQueue& queue = source->second;
+
+    const auto previousHead = queue.begin();
+    const bool hadHead = previousHead != queue.end();
+
+    auto entry = queue.emplace(transaction.innerID(), Entry{transaction, fee, order_++});
+    byFee_.insert(makeKey(source, entry));
+
+    if (queue.begin() == entry) {
+        if (hadHead) {
+            heads_.erase(makeKey(source, previousHead));
+        }
+
+        heads_.insert(makeKey(source, entry));
     }
 
-    return queue_.back().addTransaction(transaction);
+    ++transactionsCount_;
+    return true;
 }
 
 void cs::PacketQueue::push(const cs::TransactionsPacket& packet) {
     // ignore size of queue for packs
-    queue_.push_back(packet);
-    queue_.push_back(cs::TransactionsPacket{});
+    packets_.push_back(packet);
 }
 
 cs::TransactionsBlock cs::PacketQueue::pop() {
@@ -39,10 +79,21 @@ cs::TransactionsBlock cs::PacketQueue::pop() {
         cachedPackets_ = 0;
     }
 
-    while (!queue_.empty() && cachedPackets_ < maxPacketsPerRound_) {
-        block.push_back(std::move(queue_.front()));
-        queue_.pop_front();
+    while (!packets_.empty() && cachedPackets_ < maxPacketsPerRound_) {
+        block.push_back(std::move(packets_.front()));
+        packets_.pop_front();
+
+        ++cachedPackets_;
+    }
+
+    while (!heads_.empty() && cachedPackets_ < maxPacketsPerRound_) {
+        cs::TransactionsPacket packet;
+
+        while (!heads_.empty() && packet.transactionsCount() < maxTransactionsSize_) {
+            packet.addTransaction(takeMostValuable());
+        }
 
+        block.push_back(std::move(packet));
         ++cachedPackets_;
     }
 
@@ -50,22 +101,86 @@ cs::TransactionsBlock cs::PacketQueue::pop() {
     return block;
 }
 
-typename std::deque<cs::TransactionsPacket>::const_iterator cs::PacketQueue::begin() const {
-    return queue_.begin();
-}
+bool cs::PacketQueue::containsInnerId(int64_t innerId) const {
+    for (const auto& packet : packets_) {
+        for (const auto& transaction : packet.transactions()) {
+            if (transaction.innerID() == innerId) {
+                return true;
+            }
+        }
+    }
 
-typename std::deque<cs::TransactionsPacket>::const_iterator cs::PacketQueue::end() const {
-    return queue_.end();
+    for (const auto& [address, queue] : sources_) {
+        if (queue.find(innerId) != queue.end()) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 size_t cs::PacketQueue::size() const {
-    return queue_.size();
+    const size_t packetSize = std::max<size_t>(maxTransactionsSize_, 1);
+    return packets_.size() + (transactionsCount_ + packetSize - 1) / packetSize;
+}
+
+size_t cs::PacketQueue::transactionsCount() const {
+    size_t count = transactionsCount_;
+
+    for (const auto& packet : packets_) {
+        count += packet.transactionsCount();
+    }
+
+    return count;
+}
+
+size_t cs::PacketQueue::evictedCount() const {
+    return evictedCount_;
 }
 
 bool cs::PacketQueue::isEmpty() const {
-    return queue_.empty();
+    return packets_.empty() && transactionsCount_ == 0;
+}
+
+csdb::Address cs::PacketQueue::resolveSource(const csdb::Address& source) const {
+    if (!resolver_) {
+        return source;
+    }
+
+    csdb::Address resolved = resolver_(source);
+    return resolved.is_valid() ? resolved : source;
+}
+
+cs::PacketQueue::Key cs::PacketQueue::makeKey(Sources::iterator source, SourceQueue::iterator entry) {
+    return Key{entry->second.fee, entry->second.order, source, entry};
 }
 
-std::deque<cs::TransactionsPacket>::const_reference cs::PacketQueue::back() const {
-    return queue_.back();
+void cs::PacketQueue::erase(Sources::iterator source, SourceQueue::iterator entry) {
+    SourceQueue& queue = source->second;
+    const Key key = makeKey(source, entry);
+    const bool isHead = queue.begin() == entry;
+
+    byFee_.erase(key);
+
+    if (isHead) {
+        heads_.erase(key);
+    }
+
+    queue.erase(entry);
+    --transactionsCount_;
+
+    if (queue.empty()) {
+        sources_.erase(source);
+    }
+    else if (isHead) {
+        heads_.insert(makeKey(source, queue.begin()));
+    }
+}
+
+csdb::Transaction cs::PacketQueue::takeMostValuable() {
+    const Key head = *heads_.begin();
+    csdb::Transaction transaction = head.entry->second.transaction;
+
+    erase(head.source, head.entry);
+    return transaction;
 }
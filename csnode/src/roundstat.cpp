@@ -1,4 +1,7 @@
+#include <csnode/datastream.hpp>
 #include <csnode/roundstat.hpp>
+#include <csnode/signaturescache.hpp>
+#include <csnode/statesnapshot.hpp>
 #include <lib/system/logger.hpp>
 #include <sstream>
 
@@ -62,7 +65,8 @@ void RoundStat::onRoundStart(RoundNumber round) {
 
         os << ", "
            //<< totalReceivedTransactions_ << " viewed transactions, "
-           << WithDelimiters(totalAcceptedTransactions_) << " stored transactions.";
+           << WithDelimiters(totalAcceptedTransactions_) << " stored transactions, signatures cache "
+           << WithDelimiters(SignaturesCache::instance().hits()) << " hits / " << WithDelimiters(SignaturesCache::instance().misses()) << " misses.";
         cslog() << os.str();
     }
 }
@@ -75,4 +79,24 @@ void RoundStat::onStoreBlock(csdb::Pool block) {
     totalAcceptedTransactions_ += block.transactions_count();
 }
 
+void RoundStat::onSaveState(cs::StateSnapshot& snapshot) {
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+    stream << totalAcceptedTransactions_;
+    snapshot.setSection("round_stat", std::move(bytes));
+}
+
+void RoundStat::onLoadState(const cs::StateSnapshot& snapshot, bool* /*failed*/) {
+    // statistics only, so it is not a reason to read all blocks
+    if (const cs::Bytes* data = snapshot.section("round_stat"); data != nullptr) {
+        cs::DataStream stream(data->data(), data->size());
+        size_t total = 0;
+        stream >> total;
+
+        if (stream.isValid()) {
+            totalAcceptedTransactions_ = total;
+        }
+    }
+}
+
 }  // namespace cs
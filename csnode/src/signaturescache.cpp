@@ -0,0 +1,102 @@
+#include <csnode/signaturescache.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <cscrypto/cscrypto.hpp>
+#include <lib/system/hash.hpp>
+
+namespace cs {
+/*static*/
+SignaturesCache& SignaturesCache::instance() {
+    static SignaturesCache inst;
+    return inst;
+}
+
+SignaturesCache::SignaturesCache(size_t capacity)
+: shardCapacity_(std::max<size_t>(capacity / ShardsCount, 1)) {
+}
+
+bool SignaturesCache::verify(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Byte* data, size_t size) {
+    const cs::Hash dataHash = generateHash(data, size);
+
+    if (contains(signature, publicKey, dataHash)) {
+        return true;
+    }
+
+    if (!cscrypto::verifySignature(signature, publicKey, data, size)) {
+        return false;
+    }
+
+    insert(signature, publicKey, dataHash);
+    return true;
+}
+
+bool SignaturesCache::verify(const csdb::Transaction& transaction, const cs::PublicKey& publicKey) {
+    const auto bytes = transaction.to_byte_stream_for_sig();
+    return verify(transaction.signature(), publicKey, bytes.data(), bytes.size());
+}
+
+bool SignaturesCache::contains(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Hash& dataHash) {
+    Shard& target = shard(signature);
+    bool found = false;
+
+    {
+        std::lock_guard lock(target.mutex);
+        const auto it = target.records.find(signature);
+        found = it != target.records.end() && it->second.publicKey == publicKey && it->second.dataHash == dataHash;
+    }
+
+    (found ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+    return found;
+}
+
+void SignaturesCache::insert(const cs::Signature& signature, const cs::PublicKey& publicKey, const cs::Hash& dataHash) {
+    Shard& target = shard(signature);
+    std::lock_guard lock(target.mutex);
+
+    auto [it, inserted] = target.records.try_emplace(signature, Record{publicKey, dataHash});
+
+    if (!inserted) {
+        it->second = Record{publicKey, dataHash};
+        return;
+    }
+
+    target.order.push_back(signature);
+
+    if (target.order.size() > shardCapacity_) {
+        target.records.erase(target.order.front());
+        target.order.pop_front();
+    }
+}
+
+void SignaturesCache::clear() {
+    for (auto& target : shards_) {
+        std::lock_guard lock(target.mutex);
+        target.records.clear();
+        target.order.clear();
+    }
+}
+
+size_t SignaturesCache::size() const {
+    size_t result = 0;
+
+    for (const auto& target : shards_) {
+        std::lock_guard lock(target.mutex);
+        result += target.records.size();
+    }
+
+    return result;
+}
+
+size_t SignaturesCache::SignatureHash::operator()(const cs::Signature& signature) const {
+    size_t result = 0;
+    std::memcpy(&result, signature.data(), sizeof(result));
+    return result;
+}
+
+SignaturesCache::Shard& SignaturesCache::shard(const cs::Signature& signature) {
+    // other bytes than the ones of the map hash
+    return shards_[signature[sizeof(size_t)] % ShardsCount];
+}
+}  // namespace cs
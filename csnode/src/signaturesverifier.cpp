@@ -0,0 +1,117 @@
+#include <csnode/signaturesverifier.hpp>
+
+#include <algorithm>
+#include <future>
+
+#include <boost/asio/post.hpp>
+
+#include <cscrypto/cscrypto.hpp>
+#include <lib/system/hash.hpp>
+
+namespace cs {
+// the calling thread verifies a part of every batch too
+SignaturesVerifier::SignaturesVerifier(size_t threadsCount, SignaturesCache& cache)
+: threadsCount_(std::max<size_t>(threadsCount, 1))
+, cache_(cache) {
+    if (threadsCount_ > 1) {
+        pool_ = std::make_unique<boost::asio::thread_pool>(threadsCount_ - 1);
+    }
+}
+
+SignaturesVerifier::~SignaturesVerifier() {
+    if (pool_) {
+        pool_->join();
+    }
+}
+
+void SignaturesVerifier::reserve(size_t count) {
+    entries_.reserve(count);
+}
+
+void SignaturesVerifier::add(size_t index, const csdb::Transaction& transaction, const cs::PublicKey& publicKey) {
+    const size_t offset = buffer_.size();
+    transaction.to_byte_stream_for_sig(buffer_);
+
+    entries_.push_back(Entry{index, offset, buffer_.size() - offset, transaction.signature(), publicKey});
+}
+
+void SignaturesVerifier::add(size_t index, const cs::Byte* data, size_t size, const cs::Signature& signature, const cs::PublicKey& publicKey) {
+    const size_t offset = buffer_.size();
+    buffer_.insert(buffer_.end(), data, data + size);
+
+    entries_.push_back(Entry{index, offset, size, signature, publicKey});
+}
+
+std::vector<size_t> SignaturesVerifier::verify(cs::Bytes& characteristicMask) {
+    results_.assign(entries_.size(), 0);
+
+    std::atomic<size_t> next = {0};
+
+    if (pool_ && entries_.size() >= MinParallelSize) {
+        const size_t helpers = std::min(threadsCount_, (entries_.size() + ChunkSize - 1) / ChunkSize) - 1;
+        std::vector<std::future<void>> finished;
+
+        for (size_t i = 0; i < helpers; ++i) {
+            auto task = std::make_shared<std::packaged_task<void()>>([this, &next] { verifyChunks(next); });
+            finished.push_back(task->get_future());
+            boost::asio::post(*pool_, [task] { (*task)(); });
+        }
+
+        verifyChunks(next);
+
+        for (auto& future : finished) {
+            future.wait();
+        }
+    }
+    else {
+        verifyChunks(next);
+    }
+
+    std::vector<size_t> rejected;
+
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (!results_[i]) {
+            const size_t index = entries_[i].index;
+
+            if (index < characteristicMask.size()) {
+                characteristicMask[index] = 0;
+            }
+
+            rejected.push_back(index);
+        }
+    }
+
+    return rejected;
+}
+
+void SignaturesVerifier::clear() {
+    buffer_.clear();
+    entries_.clear();
+    results_.clear();
+}
+
+void SignaturesVerifier::verifyChunks(std::atomic<size_t>& next) {
+    const size_t count = entries_.size();
+
+    for (size_t begin = next.fetch_add(ChunkSize, std::memory_order_relaxed); begin < count; begin = next.fetch_add(ChunkSize, std::memory_order_relaxed)) {
+        const size_t end = std::min(begin + ChunkSize, count);
+
+        for (size_t i = begin; i < end; ++i) {
+            const Entry& entry = entries_[i];
+            const auto data = buffer_.data() + entry.offset;
+            const cs::Hash dataHash = generateHash(data, entry.size);
+
+            if (cache_.contains(entry.signature, entry.publicKey, dataHash)) {
+                results_[i] = 1;
+                continue;
+            }
+
+            results_[i] = cscrypto::verifySignature(entry.signature, entry.publicKey, data, entry.size);
+
+            if (results_[i]) {
+                cache_.insert(entry.signature, entry.publicKey, dataHash);
+            }
+        }
+    }
+}
+}  // namespace cs
@@ -0,0 +1,136 @@
+#include <csnode/statesnapshot.hpp>
+
+#include <fstream>
+#include <iterator>
+
+#include <boost/filesystem.hpp>
+
+#include <cscrypto/cscrypto.hpp>
+#include <csnode/datastream.hpp>
+#include <lib/system/logger.hpp>
+
+namespace {
+constexpr uint32_t kSnapshotMagic = 0x50414e53;  // "SNAP"
+const char* kLogPrefix = "Snapshot: ";
+}  // namespace
+
+namespace cs {
+
+StateSnapshot::StateSnapshot(cs::Sequence sequence, const csdb::PoolHash& hash)
+: sequence_(sequence)
+, hash_(hash) {
+}
+
+void StateSnapshot::setSection(const std::string& name, cs::Bytes&& data) {
+    sections_[name] = std::move(data);
+}
+
+const cs::Bytes* StateSnapshot::section(const std::string& name) const {
+    const auto it = sections_.find(name);
+    return it != sections_.cend() ? &it->second : nullptr;
+}
+
+bool StateSnapshot::save(const std::string& path) const {
+    if (!isValid()) {
+        return false;
+    }
+
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+    stream << kSnapshotMagic << Version << sequence_ << hash_;
+    stream << sections_.size();
+
+    for (const auto& [name, data] : sections_) {
+        stream << name << data;
+    }
+
+    const cs::Hash checksum = cscrypto::calculateHash(bytes.data(), bytes.size());
+    stream << checksum;
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        if (!file.good()) {
+            cserror() << kLogPrefix << "failed to write " << tmpPath;
+            return false;
+        }
+    }
+
+    boost::system::error_code code;
+    boost::filesystem::rename(tmpPath, path, code);
+
+    if (code) {
+        cserror() << kLogPrefix << "failed to replace " << path << ": " << code.message();
+        return false;
+    }
+
+    csdebug() << kLogPrefix << "saved state of block #" << sequence_ << ", " << bytes.size() << " bytes";
+    return true;
+}
+
+bool StateSnapshot::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    cs::Bytes bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < sizeof(kSnapshotMagic) + sizeof(Version) + cs::Hash{}.size()) {
+        cswarning() << kLogPrefix << path << " is too short";
+        return false;
+    }
+
+    const size_t bodySize = bytes.size() - cs::Hash{}.size();
+    const cs::Hash checksum = cscrypto::calculateHash(bytes.data(), bodySize);
+
+    if (!std::equal(checksum.cbegin(), checksum.cend(), bytes.cbegin() + static_cast<std::ptrdiff_t>(bodySize))) {
+        cswarning() << kLogPrefix << path << " is damaged, checksum mismatch";
+        return false;
+    }
+
+    cs::DataStream stream(bytes.data(), bodySize);
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    stream >> magic >> version;
+
+    if (magic != kSnapshotMagic || version != Version) {
+        cswarning() << kLogPrefix << path << " has unsupported version " << version;
+        return false;
+    }
+
+    cs::Sequence sequence = 0;
+    csdb::PoolHash hash;
+    size_t count = 0;
+    stream >> sequence >> hash >> count;
+
+    Sections sections;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        std::string name;
+        cs::Bytes data;
+        stream >> name >> data;
+        sections.emplace(std::move(name), std::move(data));
+    }
+
+    if (!stream.isValid() || hash.is_empty()) {
+        cswarning() << kLogPrefix << path << " has corrupted layout";
+        return false;
+    }
+
+    sequence_ = sequence;
+    hash_ = hash;
+    sections_ = std::move(sections);
+    return true;
+}
+
+void StateSnapshot::remove(const std::string& path) {
+    boost::system::error_code code;
+    boost::filesystem::remove(path, code);
+}
+
+}  // namespace cs
@@ -0,0 +1,236 @@
+#include <csnode/transactionsbatch.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include <csdb/currency.hpp>
+
+namespace {
+// sizes of csdb::Transaction binary fields
+constexpr size_t kInnerIdSize = 6;
+constexpr size_t kAmountSize = sizeof(int32_t) + sizeof(uint64_t);
+constexpr size_t kCommissionSize = sizeof(uint16_t);
+
+static_assert(std::is_trivially_copyable_v<csdb::Amount>, "amounts are copied to the values buffer as bytes");
+
+template <typename T>
+void append(cs::Bytes& bytes, const T& value) {
+    const auto data = reinterpret_cast<const cs::Byte*>(&value);
+    bytes.insert(bytes.end(), data, data + sizeof(value));
+}
+
+template <typename T>
+size_t capacityBytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+size_t addressSize(const cs::TransactionsBatch::Address& address) {
+    return address.isWalletId ? sizeof(csdb::internal::WalletId) : sizeof(cs::PublicKey);
+}
+}  // namespace
+
+namespace cs {
+TransactionsBatch::TransactionsBatch(const std::vector<csdb::Transaction>& transactions) {
+    reserve(transactions.size());
+
+    for (const auto& transaction : transactions) {
+        add(transaction);
+    }
+}
+
+void TransactionsBatch::reserve(size_t transactionsCount, size_t userFieldsSize) {
+    innerIds_.reserve(transactionsCount);
+    sources_.reserve(transactionsCount);
+    targets_.reserve(transactionsCount);
+    currencies_.reserve(transactionsCount);
+    amounts_.reserve(transactionsCount);
+    maxFees_.reserve(transactionsCount);
+    countedFees_.reserve(transactionsCount);
+    signatures_.reserve(transactionsCount);
+    times_.reserve(transactionsCount);
+    userFieldsBegin_.reserve(transactionsCount + 1);
+    values_.reserve(userFieldsSize);
+}
+
+void TransactionsBatch::clear() {
+    innerIds_.clear();
+    sources_.clear();
+    targets_.clear();
+    currencies_.clear();
+    amounts_.clear();
+    maxFees_.clear();
+    countedFees_.clear();
+    signatures_.clear();
+    times_.clear();
+    userFieldsBegin_.assign(1, 0);
+    userFields_.clear();
+    values_.clear();
+}
+
+void TransactionsBatch::add(const csdb::Transaction& transaction) {
+    innerIds_.push_back(transaction.innerID());
+    sources_.push_back(fromAddress(transaction.source()));
+    targets_.push_back(fromAddress(transaction.target()));
+    currencies_.push_back(transaction.currency().id());
+    amounts_.push_back(transaction.amount());
+    maxFees_.push_back(transaction.max_fee().get_raw());
+    countedFees_.push_back(transaction.counted_fee().get_raw());
+    signatures_.push_back(transaction.signature());
+    times_.push_back(transaction.get_time());
+
+    for (const auto id : transaction.user_field_ids()) {
+        const csdb::UserField field = transaction.user_field(id);
+        UserField stored{id, field.type(), static_cast<uint32_t>(values_.size()), 0};
+
+        switch (field.type()) {
+            case csdb::UserField::Integer:
+                append(values_, field.value<uint64_t>());
+                break;
+
+            case csdb::UserField::String: {
+                const auto value = field.value<std::string>();
+                values_.insert(values_.end(), value.begin(), value.end());
+                break;
+            }
+
+            case csdb::UserField::Amount:
+                append(values_, field.value<csdb::Amount>());
+                break;
+
+            default:
+                continue;
+        }
+
+        stored.size = static_cast<uint32_t>(values_.size() - stored.offset);
+        userFields_.push_back(stored);
+    }
+
+    userFieldsBegin_.push_back(static_cast<uint32_t>(userFields_.size()));
+}
+
+csdb::Transaction TransactionsBatch::transaction(size_t index) const {
+    csdb::Transaction result(innerIds_[index], toAddress(sources_[index]), toAddress(targets_[index]), csdb::Currency(currencies_[index]), amounts_[index],
+                             maxFee(index), countedFee(index), signatures_[index]);
+
+    for (uint32_t i = userFieldsBegin_[index]; i < userFieldsBegin_[index + 1]; ++i) {
+        result.add_user_field(userFields_[i].id, userField(userFields_[i]));
+    }
+
+    result.set_time(times_[index]);
+    return result;
+}
+
+std::vector<csdb::Transaction> TransactionsBatch::transactions() const {
+    std::vector<csdb::Transaction> result;
+    result.reserve(size());
+
+    for (size_t i = 0; i < size(); ++i) {
+        result.push_back(transaction(i));
+    }
+
+    return result;
+}
+
+csdb::UserField::Type TransactionsBatch::userFieldType(size_t index, csdb::user_field_id_t id) const {
+    const UserField* field = findUserField(index, id);
+    return field != nullptr ? field->type : csdb::UserField::Unknown;
+}
+
+std::string_view TransactionsBatch::stringUserField(size_t index, csdb::user_field_id_t id) const {
+    const UserField* field = findUserField(index, id);
+
+    if (field == nullptr || field->type != csdb::UserField::String) {
+        return std::string_view();
+    }
+
+    return std::string_view(reinterpret_cast<const char*>(values_.data()) + field->offset, field->size);
+}
+
+size_t TransactionsBatch::serializedSize(size_t index) const {
+    size_t result = kInnerIdSize + addressSize(sources_[index]) + addressSize(targets_[index]) + kAmountSize + kCommissionSize + sizeof(uint8_t);
+
+    // count, id, type and value of each field
+    result += sizeof(uint8_t);
+
+    for (uint32_t i = userFieldsBegin_[index]; i < userFieldsBegin_[index + 1]; ++i) {
+        const UserField& field = userFields_[i];
+        result += sizeof(csdb::user_field_id_t) + sizeof(csdb::UserField::Type);
+
+        switch (field.type) {
+            case csdb::UserField::Integer:
+                result += sizeof(uint64_t);
+                break;
+
+            case csdb::UserField::String:
+                result += sizeof(uint32_t) + field.size;
+                break;
+
+            case csdb::UserField::Amount:
+                result += kAmountSize;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return result + sizeof(cs::Signature) + kCommissionSize;
+}
+
+size_t TransactionsBatch::memoryUsage() const {
+    return capacityBytes(innerIds_) + capacityBytes(sources_) + capacityBytes(targets_) + capacityBytes(currencies_) + capacityBytes(amounts_) +
+           capacityBytes(maxFees_) + capacityBytes(countedFees_) + capacityBytes(signatures_) + capacityBytes(times_) + capacityBytes(userFieldsBegin_) +
+           capacityBytes(userFields_) + capacityBytes(values_);
+}
+
+csdb::Address TransactionsBatch::toAddress(const Address& address) {
+    return address.isWalletId ? csdb::Address::from_wallet_id(address.walletId) : csdb::Address::from_public_key(address.publicKey);
+}
+
+TransactionsBatch::Address TransactionsBatch::fromAddress(const csdb::Address& address) {
+    Address result{};
+
+    if (address.is_wallet_id()) {
+        result.walletId = address.wallet_id();
+        result.isWalletId = true;
+    }
+    else {
+        result.publicKey = address.public_key();
+    }
+
+    return result;
+}
+
+const TransactionsBatch::UserField* TransactionsBatch::findUserField(size_t index, csdb::user_field_id_t id) const {
+    const auto begin = userFields_.begin() + userFieldsBegin_[index];
+    const auto end = userFields_.begin() + userFieldsBegin_[index + 1];
+    const auto it = std::lower_bound(begin, end, id, [](const UserField& field, csdb::user_field_id_t value) { return field.id < value; });
+
+    return (it != end && it->id == id) ? &*it : nullptr;
+}
+
+csdb::UserField TransactionsBatch::userField(const UserField& field) const {
+    const cs::Byte* value = values_.data() + field.offset;
+
+    switch (field.type) {
+        case csdb::UserField::Integer: {
+            uint64_t result = 0;
+            std::memcpy(&result, value, sizeof(result));
+            return csdb::UserField(result);
+        }
+
+        case csdb::UserField::String:
+            return csdb::UserField(std::string(reinterpret_cast<const char*>(value), field.size));
+
+        case csdb::UserField::Amount: {
+            csdb::Amount result;
+            std::memcpy(&result, value, sizeof(result));
+            return csdb::UserField(result);
+        }
+
+        default:
+            return csdb::UserField();
+    }
+}
+}  // namespace cs
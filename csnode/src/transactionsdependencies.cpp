@@ -0,0 +1,117 @@
+#include <csnode/transactionsdependencies.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace cs {
+void TransactionsDependencies::reset(size_t transactionsCount) {
+    parents_.resize(transactionsCount);
+    std::iota(parents_.begin(), parents_.end(), 0);
+
+    wallets_.clear();
+    addresses_.clear();
+    walletsIndices_.clear();
+
+    grouped_ = false;
+    groupOf_.clear();
+    groups_.clear();
+    groupsWallets_.clear();
+}
+
+void TransactionsDependencies::add(size_t index, const csdb::Address& address, Wallet wallet) {
+    if (index >= parents_.size()) {
+        return;
+    }
+
+    grouped_ = false;
+
+    auto [it, inserted] = wallets_.emplace(wallet, addresses_.size());
+
+    if (inserted) {
+        addresses_.push_back(address);
+        walletsIndices_.push_back(index);
+        return;
+    }
+
+    const size_t root = find(index);
+    const size_t walletRoot = find(walletsIndices_[it->second]);
+
+    if (root != walletRoot) {
+        parents_[std::max(root, walletRoot)] = std::min(root, walletRoot);
+    }
+}
+
+TransactionsDependencies::Indices TransactionsDependencies::affected(const Indices& changed, Addresses& wallets) {
+    group();
+
+    std::vector<size_t> groups;
+
+    for (const auto index : changed) {
+        if (index < groupOf_.size()) {
+            groups.push_back(groupOf_[index]);
+        }
+    }
+
+    std::sort(groups.begin(), groups.end());
+    groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+
+    Indices result;
+
+    for (const auto number : groups) {
+        result.insert(result.end(), groups_[number].begin(), groups_[number].end());
+        wallets.insert(wallets.end(), groupsWallets_[number].begin(), groupsWallets_[number].end());
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+size_t TransactionsDependencies::groupsCount() {
+    group();
+    return groups_.size();
+}
+
+size_t TransactionsDependencies::find(size_t index) {
+    while (parents_[index] != index) {
+        parents_[index] = parents_[parents_[index]];
+        index = parents_[index];
+    }
+
+    return index;
+}
+
+void TransactionsDependencies::group() {
+    if (grouped_) {
+        return;
+    }
+
+    constexpr size_t noGroup = std::numeric_limits<size_t>::max();
+    std::vector<size_t> rootGroups(parents_.size(), noGroup);
+
+    groupOf_.resize(parents_.size());
+    groups_.clear();
+    groupsWallets_.clear();
+
+    // roots have the least indices, so every group is filled in ascending order
+    for (size_t i = 0; i < parents_.size(); ++i) {
+        const size_t root = find(i);
+
+        if (rootGroups[root] == noGroup) {
+            rootGroups[root] = groups_.size();
+            groups_.emplace_back();
+        }
+
+        groupOf_[i] = rootGroups[root];
+        groups_[groupOf_[i]].push_back(i);
+    }
+
+    groupsWallets_.resize(groups_.size());
+
+    for (size_t i = 0; i < addresses_.size(); ++i) {
+        groupsWallets_[groupOf_[walletsIndices_[i]]].push_back(addresses_[i]);
+    }
+
+    grouped_ = true;
+}
+}  // namespace cs
@@ -35,6 +35,16 @@ void TransactionsValidator::reset(size_t transactionsNum) {
     cntRemovedTrxs_ = 0;
 }
 
+void TransactionsValidator::reset(const Indices& trxsInds) {
+    for (const auto trxInd : trxsInds) {
+        if (trxInd < trxList_.size()) {
+            trxList_[trxInd] = WalletsState::noInd_;
+        }
+    }
+    negativeNodes_.clear();
+    cntRemovedTrxs_ = 0;
+}
+
 bool TransactionsValidator::validateTransaction(SolverContext& context, const Transactions& trxs, size_t trxInd) {
     if (!validateTransactionAsSource(context, trxs, trxInd)) {
         return false;
@@ -208,16 +218,16 @@ bool TransactionsValidator::validateTransactionAsTarget(const csdb::Transaction&
     return true;
 }
 
-size_t TransactionsValidator::checkRejectedSmarts(SolverContext& context, const Transactions& trxs, CharacteristicMask& maskIncluded) {
+size_t TransactionsValidator::checkRejectedSmarts(SolverContext& context, const Transactions& trxs, const Indices& trxsInds, CharacteristicMask& maskIncluded) {
     using rejectedSmart = std::pair<csdb::Transaction, size_t>;
     auto& smarts = context.smart_contracts();
     std::vector<csdb::Transaction> newStates;
     std::vector<rejectedSmart> rejectedSmarts;
     size_t maskSize = maskIncluded.size();
-    size_t i = 0;
     size_t restoredCounter = 0;
 
-    for (const auto& t : trxs) {
+    for (const auto i : trxsInds) {
+        const auto& t = trxs[i];
         if (i < maskSize && smarts.is_known_smart_contract(t.source()) && !SmartContracts::is_new_state(t)) {
             WalletsState::WalletId id{};
             WalletsState::WalletData& wallState = walletsState_.getData(t.source(), id);
@@ -228,7 +238,6 @@ size_t TransactionsValidator::checkRejectedSmarts(SolverContext& context, const
         else if (i < maskSize && SmartContracts::is_new_state(t) && *(maskIncluded.cbegin() + i) == kValidMarker) {
             newStates.push_back(t);
         }
-        ++i;
     }
 
     for (const auto& state : newStates) {
@@ -1,19 +1,216 @@
 #include <algorithm>
 #include <blockchain.hpp>
 #include <csdb/amount_commission.hpp>
+#include <csnode/datastream.hpp>
 #include <csnode/walletscache.hpp>
 #include <csnode/walletsids.hpp>
 #include <lib/system/logger.hpp>
 #include <solver/smartcontracts.hpp>
+#include <utility>
 
 using namespace std;
 
 namespace {
 const uint8_t kUntrustedMarker = 255;
 
+// wallet data layout depends on build options, snapshot of other build must not be loaded
+constexpr uint8_t snapshotLayout() {
+    uint8_t layout = 0;
+#ifdef MONITOR_NODE
+    layout |= 0x1;
+#endif
+#ifdef TRANSACTIONS_INDEX
+    layout |= 0x2;
+#endif
+    return layout;
+}
+
+void writeTransactions(cs::DataStream& stream, const std::list<csdb::Transaction>& transactions) {
+    stream << transactions.size();
+
+    // copy, because to_binary() is not const
+    for (auto transaction : transactions) {
+        stream << transaction.to_binary();
+    }
+}
+
+void readTransactions(cs::DataStream& stream, std::list<csdb::Transaction>& transactions) {
+    size_t count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::Bytes bytes;
+        stream >> bytes;
+        transactions.push_back(csdb::Transaction::from_binary(bytes));
+    }
+}
 }  // namespace
 
 namespace cs {
+void WalletsCache::Data::reserve(size_t size) {
+    slabs_.reserve((size + SlabSize - 1) / SlabSize);
+}
+
+void WalletsCache::Data::grow(size_t size) {
+    size_ = std::max(size_, size);
+}
+
+WalletsCache::WalletData& WalletsCache::Data::Slab::record(size_t slot) {
+    return const_cast<WalletData&>(std::as_const(*this).record(slot));
+}
+
+const WalletsCache::WalletData& WalletsCache::Data::Slab::record(size_t slot) const {
+    if (slot < recordsCount) {
+        return records[slot];
+    }
+
+    slot -= recordsCount;
+    return (*chunks[slot / ChunkSize])[slot % ChunkSize];
+}
+
+WalletsCache::WalletData* WalletsCache::Data::find(WalletId id) {
+    return const_cast<WalletData*>(std::as_const(*this).find(id));
+}
+
+const WalletsCache::WalletData* WalletsCache::Data::find(WalletId id) const {
+    const size_t index = id / SlabSize;
+    const size_t offset = id % SlabSize;
+
+    if (index >= slabs_.size() || !slabs_[index] || !slabs_[index]->present[offset]) {
+        return nullptr;
+    }
+
+    return &slabs_[index]->record(slabs_[index]->slotOf[offset]);
+}
+
+WalletsCache::WalletData& WalletsCache::Data::emplace(WalletId id) {
+    const size_t index = id / SlabSize;
+    const size_t offset = id % SlabSize;
+
+    if (index >= slabs_.size()) {
+        slabs_.resize(index + 1);
+    }
+
+    if (!slabs_[index]) {
+        slabs_[index] = std::make_unique<Slab>();
+    }
+
+    Slab& slab = *slabs_[index];
+
+    if (slab.present[offset]) {
+        WalletData& wallet = slab.record(slab.slotOf[offset]);
+        wallet = WalletData{};
+        return wallet;
+    }
+
+    size_t slot = 0;
+
+    if (!slab.freeSlots.empty()) {
+        slot = slab.freeSlots.back();
+        slab.freeSlots.pop_back();
+    }
+    else {
+        slot = slab.used++;
+
+        if (slot >= slab.recordsCount + slab.chunks.size() * Slab::ChunkSize) {
+            slab.chunks.push_back(std::make_unique<Slab::Chunk>());
+        }
+    }
+
+    slab.slotOf[offset] = static_cast<uint16_t>(slot);
+    slab.present.set(offset);
+    ++count_;
+
+    grow(static_cast<size_t>(id) + 1);
+    return slab.record(slot);
+}
+
+void WalletsCache::Data::erase(WalletId id) {
+    const size_t index = id / SlabSize;
+    const size_t offset = id % SlabSize;
+
+    if (index >= slabs_.size() || !slabs_[index] || !slabs_[index]->present[offset]) {
+        return;
+    }
+
+    Slab& slab = *slabs_[index];
+    slab.record(slab.slotOf[offset]) = WalletData{};
+    slab.freeSlots.push_back(slab.slotOf[offset]);
+    slab.present.reset(offset);
+    --count_;
+}
+
+void WalletsCache::Data::shrinkToFit() {
+    for (auto& slab : slabs_) {
+        if (!slab) {
+            continue;
+        }
+
+        const size_t count = slab->present.count();
+
+        if (count == 0) {
+            slab.reset();
+            continue;
+        }
+
+        if (slab->chunks.empty() && slab->freeSlots.empty()) {
+            continue;
+        }
+
+        auto records = std::make_unique<WalletData[]>(count);
+        size_t next = 0;
+
+        for (size_t i = 0; i < SlabSize; ++i) {
+            if (slab->present[i]) {
+                records[next] = std::move(slab->record(slab->slotOf[i]));
+                slab->slotOf[i] = static_cast<uint16_t>(next++);
+            }
+        }
+
+        slab->records = std::move(records);
+        slab->recordsCount = count;
+        slab->chunks = std::vector<std::unique_ptr<Slab::Chunk>>();
+        slab->used = count;
+        slab->freeSlots = std::vector<uint16_t>();
+    }
+}
+
+template <typename Function>
+void WalletsCache::Data::forEach(Function&& function) const {
+    for (const auto& slab : slabs_) {
+        if (!slab || slab->present.none()) {
+            continue;
+        }
+
+        for (size_t i = 0; i < SlabSize; ++i) {
+            if (slab->present[i] && !function(slab->record(slab->slotOf[i]))) {
+                return;
+            }
+        }
+    }
+}
+
+template <typename Function>
+void WalletsCache::Data::forEach(Function&& function) {
+    std::as_const(*this).forEach([&function](const WalletData& wallet) { return function(const_cast<WalletData&>(wallet)); });
+}
+
+WalletsCache::MemoryUsage WalletsCache::Data::memoryUsage() const {
+    MemoryUsage usage;
+    usage.wallets = count_;
+    usage.bytes = slabs_.capacity() * sizeof(std::unique_ptr<Slab>);
+
+    for (const auto& slab : slabs_) {
+        if (slab) {
+            ++usage.slabs;
+            usage.bytes += sizeof(Slab) + slab->recordsCount * sizeof(WalletData) + slab->chunks.capacity() * sizeof(std::unique_ptr<Slab::Chunk>) +
+                           slab->chunks.size() * sizeof(Slab::Chunk) + slab->freeSlots.capacity() * sizeof(uint16_t);
+        }
+    }
+
+    return usage;
+}
+
 void WalletsCache::convert(const csdb::Address& address, WalletData::Address& walletAddress) {
     walletAddress = address.public_key();
 }
@@ -30,9 +227,10 @@ WalletsCache::WalletsCache(const Config& config, csdb::Address genesisAddress, c
     wallets_.reserve(config.initialWalletsNum_);
 }
 
-WalletsCache::~WalletsCache() {
-    for (auto el : wallets_)
-        delete el;
+WalletsCache::~WalletsCache() = default;
+
+WalletsCache::MemoryUsage WalletsCache::memoryUsage() const {
+    return wallets_.memoryUsage();
 }
 
 std::unique_ptr<WalletsCache::Initer> WalletsCache::createIniter() {
@@ -43,6 +241,123 @@ std::unique_ptr<WalletsCache::Updater> WalletsCache::createUpdater() {
     return std::unique_ptr<Updater>(new Updater(*this));
 }
 
+cs::Bytes WalletsCache::toBinary() const {
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+
+    stream << snapshotLayout() << wallets_.size();
+
+    for (size_t id = 0; id < wallets_.size(); ++id) {
+        const WalletData* wallet = wallets_.find(static_cast<WalletId>(id));
+        stream << static_cast<uint8_t>(wallet != nullptr);
+
+        if (wallet == nullptr) {
+            continue;
+        }
+
+        stream << wallet->address_ << wallet->balance_ << wallet->transNum_;
+        stream.addValue(wallet->trxTail_);
+#ifdef MONITOR_NODE
+        stream << wallet->createTime_;
+#endif
+#ifdef TRANSACTIONS_INDEX
+        stream << wallet->lastTransaction_.pool_hash() << wallet->lastTransaction_.index();
+#endif
+    }
+
+    writeTransactions(stream, smartPayableTransactions_);
+    writeTransactions(stream, closedSmarts_);
+
+#ifdef MONITOR_NODE
+    stream << trusted_info_.size();
+
+    for (const auto& [key, trusted] : trusted_info_) {
+        stream << key << trusted.times << trusted.times_trusted << trusted.totalFee;
+    }
+#endif
+
+    return bytes;
+}
+
+bool WalletsCache::fromBinary(const cs::Bytes& data) {
+    static_assert(std::is_trivially_copyable_v<TransactionsTail>, "TransactionsTail is stored into snapshot as is");
+
+    cs::DataStream stream(data.data(), data.size());
+
+    uint8_t layout = 0;
+    size_t count = 0;
+    stream >> layout >> count;
+
+    if (layout != snapshotLayout()) {
+        cserror() << "WalletsCache: snapshot is made by node of other build";
+        return false;
+    }
+
+    Data wallets;
+    wallets.reserve(std::max(count, config_.initialWalletsNum_));
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        uint8_t present = 0;
+        stream >> present;
+        wallets.grow(i + 1);
+
+        if (!present) {
+            continue;
+        }
+
+        WalletData* wallet = &wallets.emplace(static_cast<WalletId>(i));
+
+        stream >> wallet->address_ >> wallet->balance_ >> wallet->transNum_;
+        wallet->trxTail_ = stream.parseValue<TransactionsTail>();
+#ifdef MONITOR_NODE
+        stream >> wallet->createTime_;
+#endif
+#ifdef TRANSACTIONS_INDEX
+        csdb::PoolHash poolHash;
+        cs::Sequence index = 0;
+        stream >> poolHash >> index;
+
+        if (!poolHash.is_empty()) {
+            wallet->lastTransaction_ = csdb::TransactionID(poolHash, index);
+        }
+#endif
+    }
+
+    std::list<csdb::Transaction> smartPayableTransactions;
+    std::list<csdb::Transaction> closedSmarts;
+    readTransactions(stream, smartPayableTransactions);
+    readTransactions(stream, closedSmarts);
+
+#ifdef MONITOR_NODE
+    std::map<WalletData::Address, TrustedData> trustedInfo;
+    size_t trustedCount = 0;
+    stream >> trustedCount;
+
+    for (size_t i = 0; i < trustedCount && stream.isValid(); ++i) {
+        WalletData::Address key;
+        TrustedData trusted;
+        stream >> key >> trusted.times >> trusted.times_trusted >> trusted.totalFee;
+        trustedInfo.emplace(key, trusted);
+    }
+#endif
+
+    if (!stream.isValid() || wallets.size() != count) {
+        cserror() << "WalletsCache: corrupted snapshot data";
+        return false;
+    }
+
+    wallets.shrinkToFit();
+
+    wallets_ = std::move(wallets);
+    smartPayableTransactions_ = std::move(smartPayableTransactions);
+    closedSmarts_ = std::move(closedSmarts);
+#ifdef MONITOR_NODE
+    trusted_info_ = std::move(trustedInfo);
+#endif
+
+    return true;
+}
+
 // Initer
 WalletsCache::Initer::Initer(WalletsCache& data)
 : ProcessorBase(data) {
@@ -197,13 +512,15 @@ void WalletsCache::ProcessorBase::load(csdb::Pool& pool, const cs::ConfidantsKey
 }
 #ifdef MONITOR_NODE
 bool WalletsCache::ProcessorBase::setWalletTime(const WalletData::Address& address, const uint64_t& p_timeStamp) {
-    for (auto& it : data_.wallets_) {
-        if (it != nullptr && it->address_ == address) {
-            it->createTime_ = p_timeStamp;
-            return true;
+    bool found = false;
+    data_.wallets_.forEach([&](WalletData& wallet) {
+        if (wallet.address_ == address) {
+            wallet.createTime_ = p_timeStamp;
+            found = true;
         }
-    }
-    return false;
+        return !found;
+    });
+    return found;
 }
 #endif
 
@@ -504,15 +821,13 @@ bool WalletsCache::Updater::findWalletId(const csdb::Address& address, WalletId&
 WalletsCache::WalletData& WalletsCache::ProcessorBase::getWalletData(Data& wallets, WalletId id, const csdb::Address& address) {
     id = WalletsIds::Special::makeNormal(id);
 
-    if (id >= wallets.size())
-        wallets.resize(id + 1);
-
-    if (!wallets[id]) {
-        wallets[id] = new WalletData{};
-        convert(address, wallets[id]->address_);
+    if (WalletData* wallet = wallets.find(id)) {
+        return *wallet;
     }
 
-    return *wallets[id];
+    WalletData& wallet = wallets.emplace(id);
+    convert(address, wallet.address_);
+    return wallet;
 }
 
 WalletsCache::WalletData& WalletsCache::Initer::getWalletData(WalletId id, const csdb::Address& address) {
@@ -545,36 +860,31 @@ bool WalletsCache::Initer::moveData(WalletId srcIdSpecial, WalletId destIdNormal
 
     if (srcIdSpecial >= walletsSpecial_.size())
         return false;
-    if (!walletsSpecial_[srcIdSpecial]) {
+    WalletData* source = walletsSpecial_.find(srcIdSpecial);
+    if (!source) {
         cserror() << "Src wallet data should not be empty";
         return false;
     }
 
-    if (destIdNormal >= data_.wallets_.size())
-        data_.wallets_.resize(destIdNormal + 1);
-    if (data_.wallets_[destIdNormal]) {
+    if (data_.wallets_.find(destIdNormal)) {
         cserror() << "Dest wallet data should be empty";
         //        return false; // examine it
     }
-    data_.wallets_[destIdNormal] = walletsSpecial_[srcIdSpecial];
-    walletsSpecial_[srcIdSpecial] = nullptr;
+    data_.wallets_.emplace(destIdNormal) = std::move(*source);
+    walletsSpecial_.erase(srcIdSpecial);
     return true;
 }
 
 bool WalletsCache::Initer::isFinishedOk() const {
-    for (const auto& ptr : walletsSpecial_) {
-        if (ptr) {
-            cserror() << "Some new wallet was not added to block";
-            return false;
-        }
+    if (walletsSpecial_.count() != 0) {
+        cserror() << "Some new wallet was not added to block";
+        return false;
     }
     return true;
 }
 
 const WalletsCache::WalletData* WalletsCache::Updater::findWallet(WalletId id) const {
-    if (id >= data_.wallets_.size())
-        return nullptr;
-    return data_.wallets_[id];
+    return data_.wallets_.find(id);
 }
 
 void WalletsCache::iterateOverWallets(const std::function<bool(const WalletData::Address&, const WalletData&)> func) {
@@ -583,10 +893,7 @@ void WalletsCache::iterateOverWallets(const std::function<bool(const WalletData:
         break;
     }*/
 
-    for (const auto& wdp : wallets_) {
-        if (wdp != nullptr && !func(wdp->address_, *wdp))
-            break;
-    }
+    wallets_.forEach([&func](const WalletData& wallet) { return func(wallet.address_, wallet); });
 }
 
 #ifdef MONITOR_NODE
@@ -1,6 +1,8 @@
+#include <csnode/datastream.hpp>
 #include <csnode/walletsids.hpp>
 #include <lib/system/logger.hpp>
 #include <lib/system/utils.hpp>
+#include <cstring>
 #include <limits>
 
 using namespace std;
@@ -13,6 +15,93 @@ WalletsIds::WalletsIds()
     norm_.reset(new Normal(*this));
 }
 
+cs::Bytes WalletsIds::toBinary() const {
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+
+    stream << nextId_ << special_->nextIdSpecial_ << data_.size();
+
+    for (const auto& [key, id] : data_) {
+        stream << key << id;
+    }
+
+    return bytes;
+}
+
+bool WalletsIds::fromBinary(const cs::Bytes& data) {
+    cs::DataStream stream(data.data(), data.size());
+
+    WalletId nextId = 0;
+    WalletId nextIdSpecial = 0;
+    size_t count = 0;
+    stream >> nextId >> nextIdSpecial >> count;
+
+    Data ids;
+    ids.reserve(count);
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::PublicKey key;
+        WalletId id = 0;
+        stream >> key >> id;
+        ids.emplace(key, id);
+    }
+
+    if (!stream.isValid() || ids.size() != count || !Special::isSpecial(nextIdSpecial)) {
+        cserror() << "WalletsIds: corrupted snapshot data";
+        return false;
+    }
+
+    nextId_ = nextId;
+    special_->nextIdSpecial_ = nextIdSpecial;
+    data_ = std::move(ids);
+    rebuildKeys();
+    return true;
+}
+
+size_t WalletsIds::PublicKeyHash::operator()(const cs::PublicKey& key) const noexcept {
+    size_t result = 0;
+    std::memcpy(&result, key.data(), sizeof(result));
+    return result;
+}
+
+WalletsIds::Keys& WalletsIds::keys(WalletId id) {
+    return Special::isSpecial(id) ? specialKeys_ : normalKeys_;
+}
+
+void WalletsIds::setKey(WalletId id, const cs::PublicKey* key) {
+    Keys& values = keys(id);
+    const size_t index = Special::makeNormal(id);
+
+    if (index >= values.size()) {
+        values.resize(index + 1, nullptr);
+    }
+
+    values[index] = key;
+}
+
+void WalletsIds::resetKey(WalletId id, const cs::PublicKey* key) {
+    Keys& values = keys(id);
+    const size_t index = Special::makeNormal(id);
+
+    if (index < values.size() && values[index] == key) {
+        values[index] = nullptr;
+    }
+
+    while (!values.empty() && values.back() == nullptr) {
+        values.pop_back();
+    }
+}
+
+void WalletsIds::rebuildKeys() {
+    normalKeys_.clear();
+    specialKeys_.clear();
+    normalKeys_.reserve(nextId_);
+
+    for (const auto& [key, id] : data_) {
+        setKey(id, &key);
+    }
+}
+
 WalletsIds::Normal::Normal(WalletsIds& norm)
 : norm_(norm) {
 }
@@ -25,13 +114,16 @@ bool WalletsIds::Normal::insert(const WalletAddress& address, WalletId id) {
         return false;
     }
     else if (address.is_public_key()) {
-        std::pair<Data::const_iterator, bool> res = norm_.data_.insert(std::make_pair(address, id));
+        std::pair<Data::const_iterator, bool> res = norm_.data_.emplace(address.public_key(), id);
         if (res.second && id >= norm_.nextId_) {
             if (id >= numeric_limits<WalletId>::max() / 2)
                 throw runtime_error("idNormal >= numeric_limits<WalletId>::max() / 2");
 
             norm_.nextId_ = id + 1;
         }
+        if (res.second) {
+            norm_.setKey(id, &res.first->first);
+        }
         return res.second;
     }
     cserror() << "Wrong address";
@@ -44,7 +136,7 @@ bool WalletsIds::Normal::find(const WalletAddress& address, WalletId& id) const
         return true;
     }
     else if (address.is_public_key()) {
-        Data::const_iterator it = norm_.data_.find(address);
+        Data::const_iterator it = norm_.data_.find(address.public_key());
         if (it == norm_.data_.end())
             return false;
         id = it->second;
@@ -55,16 +147,13 @@ bool WalletsIds::Normal::find(const WalletAddress& address, WalletId& id) const
 }
 
 bool WalletsIds::Normal::findaddr(const WalletId& id, WalletAddress& address) const {
-    bool flgfind = false;
-    for (auto& it : norm_.data_) {
-        if (it.second == id) {
-            flgfind = true;
-            address = it.first;
-            break;
-        }
-    }
-    if (flgfind)
+    const Keys& keys = Special::isSpecial(id) ? norm_.specialKeys_ : norm_.normalKeys_;
+    const size_t index = Special::makeNormal(id);
+
+    if (index < keys.size() && keys[index] != nullptr) {
+        address = csdb::Address::from_public_key(*keys[index]);
         return true;
+    }
 
     cserror() << "Wrong WalletId";
     return false;
@@ -76,10 +165,11 @@ bool WalletsIds::Normal::get(const WalletAddress& address, WalletId& id) {
         return false;
     }
     else if (address.is_public_key()) {
-        std::pair<Data::const_iterator, bool> res = norm_.data_.insert(std::make_pair(address, norm_.nextId_));
+        std::pair<Data::const_iterator, bool> res = norm_.data_.emplace(address.public_key(), norm_.nextId_);
         if (res.second) {
             if (norm_.nextId_ >= numeric_limits<WalletId>::max() / 2)
                 throw runtime_error("nextId_ >= numeric_limits<WalletId>::max() / 2");
+            norm_.setKey(norm_.nextId_, &res.first->first);
             ++norm_.nextId_;
         }
         id = res.first->second;
@@ -94,18 +184,15 @@ bool WalletsIds::Normal::remove(const WalletAddress& address) {
         cserror() << __func__ << ": wrong address type";
         return false;
     }
-    csdebug() << "Keys before erasing address " << address.to_string();
-    for (auto& it : norm_.data_) {
-        csdebug() << it.second << " - " << it.first.to_string();
+    csdebug() << "Erasing address " << address.to_string();
+    if (auto it = norm_.data_.find(address.public_key()); it != norm_.data_.end()) {
+        csdebug() << "Erased id " << it->second;
+        norm_.resetKey(it->second, &it->first);
+        norm_.data_.erase(it);
     }
-    norm_.data_.erase(address);
     if (norm_.nextId_ > 0) {
         --norm_.nextId_;
     }
-    csdebug() << "Keys after erasing";
-    for (auto& it : norm_.data_) {
-        csdebug() << it.second << " - " << it.first.to_string();
-    }
     return true;
 }
 
@@ -136,18 +223,22 @@ bool WalletsIds::Special::insertNormal(const WalletAddress& address, WalletId id
         return false;
     }
     else if (address.is_public_key()) {
-        std::pair<Data::iterator, bool> res = norm_.data_.insert(std::make_pair(address, idNormal));
+        std::pair<Data::iterator, bool> res = norm_.data_.emplace(address.public_key(), idNormal);
 
         const bool isInserted = res.second;
+        const cs::PublicKey* key = &res.first->first;
         auto& value = res.first->second;
 
         if (!isInserted) {
             if (!isSpecial(value))
                 return false;
             idSpecial = value;
+            norm_.resetKey(idSpecial, key);
             value = idNormal;
         }
 
+        norm_.setKey(idNormal, key);
+
         if (idNormal >= norm_.nextId_) {
             if (idNormal >= numeric_limits<WalletId>::max() / 2)
                 throw runtime_error("idNormal >= numeric_limits<WalletId>::max() / 2");
@@ -166,10 +257,11 @@ bool WalletsIds::Special::findAnyOrInsertSpecial(const WalletAddress& address, W
         return true;
     }
     else if (address.is_public_key()) {
-        std::pair<Data::const_iterator, bool> res = norm_.data_.insert(std::make_pair(address, nextIdSpecial_));
+        std::pair<Data::const_iterator, bool> res = norm_.data_.emplace(address.public_key(), nextIdSpecial_);
         if (res.second) {
             if (nextIdSpecial_ == numeric_limits<WalletId>::max())
                 throw runtime_error("nextIdSpecial_ == numeric_limits<WalletId>::max()");
+            norm_.setKey(nextIdSpecial_, &res.first->first);
             ++nextIdSpecial_;
         }
         id = res.first->second;
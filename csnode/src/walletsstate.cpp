@@ -67,6 +67,13 @@ void WalletsState::WalletsExisting::setModified(const WalletId& id) {
         modified_.set(id);
 }
 
+bool WalletsState::WalletsExisting::restore(const WalletId& id) {
+    if (id >= toCopy_.size())
+        return false;
+    toCopy_.set(id);
+    return true;
+}
+
 void WalletsState::WalletsNew::clear() {
     storage_.clear();
 }
@@ -76,6 +83,12 @@ WalletsState::WalletData& WalletsState::WalletsNew::getData(const WalletAddress&
     return res.first->second;
 }
 
+void WalletsState::WalletsNew::restore(const WalletAddress& address) {
+    auto it = storage_.find(address);
+    if (it != storage_.end())
+        it->second = WalletData{noInd_};
+}
+
 void WalletsState::updateFromSource() {
     wallNew_.clear();
     wallExisting_.updateFromSource();
@@ -95,4 +108,12 @@ WalletsState::WalletData& WalletsState::getData(const WalletAddress& address, Wa
 void WalletsState::setModified(const WalletId& id) {
     wallExisting_.setModified(id);
 }
+
+void WalletsState::restore(const WalletAddress& address) {
+    WalletId id = noWalletId_;
+
+    if (blockchain_.findWalletId(address, id) && wallExisting_.restore(id))
+        return;
+    wallNew_.restore(address);
+}
 }  // namespace cs
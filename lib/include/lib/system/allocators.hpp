@@ -175,7 +175,8 @@ private:
     Region(RegionPage* page, void* data, const uint32_t size)
     : page_(page)
     , data_(data)
-    , size_(size) {
+    , size_(size)
+    , capacity_(size) {
     }
 
     Region(const Region&) = delete;
@@ -188,6 +189,7 @@ private:
 
     void* data_;
     uint32_t size_;
+    uint32_t capacity_;  // size the memory is accounted by in its page
 
     friend class RegionAllocator;
     friend class Network;
@@ -258,20 +260,28 @@ public:
     }
 
     void shrinkLast(const uint32_t size) {
-        assert(lastReg_->size_ >= size);
-        int32_t prevSize = lastReg_->size_ + sizeof(Region);
+        assert(lastReg_->capacity_ >= size);
+        int32_t prevSize = lastReg_->capacity_ + sizeof(Region);
         prevSize += (-prevSize) & 0x3f;
         int32_t newSize = size + sizeof(Region);
         newSize += (-newSize) & 0x3f;
         int32_t diff = prevSize - newSize;
 
         lastReg_->size_ = size;
+        lastReg_->capacity_ = size;
         lastReg_->page_->sizeLeft += diff;
         lastReg_->page_->usedEnd -= diff;
 
         activePage_->usedSize.fetch_sub(diff, std::memory_order_acq_rel);
     }
 
+    /* Unlike shrinkLast, can be applied to any region still in use,
+       but the memory cut off is not reused until the whole region is freed */
+    static void truncate(RegionPtr& region, const uint32_t size) {
+        assert(region.ptr_->capacity_ >= size);
+        region.ptr_->size_ = size;
+    }
+
 #ifdef TESTING
     uint32_t getPagesNum() const {
         return pagesNum_;
@@ -282,9 +292,9 @@ private:
     // Can be called from any thread using the allocated memory
     void freeMem(Region* region) {
         auto page = region->page_;
+        uint32_t toSub = region->capacity_ + sizeof(Region);
         region->~Region();
 
-        uint32_t toSub = region->size_ + sizeof(Region);
         toSub += (-(int)toSub) & 0x3f;
 
         if (page->usedSize.fetch_sub(toSub, std::memory_order_acq_rel) == toSub) {
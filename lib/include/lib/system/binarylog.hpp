@@ -0,0 +1,178 @@
+#ifndef BINARYLOG_HPP
+#define BINARYLOG_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <lib/system/logger.hpp>
+
+/*
+ * \brief Binary logging backend for hot paths.
+ *
+ * csdebugf("NODE> Send block reply, count: {}", count) puts a compact record (format pointer, severity,
+ * time and arguments) to the ring of the calling thread without formatting and locking. The log thread
+ * formats the records and writes them through Boost::Log, so sinks and filters of the config are the same.
+ * Until the backend is started records are formatted and written on the calling thread.
+ *
+ * Format must be a string literal, every "{}" in it is replaced by the next argument.
+ * Numbers and strings are copied as is, other arguments are formatted by operator<< on the calling thread.
+ *
+ * Configuration ini example:
+ * [Binary]
+ * Enabled=true
+ * Severity=debug
+ * RingSize=1048576
+ */
+
+namespace logger {
+class BinaryLog {
+public:
+    constexpr static size_t DefaultRingSize = 1 << 20;
+
+    // records less than the level are not written
+    static void start(severity_level level = severity_level::trace, size_t ringSize = DefaultRingSize);
+
+    // writes all the records put before the call
+    static void stop();
+
+    static bool isRunning();
+
+    // records not put as their thread ring was full
+    static uint64_t dropped();
+
+    template <size_t N, typename... Args>
+    static void write(severity_level level, const char (&format)[N], const Args&... args) {
+        if (!isRunning()) {
+            BOOST_LOG_SEV(getLogger(), level) << BinaryLog::format(format, args...);
+            return;
+        }
+
+        if (level < minimumLevel()) {
+            return;
+        }
+
+        std::string& record = buffer();
+        record.clear();
+
+        const auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        const char* formatPtr = format;
+
+        put(record, formatPtr);
+        put(record, static_cast<uint8_t>(level));
+        put(record, static_cast<int64_t>(time));
+        (encode(record, args), ...);
+
+        if (!push(record)) {
+            BOOST_LOG_SEV(getLogger(), level) << BinaryLog::format(format, args...);
+        }
+    }
+
+    template <typename... Args>
+    static std::string format(const char* format, const Args&... args) {
+        return substitute(format, {toString(args)...});
+    }
+
+    // replaces "{}" of the format by the arguments, the rest of arguments are appended
+    static std::string substitute(const char* format, const std::vector<std::string>& args);
+
+private:
+    enum class ArgumentType : uint8_t {
+        Signed,
+        Unsigned,
+        Double,
+        String
+    };
+
+    static severity_level minimumLevel();
+    static std::string& buffer();
+
+    // false if the backend is stopped, the record is not put
+    static bool push(const std::string& record);
+
+    template <typename T>
+    static void put(std::string& record, const T& value) {
+        record.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static void putString(std::string& record, std::string_view value) {
+        put(record, ArgumentType::String);
+        put(record, static_cast<uint32_t>(value.size()));
+        record.append(value.data(), value.size());
+    }
+
+    template <typename T>
+    static void encode(std::string& record, const T& value) {
+        if constexpr (std::is_same_v<T, char>) {
+            putString(record, std::string_view(&value, 1));
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            put(record, ArgumentType::Signed);
+            put(record, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            put(record, ArgumentType::Unsigned);
+            put(record, static_cast<uint64_t>(value));
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            put(record, ArgumentType::Double);
+            put(record, static_cast<double>(value));
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            putString(record, std::string_view(value));
+        }
+        else {
+            putString(record, toString(value));
+        }
+    }
+
+    template <typename T>
+    static std::string toString(const T& value) {
+        if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            return std::string(std::string_view(value));
+        }
+        else {
+            std::ostringstream stream;
+
+            if constexpr (std::is_integral_v<T> && sizeof(T) == 1 && !std::is_same_v<T, char>) {
+                stream << static_cast<int>(value);
+            }
+            else {
+                stream << value;
+            }
+
+            return stream.str();
+        }
+    }
+
+    // log thread
+    static void run();
+    static bool decode(const std::string& record, const char*& format, severity_level& level, int64_t& time, std::vector<std::string>& args);
+};
+}  // namespace logger
+
+// the same compile time filter as _LOG_SEV() of the default logger
+#define _BINARY_LOG_SEV(level, ...)  \
+    if (!logger::useLogger<>())      \
+        ;                            \
+    else                             \
+        logger::BinaryLog::write(logger::severity_level::level, __VA_ARGS__)
+
+#define csdetailsf(...) _BINARY_LOG_SEV(trace, __VA_ARGS__)
+
+#define csdebugf(...) _BINARY_LOG_SEV(debug, __VA_ARGS__)
+
+#define csinfof(...) _BINARY_LOG_SEV(info, __VA_ARGS__)
+
+#define cswarningf(...) _BINARY_LOG_SEV(warning, __VA_ARGS__)
+
+#define cserrorf(...) _BINARY_LOG_SEV(error, __VA_ARGS__)
+
+// alias
+#define cslogf(...) csinfof(__VA_ARGS__)
+
+#endif  // BINARYLOG_HPP
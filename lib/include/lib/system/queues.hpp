@@ -2,7 +2,9 @@
 #ifndef QUEUES_HPP
 #define QUEUES_HPP
 #include <atomic>
+#include <cassert>
 #include <cstdint>
+#include <memory>
 #include <thread>
 
 #include "cache.hpp"
@@ -99,4 +101,106 @@ private:
     __cacheline_aligned std::atomic<Element*> writingBarrier_ = {elements};
 };
 
+/* Bounded ring of preallocated elements handed over from one or many
+   producers to a single consumer without locks. Every cell keeps the
+   turn it is ready for: producers claim cells in order, fill them in
+   place and publish, the consumer takes the published cells in the
+   claim order and frees them after use. A full ring makes producers
+   spin until the consumer frees a cell */
+template <typename T, std::size_t Size, uint32_t BackOffTreshold = 1000>
+class BoundedRing {
+public:
+    static_assert(Size && !(Size & (Size - 1)), "BoundedRing size should be a power of two");
+
+    BoundedRing()
+    : cells_(new Cell[Size]) {
+        for (std::size_t i = 0; i < Size; ++i) {
+            cells_[i].turn.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedRing(const BoundedRing&) = delete;
+    BoundedRing& operator=(const BoundedRing&) = delete;
+
+    // Any producer, waits while the ring is full
+    T* claim() {
+        T* element;
+        uint32_t attempts = 0;
+
+        while (!(element = tryClaim())) {
+            if (++attempts == BackOffTreshold) {
+                attempts = 0;
+                std::this_thread::yield();
+            }
+        }
+
+        return element;
+    }
+
+    // Any producer, returns nullptr if the ring is full
+    T* tryClaim() {
+        auto pos = tail_.load(std::memory_order_relaxed);
+
+        while (true) {
+            Cell& cell = cells_[pos & Mask];
+            const auto diff = static_cast<std::intptr_t>(cell.turn.load(std::memory_order_acquire) - pos);
+
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return &cell.element;
+                }
+            }
+            else if (diff < 0) {
+                return nullptr;
+            }
+            else {
+                // another producer got ahead
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(T* element) {
+        Cell* cell = reinterpret_cast<Cell*>(element);
+        cell->turn.store(cell->turn.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Gives back the last claimed and not published element, single producer only
+    void unclaimLast(T* element) {
+        const auto pos = tail_.load(std::memory_order_relaxed) - 1;
+        (void)(element);
+        assert(&cells_[pos & Mask].element == element);
+        tail_.store(pos, std::memory_order_relaxed);
+    }
+
+    // The consumer, returns nullptr if the oldest claimed element is not published yet
+    T* front() {
+        Cell& cell = cells_[head_ & Mask];
+        return cell.turn.load(std::memory_order_acquire) == head_ + 1 ? &cell.element : nullptr;
+    }
+
+    void pop() {
+        Cell& cell = cells_[head_ & Mask];
+        cell.turn.store(head_ + Size, std::memory_order_release);
+        ++head_;
+    }
+
+    static constexpr std::size_t capacity() {
+        return Size;
+    }
+
+private:
+    static constexpr std::size_t Mask = Size - 1;
+
+    struct Cell {
+        T element;
+        std::atomic<std::size_t> turn;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+
+    __cacheline_aligned std::atomic<std::size_t> tail_ = {0};
+    __cacheline_aligned std::size_t head_ = 0;
+};
+
 #endif  // QUEUES_HPP
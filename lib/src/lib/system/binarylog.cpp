@@ -0,0 +1,454 @@
+#include <lib/system/binarylog.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <boost/date_time/c_local_time_adjustor.hpp>
+#include <boost/date_time/posix_time/conversion.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/log/attributes/mutable_constant.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/sources/logger.hpp>
+#include <boost/log/sources/record_ostream.hpp>
+
+namespace {
+// records of one thread: written by the thread, read by the log thread, no locks
+class Ring {
+public:
+    explicit Ring(size_t capacity, uint64_t generation)
+    : buffer_(roundUp(capacity))
+    , mask_(buffer_.size() - 1)
+    , generation_(generation) {
+    }
+
+    bool write(const std::string& record) {
+        const auto size = static_cast<uint32_t>(record.size());
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+
+        if (buffer_.size() - (head - tail) < sizeof(size) + size) {
+            return false;
+        }
+
+        copyIn(head, &size, sizeof(size));
+        copyIn(head + sizeof(size), record.data(), size);
+        head_.store(head + sizeof(size) + size, std::memory_order_release);
+
+        return true;
+    }
+
+    template <typename Handler>
+    size_t read(std::string& record, Handler&& handler) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        size_t count = 0;
+
+        while (tail != head) {
+            uint32_t size = 0;
+            copyOut(tail, &size, sizeof(size));
+            record.resize(size);
+            copyOut(tail + sizeof(size), record.data(), size);
+
+            tail += sizeof(size) + size;
+            tail_.store(tail, std::memory_order_release);
+
+            handler(record);
+            ++count;
+        }
+
+        return count;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    uint64_t generation() const {
+        return generation_;
+    }
+
+    // the thread is finished, the ring is removed once read
+    std::atomic_bool retired{false};
+
+private:
+    static size_t roundUp(size_t capacity) {
+        size_t result = 1024;
+
+        while (result < capacity) {
+            result <<= 1;
+        }
+
+        return result;
+    }
+
+    void copyIn(size_t position, const void* data, size_t size) {
+        const size_t offset = position & mask_;
+        const size_t first = std::min(size, buffer_.size() - offset);
+
+        std::memcpy(buffer_.data() + offset, data, first);
+        std::memcpy(buffer_.data(), static_cast<const char*>(data) + first, size - first);
+    }
+
+    void copyOut(size_t position, void* data, size_t size) const {
+        const size_t offset = position & mask_;
+        const size_t first = std::min(size, buffer_.size() - offset);
+
+        std::memcpy(data, buffer_.data() + offset, first);
+        std::memcpy(static_cast<char*>(data) + first, buffer_.data(), size - first);
+    }
+
+    std::vector<char> buffer_;
+    const size_t mask_;
+    const uint64_t generation_;
+
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+struct State {
+    // the thread is stopped if the process exits without logger::cleanup(), e.g. by exit()
+    ~State() {
+        stop();
+    }
+
+    // records put before running is cleared are written by the last pass of the thread
+    void stop() {
+        {
+            std::lock_guard lock(mutex);
+
+            if (!running) {
+                return;
+            }
+
+            running = false;
+        }
+
+        // the records being put see running set, so they are in rings when the last pass starts
+        while (pushing.load() != 0) {
+            std::this_thread::yield();
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            finished = true;
+        }
+
+        condition.notify_all();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+
+        std::lock_guard lock(mutex);
+        rings.clear();
+    }
+
+    // the log thread writes the last records through the core at exit, so it is kept
+    logging::core_ptr core = logging::core::get();
+
+    std::atomic_bool running{false};
+    std::atomic_bool finished{false};
+    std::atomic<int> pushing{0};
+    std::atomic<int> level{0};
+    std::atomic<size_t> ringSize{logger::BinaryLog::DefaultRingSize};
+    std::atomic<uint64_t> generation{0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::thread thread;
+};
+
+State& state() {
+    static State state;
+    return state;
+}
+
+struct RingHolder {
+    std::shared_ptr<Ring> ring;
+
+    ~RingHolder() {
+        if (ring) {
+            ring->retired = true;
+        }
+    }
+};
+
+template <typename T>
+bool get(const std::string& record, size_t& position, T& value) {
+    if (position + sizeof(value) > record.size()) {
+        return false;
+    }
+
+    std::memcpy(&value, record.data() + position, sizeof(value));
+    position += sizeof(value);
+
+    return true;
+}
+
+template <typename T>
+std::string toChars(T value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return std::string(buffer, result.ptr);
+}
+
+// local time of the records, time zone is requested once a second
+class LocalTime {
+public:
+    boost::posix_time::ptime get(int64_t microseconds) {
+        const int64_t second = microseconds / 1000000;
+
+        if (second != second_) {
+            second_ = second;
+            local_ = boost::date_time::c_local_adjustor<boost::posix_time::ptime>::utc_to_local(boost::posix_time::from_time_t(static_cast<std::time_t>(second)));
+        }
+
+        return local_ + boost::posix_time::microseconds(microseconds - second * 1000000);
+    }
+
+private:
+    int64_t second_ = -1;
+    boost::posix_time::ptime local_;
+};
+}  // namespace
+
+namespace logger {
+void BinaryLog::start(severity_level level, size_t ringSize) {
+    State& st = state();
+    std::lock_guard lock(st.mutex);
+
+    if (st.running) {
+        return;
+    }
+
+    st.level = static_cast<int>(level);
+    st.ringSize = ringSize;
+    st.rings.clear();
+    ++st.generation;
+    st.finished = false;
+    st.running = true;
+    st.thread = std::thread(&BinaryLog::run);
+}
+
+void BinaryLog::stop() {
+    state().stop();
+}
+
+bool BinaryLog::isRunning() {
+    return state().running.load(std::memory_order_acquire);
+}
+
+uint64_t BinaryLog::dropped() {
+    return state().dropped;
+}
+
+std::string BinaryLog::substitute(const char* format, const std::vector<std::string>& args) {
+    std::string result;
+    size_t next = 0;
+
+    for (const char* symbol = format; *symbol != '\0'; ++symbol) {
+        if (symbol[0] == '{' && symbol[1] == '}' && next < args.size()) {
+            result += args[next++];
+            ++symbol;
+        }
+        else {
+            result += *symbol;
+        }
+    }
+
+    for (; next < args.size(); ++next) {
+        result += ' ';
+        result += args[next];
+    }
+
+    return result;
+}
+
+severity_level BinaryLog::minimumLevel() {
+    return static_cast<severity_level>(state().level.load(std::memory_order_relaxed));
+}
+
+std::string& BinaryLog::buffer() {
+    thread_local std::string record;
+    return record;
+}
+
+bool BinaryLog::push(const std::string& record) {
+    thread_local RingHolder holder;
+    State& st = state();
+
+    // stop() waits for the records being put, the ones put after it is called are written by the caller
+    ++st.pushing;
+
+    if (!st.running.load()) {
+        --st.pushing;
+        return false;
+    }
+
+    const uint64_t generation = st.generation.load(std::memory_order_acquire);
+
+    if (!holder.ring || holder.ring->generation() != generation) {
+        holder.ring = std::make_shared<Ring>(st.ringSize, generation);
+
+        std::lock_guard lock(st.mutex);
+        st.rings.push_back(holder.ring);
+    }
+
+    if (!holder.ring->write(record)) {
+        ++st.dropped;
+    }
+
+    --st.pushing;
+    return true;
+}
+
+bool BinaryLog::decode(const std::string& record, const char*& format, severity_level& level, int64_t& time, std::vector<std::string>& args) {
+    size_t position = 0;
+    uint8_t levelValue = 0;
+
+    if (!get(record, position, format) || !get(record, position, levelValue) || !get(record, position, time)) {
+        return false;
+    }
+
+    level = static_cast<severity_level>(levelValue);
+    args.clear();
+
+    while (position < record.size()) {
+        ArgumentType type;
+
+        if (!get(record, position, type)) {
+            return false;
+        }
+
+        switch (type) {
+            case ArgumentType::Signed: {
+                int64_t value = 0;
+
+                if (!get(record, position, value)) {
+                    return false;
+                }
+
+                args.push_back(toChars(value));
+                break;
+            }
+
+            case ArgumentType::Unsigned: {
+                uint64_t value = 0;
+
+                if (!get(record, position, value)) {
+                    return false;
+                }
+
+                args.push_back(toChars(value));
+                break;
+            }
+
+            case ArgumentType::Double: {
+                double value = 0;
+
+                if (!get(record, position, value)) {
+                    return false;
+                }
+
+                std::ostringstream stream;
+                stream << value;
+                args.push_back(stream.str());
+                break;
+            }
+
+            case ArgumentType::String: {
+                uint32_t size = 0;
+
+                if (!get(record, position, size) || position + size > record.size()) {
+                    return false;
+                }
+
+                args.emplace_back(record.data() + position, size);
+                position += size;
+                break;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void BinaryLog::run() {
+    State& st = state();
+
+    // records keep the time they were put at, severity is an attribute of the source as severity_logger keeps
+    // it in thread specific storage which may be destroyed at exit before the last records are written
+    logging::sources::logger source;
+    logging::attributes::mutable_constant<boost::posix_time::ptime> timeStamp(boost::posix_time::microsec_clock::local_time());
+    logging::attributes::mutable_constant<severity_level> severity(severity_level::trace);
+    source.add_attribute("TimeStamp", timeStamp);
+    source.add_attribute(logging::trivial::tag::severity::get_name(), severity);
+
+    LocalTime localTime;
+
+    std::string record;
+    std::vector<std::string> args;
+    std::vector<std::shared_ptr<Ring>> rings;
+    uint64_t dropped = 0;
+
+    auto emit = [&](const std::string& data) {
+        const char* format = nullptr;
+        severity_level level = severity_level::trace;
+        int64_t time = 0;
+
+        if (!decode(data, format, level, time, args)) {
+            return;
+        }
+
+        timeStamp.set(localTime.get(time));
+        severity.set(level);
+        BOOST_LOG(source) << substitute(format, args);
+    };
+
+    while (true) {
+        // records put before the stop are read at the last pass
+        const bool stopping = st.finished.load(std::memory_order_acquire);
+
+        {
+            std::lock_guard lock(st.mutex);
+            st.rings.erase(std::remove_if(st.rings.begin(), st.rings.end(), [](const auto& ring) { return ring->retired && ring->empty(); }), st.rings.end());
+            rings = st.rings;
+        }
+
+        size_t count = 0;
+
+        for (const auto& ring : rings) {
+            count += ring->read(record, emit);
+        }
+
+        rings.clear();
+
+        if (const uint64_t current = st.dropped; current != dropped) {
+            severity.set(severity_level::warning);
+            BOOST_LOG(source) << "Binary log: " << current - dropped << " records dropped, thread ring is full";
+            dropped = current;
+        }
+
+        if (stopping) {
+            break;
+        }
+
+        if (count == 0) {
+            std::unique_lock lock(st.mutex);
+            st.condition.wait_for(lock, std::chrono::milliseconds(10), [&] { return st.finished.load(); });
+        }
+    }
+}
+}  // namespace logger
@@ -1,5 +1,7 @@
 #include <lib/system/logger.hpp>
 
+#include <lib/system/binarylog.hpp>
+
 #include <boost/log/core.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/filter_parser.hpp>
@@ -16,9 +18,22 @@ void initialize(const logging::settings& settings) {
     logging::register_simple_filter_factory<severity_level>(logging::trivial::tag::severity::get_name());
 
     logging::init_from_settings(settings);
+
+    auto binary = settings["Binary"];
+
+    if (binary["Enabled"].get<bool>().value_or(false)) {
+        severity_level level = severity_level::trace;
+
+        if (const auto severity = binary["Severity"].get<std::string>(); severity.has_value()) {
+            logging::trivial::from_string(severity->c_str(), severity->size(), level);
+        }
+
+        BinaryLog::start(level, binary["RingSize"].get<size_t>().value_or(BinaryLog::DefaultRingSize));
+    }
 }
 
 void cleanup() {
+    BinaryLog::stop();
     logging::core::get()->remove_all_sinks();
 }
 }  // namespace logger
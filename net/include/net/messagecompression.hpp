@@ -0,0 +1,76 @@
+#ifndef MESSAGECOMPRESSION_HPP
+#define MESSAGECOMPRESSION_HPP
+
+#include <lib/system/common.hpp>
+
+#include <net/packet.hpp>
+
+#include <array>
+#include <atomic>
+
+namespace cs {
+/*
+    Message data after its type and round number is compressed as a whole before the fragmentation,
+    the first packet gets BaseFlags::CompressedMessage and the data is replaced with:
+
+    raw size (4 b) | dictionary id (4 b) | LZ4 block
+
+    Type and round number stay uncompressed to be read by the relaying nodes from the first fragment,
+    the message is decompressed once by the receiver after it is collected.
+*/
+class MessageCompression {
+public:
+    static constexpr size_t HeaderSize = sizeof(uint32_t) + sizeof(uint32_t);
+    static constexpr size_t PrefixSize = sizeof(MsgTypes) + sizeof(cs::RoundNumber);
+
+    // smaller data is left as is
+    static constexpr size_t MinSize = 256;
+    static constexpr size_t MaxSize = static_cast<size_t>(Packet::MaxFragments) * Packet::MaxSize;
+
+    // LZ4 refers the last 64 Kb of the dictionary only
+    static constexpr size_t MaxDictionarySize = 1 << 16;
+
+    // stats are logged every that many compressed or decompressed messages
+    static constexpr uint64_t ReportPeriod = 1000;
+
+    static MessageCompression& instance();
+
+    // dictionary should be the same at all the nodes, it is set once before any message is sent or received
+    void setDictionary(const cs::Bytes& dictionary);
+
+    uint32_t getDictionaryId() const {
+        return dictionaryId_;
+    }
+
+    // returns false if data is too small or is not compressed to a smaller size
+    bool compress(MsgTypes type, const cs::Byte* data, size_t size, cs::Bytes& result);
+
+    // returns the packet with the message data decompressed and the flag cleared, empty packet on error
+    Packet decompress(const Packet& pack);
+
+private:
+    struct Stats {
+        std::atomic<uint64_t> messages = {0};
+        std::atomic<uint64_t> rawBytes = {0};
+        std::atomic<uint64_t> compressedBytes = {0};
+        std::atomic<uint64_t> skipped = {0};
+    };
+
+    MessageCompression() = default;
+
+    void count(Stats& stats, uint64_t rawSize, uint64_t compressedSize);
+    void report();
+
+    cs::Bytes dictionary_;
+    uint32_t dictionaryId_ = 0;
+
+    // loaded once, copied to the working stream of the thread before every compression
+    LZ4_stream_t dictionaryStream_;
+
+    std::array<Stats, 256> compressed_;
+    std::array<Stats, 256> decompressed_;
+    std::atomic<uint64_t> processed_ = {0};
+};
+}  // namespace cs
+
+#endif  // MESSAGECOMPRESSION_HPP
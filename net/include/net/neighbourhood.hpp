@@ -65,6 +65,7 @@ struct Connection {
     , node(std::move(rhs.node))
     , isSignal(rhs.isSignal)
     , connected(rhs.connected)
+    , packetSize(rhs.packetSize)
     , msgRels(std::move(rhs.msgRels)) {
     }
 
@@ -95,6 +96,9 @@ struct Connection {
     bool isSignal = false;
     bool connected = false;
 
+    // the largest datagram both sides support, agreed on registration
+    uint32_t packetSize = Packet::DefaultSize;
+
     bool isRequested = false;
     uint32_t syncNeighbourRetries = 0;
 
@@ -133,7 +137,7 @@ public:
     void addSignalServer(const ip::udp::endpoint& in, const ip::udp::endpoint& out, RemoteNodePtr);
 
     void gotRegistration(Connection&&, RemoteNodePtr);
-    void gotConfirmation(const Connection::Id& my, const Connection::Id& real, const ip::udp::endpoint&, const cs::PublicKey&, RemoteNodePtr);
+    void gotConfirmation(const Connection::Id& my, const Connection::Id& real, const ip::udp::endpoint&, const cs::PublicKey&, const uint32_t packetSize, RemoteNodePtr);
     void gotRefusal(const Connection::Id&);
 
     void resendPackets();
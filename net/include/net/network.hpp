@@ -7,8 +7,13 @@
 #endif
 #include <boost/asio.hpp>
 
+#include <memory>
+#include <vector>
+
 #include <client/config.hpp>
 #include <lib/system/cache.hpp>
+#include <lib/system/queues.hpp>
+#include "neighbourhood.hpp"
 #include "pacmans.hpp"
 
 using io_context = boost::asio::io_context;
@@ -49,6 +54,67 @@ private:
     void processorRoutine();
     inline void processTask(TaskPtr<IPacMan>&);
 
+    // Packet processing is split into preparation, which may run in parallel for
+    // different senders (header checks, hashing, fragments collection), and the
+    // dispatch to transport and node, which always runs on the processor thread
+    struct PreparedPacket {
+        RemoteNodePtr sender;
+        MessagePtr msg;
+        bool collected = false;
+        bool newFragmentedMsg = false;
+        bool completed = false;
+    };
+
+    bool preparePacket(const IPacMan::Task&, PreparedPacket&);
+    void dispatchPacket(const IPacMan::Task&, PreparedPacket&);
+
+#ifdef __linux__
+    // Packets of one sender always go to the same shard to keep their order,
+    // prepared packets are returned to the processor thread to be dispatched
+    struct ShardTask {
+        IPacMan::Task task;
+        PreparedPacket prepared;
+        bool dispatch = false;
+
+        void reset();
+    };
+
+    static constexpr size_t ShardQueueSize = 1 << 12;
+
+    struct ProcessorShard {
+        BoundedRing<ShardTask, ShardQueueSize> queue;
+        int eventfd = -1;
+        std::thread thread;
+    };
+
+    void shardedProcessorRoutine();
+    void shardRoutine(ProcessorShard&);
+    void dispatchShardTasks();
+
+    std::vector<std::unique_ptr<ProcessorShard>> shards_;
+    std::unique_ptr<BoundedRing<ShardTask, ShardQueueSize * 4>> dispatchQueue_;
+    int dispatchEventfd_ = -1;
+    std::atomic<bool> stopShardRoutines_ = {false};
+#endif
+
+    // returns packet size after decoding or 0 if packet should be rejected
+    static size_t decodeReceived(IPacMan::Task& task, size_t packetSize);
+
+    // packets per syscall counters, reported to log periodically
+    struct SyscallStats {
+        static constexpr uint64_t ReportPeriod = 100000;
+
+        explicit SyscallStats(const char* statsName)
+        : name(statsName) {
+        }
+
+        void add(size_t packetsCount);
+
+        const char* name;
+        uint64_t calls = 0;
+        uint64_t packets = 0;
+    };
+
     ip::udp::socket* getSocketInThread(const bool, const EndpointData&, std::atomic<ThreadStatus>&, const bool useIPv6);
 
     bool good_;
@@ -79,6 +145,10 @@ private:
     std::thread processorThread_;
 
     PacketCollector collector_;
+
+    // each is used by its own thread only
+    SyscallStats readerStats_{"received"};
+    SyscallStats writerStats_{"sent"};
 #ifdef __linux__
     int readerEventfd_;
     int writerEventfd_;
@@ -12,19 +12,25 @@
 
 #include <lz4.h>
 
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 /*
-    Static min memory usage (see types below):
+    Collector memory usage (see types below):
 
-    1 fragment = 1'024 b
-    1 message = 80 b * 4'096 fragments = 327'680 b
-    1 collector = 2'048 messages * 327'680 b = 671'088'640 b
+    1 fragment = 1'024 b by default, up to 8'192 b negotiated
+    1 message = 512 b fragments table + data of its fragments in a single buffer
+    all the messages being collected = Message::MaxCollectingSize at most
 */
 
 namespace ip = boost::asio::ip;
 
+namespace cs {
+class MessageCompression;
+}
+
 enum BaseFlags : uint8_t {
     NetworkMsg = 1,
     Fragmented = 1 << 1,
@@ -33,6 +39,7 @@ enum BaseFlags : uint8_t {
     Encrypted = 1 << 4,
     Signed = 1 << 5,
     Neighbours = 1 << 6,  // send packet to Neighbours only, Neighbours _cant_ resend it
+    CompressedMessage = 1 << 7,  // data of the whole message is compressed, see cs::MessageCompression
 };
 
 enum Offsets : uint32_t {
@@ -83,7 +90,10 @@ enum MsgTypes : uint8_t {
 
 class Packet {
 public:
-    static const uint32_t MaxSize = 1024;
+    // datagram size used by default and with the peers which do not negotiate it
+    static const uint32_t DefaultSize = 1024;
+    // the largest datagram size may be negotiated, fits jumbo frames of 9000 bytes MTU
+    static const uint32_t MaxSize = 8192;
     static const uint32_t MaxFragments = 4096;
 
     static const uint32_t SmartRedirectTreshold = 10000;
@@ -111,6 +121,9 @@ public:
     bool isNeighbors() const {
         return checkFlag(BaseFlags::Neighbours);
     }
+    bool isCompressedMessage() const {
+        return checkFlag(BaseFlags::CompressedMessage);
+    }
 
     const cs::Hash& getHash() const {
         if (!hashed_) {
@@ -173,10 +186,12 @@ public:
     uint32_t getHeadersLength() const;
     void recalculateHeadersLength();
 
-    explicit operator bool() {
+    explicit operator bool() const {
         return data_;
     }
 
+    // Returns the buffer to send: tempBuffer with compressed content or the packet data itself,
+    // so the packet should be kept alive until it is sent
     boost::asio::mutable_buffer encode(boost::asio::mutable_buffer tempBuffer) {
         if (data_.size() == 0) {
             cswarning() << "Encoding empty packet";
@@ -187,8 +202,7 @@ public:
             static_assert(sizeof(BaseFlags) == sizeof(char), "BaseFlags should be char sized");
             const size_t headerSize = getHeadersLength();
 
-            // Packet::MaxSize is a part of implementation magic(
-            assert(tempBuffer.size() == Packet::MaxSize);
+            assert(tempBuffer.size() >= data_.size());
 
             char* source = static_cast<char*>(data_.get());
             char* dest = static_cast<char*>(tempBuffer.data());
@@ -210,10 +224,7 @@ public:
             }
         }
 
-        char* source = static_cast<char*>(data_.get());
-        char* dest = static_cast<char*>(tempBuffer.data());
-        std::copy(source, source + data_.size(), dest);
-        return boost::asio::buffer(dest, data_.size());
+        return boost::asio::buffer(data_.get(), data_.size());
     }
 
     size_t decode(size_t packetSize = 0) {
@@ -235,15 +246,14 @@ public:
                 return 0;
             }
 
-            // It's a part of implementation magic(
-            // eg. <IPackMan> allocates Packet::MaxSize packet implicitly
-            assert(data_.size() == Packet::MaxSize);
+            // content is decompressed back into the packet, <IPackMan> allocates it of the receive size
+            assert(data_.size() <= Packet::MaxSize);
 
             char* source = static_cast<char*>(data_.get());
             char dest[Packet::MaxSize];
 
             int sourceSize = static_cast<int>(packetSize - headerSize);
-            int destSize = static_cast<int>(sizeof(dest) - headerSize);
+            int destSize = static_cast<int>(data_.size() - headerSize);
 
             auto uncompressedSize = LZ4_decompress_safe(source + headerSize, dest, sourceSize, destSize);
 
@@ -305,6 +315,9 @@ using PacketPtr = Packet*;
 
 class Message {
 public:
+    // total size of the messages being collected, fragments of new messages are dropped above it
+    static constexpr size_t MaxCollectingSize = 1 << 28;
+
     Message() = default;
 
     Message(Message&&) = default;
@@ -319,66 +332,85 @@ public:
         return packetsLeft_ == 0;
     }
 
+    // the whole message as one packet: header of the first fragment followed by data of all the fragments
     const Packet& getFirstPack() const {
-        return *packets_;
+        return fullData_;
     }
 
     const uint8_t* getFullData() const {
-        if (!fullData_) {
-            composeFullData();
-        }
-        return static_cast<const uint8_t*>(fullData_.get()) + packets_->getHeadersLength();
+        return static_cast<const uint8_t*>(fullData_.data()) + headersLength_;
     }
 
     size_t getFullSize() const {
-        if (!fullData_) {
-            composeFullData();
-        }
-        return fullData_.size() - packets_->getHeadersLength();
+        return fullData_.size() - headersLength_;
     }
 
     Packet extractData() const {
-        if (!fullData_)
-            composeFullData();
-        Packet result(std::move(fullData_));
-        result.headersLength_ = packets_->getHeadersLength();
-        return result;
+        return fullData_;
     }
 
-    // scans array of future fragments and clears all dirty elements, scans only the first maxFragment elements
-    // return cleared elements count
-    size_t clearFragments() {
-        return clearBuffer(0, maxFragment_);
+    uint32_t getFragmentsTotal() const {
+        return packetsTotal_;
     }
 
-    // scans array of future fragments and clears all dirty elements, scans only unused behind the maxFragment elements
-    // return cleared elements count
-    size_t clearUnused() {
-        return clearBuffer(maxFragment_, Packet::MaxFragments);
+    bool hasFragment(const uint32_t id) const {
+        return (fragments_[id / 64] & (1ull << (id % 64))) != 0;
     }
 
+    // restores the fragment packet from the message data to be sent again
+    Packet getFragment(const uint16_t id) const;
+
+    // splits a single packet into fragments of the given size for a peer which receives smaller packets,
+    // network and fragmented packets are not split and give no fragments
+    static std::vector<Packet> split(const Packet& pack, const uint32_t packetSize);
+
 private:
-    size_t clearBuffer(size_t from, size_t to);
+    // Message data buffer is allocated by the first received fragment of full size, data of every
+    // fragment is copied right to its final place and the fragment packet is released
+    bool init(const Packet& fragment);
+    bool insert(const Packet& fragment);
 
-    static RegionAllocator allocator_;
+    bool reserve(const Packet& fragment, const uint32_t fragmentSize);
+    void write(const uint32_t id, const uint8_t* data, const uint32_t size);
+    void markFragment(const uint32_t id);
+    void release();
 
-    void composeFullData() const;
+    static RegionPtr allocate(const uint32_t size);
+
+    static RegionAllocator allocator_;
+    static cs::SpinLock allocatorLock_;
+    static std::atomic<size_t> collectingSize_;
 
     cs::SpinLock pLock_{ATOMIC_FLAG_INIT};
 
-    uint32_t packetsLeft_;
+    uint32_t packetsLeft_ = 0;
     uint32_t packetsTotal_ = 0;
 
-    uint16_t maxFragment_ = 0;
-    Packet packets_[Packet::MaxFragments];
+    uint32_t headersLength_ = 0;
+    uint32_t fragmentSize_ = 0;
+    uint32_t lastFragmentSize_ = 0;
 
-    cs::Hash headerHash_;
+    // received fragments bits
+    std::vector<uint64_t> fragments_;
+
+    // message data while collecting, moved to fullData_ when complete
+    RegionPtr buffer_;
+    uint32_t reservedSize_ = 0;
 
-    mutable RegionPtr fullData_;
+    // the last fragment received before the others
+    Packet pendingLast_;
+
+    Packet fullData_;
+
+    // data as received when the message is decompressed to fullData_, fragments are restored from it
+    Packet compressedData_;
+
+    cs::Hash headerHash_;
 
     friend class PacketCollector;
     friend class Transport;
     friend class Network;
+    friend class cs::MessageCompression;
 };
 
 using MessagePtr = MemPtr<TypedSlot<Message>>;
@@ -391,7 +423,8 @@ public:
     : msgAllocator_(MaxParallelCollections + 1) {
     }
 
-    MessagePtr getMessage(const Packet&, bool&);
+    // newFragmentedMsg and completed are set for the fragment which has started or completed the message
+    MessagePtr getMessage(const Packet&, bool& newFragmentedMsg, bool& completed);
 
 private:
     TypedAllocator<Message> msgAllocator_;
@@ -2,10 +2,9 @@
 #ifndef PACMANS_HPP
 #define PACMANS_HPP
 
-#include <atomic>
 #include <boost/asio.hpp>
-#include <list>
-#include <mutex>
+
+#include <lib/system/queues.hpp>
 
 #include "packet.hpp"
 
@@ -39,6 +38,13 @@ public:
         return &(static_cast<typename Pacman::Task&>(*it_));
     }
 
+    typename Pacman::Task& operator*() {
+        return static_cast<typename Pacman::Task&>(*it_);
+    }
+    const typename Pacman::Task& operator*() const {
+        return static_cast<typename Pacman::Task&>(*it_);
+    }
+
 private:
     TaskPtr() {
     }
@@ -56,13 +62,15 @@ struct TaskBody {
         return *reinterpret_cast<Task*>(data);
     }
 
-    char data[sizeof(Task)];
+    alignas(Task) char data[sizeof(Task)];
 };
 
 class IPacMan {
 public:
-    IPacMan()
-    : allocator_(1 << 20) {
+    // packetSize is the largest datagram to be received
+    explicit IPacMan(const uint32_t packetSize = Packet::DefaultSize)
+    : allocator_(1 << 20)
+    , packetSize_(packetSize) {
     }
 
     struct Task {
@@ -74,17 +82,35 @@ public:
     Task& allocNext();
     void enQueueLast();
 
+    // Batch receive: tasks are reserved ahead with full size packets to be filled by
+    // a single syscall, then the first count of them are enqueued at once.
+    // Tasks with zero size are enqueued as rejected and should be skipped by the consumer.
+    static constexpr size_t MaxBatchSize = 64;
+
+    void reserve(size_t count);
+    Task& reserved(size_t index);
+    void enQueueReserved(size_t count);
+
     TaskPtr<IPacMan> getNextTask();
 
-    using TaskIterator = std::list<TaskBody<Task>>::iterator;
+    using TaskIterator = TaskBody<Task>*;
     void releaseTask(TaskIterator&);
     void rejectLast();
 
+    // reader waits for the processor when that many tasks are in flight
+    static constexpr size_t QueueSize = 1 << 15;
+
 private:
-    std::list<TaskBody<Task>> queue_;
-    std::mutex mutex_;
-    std::atomic<size_t> size_ = {0};
+    // single producer (reader) and single consumer (processor)
+    BoundedRing<TaskBody<Task>, QueueSize> queue_;
     RegionAllocator allocator_;
+    const uint32_t packetSize_;
+
+    TaskBody<Task>* last_ = nullptr;
+
+    // reserved tasks are the last claimed ones in the queue
+    TaskBody<Task>* reserved_[MaxBatchSize] = {};
+    size_t reservedCount_ = 0;
 };
 
 class OPacMan {
@@ -94,18 +120,21 @@ public:
         Packet pack;
     };
 
+    // may be called from any thread, the task is sent after enQueue
     Task* allocNext();
-    void enQueueLast();
+    void enQueue(Task* task);
 
     TaskPtr<OPacMan> getNextTask();
 
-    using TaskIterator = std::list<TaskBody<Task>>::iterator;
+    using TaskIterator = TaskBody<Task>*;
     void releaseTask(TaskIterator&);
 
+    // senders wait for the writer when that many tasks are in flight
+    static constexpr size_t QueueSize = 1 << 15;
+
 private:
-    std::list<TaskBody<Task>> queue_;
-    std::mutex mutex_;
-    std::atomic<size_t> size_ = {0};
+    // many producers and single consumer (writer)
+    BoundedRing<TaskBody<Task>, QueueSize> queue_;
 };
 
 #endif  // PACMANS_HPP
@@ -98,9 +98,10 @@ public:
 
     static const char* networkCommandToString(NetworkCommand command);
 
+    // thread safe
     RemoteNodePtr getPackSenderEntry(const ip::udp::endpoint&);
 
-    void processNetworkTask(const TaskPtr<IPacMan>&, RemoteNodePtr&);
+    void processNetworkTask(const IPacMan::Task&, RemoteNodePtr&);
     void processNodeMessage(const Message&);
     void processNodeMessage(const Packet&);
 
@@ -172,29 +173,32 @@ private:
     void postponePacket(const cs::RoundNumber, const MsgTypes, const Packet&);
 
     // Dealing with network connections
-    bool parseSSSignal(const TaskPtr<IPacMan>&);
+    bool parseSSSignal(const IPacMan::Task&);
 
     void dispatchNodeMessage(const MsgTypes, const cs::RoundNumber, const Packet&, const uint8_t* data, size_t);
 
     /* Network packages processing */
-    bool gotRegistrationRequest(const TaskPtr<IPacMan>&, RemoteNodePtr&);
+    bool gotRegistrationRequest(const IPacMan::Task&, RemoteNodePtr&);
 
-    bool gotRegistrationConfirmation(const TaskPtr<IPacMan>&, RemoteNodePtr&);
+    // the smaller of the sizes supported by the peer and by this node
+    uint32_t negotiatePacketSize(const uint32_t remoteSize) const;
 
-    bool gotRegistrationRefusal(const TaskPtr<IPacMan>&, RemoteNodePtr&);
+    bool gotRegistrationConfirmation(const IPacMan::Task&, RemoteNodePtr&);
 
-    bool gotSSRegistration(const TaskPtr<IPacMan>&, RemoteNodePtr&);
+    bool gotRegistrationRefusal(const IPacMan::Task&, RemoteNodePtr&);
+
+    bool gotSSRegistration(const IPacMan::Task&, RemoteNodePtr&);
     bool gotSSReRegistration();
-    bool gotSSRefusal(const TaskPtr<IPacMan>&);
-    bool gotSSDispatch(const TaskPtr<IPacMan>&);
-    bool gotSSPingWhiteNode(const TaskPtr<IPacMan>&);
-    bool gotSSLastBlock(const TaskPtr<IPacMan>&, cs::Sequence, const csdb::PoolHash&, bool canBeTrusted);
+    bool gotSSRefusal(const IPacMan::Task&);
+    bool gotSSDispatch(const IPacMan::Task&);
+    bool gotSSPingWhiteNode(const IPacMan::Task&);
+    bool gotSSLastBlock(const IPacMan::Task&, cs::Sequence, const csdb::PoolHash&, bool canBeTrusted);
 
-    bool gotPackInform(const TaskPtr<IPacMan>&, RemoteNodePtr&);
-    bool gotPackRenounce(const TaskPtr<IPacMan>&, RemoteNodePtr&);
-    bool gotPackRequest(const TaskPtr<IPacMan>&, RemoteNodePtr&);
+    bool gotPackInform(const IPacMan::Task&, RemoteNodePtr&);
+    bool gotPackRenounce(const IPacMan::Task&, RemoteNodePtr&);
+    bool gotPackRequest(const IPacMan::Task&, RemoteNodePtr&);
 
-    bool gotPing(const TaskPtr<IPacMan>&, RemoteNodePtr&);
+    bool gotPing(const IPacMan::Task&, RemoteNodePtr&);
 
     void askForMissingPackages();
     void requestMissing(const cs::Hash&, const uint16_t, const uint64_t);
@@ -219,6 +223,7 @@ private:
     TypedAllocator<RemoteNode> remoteNodes_;
 
     FixedHashMap<ip::udp::endpoint, RemoteNodePtr, uint16_t, maxRemoteNodes_> remoteNodesMap_;
+    cs::SpinLock remoteNodesLock_{ATOMIC_FLAG_INIT};  // packets of different senders are processed in parallel
 
     RegionAllocator netPacksAllocator_;
     cs::PublicKey myPublicKey_;
@@ -273,8 +278,6 @@ private:
     FixedHashMap<cs::Hash, cs::RoundNumber, uint16_t, fragmentsFixedMapSize_> fragOnRound_;
 
 public:
-    inline static size_t cntDirtyAllocs = 0;
-    inline static size_t cntCorruptedFragments = 0;
     inline static size_t cntExtraLargeNotSent = 0;
 };
 
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cstring>
+
+#include <lib/system/hash.hpp>
+#include <lib/system/logger.hpp>
+
+#include "messagecompression.hpp"
+
+namespace cs {
+/*static*/
+MessageCompression& MessageCompression::instance() {
+    static MessageCompression inst;
+    return inst;
+}
+
+void MessageCompression::setDictionary(const cs::Bytes& dictionary) {
+    const size_t size = std::min(dictionary.size(), MaxDictionarySize);
+    dictionary_.assign(dictionary.end() - static_cast<std::ptrdiff_t>(size), dictionary.end());
+
+    if (dictionary_.empty()) {
+        dictionaryId_ = 0;
+        return;
+    }
+
+    // id is sent with every message to detect a different dictionary at the receiver, 0 means no dictionary
+    const cs::Hash hash = generateHash(dictionary_.data(), dictionary_.size());
+    std::memcpy(&dictionaryId_, hash.data(), sizeof(dictionaryId_));
+    dictionaryId_ = std::max(dictionaryId_, 1u);
+
+    LZ4_resetStream(&dictionaryStream_);
+    LZ4_loadDict(&dictionaryStream_, reinterpret_cast<const char*>(dictionary_.data()), static_cast<int>(dictionary_.size()));
+
+    cslog() << "Net: message compression dictionary of " << dictionary_.size() << " bytes, id " << dictionaryId_;
+}
+
+bool MessageCompression::compress(MsgTypes type, const cs::Byte* data, size_t size, cs::Bytes& result) {
+    if (size < MinSize || size > MaxSize) {
+        return false;
+    }
+
+    const int bound = LZ4_compressBound(static_cast<int>(size));
+    result.resize(HeaderSize + static_cast<size_t>(bound));
+
+    const auto rawSize = static_cast<uint32_t>(size);
+    std::memcpy(result.data(), &rawSize, sizeof(rawSize));
+    std::memcpy(result.data() + sizeof(rawSize), &dictionaryId_, sizeof(dictionaryId_));
+
+    const auto source = reinterpret_cast<const char*>(data);
+    const auto dest = reinterpret_cast<char*>(result.data() + HeaderSize);
+    int compressedSize = 0;
+
+    if (dictionaryId_) {
+        thread_local LZ4_stream_t stream;
+        std::memcpy(&stream, &dictionaryStream_, sizeof(stream));
+        compressedSize = LZ4_compress_fast_continue(&stream, source, dest, static_cast<int>(size), bound, 1);
+    }
+    else {
+        compressedSize = LZ4_compress_default(source, dest, static_cast<int>(size), bound);
+    }
+
+    Stats& stats = compressed_[type];
+
+    if (compressedSize <= 0 || HeaderSize + static_cast<size_t>(compressedSize) >= size) {
+        stats.skipped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    result.resize(HeaderSize + static_cast<size_t>(compressedSize));
+    count(stats, size, result.size());
+
+    return true;
+}
+
+Packet MessageCompression::decompress(const Packet& pack) {
+    const uint32_t prefixSize = pack.getHeadersLength() + static_cast<uint32_t>(PrefixSize);
+
+    if (pack.size() <= prefixSize + HeaderSize) {
+        cswarning() << "Net: compressed message is too short, size " << pack.size();
+        return Packet();
+    }
+
+    auto source = static_cast<const cs::Byte*>(pack.data()) + prefixSize;
+    uint32_t rawSize = 0;
+    uint32_t dictionaryId = 0;
+
+    std::memcpy(&rawSize, source, sizeof(rawSize));
+    std::memcpy(&dictionaryId, source + sizeof(rawSize), sizeof(dictionaryId));
+
+    if (rawSize == 0 || rawSize > MaxSize) {
+        cswarning() << "Net: compressed message has unexpected raw size " << rawSize;
+        return Packet();
+    }
+
+    if (dictionaryId != dictionaryId_) {
+        cserror() << "Net: message " << Packet::messageTypeToString(pack.getType()) << " is compressed with dictionary " << dictionaryId
+                  << ", " << dictionaryId_ << " is used";
+        return Packet();
+    }
+
+    Packet result(Message::allocate(prefixSize + rawSize));
+    auto dest = static_cast<cs::Byte*>(result.data());
+
+    std::copy(static_cast<const cs::Byte*>(pack.data()), static_cast<const cs::Byte*>(pack.data()) + prefixSize, dest);
+    *dest &= ~BaseFlags::CompressedMessage;
+
+    const auto compressed = reinterpret_cast<const char*>(source + HeaderSize);
+    const auto compressedSize = static_cast<int>(pack.size() - prefixSize - HeaderSize);
+    const auto raw = reinterpret_cast<char*>(dest + prefixSize);
+    int size = 0;
+
+    if (dictionaryId) {
+        size = LZ4_decompress_safe_usingDict(compressed, raw, compressedSize, static_cast<int>(rawSize), reinterpret_cast<const char*>(dictionary_.data()),
+                                             static_cast<int>(dictionary_.size()));
+    }
+    else {
+        size = LZ4_decompress_safe(compressed, raw, compressedSize, static_cast<int>(rawSize));
+    }
+
+    if (size != static_cast<int>(rawSize)) {
+        cswarning() << "Net: cannot decompress message " << Packet::messageTypeToString(pack.getType()) << ", " << size << " of " << rawSize << " bytes";
+        return Packet();
+    }
+
+    count(decompressed_[pack.getType()], rawSize, pack.size() - prefixSize);
+    return result;
+}
+
+void MessageCompression::count(Stats& stats, uint64_t rawSize, uint64_t compressedSize) {
+    stats.messages.fetch_add(1, std::memory_order_relaxed);
+    stats.rawBytes.fetch_add(rawSize, std::memory_order_relaxed);
+    stats.compressedBytes.fetch_add(compressedSize, std::memory_order_relaxed);
+
+    if (processed_.fetch_add(1, std::memory_order_relaxed) % ReportPeriod == ReportPeriod - 1) {
+        report();
+    }
+}
+
+void MessageCompression::report() {
+    auto print = [](const char* name, size_t type, const Stats& stats) {
+        const uint64_t messages = stats.messages.load(std::memory_order_relaxed);
+        const uint64_t skipped = stats.skipped.load(std::memory_order_relaxed);
+
+        if (messages == 0 && skipped == 0) {
+            return;
+        }
+
+        const uint64_t rawBytes = stats.rawBytes.load(std::memory_order_relaxed);
+        const uint64_t compressedBytes = stats.compressedBytes.load(std::memory_order_relaxed);
+
+        csdebug() << "Net: " << name << " " << Packet::messageTypeToString(static_cast<MsgTypes>(type)) << ": " << messages << " messages, " << rawBytes
+                  << " -> " << compressedBytes << " bytes, ratio " << (compressedBytes ? static_cast<double>(rawBytes) / static_cast<double>(compressedBytes) : 0.0)
+                  << (skipped ? ", not compressible " : "") << (skipped ? std::to_string(skipped) : "");
+    };
+
+    for (size_t type = 0; type < compressed_.size(); ++type) {
+        print("compressed", type, compressed_[type]);
+    }
+
+    for (size_t type = 0; type < decompressed_.size(); ++type) {
+        print("decompressed", type, decompressed_[type]);
+    }
+}
+}  // namespace cs
@@ -17,6 +17,7 @@
 #include <sys/time.h>
 #endif
 
+#include <net/messagecompression.hpp>
 #include <net/packetvalidator.hpp>
 #include "network.hpp"
 #include "transport.hpp"
@@ -106,6 +107,61 @@ void Network::readerRoutine(const Config& config) {
         std::this_thread::sleep_for(1s);
     }
 
+#ifdef __linux__
+    // many datagrams are received per syscall into preallocated tasks and the processor is signaled once per batch
+    std::array<struct mmsghdr, IPacMan::MaxBatchSize> msg;
+    std::array<struct iovec, IPacMan::MaxBatchSize> iovecs;
+
+    while (stopReaderRoutine == false) {
+        iPacMan_.reserve(IPacMan::MaxBatchSize);
+
+        for (size_t i = 0; i < IPacMan::MaxBatchSize; ++i) {
+            auto& task = iPacMan_.reserved(i);
+
+            iovecs[i].iov_base = task.pack.data();
+            iovecs[i].iov_len = task.pack.size();
+
+            msg[i] = mmsghdr{};
+            msg[i].msg_hdr.msg_iov = &iovecs[i];
+            msg[i].msg_hdr.msg_iovlen = 1;
+            msg[i].msg_hdr.msg_name = task.sender.data();
+            msg[i].msg_hdr.msg_namelen = static_cast<socklen_t>(task.sender.capacity());
+        }
+
+        const int received = recvmmsg(sock->native_handle(), msg.data(), IPacMan::MaxBatchSize, MSG_WAITFORONE, nullptr);
+
+        if (stopReaderRoutine) {
+            return;
+        }
+
+        if (received <= 0) {
+            if (errno != EINTR) {
+                cserror() << "Cannot receive packets. Errno " << errno;
+            }
+            continue;
+        }
+
+        for (int i = 0; i < received; ++i) {
+            auto& task = iPacMan_.reserved(static_cast<size_t>(i));
+            task.sender.resize(msg[i].msg_hdr.msg_namelen);
+
+            // datagram is larger than the packet size negotiated with any peer
+            if (msg[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                cswarning() << "Ignore truncated packet from " << task.sender;
+                task.size = 0;
+                continue;
+            }
+
+            task.size = decodeReceived(task, msg[i].msg_len);
+        }
+
+        iPacMan_.enQueueReserved(static_cast<size_t>(received));
+        readerStats_.add(static_cast<size_t>(received));
+
+        uint64_t count = static_cast<uint64_t>(received);
+        write(readerEventfd_, &count, sizeof(uint64_t));
+    }
+#else
     boost::system::error_code lastError;
     size_t packetSize;
 
@@ -120,40 +176,22 @@ void Network::readerRoutine(const Config& config) {
         while (!task.pack.data_.ptr_) {
             cslog() << "net: invalid input packet!!!!!!!!!";
         }
-        packetSize = sock->receive_from(buffer(task.pack.data(), Packet::MaxSize), task.sender, NO_FLAGS, lastError);
+        packetSize = sock->receive_from(buffer(task.pack.data(), task.pack.size()), task.sender, NO_FLAGS, lastError);
         while (!task.pack.data_.ptr_) {
             cslog() << "net: invalid input packet!!!!!!!!!";
         }
 
         if (!lastError) {
-            task.size = task.pack.decode(packetSize);  // try to decode first
+            task.size = decodeReceived(task, packetSize);
 
-            bool reject = false;
             if (task.size == 0) {
-                cswarning() << "Ignore incorrect packet fragment, drop";
-                reject = true;
-            }
-            else if (!task.pack.hasValidFragmentation()) {
-                cswarning() << "Incorrect fragment identity in message or too many fragments, drop (" << task.pack.getFragmentId() << " from " << task.pack.getFragmentsNum()
-                            << "), sender " << task.sender;
-                reject = true;
-            }
-
-            if (reject) {
                 iPacMan_.rejectLast();
+                continue;
             }
-            else {
-                iPacMan_.enQueueLast();
 
-#ifdef LOG_NET
-                csdebug(logger::Net) << "<-- " << packetSize << " bytes from " << task.sender << " " << task.pack;
-#endif
-            }
-#ifdef __linux__
-            static uint64_t one = 1;
-            write(readerEventfd_, &one, sizeof(uint64_t));
-#endif
-#if defined(WIN32) || defined(__APPLE__)
+            iPacMan_.enQueueLast();
+            readerStats_.add(1);
+
             while (readerLock.test_and_set(std::memory_order_acquire))  // acquire lock
                 ;                                                       // spin
             readerTaskCount_.fetch_add(1, std::memory_order_relaxed);
@@ -163,17 +201,48 @@ void Network::readerRoutine(const Config& config) {
             kevent(readerKq_, &readerEvent_, 1, NULL, 0, NULL);
 #endif
             readerLock.clear(std::memory_order_release);  // release lock
-#endif
         }
         else {
             cserror() << "Cannot receive packet. Error " << lastError;
             iPacMan_.rejectLast();
         }
     }
+#endif
 
     cswarning() << "readerRoutine STOPPED!!!\n";
 }
 
+size_t Network::decodeReceived(IPacMan::Task& task, size_t packetSize) {
+    const size_t size = task.pack.decode(packetSize);  // try to decode first
+
+    if (size == 0) {
+        cswarning() << "Ignore incorrect packet fragment, drop";
+        return 0;
+    }
+
+    if (!task.pack.hasValidFragmentation()) {
+        cswarning() << "Incorrect fragment identity in message or too many fragments, drop (" << task.pack.getFragmentId() << " from " << task.pack.getFragmentsNum()
+                    << "), sender " << task.sender;
+        return 0;
+    }
+
+#ifdef LOG_NET
+    csdebug(logger::Net) << "<-- " << packetSize << " bytes from " << task.sender << " " << task.pack;
+#endif
+
+    return size;
+}
+
+void Network::SyscallStats::add(size_t packetsCount) {
+    ++calls;
+    packets += packetsCount;
+
+    if (calls % ReportPeriod == 0) {
+        csdebug() << "Net: " << name << " " << packets << " packets by " << calls << " syscalls, " << static_cast<double>(packets) / static_cast<double>(calls)
+                  << " per syscall";
+    }
+}
+
 static inline void sendPack(ip::udp::socket& sock, TaskPtr<OPacMan>& task, const ip::udp::endpoint& ep) {
     boost::system::error_code lastError;
     size_t size = 0;
@@ -214,9 +283,13 @@ void Network::writerRoutine(const Config& config) {
 #ifdef __linux__
     std::vector<struct mmsghdr> msg;
     std::vector<struct iovec> iovecs;
-    std::vector<std::array<char, Packet::MaxSize>> packets_buffer;
+    // compressed packets are encoded into the buffer of the configured packet size per task
+    const size_t packetSize = config.getPacketSize();
+    std::vector<char> packets_buffer;
     std::vector<boost::asio::mutable_buffer> encoded_packets;
     std::vector<ip::udp::endpoint> endpoints;
+    // not compressed packets are sent from their own memory, so they are kept until sent
+    std::vector<Packet> packets;
 #endif
     while (stopWriterRoutine == false) {  // changed from true
 #ifdef __linux__
@@ -233,9 +306,10 @@ void Network::writerRoutine(const Config& config) {
         std::fill(msg.begin(), msg.end(), mmsghdr{});
         iovecs.resize(tasks);
         std::fill(iovecs.begin(), iovecs.end(), iovec{});
-        packets_buffer.resize(tasks);
+        packets_buffer.resize(tasks * packetSize);
         endpoints.resize(tasks);
         encoded_packets.clear();
+        packets.clear();
 
         int j = 0;
         for (uint64_t i = 0; i < tasks; i++) {
@@ -244,7 +318,8 @@ void Network::writerRoutine(const Config& config) {
             while (!task->pack.data_.ptr_) {
                 cslog() << "net: invalid packet for send!!!!!!!!!";
             }
-            encoded_packets.emplace_back(task->pack.encode(buffer(packets_buffer[j].data(), Packet::MaxSize)));
+            encoded_packets.emplace_back(task->pack.encode(buffer(packets_buffer.data() + j * packetSize, packetSize)));
+            packets.push_back(task->pack);
             endpoints[j] = task->endpoint;
             iovecs[j].iov_base = encoded_packets[j].data();
             iovecs[j].iov_len = encoded_packets[j].size();
@@ -266,7 +341,9 @@ void Network::writerRoutine(const Config& config) {
                 cslog() << "sendmmsg errno = " << errno;
                 if (errno != EAGAIN)
                     break;
+                continue;
             }
+            writerStats_.add(static_cast<size_t>(sended));
             messages += sended;
             tasks -= sended;
         } while (tasks);
@@ -290,6 +367,7 @@ void Network::writerRoutine(const Config& config) {
                 cslog() << "net: invalid packet!!!!!!!!!";
             }
             sendPack(*sock, task, task->endpoint);
+            writerStats_.add(1);
         }
 #endif
     }
@@ -299,6 +377,14 @@ void Network::writerRoutine(const Config& config) {
 
 // Processors
 void Network::processorRoutine() {
+#ifdef __linux__
+    if (!shards_.empty()) {
+        shardedProcessorRoutine();
+        cswarning() << "processorRoutine STOPPED!!!\n";
+        return;
+    }
+#endif
+
     CallsQueue& externals = CallsQueue::instance();
 #ifdef __linux__
     struct pollfd pfd {};
@@ -330,6 +416,12 @@ void Network::processorRoutine() {
             while (!task->pack.data_.ptr_) {
                 cslog() << "net: invalid packet processor!!!!!!!!!";
             }
+
+            // rejected by reader
+            if (task->size == 0) {
+                continue;
+            }
+
             processTask(task);
         }
 #endif
@@ -366,60 +458,238 @@ void Network::processorRoutine() {
 }
 
 inline void Network::processTask(TaskPtr<IPacMan>& task) {
-    auto remoteSender = transport_->getPackSenderEntry(task->sender);
+    PreparedPacket prepared;
 
-    if (!(task->pack.isHeaderValid())) {
+    if (preparePacket(*task, prepared)) {
+        dispatchPacket(*task, prepared);
+    }
+}
+
+bool Network::preparePacket(const IPacMan::Task& task, PreparedPacket& prepared) {
+    prepared.sender = transport_->getPackSenderEntry(task.sender);
+
+    if (!(task.pack.isHeaderValid())) {
         static constexpr size_t limit = 100;
-        auto size = (task->pack.size() <= limit) ? task->pack.size() : limit;
+        auto size = (task.pack.size() <= limit) ? task.pack.size() : limit;
 
-        cswarning() << "Header is not valid: " << cs::Utils::byteStreamToHex(static_cast<const char*>(task->pack.data()), size);
-        remoteSender->addStrike();
-        return;
+        cswarning() << "Header is not valid: " << cs::Utils::byteStreamToHex(static_cast<const char*>(task.pack.data()), size);
+        prepared.sender->addStrike();
+        return false;
     }
 
     // Pure network processing, prior blacklist inspection to allow re-registration
-    if (task->pack.isNetwork()) {
-        if (cs::PacketValidator::instance().validate(task->pack)) {
-            transport_->processNetworkTask(task, remoteSender);
-        }
-        return;
+    if (task.pack.isNetwork()) {
+        return true;
     }
 
     // test blacklist, the only way to remove from the list is to re-register again
-    if (remoteSender->isBlackListed()) {
-        csdebug() << "Message is ignored from blacklisted " << task->sender;
+    if (prepared.sender->isBlackListed()) {
+        csdebug() << "Message is ignored from blacklisted " << task.sender;
+        return false;
+    }
+
+    // computed once and cached by the packet
+    task.pack.getHash();
+    return true;
+}
+
+void Network::dispatchPacket(const IPacMan::Task& task, PreparedPacket& prepared) {
+    RemoteNodePtr& remoteSender = prepared.sender;
+
+    if (task.pack.isNetwork()) {
+        if (cs::PacketValidator::instance().validate(task.pack)) {
+            transport_->processNetworkTask(task, remoteSender);
+        }
         return;
     }
 
     // Non-network data
-    uint32_t& recCounter = packetMap_.tryStore(task->pack.getHash());
-    if (!recCounter && task->pack.addressedToMe(transport_->getMyPublicKey())) {
-        if (task->pack.isFragmented() || task->pack.isCompressed()) {
-            bool newFragmentedMsg = false;
-            MessagePtr msg = collector_.getMessage(task->pack, newFragmentedMsg);
-            transport_->gotPacket(task->pack, remoteSender);
-
-            if (newFragmentedMsg) {
-                transport_->registerMessage(msg);
+    uint32_t& recCounter = packetMap_.tryStore(task.pack.getHash());
+    if (task.pack.addressedToMe(transport_->getMyPublicKey())) {
+        if (task.pack.isFragmented() || task.pack.isCompressed()) {
+            // fragments are collected by the processor shards beforehand
+            if (!recCounter && !prepared.collected) {
+                prepared.msg = collector_.getMessage(task.pack, prepared.newFragmentedMsg, prepared.completed);
             }
 
-            if (msg && msg->isComplete()) {
-                if (cs::PacketValidator::instance().validate(**msg)) {
-                    transport_->processNodeMessage(**msg);
+            // a copy of the fragment from another sender may be collected first
+            if (!recCounter || prepared.newFragmentedMsg || prepared.completed) {
+                MessagePtr& msg = prepared.msg;
+
+                if (!recCounter) {
+                    transport_->gotPacket(task.pack, remoteSender);
+                }
+
+                if (prepared.newFragmentedMsg) {
+                    transport_->registerMessage(msg);
+                }
+
+                if (msg && prepared.completed) {
+                    if (cs::PacketValidator::instance().validate(**msg)) {
+                        transport_->processNodeMessage(**msg);
+                    }
                 }
             }
         }
-        else {
-            if (cs::PacketValidator::instance().validate(task->pack)) {
-                transport_->processNodeMessage(task->pack);
+        else if (!recCounter) {
+            // compressed message is relayed as is and processed decompressed
+            Packet pack = task.pack.isCompressedMessage() ? cs::MessageCompression::instance().decompress(task.pack) : task.pack;
+
+            if (pack && cs::PacketValidator::instance().validate(pack)) {
+                transport_->processNodeMessage(pack);
             }
         }
     }
 
-    transport_->redirectPacket(task->pack, remoteSender);
+    transport_->redirectPacket(task.pack, remoteSender);
     ++recCounter;
 }
 
+#ifdef __linux__
+void Network::ShardTask::reset() {
+    task.pack = Packet();
+    prepared = PreparedPacket();
+    dispatch = false;
+}
+
+void Network::shardedProcessorRoutine() {
+    CallsQueue& externals = CallsQueue::instance();
+
+    std::array<struct pollfd, 2> pfds{};
+    pfds[0].fd = readerEventfd_;
+    pfds[0].events = POLLIN;
+    pfds[1].fd = dispatchEventfd_;
+    pfds[1].events = POLLIN;
+    constexpr int timeout = 50;  // 50ms
+
+    std::vector<uint64_t> shardTasks(shards_.size(), 0);
+
+    while (stopProcessorRoutine == false) {
+        externals.callAll();
+
+        const int ret = poll(pfds.data(), pfds.size(), timeout);
+
+        uint64_t tasks;
+        if (ret > 0 && (pfds[1].revents & POLLIN)) {
+            read(dispatchEventfd_, &tasks, sizeof(uint64_t));
+        }
+
+        dispatchShardTasks();
+
+        if (ret <= 0 || !(pfds[0].revents & POLLIN) || read(readerEventfd_, &tasks, sizeof(uint64_t)) != sizeof(uint64_t)) {
+            continue;
+        }
+
+        for (uint64_t i = 0; i < tasks; i++) {
+            auto task = iPacMan_.getNextTask();
+
+            // rejected by reader
+            if (task->size == 0) {
+                continue;
+            }
+
+            const size_t index = getHashIndex<uint16_t>(task->sender) % shards_.size();
+            auto& queue = shards_[index]->queue;
+
+            ShardTask* shardTask;
+            while (!(shardTask = queue.tryClaim())) {
+                // wake the shard up to free its queue, it may also wait for its results to be dispatched
+                if (shardTasks[index] != 0) {
+                    write(shards_[index]->eventfd, &shardTasks[index], sizeof(uint64_t));
+                    shardTasks[index] = 0;
+                }
+
+                dispatchShardTasks();
+                std::this_thread::yield();
+            }
+
+            shardTask->task.sender = task->sender;
+            shardTask->task.size = task->size;
+            shardTask->task.pack = task->pack;
+            queue.publish(shardTask);
+
+            ++shardTasks[index];
+        }
+
+        for (size_t index = 0; index < shards_.size(); ++index) {
+            if (shardTasks[index] != 0) {
+                write(shards_[index]->eventfd, &shardTasks[index], sizeof(uint64_t));
+                shardTasks[index] = 0;
+            }
+        }
+    }
+}
+
+void Network::shardRoutine(ProcessorShard& shard) {
+    struct pollfd pfd {};
+    pfd.fd = shard.eventfd;
+    pfd.events = POLLIN;
+    constexpr int timeout = 50;  // 50ms
+
+    while (stopShardRoutines_.load(std::memory_order_relaxed) == false) {
+        // the queue is drained on timeout too, so published tasks are not left behind a missed wake up
+        uint64_t tasks;
+        if (poll(&pfd, 1, timeout) > 0) {
+            read(shard.eventfd, &tasks, sizeof(uint64_t));
+        }
+
+        uint64_t prepared = 0;
+
+        while (ShardTask* task = shard.queue.front()) {
+            ShardTask* result;
+            while (!(result = dispatchQueue_->tryClaim())) {
+                if (stopShardRoutines_.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                std::this_thread::yield();
+            }
+
+            result->task.sender = task->task.sender;
+            result->task.size = task->task.size;
+            result->task.pack = std::move(task->task.pack);
+
+            if (preparePacket(result->task, result->prepared)) {
+                const Packet& pack = result->task.pack;
+
+                if (!pack.isNetwork() && (pack.isFragmented() || pack.isCompressed()) && pack.addressedToMe(transport_->getMyPublicKey())) {
+                    result->prepared.msg = collector_.getMessage(pack, result->prepared.newFragmentedMsg, result->prepared.completed);
+                    result->prepared.collected = true;
+                }
+
+                result->dispatch = true;
+            }
+
+            dispatchQueue_->publish(result);
+
+            task->reset();
+            shard.queue.pop();
+
+            // do not keep the processor waiting for the whole batch
+            if (++prepared == IPacMan::MaxBatchSize) {
+                write(dispatchEventfd_, &prepared, sizeof(uint64_t));
+                prepared = 0;
+            }
+        }
+
+        if (prepared != 0) {
+            write(dispatchEventfd_, &prepared, sizeof(uint64_t));
+        }
+    }
+}
+
+// processor thread only
+void Network::dispatchShardTasks() {
+    while (ShardTask* task = dispatchQueue_->front()) {
+        if (task->dispatch) {
+            dispatchPacket(task->task, task->prepared);
+        }
+
+        task->reset();
+        dispatchQueue_->pop();
+    }
+}
+#endif
+
 void Network::sendDirect(const Packet& p, const ip::udp::endpoint& ep) {
     auto qePtr = oPacMan_.allocNext();
 
@@ -433,7 +703,7 @@ void Network::sendDirect(const Packet& p, const ip::udp::endpoint& ep) {
     qePtr->endpoint = ep;
     qePtr->pack = p;
 
-    oPacMan_.enQueueLast();
+    oPacMan_.enQueue(qePtr);
 #ifdef __linux__
     static uint64_t one = 1;
     write(writerEventfd_, &one, sizeof(uint64_t));
@@ -453,6 +723,7 @@ void Network::sendDirect(const Packet& p, const ip::udp::endpoint& ep) {
 
 Network::Network(const Config& config, Transport* transport)
 : resolver_(context_)
+, iPacMan_(config.getPacketSize())
 , transport_(transport) {
 #ifdef __linux__
     readerEventfd_ = eventfd(0, 0);
@@ -521,6 +792,37 @@ Network::Network(const Config& config, Transport* transport)
 
     EV_SET(&writerEvent_, 0, EVFILT_USER, EV_DISPATCH | EV_ENABLE, NOTE_FFCOPY | NOTE_TRIGGER, 0, NULL);
 #endif
+
+    if (config.getProcessorThreads() > 1) {
+#ifdef __linux__
+        dispatchEventfd_ = eventfd(0, 0);
+        if (dispatchEventfd_ == -1) {
+            good_ = false;
+            return;
+        }
+
+        dispatchQueue_ = std::make_unique<BoundedRing<ShardTask, ShardQueueSize * 4>>();
+
+        for (uint32_t i = 0; i < config.getProcessorThreads(); ++i) {
+            shards_.emplace_back(std::make_unique<ProcessorShard>());
+            shards_.back()->eventfd = eventfd(0, 0);
+
+            if (shards_.back()->eventfd == -1) {
+                good_ = false;
+                return;
+            }
+        }
+
+        for (auto& shard : shards_) {
+            shard->thread = std::thread(&Network::shardRoutine, this, std::ref(*shard));
+        }
+
+        cslog() << "Network: " << shards_.size() << " packet processor threads";
+#else
+        cswarning() << "Network: multiple packet processor threads are supported on Linux only, using one";
+#endif
+    }
+
     readerThread_ = std::thread(&Network::readerRoutine, this, config);
     writerThread_ = std::thread(&Network::writerRoutine, this, config);
     processorThread_ = std::thread(&Network::processorRoutine, this);
@@ -561,15 +863,19 @@ bool Network::resendFragment(const cs::Hash& hash, const uint16_t id, const ip::
         return false;
     }
 
+    Packet fragment;
+
     {
         cs::Lock l(msg->pLock_);
-        if (id < msg->packetsTotal_ && *(msg->packets_ + id)) {
-            sendDirect(*(msg->packets_ + id), ep);
-            return true;
-        }
+        fragment = msg->getFragment(id);
+    }
+
+    if (!fragment) {
+        return false;
     }
 
-    return false;
+    sendDirect(fragment, ep);
+    return true;
 }
 
 void Network::sendInit() {
@@ -589,14 +895,15 @@ void Network::registerMessage(Packet* pack, const uint32_t size) {
         msg = collector_.msgAllocator_.emplace();
     }
 
-    msg->packetsLeft_ = 0;
-    msg->packetsTotal_ = size;
+    if (!msg->init(*pack)) {
+        cserror() << "Cannot register message of " << size << " fragments to send";
+        return;
+    }
+
     msg->headerHash_ = pack->getHeaderHash();
 
-    auto packEnd = msg->packets_ + size;
-    auto rPtr = pack;
-    for (auto wPtr = msg->packets_; wPtr != packEnd; ++wPtr, ++rPtr) {
-        *wPtr = *rPtr;
+    for (auto ptr = pack; ptr != pack + size; ++ptr) {
+        msg->insert(*ptr);
     }
 
     {
@@ -624,5 +931,23 @@ Network::~Network() {
         processorThread_.join();
     }
 
+#ifdef __linux__
+    stopShardRoutines_.store(true, std::memory_order_relaxed);
+
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+
+        if (shard->eventfd != -1) {
+            close(shard->eventfd);
+        }
+    }
+
+    if (dispatchEventfd_ != -1) {
+        close(dispatchEventfd_);
+    }
+#endif
+
     delete singleSock_.load();
 }
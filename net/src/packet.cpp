@@ -1,10 +1,13 @@
 #include <lz4.h>
 
 #include <lib/system/utils.hpp>
+#include "messagecompression.hpp"
 #include "packet.hpp"
 #include "transport.hpp"  // for NetworkCommand
 
 RegionAllocator Message::allocator_(1 << 26, 4);
+cs::SpinLock Message::allocatorLock_{ATOMIC_FLAG_INIT};
+std::atomic<size_t> Message::collectingSize_ = {0};
 
 enum Lengths {
     FragmentedHeader = 36
@@ -142,7 +145,7 @@ void Packet::recalculateHeadersLength() {
     headersLength_ = calculateHeadersLength();
 }
 
-MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMsg) {
+MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMsg, bool& completed) {
     if (!pack.isFragmented()) {
         return MessagePtr();
     }
@@ -152,36 +155,36 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
     }
 
     newFragmentedMsg = false;
+    completed = false;
 
-    MessagePtr* msgPtr;
+    const cs::Hash& headerHash = pack.getHeaderHash();
     MessagePtr msg;
 
+    // fragments of one message may be collected by several processor threads
     {
         cs::Lock l(mLock_);
-        msgPtr = &map_.tryStore(pack.getHeaderHash());
-    }
+        MessagePtr& stored = map_.tryStore(headerHash);
 
-    if (!*msgPtr) {  // First time
-        *msgPtr = msg = msgAllocator_.emplace();
-        msg->packetsLeft_ = pack.getFragmentsNum();
-        msg->packetsTotal_ = pack.getFragmentsNum();
-        msg->headerHash_ = pack.getHeaderHash();
-        // to ensure not to contain dirty fragments in buffer (prevent goodPlace below from to be incorrect):
-        msg->clearFragments();
-        newFragmentedMsg = true;
-    }
-    else {
-        msg = *msgPtr;
+        if (!stored) {  // First time
+            MessagePtr created = msgAllocator_.emplace();
+
+            if (!created->init(pack)) {
+                return MessagePtr();
+            }
+
+            created->headerHash_ = headerHash;
+            stored = created;
+            newFragmentedMsg = true;
+        }
+
+        msg = stored;
     }
 
     {
         cs::Lock lock(msg->pLock_);
-        auto goodPlace = msg->packets_ + pack.getFragmentId(); // valid fragmentation has already been tested
 
-        if (!*goodPlace) {
-            msg->maxFragment_ = std::max(pack.getFragmentsNum(), msg->maxFragment_);
-            --msg->packetsLeft_;
-            *goodPlace = pack;
+        if (msg->insert(pack)) {
+            completed = msg->isComplete();
         }
 
         if (msg->packetsTotal_ >= 20) {
@@ -202,66 +205,200 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
     return msg;
 }
 
-/* WARN: All the cases except FRAG + COMPRESSED have bugs in them */
-void Message::composeFullData() const {
-    if (getFirstPack().isFragmented()) {
-        const Packet* pack = packets_;
-        uint32_t headersLength = pack->getHeadersLength();
-        uint32_t totalSize = headersLength;
+bool Message::init(const Packet& fragment) {
+    const uint32_t headersLength = fragment.getHeadersLength();
+
+    if (headersLength >= Packet::MaxSize || fragment.size() < headersLength) {
+        return false;
+    }
+
+    headersLength_ = headersLength;
+    packetsLeft_ = fragment.getFragmentsNum();
+    packetsTotal_ = fragment.getFragmentsNum();
+    fragments_.assign((packetsTotal_ + 63) / 64, 0);
+
+    return true;
+}
+
+// all the fragments but the last carry the same size (the packet size of the sender), so the place
+// of every fragment data is known as soon as any of them but the last is received
+bool Message::insert(const Packet& fragment) {
+    const uint32_t id = fragment.getFragmentId();
 
-        for (uint32_t i = 0; i < packetsTotal_; ++i, ++pack) {
-            totalSize += static_cast<uint32_t>((pack->size() - headersLength));
+    if (id >= packetsTotal_ || hasFragment(id) || fragment.getHeadersLength() != headersLength_ || fragment.size() < headersLength_) {
+        return false;
+    }
+
+    const uint32_t size = static_cast<uint32_t>(fragment.size()) - headersLength_;
+    const bool last = (id + 1 == packetsTotal_);
+
+    if ((!last && (size == 0 || (fragmentSize_ && size != fragmentSize_))) || (last && fragmentSize_ && size > fragmentSize_)) {
+        cswarning() << "Net: fragment " << id << " of " << packetsTotal_ << " has unexpected size " << fragment.size();
+        return false;
+    }
+
+    if (!buffer_) {
+        if (last && packetsTotal_ > 1) {
+            // the last fragment waits for the fragments size to be known
+            pendingLast_ = fragment;
+            lastFragmentSize_ = size;
+            markFragment(id);
+            return true;
+        }
+
+        if (pendingLast_ && lastFragmentSize_ > size) {
+            cswarning() << "Net: the last fragment of " << packetsTotal_ << " is larger than the others, drop it";
+            pendingLast_ = Packet();
+            fragments_[(packetsTotal_ - 1) / 64] &= ~(1ull << ((packetsTotal_ - 1) % 64));
+            ++packetsLeft_;
+        }
+
+        if (!reserve(fragment, size)) {
+            return false;
         }
+    }
 
-        fullData_ = allocator_.allocateNext(totalSize);
+    write(id, static_cast<const uint8_t*>(fragment.data()) + headersLength_, size);
+    markFragment(id);
 
-        uint8_t* data = static_cast<uint8_t*>(fullData_.get());
-        pack = packets_;
+    if (last) {
+        lastFragmentSize_ = size;
+    }
 
-        for (uint32_t i = 0; i < packetsTotal_; ++i, ++pack) {
-            uint32_t headerSize = static_cast<uint32_t>((i == 0) ? 0 : headersLength);
+    if (packetsLeft_ == 0) {
+        RegionAllocator::truncate(buffer_, headersLength_ + (packetsTotal_ - 1) * fragmentSize_ + lastFragmentSize_);
+        fullData_ = Packet(std::move(buffer_));
+        release();
 
-            uint32_t cSize = cs::numeric_cast<uint32_t>(pack->size()) - headerSize;
-            auto source = (reinterpret_cast<const char*>(pack->data())) + headerSize;
+        // the message is decompressed once, the flag is left set if it cannot be
+        if (fullData_.isCompressedMessage()) {
+            Packet decompressed = cs::MessageCompression::instance().decompress(fullData_);
 
-            std::copy(source, source + cSize, data);
-            data += cSize;
+            if (decompressed) {
+                compressedData_ = std::move(fullData_);
+                fullData_ = std::move(decompressed);
+            }
         }
     }
+
+    return true;
 }
 
-// scans array of future fragments and clears all dirty elements, scans all elements
-size_t Message::clearBuffer(size_t from, size_t to) {
-    if (to <= from || to >= Packet::MaxFragments) {
-        return 0;
-    }
-    size_t cnt = 0;
-    for (size_t i = from; i < to; i++) {
-        // Packet's operator bool redirects call to Packet::data_::operator bool
-        if (packets_[i]) {
-            csdebug() << "Net: potential heap corruption prevented in message.packets_[" << i << "]";
-            cs::Utils::clearMemory(packets_[i]);
-            ++cnt;
-        }
+bool Message::reserve(const Packet& fragment, const uint32_t fragmentSize) {
+    const uint32_t reserved = headersLength_ + packetsTotal_ * fragmentSize;
+
+    if (collectingSize_.fetch_add(reserved, std::memory_order_acq_rel) + reserved > MaxCollectingSize) {
+        collectingSize_.fetch_sub(reserved, std::memory_order_acq_rel);
+        cswarning() << "Net: too much data is being collected, fragment of " << packetsTotal_ << " is dropped";
+        return false;
+    }
+
+    reservedSize_ = reserved;
+    fragmentSize_ = fragmentSize;
+    buffer_ = allocate(reserved);
+
+    auto data = static_cast<uint8_t*>(buffer_.get());
+    std::copy(static_cast<const uint8_t*>(fragment.data()), static_cast<const uint8_t*>(fragment.data()) + headersLength_, data);
+    *reinterpret_cast<uint16_t*>(data + Offsets::FragmentId) = 0;
+
+    if (pendingLast_) {
+        write(packetsTotal_ - 1, static_cast<const uint8_t*>(pendingLast_.data()) + headersLength_, lastFragmentSize_);
+        pendingLast_ = Packet();
     }
-    return cnt;
+
+    return true;
 }
 
-Message::~Message() {
-    /*auto pEnd = packets_ + packetsTotal_;
-    for (auto ptr = packets_; ptr != pEnd; ++ptr)
-      if (ptr) ptr->~Packet();
+void Message::write(const uint32_t id, const uint8_t* data, const uint32_t size) {
+    std::copy(data, data + size, static_cast<uint8_t*>(buffer_.get()) + headersLength_ + id * fragmentSize_);
+}
+
+void Message::markFragment(const uint32_t id) {
+    fragments_[id / 64] |= (1ull << (id % 64));
+    --packetsLeft_;
+}
 
-      memset(packets_, 0, sizeof(Packet*) * packetsTotal_);*/
+Packet Message::getFragment(const uint16_t id) const {
+    if (id >= packetsTotal_ || !hasFragment(id)) {
+        return Packet();
+    }
 
-    //DEBUG: prevent corruption after heap is damaged,
-    // assume maxFragment "points" behind the last fragment,
-    // idea is to avoid call to MemPtr<> destructor on incorrect object
-    size_t cnt = clearUnused();
-    if (cnt > 0) {
-        csdebug() << "Net: memory corruption prevented, invalid fragments (" << cnt << ") is behind the max of " << maxFragment_ << " and cannot been destructed";
-        Transport::cntCorruptedFragments += cnt;
+    if (pendingLast_) {
+        return pendingLast_;
     }
+
+    const uint32_t size = (id + 1u == packetsTotal_) ? lastFragmentSize_ : fragmentSize_;
+    auto source = static_cast<const uint8_t*>(buffer_ ? buffer_.get() : (compressedData_ ? compressedData_.data() : fullData_.data()));
+
+    Packet result(allocate(headersLength_ + size));
+    auto data = static_cast<uint8_t*>(result.data());
+
+    std::copy(source, source + headersLength_, data);
+    *reinterpret_cast<uint16_t*>(data + Offsets::FragmentId) = id;
+    std::copy(source + headersLength_ + id * fragmentSize_, source + headersLength_ + id * fragmentSize_ + size, data + headersLength_);
+
+    return result;
+}
+
+std::vector<Packet> Message::split(const Packet& pack, const uint32_t packetSize) {
+    std::vector<Packet> fragments;
+
+    if (pack.isNetwork() || pack.isFragmented() || pack.size() <= pack.getHeadersLength()) {
+        return fragments;
+    }
+
+    // the fragment header is the single one with the fragment id and count after the flags
+    const uint32_t singleHeadersLength = pack.getHeadersLength();
+    const uint32_t headersLength = singleHeadersLength + Offsets::IdWhenFragmented - Offsets::IdWhenSingle;
+
+    if (packetSize <= headersLength) {
+        return fragments;
+    }
+
+    const uint32_t fragmentSize = packetSize - headersLength;
+    const uint32_t dataSize = static_cast<uint32_t>(pack.size()) - singleHeadersLength;
+    const uint32_t count = (dataSize + fragmentSize - 1) / fragmentSize;
+
+    if (count >= Packet::MaxFragments) {
+        return fragments;
+    }
+
+    auto source = static_cast<const uint8_t*>(pack.data());
+    fragments.reserve(count);
+
+    for (uint32_t id = 0; id < count; ++id) {
+        const uint32_t size = std::min(fragmentSize, dataSize - id * fragmentSize);
+
+        Packet fragment(allocate(headersLength + size));
+        auto data = static_cast<uint8_t*>(fragment.data());
+
+        data[0] = source[0] | BaseFlags::Fragmented;
+        *reinterpret_cast<uint16_t*>(data + Offsets::FragmentId) = static_cast<uint16_t>(id);
+        *reinterpret_cast<uint16_t*>(data + Offsets::FragmentsNum) = static_cast<uint16_t>(count);
+        std::copy(source + Offsets::IdWhenSingle, source + singleHeadersLength, data + Offsets::IdWhenFragmented);
+        std::copy(source + singleHeadersLength + id * fragmentSize, source + singleHeadersLength + id * fragmentSize + size, data + headersLength);
+
+        fragments.push_back(std::move(fragment));
+    }
+
+    return fragments;
+}
+
+void Message::release() {
+    if (reservedSize_) {
+        collectingSize_.fetch_sub(reservedSize_, std::memory_order_acq_rel);
+        reservedSize_ = 0;
+    }
+}
+
+// messages are collected by several threads, allocator is not thread safe to allocate
+RegionPtr Message::allocate(const uint32_t size) {
+    cs::Lock lock(allocatorLock_);
+    return allocator_.allocateNext(size);
+}
+
+Message::~Message() {
+    release();
 }
 
 class PacketFlags {
@@ -288,6 +425,11 @@ public:
             ++n;
         }
 
+        if (packet_.isCompressedMessage()) {
+            os << (n ? ", " : "") << "compressed message";
+            ++n;
+        }
+
         if (packet_.isNeighbors()) {
             os << (n ? ", " : "") << "neighbors";
             ++n;
@@ -64,6 +64,10 @@ bool PacketValidator::validate(const Message& msg) {
     if (!msg.getFirstPack().hasValidFragmentation()) {
         return false;
     }
+    if (msg.getFirstPack().isCompressedMessage()) {
+        // could not be decompressed when collected
+        return false;
+    }
     return validate(msg.getFirstPack());
 
     // require to compose full message to validate:
@@ -1,76 +1,102 @@
 /* Send blaming letters to @yrtimd */
 #include "pacmans.hpp"
 
+#include <algorithm>
+#include <cassert>
+
 IPacMan::Task& IPacMan::allocNext() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.emplace_back();
-    auto end = queue_.end();
-    Task& task = *(--end);
+    last_ = queue_.claim();
+    Task& task = *last_;
     new (&task) Task();
-    task.pack.data_ = allocator_.allocateNext(Packet::MaxSize);
+    task.pack.data_ = allocator_.allocateNext(packetSize_);
     return task;
 }
 
 void IPacMan::enQueueLast() {
-    Task& task = queue_.back();
+    Task& task = *last_;
     allocator_.shrinkLast(static_cast<uint32_t>(task.size));
-    size_.fetch_add(1, std::memory_order_acq_rel);
+    queue_.publish(last_);
+}
+
+void IPacMan::reserve(size_t count) {
+    assert(count <= MaxBatchSize);
+
+    while (reservedCount_ < count) {
+        allocNext();
+        reserved_[reservedCount_++] = last_;
+    }
+}
+
+IPacMan::Task& IPacMan::reserved(size_t index) {
+    assert(index < reservedCount_);
+    return *reserved_[index];
+}
+
+void IPacMan::enQueueReserved(size_t count) {
+    assert(count <= reservedCount_);
+
+    for (size_t i = 0; i < count; ++i) {
+        Task& task = *reserved_[i];
+
+        if (task.size != 0) {
+            RegionAllocator::truncate(task.pack.data_, static_cast<uint32_t>(task.size));
+        }
+
+        queue_.publish(reserved_[i]);
+    }
+
+    std::copy(reserved_ + count, reserved_ + reservedCount_, reserved_);
+    reservedCount_ -= count;
 }
 
 void IPacMan::rejectLast() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    Task& task = queue_.back();
+    Task& task = *last_;
     task.~Task();
-    queue_.pop_back();
+    queue_.unclaimLast(last_);
 }
 
 TaskPtr<IPacMan> IPacMan::getNextTask() {
-    while (!size_.load(std::memory_order_acquire)) {
-        std::this_thread::yield();
-    }
-    std::lock_guard<std::mutex> lock(mutex_);
     TaskPtr<IPacMan> result;
     result.owner_ = this;
-    result.it_ = queue_.begin();
+
+    while (!(result.it_ = queue_.front())) {
+        std::this_thread::yield();
+    }
+
     return result;
 }
 
 void IPacMan::releaseTask(TaskIterator& it) {
+    assert(it == queue_.front());
     Task& task = *it;
     task.~Task();
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.erase(it);
-    size_.fetch_sub(1, std::memory_order_acq_rel);
+    queue_.pop();
 }
 
 OPacMan::Task* OPacMan::allocNext() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.emplace_back();
-    auto end = queue_.end();
-    Task& task = *(--end);
+    Task& task = *queue_.claim();
     new (&task) Task();
     return &task;
 }
 
-void OPacMan::enQueueLast() {
-    size_.fetch_add(1, std::memory_order_acq_rel);
+void OPacMan::enQueue(Task* task) {
+    queue_.publish(reinterpret_cast<TaskBody<Task>*>(task));
 }
 
 TaskPtr<OPacMan> OPacMan::getNextTask() {
-    while (!size_.load(std::memory_order_acquire)) {
-        std::this_thread::yield();
-    }
-    std::lock_guard<std::mutex> lock(mutex_);
     TaskPtr<OPacMan> result;
     result.owner_ = this;
-    result.it_ = queue_.begin();
+
+    while (!(result.it_ = queue_.front())) {
+        std::this_thread::yield();
+    }
+
     return result;
 }
 
 void OPacMan::releaseTask(TaskIterator& it) {
+    assert(it == queue_.front());
     Task& task = *it;
     task.~Task();
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.erase(it);
-    size_.fetch_sub(1, std::memory_order_acq_rel);
+    queue_.pop();
 }
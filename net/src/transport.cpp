@@ -3,6 +3,7 @@
 #include <csnode/packstream.hpp>
 
 #include <lib/system/allocators.hpp>
+#include <lib/system/binarylog.hpp>
 #include <lib/system/utils.hpp>
 
 #include "network.hpp"
@@ -34,9 +35,16 @@ extern void pollSignalFlag();
 enum RegFlags : uint8_t {
     UsingIPv6 = 1,
     RedirectIP = 1 << 1,
-    RedirectPort = 1 << 2
+    RedirectPort = 1 << 2,
+    // the packet size above the default one in PacketSizeStep units, the former nodes do not read these bits
+    PacketSize = 0xf8
 };
 
+const uint32_t PacketSizeStep = 256;
+const uint8_t PacketSizeShift = 3;
+
+static_assert((Packet::MaxSize - Packet::DefaultSize) / PacketSizeStep <= (RegFlags::PacketSize >> PacketSizeShift), "Packet size does not fit the registration flags");
+
 enum Platform : uint8_t {
     Linux,
     MacOS,
@@ -85,11 +93,21 @@ void addMyOut(const Config& config, cs::OPackStream& stream, const uint8_t initF
     *flagChar |= initFlagValue | regFlag;
 }
 
+// the size is rounded down to PacketSizeStep, the default one gives no bits
+uint8_t packetSizeFlags(const uint32_t packetSize) {
+    return static_cast<uint8_t>(((packetSize - Packet::DefaultSize) / PacketSizeStep) << PacketSizeShift) & RegFlags::PacketSize;
+}
+
+uint32_t packetSizeFromFlags(const uint8_t flags) {
+    return Packet::DefaultSize + ((flags & RegFlags::PacketSize) >> PacketSizeShift) * PacketSizeStep;
+}
+
 void formRegPack(const Config& config, cs::OPackStream& stream, uint64_t** regPackConnId, const cs::PublicKey& pk, uint64_t uuid) {
     stream.init(BaseFlags::NetworkMsg);
     stream << NetworkCommand::Registration << NODE_VERSION << uuid;
 
-    addMyOut(config, stream);
+    // the size is kept in the flags, the former nodes refuse a request with more data
+    addMyOut(config, stream, packetSizeFlags(config.getPacketSize()));
     *regPackConnId = reinterpret_cast<uint64_t*>(stream.getCurrentPtr());
 
     stream << static_cast<ConnectionId>(0) << pk;
@@ -249,21 +267,58 @@ uint16_t getHashIndex(const ip::udp::endpoint& ep) {
 }
 
 RemoteNodePtr Transport::getPackSenderEntry(const ip::udp::endpoint& ep) {
-    auto& rn = remoteNodesMap_.tryStore(ep);
+    RemoteNodePtr result;
+
+    {
+        cs::Lock lock(remoteNodesLock_);
+        auto& rn = remoteNodesMap_.tryStore(ep);
 
-    if (!rn) {  // Newcomer
-        rn = remoteNodes_.emplace();
+        if (!rn) {  // Newcomer
+            rn = remoteNodes_.emplace();
+        }
+
+        result = rn;
     }
 
-    rn->packets.fetch_add(1, std::memory_order_relaxed);
-    return rn;
+    result->packets.fetch_add(1, std::memory_order_relaxed);
+    return result;
 }
 
 bool Transport::sendDirect(const Packet* pack, const Connection& conn) {
-    uint32_t nextBytesCount = static_cast<uint32_t>(conn.lastBytesCount.load(std::memory_order_relaxed) + pack->size());
+    std::vector<Packet> fragments;
+    size_t bytesCount = pack->size();
+
+    // a single packet is split for the peer which receives smaller ones, the fragments are relayed as they are received
+    if (pack->size() > conn.packetSize) {
+        fragments = Message::split(*pack, conn.packetSize);
+
+        if (fragments.empty()) {
+            cswarning() << "Net: packet of " << pack->size() << " bytes" << (pack->isFragmented() ? " (fragment)" : "") << " is larger than " << conn.packetSize
+                        << " bytes received by " << conn.getOut() << ", not sent";
+            ++Transport::cntExtraLargeNotSent;
+            return true;
+        }
+
+        bytesCount = 0;
+
+        for (const auto& fragment : fragments) {
+            bytesCount += fragment.size();
+        }
+    }
+
+    uint32_t nextBytesCount = static_cast<uint32_t>(conn.lastBytesCount.load(std::memory_order_relaxed) + bytesCount);
     if (nextBytesCount <= config_.getConnectionBandwidth()) {
-        conn.lastBytesCount.fetch_add(static_cast<uint32_t>(pack->size()), std::memory_order_relaxed);
-        net_->sendDirect(*pack, conn.getOut());
+        conn.lastBytesCount.fetch_add(static_cast<uint32_t>(bytesCount), std::memory_order_relaxed);
+
+        if (fragments.empty()) {
+            net_->sendDirect(*pack, conn.getOut());
+        }
+        else {
+            for (const auto& fragment : fragments) {
+                net_->sendDirect(fragment, conn.getOut());
+            }
+        }
+
         return true;
     }
 
@@ -295,8 +350,8 @@ void Transport::deliverBroadcast(const Packet* pack, const uint32_t size) {
 
 // Processing network packages
 
-void Transport::processNetworkTask(const TaskPtr<IPacMan>& task, RemoteNodePtr& sender) {
-    iPackStream_.init(task->pack.getMsgData(), task->pack.getMsgSize());
+void Transport::processNetworkTask(const IPacMan::Task& task, RemoteNodePtr& sender) {
+    iPackStream_.init(task.pack.getMsgData(), task.pack.getMsgSize());
 
     NetworkCommand cmd;
     iPackStream_ >> cmd;
@@ -307,7 +362,7 @@ void Transport::processNetworkTask(const TaskPtr<IPacMan>& task, RemoteNodePtr&
 
     if (cmd != NetworkCommand::Registration) {
         if (sender->isBlackListed()) {
-            csdebug() << "Network command is ignored from blacklisted " << task->sender;
+            csdebug() << "Network command is ignored from blacklisted " << task.sender;
             return;
         }
     }
@@ -406,8 +461,8 @@ void Transport::refillNeighbourhood() {
     }
 }
 
-bool Transport::parseSSSignal(const TaskPtr<IPacMan>& task) {
-    iPackStream_.init(task->pack.getMsgData(), task->pack.getMsgSize());
+bool Transport::parseSSSignal(const IPacMan::Task& task) {
+    iPackStream_.init(task.pack.getMsgData(), task.pack.getMsgSize());
     iPackStream_.safeSkip<uint8_t>(1);
     iPackStream_.safeSkip<cscrypto::PublicKey>(1);
 
@@ -559,7 +614,7 @@ void Transport::dispatchNodeMessage(const MsgTypes type, const cs::RoundNumber r
 
     // cut my packs
     if (firstPack.getSender() == node_->getNodeIdKey()) {
-        csdebug() << "TRANSPORT> Ignore own packs";
+        csdebugf("TRANSPORT> Ignore own packs");
         return;
     }
 
@@ -585,7 +640,7 @@ void Transport::dispatchNodeMessage(const MsgTypes type, const cs::RoundNumber r
 
     // cut slow packs
     if ((rNum + getRoundTimeout(type)) < cs::Conveyer::instance().currentRoundNumber()) {
-        csdebug() << "TRANSPORT> Ignore old packs, round " << rNum << ", type " << Packet::messageTypeToString(type) << ", fragments " << firstPack.getFragmentsNum();
+        csdebugf("TRANSPORT> Ignore old packs, round {}, type {}, fragments {}", rNum, Packet::messageTypeToString(type), firstPack.getFragmentsNum());
         return;
     }
 
@@ -758,6 +813,11 @@ void Transport::sendRegistrationConfirmation(const Connection& conn, const Conne
     oPackStream_.init(BaseFlags::NetworkMsg);
     oPackStream_ << NetworkCommand::RegistrationConfirmed << requestedId << conn.id << myPublicKey_;
 
+    // a larger size is negotiated only with a node which has sent its own one, so the former nodes never get it
+    if (conn.packetSize != Packet::DefaultSize) {
+        oPackStream_ << conn.packetSize;
+    }
+
     sendDirect(oPackStream_.getPackets(), conn);
     oPackStream_.clear();
 }
@@ -774,8 +834,8 @@ void Transport::sendRegistrationRefusal(const Connection& conn, const Registrati
 }
 
 // Requests processing
-bool Transport::gotRegistrationRequest(const TaskPtr<IPacMan>& task, RemoteNodePtr& sender) {
-    cslog() << "Got registration request from " << task->sender;
+bool Transport::gotRegistrationRequest(const IPacMan::Task& task, RemoteNodePtr& sender) {
+    cslog() << "Got registration request from " << task.sender;
 
     NodeVersion vers;
     uint64_t remote_uuid = 0;
@@ -786,8 +846,9 @@ bool Transport::gotRegistrationRequest(const TaskPtr<IPacMan>& task, RemoteNodeP
     }
 
     Connection conn;
-    conn.in = task->sender;
+    conn.in = task.sender;
     auto& flags = iPackStream_.peek<uint8_t>();
+    conn.packetSize = negotiatePacketSize(packetSizeFromFlags(flags));
 
     if (flags & RegFlags::RedirectIP) {
         boost::asio::ip::address addr;
@@ -807,12 +868,12 @@ bool Transport::gotRegistrationRequest(const TaskPtr<IPacMan>& task, RemoteNodeP
 
         if (!conn.specialOut) {
             conn.specialOut = true;
-            conn.out.address(task->sender.address());
+            conn.out.address(task.sender.address());
         }
         conn.out.port(port);
     }
     else if (conn.specialOut) {
-        conn.out.port(task->sender.port());
+        conn.out.port(task.sender.port());
     }
 
     if (vers != NODE_VERSION) {
@@ -842,24 +903,33 @@ bool Transport::gotRegistrationRequest(const TaskPtr<IPacMan>& task, RemoteNodeP
     return true;
 }
 
-bool Transport::gotRegistrationConfirmation(const TaskPtr<IPacMan>& task, RemoteNodePtr& sender) {
-    cslog() << "Got registration confirmation from " << task->sender;
+uint32_t Transport::negotiatePacketSize(const uint32_t remoteSize) const {
+    return std::max(static_cast<uint32_t>(Packet::DefaultSize), std::min(remoteSize, config_.getPacketSize()));
+}
+
+bool Transport::gotRegistrationConfirmation(const IPacMan::Task& task, RemoteNodePtr& sender) {
+    cslog() << "Got registration confirmation from " << task.sender;
 
     ConnectionId myCId;
     ConnectionId realCId;
     cs::PublicKey key;
     iPackStream_ >> myCId >> realCId >> key;
 
+    uint32_t packetSize = Packet::DefaultSize;
+    if (iPackStream_.good() && !iPackStream_.end()) {
+        iPackStream_ >> packetSize;
+    }
+
     if (!iPackStream_.good()) {
         return false;
     }
 
-    nh_.gotConfirmation(myCId, realCId, task->sender, key, sender);
+    nh_.gotConfirmation(myCId, realCId, task.sender, key, negotiatePacketSize(packetSize), sender);
     return true;
 }
 
-bool Transport::gotRegistrationRefusal(const TaskPtr<IPacMan>& task, RemoteNodePtr&) {
-    cslog() << "Got registration refusal from " << task->sender;
+bool Transport::gotRegistrationRefusal(const IPacMan::Task& task, RemoteNodePtr&) {
+    cslog() << "Got registration refusal from " << task.sender;
 
     RegistrationRefuseReasons reason;
     Connection::Id id;
@@ -890,22 +960,22 @@ bool Transport::gotRegistrationRefusal(const TaskPtr<IPacMan>& task, RemoteNodeP
         }
         break;
     }
-    cslog() << "Registration to " << task->sender << " refused: " << reason_info;
+    cslog() << "Registration to " << task.sender << " refused: " << reason_info;
 
     return true;
 }
 
-bool Transport::gotSSRegistration(const TaskPtr<IPacMan>& task, RemoteNodePtr& rNode) {
+bool Transport::gotSSRegistration(const IPacMan::Task& task, RemoteNodePtr& rNode) {
     if (ssStatus_ != SSBootstrapStatus::Requested) {
         cswarning() << "Unexpected Signal Server response " << static_cast<int>(ssStatus_) << " instead of Requested";
         return false;
     }
 
     cslog() << "Connection to the Signal Server has been established";
-    nh_.addSignalServer(task->sender, ssEp_, rNode);
+    nh_.addSignalServer(task.sender, ssEp_, rNode);
 
     constexpr int MinRegistrationSize = 1 + cscrypto::kPublicKeySize;
-    size_t msg_size = task->pack.getMsgSize();
+    size_t msg_size = task.pack.getMsgSize();
 
     if (msg_size > MinRegistrationSize) {
         if (!parseSSSignal(task)) {
@@ -931,7 +1001,7 @@ bool Transport::gotSSReRegistration() {
     return true;
 }
 
-bool Transport::gotSSDispatch(const TaskPtr<IPacMan>& task) {
+bool Transport::gotSSDispatch(const IPacMan::Task& task) {
     if (ssStatus_ != SSBootstrapStatus::RegisteredWait) {
         cswarning() << "Unexpected Signal Server response " << static_cast<int>(ssStatus_) << " instead of RegisteredWait";
     }
@@ -943,7 +1013,7 @@ bool Transport::gotSSDispatch(const TaskPtr<IPacMan>& task) {
     return true;
 }
 
-bool Transport::gotSSRefusal(const TaskPtr<IPacMan>&) {
+bool Transport::gotSSRefusal(const IPacMan::Task&) {
     uint16_t expectedVersion;
     RegistrationRefuseReasons reason;
     iPackStream_ >> expectedVersion >> reason;
@@ -968,15 +1038,15 @@ bool Transport::gotSSRefusal(const TaskPtr<IPacMan>&) {
     return true;
 }
 
-bool Transport::gotSSPingWhiteNode(const TaskPtr<IPacMan>& task) {
+bool Transport::gotSSPingWhiteNode(const IPacMan::Task& task) {
     Connection conn;
-    conn.in = task->sender;
+    conn.in = task.sender;
     conn.specialOut = false;
-    sendDirect(&task->pack, conn);
+    sendDirect(&task.pack, conn);
     return true;
 }
 
-bool Transport::gotSSLastBlock(const TaskPtr<IPacMan>& task, cs::Sequence lastBlock, const csdb::PoolHash& lastHash, bool canBeTrusted) {
+bool Transport::gotSSLastBlock(const IPacMan::Task& task, cs::Sequence lastBlock, const csdb::PoolHash& lastHash, bool canBeTrusted) {
 #if !defined(MONITOR_NODE) && !defined(WEB_WALLET_NODE)
     csdebug() << "TRANSPORT> Got SS Last Block: " << lastBlock;
     csunused(task);
@@ -1045,7 +1115,7 @@ void Transport::sendPackInform(const Packet& pack, const Connection& addr) {
     oPackStream_.clear();
 }
 
-bool Transport::gotPackInform(const TaskPtr<IPacMan>&, RemoteNodePtr& sender) {
+bool Transport::gotPackInform(const IPacMan::Task&, RemoteNodePtr& sender) {
     uint8_t isDirect;
     cs::Hash hHash;
     iPackStream_ >> isDirect >> hHash;
@@ -1068,7 +1138,7 @@ void Transport::sendPackRenounce(const cs::Hash& hash, const Connection& addr) {
     oPackStream_.clear();
 }
 
-bool Transport::gotPackRenounce(const TaskPtr<IPacMan>&, RemoteNodePtr& sender) {
+bool Transport::gotPackRenounce(const IPacMan::Task&, RemoteNodePtr& sender) {
     cs::Hash hHash;
 
     iPackStream_ >> hHash;
@@ -1104,17 +1174,16 @@ void Transport::askForMissingPackages() {
 
         {
             cs::Lock messageLock(msg->pLock_);
-            const auto end = msg->packets_ + msg->packetsTotal_;
 
             uint16_t start = 0;
             uint64_t mask = 0;
             uint64_t req = 0;
 
-            for (auto s = msg->packets_; s != end; ++s) {
-                if (!*s) {
+            for (uint32_t id = 0; id < msg->getFragmentsTotal(); ++id) {
+                if (!msg->hasFragment(id)) {
                     if (!mask) {
                         mask = 1;
-                        start = cs::numeric_cast<uint16_t>(s - msg->packets_);
+                        start = cs::numeric_cast<uint16_t>(id);
                     }
                     req |= mask;
                 }
@@ -1122,11 +1191,8 @@ void Transport::askForMissingPackages() {
                 if (mask == maxMask) {
                     requestMissing(msg->headerHash_, start, req);
 
-                    if (s > (msg->packets_ + msg->maxFragment_) && (end - s) > 128) {
-                        break;
-                    }
-
                     mask = 0;
+                    req = 0;
                 }
                 else {
                     mask <<= 1;
@@ -1160,17 +1226,10 @@ void Transport::requestMissing(const cs::Hash& hash, const uint16_t start, const
 
 void Transport::registerMessage(MessagePtr msg) {
     cs::Lock lock(uLock_);
-    auto& ptr = uncollected_.emplace(msg);
-    //DEBUG:
-    Message& message = *ptr.get();
-    size_t cnt = message.clearUnused();
-    if (cnt > 0) {
-        csdebug() << "Net: potential heap corruption detected in uncollected message fragments (" << cnt << ")";
-        Transport::cntDirtyAllocs += cnt;
-    }
+    uncollected_.emplace(msg);
 }
 
-bool Transport::gotPackRequest(const TaskPtr<IPacMan>&, RemoteNodePtr& sender) {
+bool Transport::gotPackRequest(const IPacMan::Task&, RemoteNodePtr& sender) {
     ConnectionPtr conn = nh_.getConnection(sender);
     if (!conn) {
         return false;
@@ -1220,7 +1279,7 @@ void Transport::sendPingPack(const Connection& conn) {
     oPackStream_.clear();
 }
 
-bool Transport::gotPing(const TaskPtr<IPacMan>& task, RemoteNodePtr& sender) {
+bool Transport::gotPing(const IPacMan::Task& task, RemoteNodePtr& sender) {
     Connection::Id id = 0u;
     cs::Sequence lastSeq = 0u;
 
@@ -1249,7 +1308,7 @@ bool Transport::gotPing(const TaskPtr<IPacMan>& task, RemoteNodePtr& sender) {
         maxBlockCount_ = 1;
     }
 
-    if (nh_.validateConnectionId(sender, id, task->sender, pk, lastSeq)) {
+    if (nh_.validateConnectionId(sender, id, task.sender, pk, lastSeq)) {
         emit pingReceived(lastSeq, pk);
     }
 
@@ -275,6 +275,12 @@ public slots:
     // called when next block is read from database
     void on_read_block(const csdb::Pool& block, bool* should_stop);
 
+    // called when state snapshot is made
+    void on_save_state(cs::StateSnapshot& snapshot);
+
+    // called on start instead of reading blocks included into state snapshot
+    void on_load_state(const cs::StateSnapshot& snapshot, bool* failed);
+
 private:
     using trx_innerid_t = int64_t;  // see csdb/transaction.hpp near #101
 
@@ -237,6 +237,11 @@ public:
         return core.private_key;
     }
 
+    // validation iterations are switched on by config, the same at all the trusted nodes
+    bool validation_iterations() const {
+        return core.opt_validation_iterations;
+    }
+
     std::string sender_description(const cs::PublicKey& sender_id);
 
     csdb::PoolHash spoileHash(const csdb::PoolHash& hashToSpoil, const cs::PublicKey& pKey);
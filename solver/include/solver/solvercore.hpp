@@ -66,6 +66,7 @@ public:
     // below are the "required" methods to be implemented by Solver-compatibility issue:
 
     void setKeysPair(const cs::PublicKey& pub, const cs::PrivateKey& priv);
+    void setValidationIterations(bool enabled);
     void gotConveyerSync(cs::RoundNumber rNum);
     void gotHash(csdb::PoolHash&& hash, const cs::PublicKey& sender);
 
@@ -167,6 +168,9 @@ private:
     /** @brief The option mode */
     Mode opt_mode;
 
+    /** @brief   True to validate again the transactions affected by the rejected ones, set by config */
+    bool opt_validation_iterations;
+
     // inner data
 
     std::unique_ptr<SolverContext> pcontext;
@@ -6,6 +6,7 @@
 #include <cscrypto/cryptoconstants.hpp>
 #include <csdb/currency.hpp>
 #include <csnode/datastream.hpp>
+#include <csnode/statesnapshot.hpp>
 #include <lib/system/logger.hpp>
 
 #include <functional>
@@ -15,6 +16,15 @@
 
 namespace {
 const char* kLogPrefix = "Smart: ";
+const char* kSnapshotSection = "smart_contracts";
+
+void writeRef(cs::DataStream& stream, const cs::SmartContractRef& ref) {
+    stream << ref.hash << ref.sequence << ref.transaction;
+}
+
+void readRef(cs::DataStream& stream, cs::SmartContractRef& ref) {
+    stream >> ref.hash >> ref.sequence >> ref.transaction;
+}
 
 inline void print(std::ostream& os, const ::general::Variant& var) {
     os << "Variant(";
@@ -116,6 +126,8 @@ SmartContracts::SmartContracts(BlockChain& blockchain, CallsQueueScheduler& call
     // as event receiver:
     cs::Connector::connect(&bc.storeBlockEvent, this, &SmartContracts::on_store_block);
     cs::Connector::connect(&bc.readBlockEvent(), this, &SmartContracts::on_read_block);
+    cs::Connector::connect(&bc.saveStateEvent, this, &SmartContracts::on_save_state);
+    cs::Connector::connect(&bc.loadStateEvent, this, &SmartContracts::on_load_state);
     // as event source:
     cs::Connector::connect(&signal_payable_invoke, &bc, &BlockChain::onPayableContractReplenish);
     cs::Connector::connect(&signal_payable_timeout, &bc, &BlockChain::onPayableContractTimeout);
@@ -857,6 +869,103 @@ void SmartContracts::on_read_block(const csdb::Pool& block, bool* /*should_stop*
     //*should_stop = false;
 }
 
+void SmartContracts::on_save_state(cs::StateSnapshot& snapshot) {
+    cs::Lock lock(public_access_lock);
+
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+
+    // all known contracts and used ones are stored by absolute address
+    stream << known_contracts.size();
+
+    for (const auto& [abs_addr, item] : known_contracts) {
+        stream << abs_addr.public_key() << static_cast<int>(item.payable);
+        writeRef(stream, item.ref_deploy);
+        writeRef(stream, item.ref_execute);
+        stream << item.state << item.uses.size();
+
+        for (const auto& [method, calls] : item.uses) {
+            stream << method << calls.size();
+
+            for (const auto& [addr, call] : calls) {
+                stream << addr.public_key() << call;
+            }
+        }
+    }
+
+    stream << replenish_contract.size();
+
+    for (const auto& ref : replenish_contract) {
+        writeRef(stream, ref);
+    }
+
+    snapshot.setSection(kSnapshotSection, std::move(bytes));
+}
+
+void SmartContracts::on_load_state(const cs::StateSnapshot& snapshot, bool* failed) {
+    const cs::Bytes* data = snapshot.section(kSnapshotSection);
+
+    if (data == nullptr) {
+        cserror() << kLogPrefix << "state snapshot does not contain contracts";
+        *failed = true;
+        return;
+    }
+
+    cs::DataStream stream(data->data(), data->size());
+
+    std::map<csdb::Address, StateItem> contracts;
+    size_t count = 0;
+    stream >> count;
+
+    for (size_t i = 0; i < count && stream.isValid(); ++i) {
+        cs::PublicKey key;
+        int payable = 0;
+        StateItem item;
+        stream >> key >> payable;
+        readRef(stream, item.ref_deploy);
+        readRef(stream, item.ref_execute);
+        item.payable = static_cast<PayableStatus>(payable);
+
+        size_t methods = 0;
+        stream >> item.state >> methods;
+
+        for (size_t j = 0; j < methods && stream.isValid(); ++j) {
+            std::string method;
+            size_t calls = 0;
+            stream >> method >> calls;
+            auto& uses = item.uses[method];
+
+            for (size_t k = 0; k < calls && stream.isValid(); ++k) {
+                cs::PublicKey addr;
+                std::string call;
+                stream >> addr >> call;
+                uses[csdb::Address::from_public_key(addr)] = call;
+            }
+        }
+
+        contracts.emplace(csdb::Address::from_public_key(key), std::move(item));
+    }
+
+    std::vector<SmartContractRef> replenish;
+    size_t replenish_count = 0;
+    stream >> replenish_count;
+
+    for (size_t i = 0; i < replenish_count && stream.isValid(); ++i) {
+        readRef(stream, replenish.emplace_back());
+    }
+
+    if (!stream.isValid()) {
+        cserror() << kLogPrefix << "state snapshot contains corrupted contracts";
+        *failed = true;
+        return;
+    }
+
+    cs::Lock lock(public_access_lock);
+    known_contracts = std::move(contracts);
+    replenish_contract = std::move(replenish);
+    csdebug() << kLogPrefix << known_contracts.size() << " contracts are restored from state snapshot";
+}
+
 // tests max fee amount and round-based timeout on executed smart contracts;
 // invoked on every new block ready
 void SmartContracts::test_exe_conditions(const csdb::Pool& block) {
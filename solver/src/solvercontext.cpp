@@ -201,18 +201,9 @@ void SolverContext::request_stage3(uint8_t from, uint8_t required) {
 }
 
 bool SolverContext::transaction_still_in_pool(int64_t inner_id) const {
-    auto lock = cs::Conveyer::instance().lock();
-    const auto& block = cs::Conveyer::instance().packetQueue();
-
-    for (const auto& packet : block) {
-        for (const auto& tr : packet.transactions()) {
-            if (tr.innerID() == inner_id) {
-                return true;
-            }
-        }
-    }
-
-    return false;
+    auto& conveyer = cs::Conveyer::instance();
+    auto lock = conveyer.lock();
+    return conveyer.lockedPacketQueue(lock).containsInnerId(inner_id);
 }
 
 void SolverContext::request_round_info(uint8_t respondent1, uint8_t respondent2) {
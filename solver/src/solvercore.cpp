@@ -53,6 +53,7 @@ SolverCore::SolverCore()
 : opt_timeouts_enabled(TimeoutsEnabled)
 , opt_repeat_state_enabled(RepeatStateEnabled)
 , opt_mode(Mode::Default)
+, opt_validation_iterations(false)
 // inner data
 , pcontext(std::make_unique<SolverContext>(*this))
 , tag_state_expired(CallsQueueScheduler::no_tag)
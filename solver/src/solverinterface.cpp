@@ -27,6 +27,10 @@ void SolverCore::setKeysPair(const cs::PublicKey& pub, const cs::PrivateKey& pri
     }
 }
 
+void SolverCore::setValidationIterations(bool enabled) {
+    opt_validation_iterations = enabled;
+}
+
 void SolverCore::gotConveyerSync(cs::RoundNumber rNum) {
     // clear data
     markUntrusted.fill(0);
@@ -427,7 +431,8 @@ void SolverCore::gotRoundInfoReply(bool next_round_started, const cs::PublicKey&
 }
 
 bool SolverCore::isContractLocked(const csdb::Address& address) const {
-    return psmarts->is_contract_locked(address);
+    // solver without contracts support (e.g. in benchmarks) has no contracts locked
+    return psmarts != nullptr && psmarts->is_contract_locked(address);
 }
 
 }  // namespace cs
@@ -95,17 +95,19 @@ Result TrustedStage1State::onSyncTransactions(SolverContext& context, cs::RoundN
         std::unique_lock<cs::SharedMutex> lock = conveyer.lock();
         const cs::RoundTable& roundTable = conveyer.currentRoundTable();
 
-        for (const auto& element : conveyer.transactionsPacketTable()) {
-            const cs::PacketsHashes& hashes = roundTable.hashes;
+        const cs::PacketsHashes& hashes = roundTable.hashes;
+        cs::PacketsHashes candidates;
 
+        for (const auto& element : conveyer.transactionsPacketTable()) {
             if (std::find(hashes.cbegin(), hashes.cend(), element.first) == hashes.cend()) {
-                stage.hashesCandidates.push_back(element.first);
-
-                if (stage.hashesCandidates.size() > Consensus::MaxStageOneHashes) {
-                    break;
-                }
+                candidates.push_back(element.first);
             }
         }
+
+        // the table is not ordered, so all trusted nodes take the same lowest hashes
+        const size_t count = std::min(candidates.size(), Consensus::MaxStageOneHashes + 1);
+        std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(count), candidates.end());
+        stage.hashesCandidates.insert(stage.hashesCandidates.end(), candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(count));
     }
 
     transactions_checked = true;
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "blocksreplycache.hpp"
+
+namespace {
+cs::BlocksReplyCache::FramePtr makeFrame(std::size_t size) {
+    auto frame = std::make_shared<cs::BlocksReplyCache::Frame>();
+    frame->data.resize(size);
+    return frame;
+}
+}  // namespace
+
+TEST(BlocksReplyCache, FindsInsertedReply) {
+    cs::BlocksReplyCache cache(100);
+    const auto frame = makeFrame(10);
+
+    cache.insert({1, 2, 3}, frame);
+
+    ASSERT_EQ(cache.find({1, 2, 3}), frame);
+    ASSERT_EQ(cache.find({1, 2}), nullptr);
+    ASSERT_EQ(cache.hits(), 1);
+    ASSERT_EQ(cache.misses(), 1);
+}
+
+TEST(BlocksReplyCache, EvictsLeastRecentlyUsed) {
+    cs::BlocksReplyCache cache(100);
+
+    cache.insert({1}, makeFrame(40));
+    cache.insert({2}, makeFrame(40));
+    ASSERT_NE(cache.find({1}), nullptr);
+
+    cache.insert({3}, makeFrame(40));
+
+    ASSERT_NE(cache.find({1}), nullptr);
+    ASSERT_EQ(cache.find({2}), nullptr);
+    ASSERT_NE(cache.find({3}), nullptr);
+}
+
+TEST(BlocksReplyCache, DoesNotStoreTooLargeReply) {
+    cs::BlocksReplyCache cache(100);
+    cache.insert({1}, makeFrame(101));
+    ASSERT_EQ(cache.find({1}), nullptr);
+}
+
+TEST(BlocksReplyCache, RemovesRepliesWithRemovedBlocks) {
+    cs::BlocksReplyCache cache(100);
+
+    cache.insert({1, 2}, makeFrame(10));
+    cache.insert({3, 4}, makeFrame(10));
+    cache.removeFrom(4);
+
+    ASSERT_NE(cache.find({1, 2}), nullptr);
+    ASSERT_EQ(cache.find({3, 4}), nullptr);
+}
@@ -2,7 +2,10 @@
 #include <csdb/amount_commission.hpp>
 #include <csdb/currency.hpp>
 #include <csnode/conveyer.hpp>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 #include <lib/system/hash.hpp>
 
@@ -157,11 +160,17 @@ TEST(Conveyer, AddTransaction) {
     ConveyerTest conveyer{};
     auto transaction{CreateTestTransaction(3, 1)};
     conveyer.addTransaction(transaction);
-    auto& transactions_block = conveyer.packetQueue();
-    ASSERT_EQ(1, conveyer.packetQueue().size());
+    {
+        auto lock = conveyer.lock();
+        ASSERT_EQ(1, conveyer.lockedPacketQueue(lock).size());
+    }
+    conveyer.flushTransactions();
+    auto& table = conveyer.transactionsPacketTable();
+    ASSERT_EQ(1, table.size());
     auto packet{cs::TransactionsPacket{}};
     packet.addTransaction(transaction);
-    ASSERT_EQ(packet.toBinary(), transactions_block.back().toBinary());
+    ASSERT_EQ(packet.toBinary(cs::TransactionsPacket::Serialization::Transactions),
+              table.begin()->second.toBinary(cs::TransactionsPacket::Serialization::Transactions));
 }
 
 TEST(Conveyer, TransactionPacketTableIsEmptyAtCreation) {
@@ -186,10 +195,22 @@ TEST(Conveyer, CanAddTransactionToLastBlock) {
     auto transaction1 = CreateTestTransaction(1, 1), transaction2 = CreateTestTransaction(2, 1);
     conveyer.addTransaction(transaction1);
     conveyer.addTransaction(transaction2);
+    // added transactions are staged until the queue is requested under lock
+    ASSERT_TRUE(table.isEmpty());
+    {
+        auto lock = conveyer.lock();
+        conveyer.lockedPacketQueue(lock);
+    }
     ASSERT_EQ(1, table.size());
-    ASSERT_EQ(2, table.back().transactionsCount());
-    ASSERT_EQ(transaction1, table.back().transactions().at(0));
-    ASSERT_EQ(transaction2, table.back().transactions().at(1));
+    ASSERT_EQ(2, table.transactionsCount());
+    conveyer.flushTransactions();
+    ASSERT_TRUE(table.isEmpty());
+    auto& packets = conveyer.transactionsPacketTable();
+    ASSERT_EQ(1, packets.size());
+    const auto& packet = packets.begin()->second;
+    ASSERT_EQ(2, packet.transactionsCount());
+    ASSERT_EQ(transaction1, packet.transactions().at(0));
+    ASSERT_EQ(transaction2, packet.transactions().at(1));
 }
 
 TEST(Conveyer, MainLogic) {
@@ -239,3 +260,106 @@ TEST(Conveyer, MainLogic) {
     ASSERT_EQ(packet.transactions().at(9), pool.value().transaction(1));
     ASSERT_EQ(packet.transactions().at(16), pool.value().transaction(2));
 }
+
+TEST(Conveyer, AppliedPacketsMoveToRoundStorage) {
+    auto packet = CreateTestPacket(4);
+    ConveyerTest conveyer{};
+    conveyer.addTransactionsPacket(packet);
+    conveyer.setTable(CreateTestRoundTable({packet.hash(), packet.hash()}));
+    conveyer.setCharacteristic(cs::Characteristic{{1, 0, 1, 1, 1, 0, 1, 1}}, kRoundNumber);
+
+    cs::PublicKey pk;
+    pk.fill(0);
+
+    cs::PoolMetaInfo pool_meta_info{"1542617459297", pk, csdb::PoolHash{}, kRoundNumber, cs::Bytes{}, std::vector<csdb::Pool::SmartSignature>{}};
+    auto pool{conveyer.applyCharacteristic(pool_meta_info)};
+
+    ASSERT_TRUE(pool.has_value());
+    ASSERT_EQ(6, pool.value().transactions_count());
+    ASSERT_EQ(packet.transactions().at(2), pool.value().transaction(1));
+    ASSERT_EQ(packet.transactions().at(3), pool.value().transaction(5));
+    ASSERT_TRUE(conveyer.transactionsPacketTable().empty());
+
+    auto packets = conveyer.findPackets({packet.hash()}, kRoundNumber);
+    ASSERT_EQ(1, packets.size());
+    ASSERT_EQ(packet.toBinary(), packets.front().toBinary());
+}
+
+TEST(Conveyer, FindPacketsSkipsUnknownHashes) {
+    ConveyerTest conveyer{};
+    auto packet = CreateTestPacket(3);
+    conveyer.addTransactionsPacket(packet);
+
+    auto packets = conveyer.findPackets({CreateTestPacket(5).hash(), packet.hash()}, kRoundNumber);
+    ASSERT_EQ(1, packets.size());
+    ASSERT_EQ(packet.hash(), packets.front().hash());
+}
+
+// intake from several threads while the conveyer is flushed and its packet table is searched
+TEST(Conveyer, ConcurrentIntakeKeepsAllTransactions) {
+    constexpr size_t kThreads = 8;
+    constexpr size_t kTransactionsPerThread = 5000;
+
+    ConveyerTest conveyer{};
+    auto packet = CreateTestPacket(2);
+    conveyer.addTransactionsPacket(packet);
+
+    std::vector<std::vector<csdb::Transaction>> transactions(kThreads);
+
+    for (size_t i = 0; i < kThreads; ++i) {
+        for (size_t j = 0; j < kTransactionsPerThread; ++j) {
+            transactions[i].push_back(CreateTestTransaction(static_cast<int64_t>(i * kTransactionsPerThread + j + 1), 1));
+        }
+    }
+
+    std::atomic<bool> done = false;
+    std::atomic<size_t> lookups = 0;
+
+    std::thread flusher([&] {
+        while (!done) {
+            conveyer.flushTransactions();
+            std::this_thread::yield();
+        }
+    });
+
+    std::thread reader([&] {
+        while (!done) {
+            lookups += conveyer.findPackets({packet.hash()}, kRoundNumber).size();
+        }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> writers;
+
+    for (size_t i = 0; i < kThreads; ++i) {
+        writers.emplace_back([&, i] {
+            for (const auto& transaction : transactions[i]) {
+                conveyer.addTransaction(transaction);
+            }
+        });
+    }
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    done = true;
+    flusher.join();
+    reader.join();
+
+    // flush sends limited count of packets per round, the rest stays in the queue
+    size_t count = conveyer.packetQueueTransactionsCount();
+
+    for (const auto& element : conveyer.transactionsPacketTable()) {
+        if (element.first != packet.hash()) {
+            count += element.second.transactionsCount();
+        }
+    }
+
+    std::cout << "intake of " << kThreads * kTransactionsPerThread << " transactions by " << kThreads << " threads: " << elapsed * 1000 << " ms, " << lookups
+              << " concurrent packet lookups" << std::endl;
+
+    ASSERT_EQ(kThreads * kTransactionsPerThread, count);
+}
@@ -0,0 +1,349 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <net/messagecompression.hpp>
+#include <net/packet.hpp>
+#include "packstream.hpp"
+
+namespace {
+const cs::PublicKey kSenderKey = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+                                  0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20};
+
+const size_t kMessageSize = 5000;
+
+std::vector<cs::Byte> makeData(const size_t size = kMessageSize) {
+    std::vector<cs::Byte> data(size);
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<cs::Byte>(i * 7 + 3);
+    }
+
+    return data;
+}
+
+// a half of every 64 bytes is random
+std::vector<cs::Byte> makePartlyRandomData(const size_t size) {
+    std::vector<cs::Byte> data(size);
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+
+    for (size_t i = 0; i < size; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        data[i] = (i % 64 < 32) ? static_cast<cs::Byte>(state) : static_cast<cs::Byte>(i / 64);
+    }
+
+    return data;
+}
+
+bool equal(const Packet& lhs, const Packet& rhs) {
+    return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+}  // namespace
+
+TEST(PacketCollector, ComposesMessageFromFragmentsInAnyOrder) {
+    RegionAllocator allocator(1 << 20, 1);
+    cs::OPackStream stream(&allocator, kSenderKey);
+
+    const auto data = makeData();
+    stream.init(BaseFlags::Broadcast | BaseFlags::Fragmented);
+    stream << MsgTypes::Transactions;
+    stream << cs::BytesView(data.data(), data.size());
+
+    Packet* fragments = stream.getPackets();
+    const uint32_t count = stream.getPacketsCount();
+    ASSERT_GT(count, 1u);
+
+    std::vector<uint32_t> order;
+    for (uint32_t i = count; i > 0; --i) {
+        order.push_back(i - 1);
+    }
+    order.insert(order.begin() + 1, order.front());  // duplicated fragment
+
+    PacketCollector collector;
+    MessagePtr msg;
+    uint32_t completedCount = 0;
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        bool newMessage = false;
+        bool completed = false;
+
+        msg = collector.getMessage(fragments[order[i]], newMessage, completed);
+        ASSERT_TRUE(msg);
+
+        EXPECT_EQ(newMessage, i == 0);
+        completedCount += completed;
+    }
+
+    ASSERT_TRUE(msg->isComplete());
+    EXPECT_EQ(completedCount, 1u);
+    EXPECT_EQ(msg->getFirstPack().getFragmentId(), 0);
+    EXPECT_EQ(msg->getFirstPack().getType(), MsgTypes::Transactions);
+
+    size_t size = 0;
+    std::memcpy(&size, msg->getFullData() + 1, sizeof(size));
+    ASSERT_EQ(size, data.size());
+    ASSERT_EQ(msg->getFullSize(), 1 + sizeof(size) + data.size());
+    EXPECT_EQ(std::memcmp(msg->getFullData() + 1 + sizeof(size), data.data(), data.size()), 0);
+
+    for (uint16_t i = 0; i < count; ++i) {
+        EXPECT_TRUE(equal(msg->getFragment(i), fragments[i]));
+    }
+}
+
+TEST(PacketCollector, RestoresOnlyReceivedFragments) {
+    RegionAllocator allocator(1 << 20, 1);
+    cs::OPackStream stream(&allocator, kSenderKey);
+
+    const auto data = makeData();
+    stream.init(BaseFlags::Broadcast | BaseFlags::Fragmented);
+    stream << MsgTypes::Transactions;
+    stream << cs::BytesView(data.data(), data.size());
+
+    Packet* fragments = stream.getPackets();
+    const uint32_t count = stream.getPacketsCount();
+    ASSERT_GT(count, 2u);
+
+    PacketCollector collector;
+    bool newMessage = false;
+    bool completed = false;
+
+    collector.getMessage(fragments[count - 1], newMessage, completed);
+    auto msg = collector.getMessage(fragments[1], newMessage, completed);
+
+    ASSERT_TRUE(msg);
+    EXPECT_FALSE(msg->isComplete());
+    EXPECT_FALSE(completed);
+
+    EXPECT_TRUE(msg->hasFragment(1));
+    EXPECT_TRUE(msg->hasFragment(count - 1));
+    EXPECT_FALSE(msg->hasFragment(0));
+
+    EXPECT_TRUE(equal(msg->getFragment(1), fragments[1]));
+    EXPECT_TRUE(equal(msg->getFragment(static_cast<uint16_t>(count - 1)), fragments[count - 1]));
+    EXPECT_FALSE(msg->getFragment(0));
+}
+
+TEST(PacketCollector, ComposesMessageOfNegotiatedPacketSize) {
+    RegionAllocator allocator(1 << 20, 1);
+    cs::OPackStream stream(&allocator, kSenderKey);
+    stream.setPacketSize(Packet::MaxSize);
+
+    const auto data = makeData(20000);
+    stream.init(BaseFlags::Broadcast | BaseFlags::Fragmented);
+    stream << MsgTypes::Transactions;
+    stream << cs::BytesView(data.data(), data.size());
+
+    Packet* fragments = stream.getPackets();
+    ASSERT_EQ(stream.getPacketsCount(), 3u);
+    EXPECT_EQ(fragments[0].size(), static_cast<size_t>(Packet::MaxSize));
+
+    PacketCollector collector;
+    MessagePtr msg;
+    bool newMessage = false;
+    bool completed = false;
+
+    for (const auto id : {1, 0, 2}) {
+        msg = collector.getMessage(fragments[id], newMessage, completed);
+        ASSERT_TRUE(msg);
+    }
+
+    ASSERT_TRUE(completed);
+    ASSERT_EQ(msg->getFullSize(), 1 + sizeof(size_t) + data.size());
+    EXPECT_EQ(std::memcmp(msg->getFullData() + 1 + sizeof(size_t), data.data(), data.size()), 0);
+}
+
+TEST(PacketCollector, ComposesSinglePacketSplitForSmallerPeer) {
+    RegionAllocator allocator(1 << 20, 1);
+    cs::OPackStream stream(&allocator, kSenderKey);
+    stream.setPacketSize(Packet::MaxSize);
+
+    const auto data = makeData(3000);
+    stream.init(BaseFlags::Broadcast);
+    stream << MsgTypes::Transactions;
+    stream << cs::BytesView(data.data(), data.size());
+
+    ASSERT_EQ(stream.getPacketsCount(), 1u);
+    const Packet& single = *stream.getPackets();
+    ASSERT_FALSE(single.isFragmented());
+
+    const auto fragments = Message::split(single, Packet::DefaultSize);
+    ASSERT_EQ(fragments.size(), 4u);
+
+    PacketCollector collector;
+    MessagePtr msg;
+    bool newMessage = false;
+    bool completed = false;
+
+    for (size_t i = fragments.size(); i > 0; --i) {
+        const auto& fragment = fragments[i - 1];
+        EXPECT_LE(fragment.size(), static_cast<size_t>(Packet::DefaultSize));
+        EXPECT_TRUE(fragment.isHeaderValid());
+        EXPECT_TRUE(fragment.getSender() == kSenderKey);
+        EXPECT_EQ(fragment.getId(), single.getId());
+
+        msg = collector.getMessage(fragment, newMessage, completed);
+        ASSERT_TRUE(msg);
+    }
+
+    ASSERT_TRUE(completed);
+    EXPECT_EQ(msg->getFirstPack().getType(), MsgTypes::Transactions);
+    ASSERT_EQ(msg->getFullSize(), single.getMsgSize());
+    EXPECT_EQ(std::memcmp(msg->getFullData(), single.getMsgData(), single.getMsgSize()), 0);
+
+    // fragments are relayed as they are
+    EXPECT_TRUE(Message::split(fragments[0], Packet::DefaultSize / 2).empty());
+}
+
+TEST(PacketCollector, DecompressesMessageOnceCollected) {
+    RegionAllocator allocator(1 << 20, 1);
+    cs::OPackStream stream(&allocator, kSenderKey);
+    stream.setMessageCompression(true);
+
+    const auto data = makePartlyRandomData(20000);
+    const cs::RoundNumber round = 42;
+
+    stream.init(BaseFlags::Broadcast | BaseFlags::Fragmented | BaseFlags::Compressed);
+    stream << MsgTypes::Transactions << round;
+    stream << cs::BytesView(data.data(), data.size());
+
+    Packet* fragments = stream.getPackets();
+    const uint32_t count = stream.getPacketsCount();
+
+    ASSERT_GT(count, 1u);
+    ASSERT_LT(count, 20u);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        EXPECT_TRUE(fragments[i].isCompressedMessage());
+        EXPECT_FALSE(fragments[i].isCompressed());
+        EXPECT_EQ(fragments[i].getFragmentsNum(), count);
+    }
+
+    // relaying nodes read them from the first fragment
+    EXPECT_EQ(fragments[0].getType(), MsgTypes::Transactions);
+    EXPECT_EQ(fragments[0].getRoundNum(), round);
+
+    PacketCollector collector;
+    MessagePtr msg;
+    bool newMessage = false;
+    bool completed = false;
+
+    for (uint32_t i = count; i > 0; --i) {
+        msg = collector.getMessage(fragments[i - 1], newMessage, completed);
+        ASSERT_TRUE(msg);
+    }
+
+    ASSERT_TRUE(completed);
+    EXPECT_FALSE(msg->getFirstPack().isCompressedMessage());
+    EXPECT_EQ(msg->getFirstPack().getRoundNum(), round);
+
+    const size_t prefixSize = sizeof(MsgTypes) + sizeof(round) + sizeof(size_t);
+    ASSERT_EQ(msg->getFullSize(), prefixSize + data.size());
+    EXPECT_EQ(std::memcmp(msg->getFullData() + prefixSize, data.data(), data.size()), 0);
+
+    // fragments are resent as they were received
+    for (uint16_t i = 0; i < count; ++i) {
+        EXPECT_TRUE(equal(msg->getFragment(i), fragments[i]));
+    }
+}
+
+TEST(PacketCollector, DecompressesSinglePacketMessage) {
+    // the last packet is shrunk in its allocator
+    RegionAllocator plainAllocator(1 << 20, 1);
+    RegionAllocator allocator(1 << 20, 1);
+    cs::OPackStream plainStream(&plainAllocator, kSenderKey);
+    cs::OPackStream stream(&allocator, kSenderKey);
+
+    plainStream.setPacketSize(Packet::MaxSize);
+    stream.setPacketSize(Packet::MaxSize);
+    stream.setMessageCompression(true);
+
+    const auto data = makeData(4000);
+
+    for (auto s : {&plainStream, &stream}) {
+        s->init(BaseFlags::Broadcast);
+        *s << MsgTypes::NewCharacteristic << static_cast<cs::RoundNumber>(7);
+        *s << cs::BytesView(data.data(), data.size());
+    }
+
+    Packet* plain = plainStream.getPackets();
+    Packet* packet = stream.getPackets();
+
+    ASSERT_EQ(stream.getPacketsCount(), 1u);
+    ASSERT_TRUE(packet->isCompressedMessage());
+    EXPECT_LT(packet->size(), plain->size());
+
+    Packet decompressed = cs::MessageCompression::instance().decompress(*packet);
+
+    ASSERT_TRUE(decompressed);
+    EXPECT_TRUE(equal(decompressed, *plain));
+}
+
+TEST(PacketCollector, LeavesSmallAndIncompressibleMessagesAsIs) {
+    RegionAllocator allocator(1 << 20, 1);
+    cs::OPackStream stream(&allocator, kSenderKey);
+    stream.setMessageCompression(true);
+
+    std::vector<cs::Byte> random(3000);
+    uint32_t state = 1;
+    for (auto& byte : random) {
+        state = state * 1103515245 + 12345;
+        byte = static_cast<cs::Byte>(state >> 16);
+    }
+
+    for (const auto& data : {makeData(100), random}) {
+        stream.init(BaseFlags::Broadcast | BaseFlags::Compressed);
+        stream << MsgTypes::Transactions << static_cast<cs::RoundNumber>(1);
+        stream << cs::BytesView(data.data(), data.size());
+
+        Packet* packets = stream.getPackets();
+        EXPECT_FALSE(packets->isCompressedMessage());
+        EXPECT_TRUE(packets->isCompressed());
+    }
+}
+
+TEST(MessageCompression, UsesSharedDictionary) {
+    auto& compression = cs::MessageCompression::instance();
+
+    // transactions of the same layout differ in a few bytes
+    const auto dictionary = makePartlyRandomData(4096);
+    auto data = std::vector<cs::Byte>(dictionary.begin() + 1024, dictionary.begin() + 1536);
+    data[100] ^= 0xff;
+
+    cs::Bytes withoutDictionary;
+    const bool compressedWithout = compression.compress(MsgTypes::TransactionPacket, data.data(), data.size(), withoutDictionary);
+
+    compression.setDictionary(dictionary);
+    EXPECT_NE(compression.getDictionaryId(), 0u);
+
+    cs::Bytes withDictionary;
+    ASSERT_TRUE(compression.compress(MsgTypes::TransactionPacket, data.data(), data.size(), withDictionary));
+
+    if (compressedWithout) {
+        EXPECT_LT(withDictionary.size(), withoutDictionary.size());
+    }
+
+    // packet of the empty header for a neighbour, type and round
+    RegionAllocator allocator(1 << 20, 1);
+    const size_t headersLength = 1 + sizeof(uint64_t) + cscrypto::kPublicKeySize;
+    const size_t prefixSize = headersLength + cs::MessageCompression::PrefixSize;
+
+    Packet packet(allocator.allocateNext(static_cast<uint32_t>(prefixSize + withDictionary.size())));
+    auto bytes = static_cast<cs::Byte*>(packet.data());
+    std::fill(bytes, bytes + prefixSize, 0);
+    bytes[0] = BaseFlags::Neighbours | BaseFlags::CompressedMessage;
+    bytes[headersLength] = MsgTypes::TransactionPacket;
+    std::copy(withDictionary.begin(), withDictionary.end(), bytes + prefixSize);
+
+    Packet decompressed = compression.decompress(packet);
+    ASSERT_TRUE(decompressed);
+    ASSERT_EQ(decompressed.size(), prefixSize + data.size());
+    EXPECT_EQ(std::memcmp(static_cast<const cs::Byte*>(decompressed.data()) + prefixSize, data.data(), data.size()), 0);
+
+    // other dictionary
+    compression.setDictionary(cs::Bytes());
+    EXPECT_FALSE(compression.decompress(packet));
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
 #include <csnode/packetqueue.hpp>
 
 const size_t kMaxPacketTransactions = 100;
@@ -35,12 +37,36 @@ TEST(PacketQueue, EmptyState) {
     ASSERT_EQ(queue.isEmpty(), true);
 }
 
+csdb::Transaction createTransaction(cs::Byte source, int64_t innerId, double fee) {
+    cs::PublicKey sourceKey{};
+    sourceKey[0] = source;
+
+    cs::PublicKey targetKey{};
+    targetKey[0] = 0xFF;
+
+    cs::Signature signature{};
+
+    return csdb::Transaction(innerId, csdb::Address::from_public_key(sourceKey), csdb::Address::from_public_key(targetKey), csdb::Currency(1),
+                             csdb::Amount(1), csdb::AmountCommission(fee), csdb::AmountCommission(0.), signature);
+}
+
 void addTransactions(cs::PacketQueue& queue) {
     for (size_t i = 0; i < (kMaxPacketTransactions * 2) + 1; ++i) {
         queue.push(csdb::Transaction{});
     }
 }
 
+cs::TransactionsBlock popAll(cs::PacketQueue& queue) {
+    cs::TransactionsBlock block;
+
+    while (!queue.isEmpty()) {
+        auto packets = queue.pop();
+        std::move(packets.begin(), packets.end(), std::back_inserter(block));
+    }
+
+    return block;
+}
+
 TEST(PacketQueue, pushTransaction) {
     cs::PacketQueue queue = PacketCreator::create<PacketCreator::Default>();
     addTransactions(queue);
@@ -58,3 +84,104 @@ TEST(PacketQueue, popTransactionsBlocks) {
 
     ASSERT_EQ(queue.isEmpty(), true);
 }
+
+TEST(PacketQueue, HigherFeeTransactionsArePoppedFirst) {
+    cs::PacketQueue queue(kMaxQueueSize, 2, kMaxPacketsPerRound);
+    queue.push(createTransaction(1, 1, 0.01));
+    queue.push(createTransaction(2, 1, 1.));
+    queue.push(createTransaction(3, 1, 0.1));
+
+    auto block = popAll(queue);
+    ASSERT_EQ(block.size(), 2);
+    ASSERT_EQ(block[0].transactionsCount(), 2);
+    ASSERT_EQ(block[0].transactions().at(0).source(), createTransaction(2, 1, 1.).source());
+    ASSERT_EQ(block[0].transactions().at(1).source(), createTransaction(3, 1, 0.1).source());
+    ASSERT_EQ(block[1].transactions().at(0).source(), createTransaction(1, 1, 0.01).source());
+}
+
+TEST(PacketQueue, SameSourceKeepsInnerIdOrder) {
+    cs::PacketQueue queue = PacketCreator::create<PacketCreator::Default>();
+    queue.push(createTransaction(1, 3, 1.));
+    queue.push(createTransaction(1, 1, 0.01));
+    queue.push(createTransaction(1, 2, 0.1));
+    queue.push(createTransaction(2, 1, 0.05));
+
+    auto block = popAll(queue);
+    ASSERT_EQ(block.size(), 1);
+
+    const auto& transactions = block.front().transactions();
+    ASSERT_EQ(transactions.size(), 4);
+
+    // the cheapest first transaction of the source holds the rest of it
+    ASSERT_EQ(transactions[0].source(), createTransaction(2, 1, 0.05).source());
+    ASSERT_EQ(transactions[1].innerID(), 1);
+    ASSERT_EQ(transactions[2].innerID(), 2);
+    ASSERT_EQ(transactions[3].innerID(), 3);
+}
+
+TEST(PacketQueue, WalletIdAndPublicKeySourcesShareInnerIdOrder) {
+    const csdb::Address publicKey = createTransaction(1, 1, 0.).source();
+    const csdb::Address walletId = csdb::Address::from_wallet_id(1);
+
+    cs::PacketQueue queue = PacketCreator::create<PacketCreator::Default>();
+    queue.setSourceResolver([&](const csdb::Address& source) { return source == walletId ? publicKey : source; });
+
+    csdb::Transaction byWalletId = createTransaction(1, 1, 0.01);
+    byWalletId.set_source(walletId);
+
+    queue.push(createTransaction(1, 2, 1.));
+    queue.push(byWalletId);
+
+    auto block = popAll(queue);
+    ASSERT_EQ(block.size(), 1);
+
+    const auto& transactions = block.front().transactions();
+    ASSERT_EQ(transactions.size(), 2);
+    ASSERT_EQ(transactions[0].innerID(), 1);
+    ASSERT_EQ(transactions[0].source(), walletId);
+    ASSERT_EQ(transactions[1].innerID(), 2);
+}
+
+TEST(PacketQueue, CheapestTransactionIsEvictedWhenFull) {
+    cs::PacketQueue queue(2, 2, kMaxPacketsPerRound);
+
+    for (int64_t i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(queue.push(createTransaction(static_cast<cs::Byte>(i), i, 0.1 * static_cast<double>(i))));
+    }
+
+    ASSERT_FALSE(queue.push(createTransaction(5, 1, 0.01)));
+    ASSERT_EQ(queue.transactionsCount(), 4);
+    ASSERT_EQ(queue.evictedCount(), 0);
+
+    ASSERT_TRUE(queue.push(createTransaction(6, 6, 1.)));
+    ASSERT_EQ(queue.transactionsCount(), 4);
+    ASSERT_EQ(queue.evictedCount(), 1);
+
+    auto block = popAll(queue);
+    ASSERT_EQ(block.size(), 2);
+
+    for (const auto& packet : block) {
+        for (const auto& transaction : packet.transactions()) {
+            ASSERT_NE(transaction.innerID(), 1);
+        }
+    }
+}
+
+TEST(PacketQueue, SeparatePacketGoesFirst) {
+    cs::PacketQueue queue = PacketCreator::create<PacketCreator::Default>();
+    queue.push(createTransaction(1, 1, 1.));
+
+    cs::TransactionsPacket packet;
+    packet.addTransaction(createTransaction(2, 7, 0.01));
+    queue.push(packet);
+
+    ASSERT_EQ(queue.size(), 2);
+    ASSERT_TRUE(queue.containsInnerId(7));
+    ASSERT_TRUE(queue.containsInnerId(1));
+    ASSERT_FALSE(queue.containsInnerId(2));
+
+    auto block = popAll(queue);
+    ASSERT_EQ(block.size(), 2);
+    ASSERT_EQ(block[0].transactions().at(0).innerID(), 7);
+    ASSERT_EQ(block[1].transactions().at(0).innerID(), 1);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "signaturescache.hpp"
+#include "signaturesverifier.hpp"
+
+#include <cscrypto/cscrypto.hpp>
+#include <lib/system/hash.hpp>
+
+namespace {
+struct Signed {
+    cs::Bytes data;
+    cs::PublicKey publicKey;
+    cs::Signature signature;
+};
+
+Signed makeSigned(cs::Byte value) {
+    Signed result;
+    const auto privateKey = cscrypto::generateKeyPair(result.publicKey);
+
+    result.data.assign(100, value);
+    result.signature = cscrypto::generateSignature(privateKey, result.data.data(), result.data.size());
+
+    return result;
+}
+}  // namespace
+
+TEST(SignaturesCache, KeepsSuccessfulVerificationsOnly) {
+    cs::SignaturesCache cache(64);
+    const Signed item = makeSigned(1);
+
+    cs::Bytes changed = item.data;
+    changed.back() ^= 1;
+
+    EXPECT_FALSE(cache.verify(item.signature, item.publicKey, changed.data(), changed.size()));
+    EXPECT_EQ(cache.size(), 0);
+
+    EXPECT_TRUE(cache.verify(item.signature, item.publicKey, item.data.data(), item.data.size()));
+    EXPECT_TRUE(cache.verify(item.signature, item.publicKey, item.data.data(), item.data.size()));
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 2);
+
+    // the same signature with other data or key is not taken from the cache
+    EXPECT_FALSE(cache.verify(item.signature, item.publicKey, changed.data(), changed.size()));
+
+    const Signed other = makeSigned(1);
+    EXPECT_FALSE(cache.verify(item.signature, other.publicKey, item.data.data(), item.data.size()));
+    EXPECT_EQ(cache.hits(), 1);
+}
+
+TEST(SignaturesCache, EvictsOldestRecords) {
+    cs::SignaturesCache cache(cs::SignaturesCache::ShardsCount);
+    ASSERT_EQ(cache.capacity(), cs::SignaturesCache::ShardsCount);
+
+    std::vector<Signed> items;
+
+    for (size_t i = 0; i < 200; ++i) {
+        items.push_back(makeSigned(static_cast<cs::Byte>(i)));
+        const Signed& item = items.back();
+        cache.insert(item.signature, item.publicKey, generateHash(item.data.data(), item.data.size()));
+    }
+
+    EXPECT_LE(cache.size(), cache.capacity());
+
+    const Signed& last = items.back();
+    EXPECT_TRUE(cache.contains(last.signature, last.publicKey, generateHash(last.data.data(), last.data.size())));
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(SignaturesCache, SkipsVerifiedSignaturesInBatch) {
+    cs::SignaturesCache cache(1024);
+    cs::SignaturesVerifier verifier(4, cache);
+
+    std::vector<Signed> items;
+
+    for (size_t i = 0; i < 100; ++i) {
+        items.push_back(makeSigned(static_cast<cs::Byte>(i)));
+    }
+
+    auto verify = [&] {
+        verifier.clear();
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            verifier.add(i, items[i].data.data(), items[i].data.size(), items[i].signature, items[i].publicKey);
+        }
+
+        cs::Bytes mask(items.size(), 1);
+        return verifier.verify(mask);
+    };
+
+    EXPECT_TRUE(verify().empty());
+    EXPECT_EQ(cache.hits(), 0);
+    EXPECT_EQ(cache.size(), items.size());
+
+    EXPECT_TRUE(verify().empty());
+    EXPECT_EQ(cache.hits(), items.size());
+
+    // signature verified before does not make a changed transaction valid
+    items[5].data.front() ^= 1;
+    EXPECT_EQ(verify(), std::vector<size_t>{5});
+}
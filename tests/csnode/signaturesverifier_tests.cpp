@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "signaturesverifier.hpp"
+
+#include <cscrypto/cscrypto.hpp>
+#include <csdb/address.hpp>
+#include <csdb/amount.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/transaction.hpp>
+
+namespace {
+std::vector<csdb::Transaction> makeSignedTransactions(size_t count, cscrypto::PublicKey& publicKey) {
+    const auto privateKey = cscrypto::generateKeyPair(publicKey);
+    const auto target = csdb::Address::from_string("0000000000000000000000000000000000000000000000000000000000000007");
+
+    std::vector<csdb::Transaction> transactions;
+
+    for (size_t i = 0; i < count; ++i) {
+        csdb::Transaction transaction;
+        transaction.set_source(csdb::Address::from_public_key(publicKey));
+        transaction.set_target(target);
+        transaction.set_currency(1);
+        transaction.set_amount(csdb::Amount(static_cast<int32_t>(i + 1), 0));
+        transaction.set_innerID(static_cast<int64_t>(i + 1));
+
+        const auto bytes = transaction.to_byte_stream_for_sig();
+        transaction.set_signature(cscrypto::generateSignature(privateKey, bytes.data(), bytes.size()));
+
+        transactions.push_back(transaction);
+    }
+
+    return transactions;
+}
+
+void verifyBatch(cs::SignaturesVerifier& verifier, size_t count) {
+    cscrypto::PublicKey publicKey;
+    auto transactions = makeSignedTransactions(count, publicKey);
+
+    // signed data is changed
+    const std::vector<size_t> corrupted = {0, count / 2, count - 1};
+    for (const auto i : corrupted) {
+        transactions[i].set_amount(csdb::Amount(1000, 0));
+    }
+
+    cs::Bytes mask(count, 1);
+
+    verifier.clear();
+    for (size_t i = 0; i < count; ++i) {
+        verifier.add(i, transactions[i], publicKey);
+    }
+
+    EXPECT_EQ(verifier.verify(mask), corrupted);
+
+    for (size_t i = 0; i < count; ++i) {
+        const bool isCorrupted = std::find(corrupted.begin(), corrupted.end(), i) != corrupted.end();
+        EXPECT_EQ(mask[i], isCorrupted ? 0 : 1) << "transaction " << i;
+        EXPECT_EQ(transactions[i].verify_signature(publicKey), !isCorrupted);
+    }
+}
+}  // namespace
+
+TEST(SignaturesVerifier, VerifiesBatchByPool) {
+    cs::SignaturesVerifier verifier(4);
+    verifyBatch(verifier, 500);
+}
+
+TEST(SignaturesVerifier, VerifiesSmallBatchInPlace) {
+    cs::SignaturesVerifier verifier(4);
+    verifyBatch(verifier, cs::SignaturesVerifier::MinParallelSize / 2);
+}
+
+TEST(SignaturesVerifier, VerifiesWithoutPool) {
+    cs::SignaturesVerifier verifier(1);
+    verifyBatch(verifier, 200);
+}
+
+TEST(SignaturesVerifier, SerializesSignedDataOneAfterAnother) {
+    cscrypto::PublicKey publicKey;
+    const auto transactions = makeSignedTransactions(3, publicKey);
+
+    cs::Bytes buffer;
+    size_t size = 0;
+
+    for (const auto& transaction : transactions) {
+        const auto bytes = transaction.to_byte_stream_for_sig();
+        transaction.to_byte_stream_for_sig(buffer);
+
+        ASSERT_EQ(buffer.size(), size + bytes.size());
+        EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), buffer.begin() + static_cast<std::ptrdiff_t>(size)));
+        size = buffer.size();
+    }
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "statesnapshot.hpp"
+
+namespace {
+std::string snapshotPath() {
+    return (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("state-%%%%-%%%%.snapshot")).string();
+}
+
+csdb::PoolHash someHash() {
+    return csdb::PoolHash::from_binary(cs::Bytes(32, 0xAB));
+}
+}  // namespace
+
+TEST(StateSnapshot, IsInvalidByDefault) {
+    cs::StateSnapshot snapshot;
+    ASSERT_FALSE(snapshot.isValid());
+    ASSERT_FALSE(snapshot.save(snapshotPath()));
+}
+
+TEST(StateSnapshot, SavedSectionsAreLoaded) {
+    const auto path = snapshotPath();
+
+    cs::StateSnapshot snapshot(10000, someHash());
+    snapshot.setSection("first", cs::Bytes{1, 2, 3});
+    snapshot.setSection("empty", cs::Bytes{});
+    ASSERT_TRUE(snapshot.save(path));
+
+    cs::StateSnapshot loaded;
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_EQ(loaded.sequence(), 10000);
+    ASSERT_EQ(loaded.hash(), someHash());
+
+    ASSERT_NE(loaded.section("first"), nullptr);
+    ASSERT_EQ(*loaded.section("first"), (cs::Bytes{1, 2, 3}));
+    ASSERT_NE(loaded.section("empty"), nullptr);
+    ASSERT_TRUE(loaded.section("empty")->empty());
+    ASSERT_EQ(loaded.section("absent"), nullptr);
+
+    cs::StateSnapshot::remove(path);
+}
+
+TEST(StateSnapshot, AbsentFileIsNotLoaded) {
+    cs::StateSnapshot snapshot;
+    ASSERT_FALSE(snapshot.load(snapshotPath()));
+    ASSERT_FALSE(snapshot.isValid());
+}
+
+TEST(StateSnapshot, DamagedFileIsNotLoaded) {
+    const auto path = snapshotPath();
+
+    cs::StateSnapshot snapshot(1, someHash());
+    snapshot.setSection("data", cs::Bytes(100, 0x11));
+    ASSERT_TRUE(snapshot.save(path));
+
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(50);
+        file.put(0x22);
+    }
+
+    cs::StateSnapshot loaded;
+    ASSERT_FALSE(loaded.load(path));
+    ASSERT_FALSE(loaded.isValid());
+
+    cs::StateSnapshot::remove(path);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <csdb/currency.hpp>
+
+#include "transactionsbatch.hpp"
+
+namespace {
+csdb::Transaction makeTransaction(int64_t innerId, const csdb::Address& source, const csdb::Address& target) {
+    cs::Signature signature{};
+    signature.fill(static_cast<cs::Byte>(innerId));
+
+    return csdb::Transaction(innerId, source, target, csdb::Currency(1), csdb::Amount(innerId, 25, 100), csdb::AmountCommission(0.1),
+                             csdb::AmountCommission(0.0), signature);
+}
+
+csdb::Address makeKeyAddress(cs::Byte value) {
+    cs::PublicKey key{};
+    key.fill(value);
+    return csdb::Address::from_public_key(key);
+}
+
+std::vector<csdb::Transaction> makeTransactions() {
+    std::vector<csdb::Transaction> transactions;
+
+    transactions.push_back(makeTransaction(1, makeKeyAddress(1), makeKeyAddress(2)));
+    transactions.push_back(makeTransaction(2, csdb::Address::from_wallet_id(10), makeKeyAddress(3)));
+    transactions.push_back(makeTransaction(3, csdb::Address::from_wallet_id(11), csdb::Address::from_wallet_id(12)));
+
+    transactions[1].add_user_field(-1, std::string("comment"));
+    transactions[2].add_user_field(0, std::string(1000, 'c'));
+    transactions[2].add_user_field(1, uint64_t(42));
+    transactions[2].add_user_field(-2, csdb::Amount(7, 5, 10));
+
+    return transactions;
+}
+}  // namespace
+
+TEST(TransactionsBatch, ConvertsTransactionsBack) {
+    const auto transactions = makeTransactions();
+    const cs::TransactionsBatch batch(transactions);
+
+    ASSERT_EQ(batch.size(), transactions.size());
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        const csdb::Transaction restored = batch.transaction(i);
+
+        EXPECT_EQ(batch.innerId(i), transactions[i].innerID());
+        EXPECT_EQ(batch.amount(i), transactions[i].amount());
+        EXPECT_EQ(restored.to_byte_stream(), transactions[i].to_byte_stream());
+        EXPECT_EQ(restored.source(), transactions[i].source());
+        EXPECT_EQ(restored.target(), transactions[i].target());
+    }
+
+    EXPECT_EQ(batch.stringUserField(1, -1), "comment");
+    EXPECT_EQ(batch.userFieldType(2, 1), csdb::UserField::Integer);
+    EXPECT_EQ(batch.userFieldType(2, -2), csdb::UserField::Amount);
+    EXPECT_EQ(batch.userFieldType(0, 0), csdb::UserField::Unknown);
+    EXPECT_TRUE(batch.stringUserField(2, 1).empty());
+}
+
+TEST(TransactionsBatch, CountsSerializedSizeWithoutSerialization) {
+    const auto transactions = makeTransactions();
+    cs::TransactionsBatch batch(transactions);
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        EXPECT_EQ(batch.serializedSize(i), transactions[i].to_byte_stream().size());
+    }
+
+    batch.setCountedFee(0, csdb::AmountCommission(0.5));
+    EXPECT_EQ(batch.transaction(0).counted_fee().to_double(), csdb::AmountCommission(0.5).to_double());
+
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+
+    batch.add(transactions[2]);
+    EXPECT_EQ(batch.serializedSize(0), transactions[2].to_byte_stream().size());
+}
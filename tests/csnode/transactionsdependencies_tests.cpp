@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "transactionsdependencies.hpp"
+
+namespace {
+csdb::Address makeAddress(csdb::internal::WalletId id) {
+    return csdb::Address::from_wallet_id(id);
+}
+}  // namespace
+
+TEST(TransactionsDependencies, GroupsTransactionsBySharedWallets) {
+    std::vector<cs::WalletsState::WalletData> wallets(6);
+    cs::TransactionsDependencies dependencies;
+
+    // transaction index -> source and target wallets: {0, 1}, {2, 3}, {1, 4}, {5, 5}, {3, 2}
+    const std::vector<std::pair<size_t, size_t>> transactions = {{0, 1}, {2, 3}, {1, 4}, {5, 5}, {3, 2}};
+
+    dependencies.reset(transactions.size());
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        dependencies.add(i, makeAddress(transactions[i].first), &wallets[transactions[i].first]);
+        dependencies.add(i, makeAddress(transactions[i].second), &wallets[transactions[i].second]);
+    }
+
+    EXPECT_EQ(dependencies.groupsCount(), 3);
+
+    cs::TransactionsDependencies::Addresses addresses;
+    EXPECT_EQ(dependencies.affected({2}, addresses), (cs::TransactionsDependencies::Indices{0, 2}));
+
+    std::vector<csdb::Address> expected = {makeAddress(0), makeAddress(1), makeAddress(4)};
+    std::sort(addresses.begin(), addresses.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(addresses, expected);
+
+    addresses.clear();
+    EXPECT_EQ(dependencies.affected({4, 3, 1}, addresses), (cs::TransactionsDependencies::Indices{1, 3, 4}));
+    EXPECT_EQ(addresses.size(), 3);
+
+    addresses.clear();
+    EXPECT_TRUE(dependencies.affected({}, addresses).empty());
+    EXPECT_TRUE(addresses.empty());
+}
+
+TEST(TransactionsDependencies, JoinsGroupsByLaterTransactions) {
+    std::vector<cs::WalletsState::WalletData> wallets(4);
+    cs::TransactionsDependencies dependencies;
+
+    dependencies.reset(3);
+    dependencies.add(0, makeAddress(0), &wallets[0]);
+    dependencies.add(0, makeAddress(1), &wallets[1]);
+    dependencies.add(1, makeAddress(2), &wallets[2]);
+    dependencies.add(1, makeAddress(3), &wallets[3]);
+
+    EXPECT_EQ(dependencies.groupsCount(), 3);
+
+    // the last transaction depends on both groups
+    dependencies.add(2, makeAddress(3), &wallets[3]);
+    dependencies.add(2, makeAddress(0), &wallets[0]);
+
+    EXPECT_EQ(dependencies.groupsCount(), 1);
+
+    cs::TransactionsDependencies::Addresses addresses;
+    EXPECT_EQ(dependencies.affected({1}, addresses), (cs::TransactionsDependencies::Indices{0, 1, 2}));
+    EXPECT_EQ(addresses.size(), wallets.size());
+}
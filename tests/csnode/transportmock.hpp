@@ -14,7 +14,7 @@ public:
 
   MOCK_METHOD1(getPackSenderEntry, RemoteNodePtr(const ip::udp::endpoint&));
 
-  MOCK_METHOD2(processNetworkTask, void(const TaskPtr<IPacMan>&, RemoteNodePtr&));
+  MOCK_METHOD2(processNetworkTask, void(const IPacMan::Task&, RemoteNodePtr&));
   MOCK_METHOD1(processNodeMessage, void(const Message&));
   MOCK_METHOD1(processNodeMessage, void(const Packet&));
 
@@ -50,29 +50,29 @@ public:
   MOCK_METHOD3(postponePacket, void(const cs::RoundNumber, const MsgTypes, const Packet&));
 
   // Dealing with network connections
-  MOCK_METHOD1(parseSSSignal, bool(const TaskPtr<IPacMan>&));
+  MOCK_METHOD1(parseSSSignal, bool(const IPacMan::Task&));
 
   MOCK_METHOD5(dispatchNodeMessage,
                void(const MsgTypes, const cs::RoundNumber, const Packet&, const uint8_t* data, size_t));
 
   /* Network packages processing */
-  MOCK_METHOD2(gotRegistrationRequest, bool(const TaskPtr<IPacMan>&, RemoteNodePtr&));
+  MOCK_METHOD2(gotRegistrationRequest, bool(const IPacMan::Task&, RemoteNodePtr&));
 
-  MOCK_METHOD2(gotRegistrationConfirmation, bool(const TaskPtr<IPacMan>&, RemoteNodePtr&));
+  MOCK_METHOD2(gotRegistrationConfirmation, bool(const IPacMan::Task&, RemoteNodePtr&));
 
-  MOCK_METHOD2(gotRegistrationRefusal, bool(const TaskPtr<IPacMan>&, RemoteNodePtr&));
+  MOCK_METHOD2(gotRegistrationRefusal, bool(const IPacMan::Task&, RemoteNodePtr&));
 
-  MOCK_METHOD2(gotSSRegistration, bool(const TaskPtr<IPacMan>&, RemoteNodePtr&));
-  MOCK_METHOD1(gotSSRefusal, bool(const TaskPtr<IPacMan>&));
-  MOCK_METHOD1(gotSSDispatch, bool(const TaskPtr<IPacMan>&));
-  MOCK_METHOD1(gotSSPingWhiteNode, bool(const TaskPtr<IPacMan>&));
-  MOCK_METHOD2(gotSSLastBlock, bool(const TaskPtr<IPacMan>&, uint32_t lastBlock));
+  MOCK_METHOD2(gotSSRegistration, bool(const IPacMan::Task&, RemoteNodePtr&));
+  MOCK_METHOD1(gotSSRefusal, bool(const IPacMan::Task&));
+  MOCK_METHOD1(gotSSDispatch, bool(const IPacMan::Task&));
+  MOCK_METHOD1(gotSSPingWhiteNode, bool(const IPacMan::Task&));
+  MOCK_METHOD2(gotSSLastBlock, bool(const IPacMan::Task&, uint32_t lastBlock));
 
-  MOCK_METHOD2(gotPackInform, bool(const TaskPtr<IPacMan>&, RemoteNodePtr&));
-  MOCK_METHOD2(gotPackRenounce, bool(const TaskPtr<IPacMan>&, RemoteNodePtr&));
-  MOCK_METHOD2(gotPackRequest, bool(const TaskPtr<IPacMan>&, RemoteNodePtr&));
+  MOCK_METHOD2(gotPackInform, bool(const IPacMan::Task&, RemoteNodePtr&));
+  MOCK_METHOD2(gotPackRenounce, bool(const IPacMan::Task&, RemoteNodePtr&));
+  MOCK_METHOD2(gotPackRequest, bool(const IPacMan::Task&, RemoteNodePtr&));
 
-  MOCK_METHOD2(gotPing, bool(const TaskPtr<IPacMan>&, RemoteNodePtr&));
+  MOCK_METHOD2(gotPing, bool(const IPacMan::Task&, RemoteNodePtr&));
 
   MOCK_METHOD0(askForMissingPackages, void());
   MOCK_METHOD3(requestMissing, void(const cs::Hash&, const uint16_t, const uint64_t));
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+#include <csnode/datastream.hpp>
+#include <csnode/walletscache.hpp>
+#include <csnode/walletsids.hpp>
+
+namespace {
+// snapshot of wallets cache with the given balances, absent wallets have no balance
+cs::Bytes makeSnapshot(const std::vector<std::optional<int32_t>>& balances) {
+    uint8_t layout = 0;
+#ifdef MONITOR_NODE
+    layout |= 0x1;
+#endif
+#ifdef TRANSACTIONS_INDEX
+    layout |= 0x2;
+#endif
+
+    cs::Bytes bytes;
+    cs::DataStream stream(bytes);
+    stream << layout << balances.size();
+
+    for (size_t i = 0; i < balances.size(); ++i) {
+        stream << static_cast<uint8_t>(balances[i].has_value());
+
+        if (!balances[i].has_value()) {
+            continue;
+        }
+
+        cs::PublicKey key{};
+        key[0] = static_cast<cs::Byte>(i);
+        key[1] = static_cast<cs::Byte>(i >> 8);
+
+        cs::TransactionsTail tail;
+        tail.push(static_cast<int64_t>(i) + 1);
+
+        stream << key << csdb::Amount(balances[i].value()) << static_cast<uint64_t>(i);
+        stream.addValue(tail);
+#ifdef MONITOR_NODE
+        stream << static_cast<uint64_t>(0);
+#endif
+#ifdef TRANSACTIONS_INDEX
+        stream << csdb::PoolHash{} << static_cast<cs::Sequence>(0);
+#endif
+    }
+
+    // payable and closed smart contracts transactions
+    stream << size_t(0) << size_t(0);
+#ifdef MONITOR_NODE
+    stream << size_t(0);
+#endif
+
+    return bytes;
+}
+
+std::vector<std::optional<int32_t>> someBalances() {
+    std::vector<std::optional<int32_t>> balances(cs::WalletsCache::Config{}.initialWalletsNum_ / 256 + 3);
+
+    for (size_t i = 0; i < balances.size(); ++i) {
+        if (i % 3 != 1) {
+            balances[i] = static_cast<int32_t>(i);
+        }
+    }
+
+    return balances;
+}
+}  // namespace
+
+TEST(WalletsCache, SnapshotIsLoadedAndStoredBack) {
+    const auto balances = someBalances();
+    const auto bytes = makeSnapshot(balances);
+
+    cs::WalletsIds ids;
+    cs::WalletsCache cache(cs::WalletsCache::Config{}, csdb::Address{}, csdb::Address{}, ids);
+
+    ASSERT_TRUE(cache.fromBinary(bytes));
+    ASSERT_EQ(cache.getCount(), balances.size());
+    ASSERT_EQ(cache.toBinary(), bytes);
+}
+
+TEST(WalletsCache, WalletsAreFoundById) {
+    const auto balances = someBalances();
+
+    cs::WalletsIds ids;
+    cs::WalletsCache cache(cs::WalletsCache::Config{}, csdb::Address{}, csdb::Address{}, ids);
+    ASSERT_TRUE(cache.fromBinary(makeSnapshot(balances)));
+
+    auto updater = cache.createUpdater();
+
+    for (size_t i = 0; i < balances.size(); ++i) {
+        const auto* wallet = updater->findWallet(static_cast<cs::WalletsCache::WalletId>(i));
+
+        if (!balances[i].has_value()) {
+            ASSERT_EQ(wallet, nullptr);
+            continue;
+        }
+
+        ASSERT_NE(wallet, nullptr);
+        ASSERT_EQ(wallet->balance_, csdb::Amount(balances[i].value()));
+        ASSERT_EQ(wallet->transNum_, i);
+        ASSERT_EQ(wallet->trxTail_.getLastTransactionId(), static_cast<int64_t>(i) + 1);
+    }
+
+    ASSERT_EQ(updater->findWallet(static_cast<cs::WalletsCache::WalletId>(balances.size())), nullptr);
+}
+
+TEST(WalletsCache, IterationGoesByIdAndSkipsAbsentWallets) {
+    const auto balances = someBalances();
+
+    cs::WalletsIds ids;
+    cs::WalletsCache cache(cs::WalletsCache::Config{}, csdb::Address{}, csdb::Address{}, ids);
+    ASSERT_TRUE(cache.fromBinary(makeSnapshot(balances)));
+
+    std::vector<uint64_t> visited;
+    cache.iterateOverWallets([&](const cs::WalletsCache::WalletData::Address&, const cs::WalletsCache::WalletData& wallet) {
+        visited.push_back(wallet.transNum_);
+        return true;
+    });
+
+    std::vector<uint64_t> expected;
+
+    for (size_t i = 0; i < balances.size(); ++i) {
+        if (balances[i].has_value()) {
+            expected.push_back(i);
+        }
+    }
+
+    ASSERT_EQ(visited, expected);
+
+    const auto usage = cache.memoryUsage();
+    ASSERT_EQ(usage.wallets, expected.size());
+    ASSERT_GE(usage.slabs, 2);
+    ASSERT_GE(usage.bytes, usage.wallets * sizeof(cs::WalletsCache::WalletData));
+    // records are allocated for the present wallets only
+    ASSERT_LT(usage.bytes, usage.wallets * (sizeof(cs::WalletsCache::WalletData) + 8));
+}
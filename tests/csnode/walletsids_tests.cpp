@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <csnode/walletsids.hpp>
+
+namespace {
+csdb::Address address(cs::Byte value) {
+    cs::PublicKey key{};
+    key.fill(value);
+    return csdb::Address::from_public_key(key);
+}
+}  // namespace
+
+TEST(WalletsIds, AddressIsFoundById) {
+    cs::WalletsIds ids;
+    cs::WalletsIds::WalletId id = 0;
+
+    ASSERT_TRUE(ids.normal().get(address(1), id));
+    ASSERT_EQ(id, 0);
+    ASSERT_TRUE(ids.normal().get(address(2), id));
+    ASSERT_EQ(id, 1);
+    ASSERT_TRUE(ids.normal().insert(address(3), 10));
+
+    csdb::Address found;
+    ASSERT_TRUE(ids.normal().findaddr(1, found));
+    ASSERT_EQ(found, address(2));
+    ASSERT_TRUE(ids.normal().findaddr(10, found));
+    ASSERT_EQ(found, address(3));
+    ASSERT_FALSE(ids.normal().findaddr(5, found));
+    ASSERT_FALSE(ids.normal().findaddr(11, found));
+
+    ASSERT_TRUE(ids.normal().find(address(3), id));
+    ASSERT_EQ(id, 10);
+}
+
+TEST(WalletsIds, SpecialIdIsReplacedByNormal) {
+    cs::WalletsIds ids;
+    cs::WalletsIds::WalletId special = 0;
+
+    ASSERT_TRUE(ids.special().findAnyOrInsertSpecial(address(1), special));
+    ASSERT_TRUE(cs::WalletsIds::Special::isSpecial(special));
+
+    csdb::Address found;
+    ASSERT_TRUE(ids.normal().findaddr(special, found));
+    ASSERT_EQ(found, address(1));
+
+    cs::WalletsIds::WalletId replaced = 0;
+    ASSERT_TRUE(ids.special().insertNormal(address(1), 7, replaced));
+    ASSERT_EQ(replaced, special);
+
+    ASSERT_FALSE(ids.normal().findaddr(special, found));
+    ASSERT_TRUE(ids.normal().findaddr(7, found));
+    ASSERT_EQ(found, address(1));
+}
+
+TEST(WalletsIds, RemovedAddressIsNotFound) {
+    cs::WalletsIds ids;
+    cs::WalletsIds::WalletId id = 0;
+
+    ids.normal().get(address(1), id);
+    ids.normal().get(address(2), id);
+    ASSERT_TRUE(ids.normal().remove(address(2)));
+
+    csdb::Address found;
+    ASSERT_FALSE(ids.normal().findaddr(id, found));
+    ASSERT_FALSE(ids.normal().find(address(2), id));
+
+    // the id of the removed address is given again
+    ASSERT_TRUE(ids.normal().get(address(3), id));
+    ASSERT_EQ(id, 1);
+    ASSERT_TRUE(ids.normal().findaddr(1, found));
+    ASSERT_EQ(found, address(3));
+}
+
+TEST(WalletsIds, ReverseIndexIsRestoredFromBinary) {
+    cs::WalletsIds ids;
+    cs::WalletsIds::WalletId id = 0;
+
+    for (cs::Byte i = 1; i <= 100; ++i) {
+        ids.normal().get(address(i), id);
+    }
+
+    cs::WalletsIds loaded;
+    ASSERT_TRUE(loaded.fromBinary(ids.toBinary()));
+
+    for (cs::WalletsIds::WalletId i = 0; i < 100; ++i) {
+        csdb::Address found;
+        ASSERT_TRUE(loaded.normal().findaddr(i, found));
+        ASSERT_EQ(found, address(static_cast<cs::Byte>(i + 1)));
+    }
+
+    ASSERT_TRUE(loaded.normal().get(address(101), id));
+    ASSERT_EQ(id, 100);
+}
+
+TEST(WalletsIds, SpecialIdsAreNotReusedAfterBinary) {
+    cs::WalletsIds ids;
+    cs::WalletsIds::WalletId special = 0;
+
+    ASSERT_TRUE(ids.special().findAnyOrInsertSpecial(address(1), special));
+
+    cs::WalletsIds loaded;
+    ASSERT_TRUE(loaded.fromBinary(ids.toBinary()));
+
+    cs::WalletsIds::WalletId next = 0;
+    ASSERT_TRUE(loaded.special().findAnyOrInsertSpecial(address(2), next));
+    ASSERT_NE(next, special);
+
+    csdb::Address found;
+    ASSERT_TRUE(loaded.normal().findaddr(special, found));
+    ASSERT_EQ(found, address(1));
+    ASSERT_TRUE(loaded.normal().findaddr(next, found));
+    ASSERT_EQ(found, address(2));
+}
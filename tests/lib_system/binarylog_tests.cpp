@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/core/null_deleter.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/utility/setup/console.hpp>
+
+#include "lib/system/binarylog.hpp"
+
+namespace {
+std::vector<std::string> lines(const std::string& text) {
+    std::vector<std::string> result;
+    std::istringstream stream(text);
+
+    for (std::string line; std::getline(stream, line);) {
+        result.push_back(line);
+    }
+
+    return result;
+}
+}  // namespace
+
+TEST(BinaryLog, FormatsArguments) {
+    const std::string text("text");
+
+    ASSERT_EQ(logger::BinaryLog::format("{} + {} = {}", 2, 2u, 4.5), "2 + 2 = 4.5");
+    ASSERT_EQ(logger::BinaryLog::format("{} {} {}", text, "literal", 'c'), "text literal c");
+    ASSERT_EQ(logger::BinaryLog::format("byte {}", static_cast<uint8_t>(200)), "byte 200");
+
+    // missing arguments leave placeholders, the rest of them are appended
+    ASSERT_EQ(logger::BinaryLog::format("{} and {}", 1), "1 and {}");
+    ASSERT_EQ(logger::BinaryLog::format("values:", 1, 2), "values: 1 2");
+}
+
+TEST(BinaryLog, WritesRecordsOfAllThreadsInLogThread) {
+    std::ostringstream output;
+    auto sink = logging::add_console_log(output, logging::keywords::format = "%Message%");
+
+    constexpr size_t threadsCount = 4;
+    constexpr size_t recordsCount = 1000;
+
+    logger::BinaryLog::start(logger::severity_level::debug);
+    ASSERT_TRUE(logger::BinaryLog::isRunning());
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([i] {
+            for (size_t j = 0; j < recordsCount; ++j) {
+                csdebugf("thread {} record {} {}", i, j, std::string("done"));
+                csdetailsf("filtered {}", j);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    logger::BinaryLog::stop();
+    ASSERT_FALSE(logger::BinaryLog::isRunning());
+
+    logging::core::get()->remove_sink(sink);
+    sink->flush();
+
+    const auto result = lines(output.str());
+    ASSERT_EQ(logger::BinaryLog::dropped(), 0);
+    ASSERT_EQ(result.size(), threadsCount * recordsCount);
+
+    // records of a thread keep their order
+    size_t next = 0;
+
+    for (const auto& line : result) {
+        ASSERT_EQ(line.find("filtered"), std::string::npos);
+
+        if (line.rfind("thread 0 ", 0) == 0) {
+            ASSERT_EQ(line, "thread 0 record " + std::to_string(next) + " done");
+            ++next;
+        }
+    }
+}
+
+TEST(BinaryLog, WritesRecordsAfterStopOnCallingThread) {
+    std::ostringstream output;
+    auto sink = logging::add_console_log(output, logging::keywords::format = "%Message%");
+
+    logger::BinaryLog::start(logger::severity_level::debug);
+    csdebugf("before {}", 1);
+    logger::BinaryLog::stop();
+    csdebugf("after {}", 2);
+
+    logging::core::get()->remove_sink(sink);
+    sink->flush();
+
+    const auto result = lines(output.str());
+    ASSERT_EQ(result.size(), 2u);
+    ASSERT_EQ(result[0], "before 1");
+    ASSERT_EQ(result[1], "after 2");
+}
+
+TEST(BinaryLog, ProcessExitsWithoutStop) {
+    EXPECT_EXIT(
+        {
+            logger::BinaryLog::start();
+            csdebugf("record {}", 1);
+            std::exit(3);
+        },
+        ::testing::ExitedWithCode(3), "");
+}
@@ -5,6 +5,7 @@
 #include <list>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include <lib/system/allocators.hpp>
 #include <lib/system/queues.hpp>
@@ -235,6 +236,120 @@ TEST(fuqueue, DISABLED_multithreaded_stress) {
     r3.join();
 }
 
+TEST(bounded_ring, consecutive) {
+    BoundedRing<uint32_t, 1024> ring;
+
+    for (uint32_t i = 0; i < 1000; ++i) {
+        auto s = ring.claim();
+        *s = i;
+        ring.publish(s);
+    }
+
+    for (uint32_t i = 0; i < 1000; ++i) {
+        auto s = ring.front();
+        ASSERT_NE(s, nullptr);
+        ASSERT_EQ(*s, i);
+        ring.pop();
+    }
+
+    ASSERT_EQ(ring.front(), nullptr);
+}
+
+TEST(bounded_ring, front_waits_for_oldest_claimed) {
+    BoundedRing<uint32_t, 16> ring;
+
+    auto first = ring.claim();
+    auto second = ring.claim();
+
+    *second = 2;
+    ring.publish(second);
+    ASSERT_EQ(ring.front(), nullptr);
+
+    *first = 1;
+    ring.publish(first);
+    ASSERT_EQ(*ring.front(), 1u);
+    ring.pop();
+    ASSERT_EQ(*ring.front(), 2u);
+    ring.pop();
+    ASSERT_EQ(ring.front(), nullptr);
+}
+
+TEST(bounded_ring, try_claim_on_full) {
+    BoundedRing<uint32_t, 4> ring;
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        auto s = ring.tryClaim();
+        ASSERT_NE(s, nullptr);
+        *s = i;
+        ring.publish(s);
+    }
+
+    ASSERT_EQ(ring.tryClaim(), nullptr);
+
+    ring.pop();
+    auto s = ring.tryClaim();
+    ASSERT_NE(s, nullptr);
+    ring.publish(s);
+    ASSERT_EQ(ring.tryClaim(), nullptr);
+}
+
+TEST(bounded_ring, unclaim_last) {
+    BoundedRing<uint32_t, 16> ring;
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        auto rejected = ring.claim();
+        ring.unclaimLast(rejected);
+
+        auto s = ring.claim();
+        ASSERT_EQ(s, rejected);
+        *s = i;
+        ring.publish(s);
+
+        ASSERT_EQ(*ring.front(), i);
+        ring.pop();
+    }
+}
+
+TEST(bounded_ring, multiple_producers) {
+    BoundedRing<uint64_t, 256> ring;
+
+    constexpr uint64_t producers = 4;
+    constexpr uint64_t count = 100000;
+
+    auto producer = [&](uint64_t id) {
+        for (uint64_t i = 0; i < count; ++i) {
+            auto s = ring.claim();
+            *s = (id << 32) | i;
+            ring.publish(s);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint64_t id = 0; id < producers; ++id) {
+        threads.emplace_back(producer, id);
+    }
+
+    // every producer elements keep their order
+    std::array<uint64_t, producers> next = {};
+    for (uint64_t i = 0; i < producers * count; ++i) {
+        uint64_t* s = nullptr;
+        while (!(s = ring.front())) {
+            std::this_thread::yield();
+        }
+
+        const uint64_t id = *s >> 32;
+        ASSERT_LT(id, producers);
+        ASSERT_EQ(*s & 0xffffffff, next[id]++);
+        ring.pop();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(ring.front(), nullptr);
+}
+
 TEST(boost_spsc_queue, DISABLED_multithreaded_stress) {
     boost::lockfree::spsc_queue<uint32_t, boost::lockfree::capacity<10000>> queue;
 